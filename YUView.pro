@@ -1,13 +1,21 @@
 TEMPLATE = subdirs
-SUBDIRS = YUViewLib YUViewApp
+SUBDIRS = YUViewLib YUViewApp YUViewMetrics
 
 YUViewApp.subdir = YUViewApp
 YUViewLib.subdir = YUViewLib
+YUViewMetrics.subdir = YUViewMetrics
 
 YUViewApp.depends = YUViewLib
+YUViewMetrics.depends = YUViewLib
 
 UNITTESTS {
   SUBDIRS += YUViewUnitTest
   YUViewUnitTest.subdir = YUViewUnitTest
   YUViewUnitTest.depends = YUViewLib
 }
+
+BENCHMARKS {
+  SUBDIRS += YUViewBenchmark
+  YUViewBenchmark.subdir = YUViewBenchmark
+  YUViewBenchmark.depends = YUViewLib
+}
@@ -0,0 +1,31 @@
+QT += core gui widgets opengl xml concurrent network
+
+TARGET = YUViewBenchmark
+TEMPLATE = app
+CONFIG += console c++1z
+CONFIG -= debug_and_release
+CONFIG -= app_bundle
+
+SOURCES += $$files(src/*.cpp, false)
+HEADERS += $$files(src/*.h, false)
+
+# The generated ui headers of the library are needed for the video handlers
+INCLUDEPATH += $$top_srcdir/YUViewLib/src $$top_builddir/YUViewLib
+LIBS += -L$$top_builddir/YUViewLib -lYUViewLib
+
+win32-msvc* {
+    PRE_TARGETDEPS += $$top_builddir/YUViewLib/YUViewLib.lib
+} else {
+    PRE_TARGETDEPS += $$top_builddir/YUViewLib/libYUViewLib.a
+}
+
+win32 {
+    DEFINES += NOMINMAX
+}
+
+SVNN = $$system("git describe --tags")
+isEmpty(SVNN) {
+    SVNN = 0
+}
+VERSTR = '\\"$${SVNN}\\"'
+DEFINES += YUVIEW_VERSION=$${VERSTR}
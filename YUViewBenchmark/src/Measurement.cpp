@@ -0,0 +1,97 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Measurement.h"
+
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+
+namespace benchmark
+{
+
+Measurement::Measurement(const QString &name) : name(name)
+{
+}
+
+void Measurement::addRun(double seconds, unsigned frames, int64_t bytes)
+{
+  this->latencies.push_back(seconds);
+  this->totalFrames += frames;
+  this->totalBytes += bytes;
+  this->totalTime += seconds;
+}
+
+QJsonObject Measurement::toJson() const
+{
+  const auto time = (this->wallTime > 0) ? this->wallTime : this->totalTime;
+
+  QJsonObject json;
+  json["name"]    = this->name;
+  json["runs"]    = int(this->latencies.size());
+  json["frames"]  = double(this->totalFrames);
+  json["bytes"]   = double(this->totalBytes);
+  json["seconds"] = time;
+  if (time > 0)
+  {
+    if (this->totalFrames > 0)
+      json["framesPerSecond"] = double(this->totalFrames) / time;
+    if (this->totalBytes > 0)
+      json["megabytesPerSecond"] = double(this->totalBytes) / time / 1e6;
+  }
+
+  QJsonObject latency;
+  latency["p50"] = this->getPercentile(0.5) * 1000;
+  latency["p99"] = this->getPercentile(0.99) * 1000;
+  if (!this->latencies.empty())
+  {
+    const auto minMax = std::minmax_element(this->latencies.begin(), this->latencies.end());
+    latency["min"]    = *minMax.first * 1000;
+    latency["max"]    = *minMax.second * 1000;
+  }
+  json["latencyMs"] = latency;
+
+  return json;
+}
+
+double Measurement::getPercentile(double percentile) const
+{
+  if (this->latencies.empty())
+    return 0;
+
+  auto sorted = this->latencies;
+  std::sort(sorted.begin(), sorted.end());
+  const auto index = size_t(std::ceil(percentile * double(sorted.size()))) - 1;
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace benchmark
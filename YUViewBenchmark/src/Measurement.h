@@ -0,0 +1,71 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <vector>
+
+namespace benchmark
+{
+
+/* The measurement of one benchmark scenario. Every run of the scenario adds its latency, the
+ * number of frames and the number of bytes that were processed. From this the throughput and the
+ * latency percentiles are calculated.
+ */
+class Measurement
+{
+public:
+  Measurement(const QString &name);
+
+  void addRun(double seconds, unsigned frames, int64_t bytes);
+
+  // For scenarios that run in multiple threads, the throughput must be calculated from the time
+  // that the whole scenario took and not from the sum of the latencies.
+  void setWallTime(double seconds) { this->wallTime = seconds; }
+
+  QString     getName() const { return this->name; }
+  QJsonObject toJson() const;
+
+private:
+  double getPercentile(double percentile) const;
+
+  QString             name;
+  std::vector<double> latencies;
+  uint64_t            totalFrames{};
+  int64_t             totalBytes{};
+  double              totalTime{};
+  double              wallTime{};
+};
+
+} // namespace benchmark
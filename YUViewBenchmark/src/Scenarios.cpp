@@ -0,0 +1,502 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Scenarios.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <QMutex>
+#include <QPainter>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+
+#include <common/Functions.h>
+#include <common/TemporaryFile.h>
+#include <filesource/FileSourceAnnexBFile.h>
+#include <parser/AVC/AnnexBAVC.h>
+#include <parser/HEVC/AnnexBHEVC.h>
+#include <parser/VVC/AnnexBVVC.h>
+#include <playlistitem/playlistItemRawFile.h>
+#include <statistics/StatisticsDataPainting.h>
+#include <statistics/StatisticsFileCSV.h>
+#include <statistics/StatisticsFileVTMBMS.h>
+#include <video/PixelFormatRGB.h>
+#include <video/PixelFormatYUV.h>
+#include <video/videoHandlerRGB.h>
+#include <video/videoHandlerYUV.h>
+
+namespace benchmark
+{
+
+namespace
+{
+
+using namespace video;
+
+// The size of the generated AnnexB file for the start code scanning scenario
+constexpr int64_t ANNEXB_SCAN_FILE_SIZE = 32 * 1024 * 1024;
+// The block size of the generated statistics
+constexpr int STATISTICS_BLOCK_SIZE = 16;
+
+bool isSelected(const Options &options, const QString &scenarioName)
+{
+  return options.filter.isEmpty() || scenarioName.contains(options.filter);
+}
+
+double getElapsedSeconds(const QElapsedTimer &timer)
+{
+  return double(timer.nsecsElapsed()) / 1e9;
+}
+
+void writeRandomData(const std::string &filename, int64_t nrBytes)
+{
+  std::ofstream     file(filename, std::ios::binary);
+  std::mt19937      generator(42);
+  std::vector<char> buffer(1024 * 1024);
+  while (nrBytes > 0)
+  {
+    for (auto &c : buffer)
+      c = char(generator());
+    const auto nrBytesToWrite = std::min(int64_t(buffer.size()), nrBytes);
+    file.write(buffer.data(), nrBytesToWrite);
+    nrBytes -= nrBytesToWrite;
+  }
+}
+
+// Write an AnnexB file with NAL units of random size. The payload contains no zero bytes so that
+// there are no emulated start codes.
+void writeSyntheticAnnexBFile(const std::string &filename, int64_t nrBytes)
+{
+  std::ofstream                   file(filename, std::ios::binary);
+  std::mt19937                    generator(42);
+  std::uniform_int_distribution<> nalSizeDistribution(1024, 64 * 1024);
+  std::vector<char>               nal;
+  while (nrBytes > 0)
+  {
+    nal.resize(size_t(nalSizeDistribution(generator)));
+    nal[0] = 0;
+    nal[1] = 0;
+    nal[2] = 0;
+    nal[3] = 1;
+    for (size_t i = 4; i < nal.size(); i++)
+      nal[i] = char(generator() % 255 + 1);
+    file.write(nal.data(), nal.size());
+    nrBytes -= int64_t(nal.size());
+  }
+}
+
+void writeStatisticsFileCSV(const std::string &filename, const Options &options)
+{
+  const auto    frameSize = options.frameSize;
+  std::ofstream file(filename);
+  file << "%;syntax-version;v1.2\n";
+  file << "%;seq-specs;benchmark;0;" << frameSize.width << ";" << frameSize.height << ";0;\n";
+  file << "%;type;0;PredMode;range;\n";
+  file << "%;defaultRange;0;3;jet\n";
+  file << "%;type;1;MVL0;vector;\n";
+  file << "%;vectorColor;200;0;0;255\n";
+  file << "%;scaleFactor;4\n";
+
+  std::mt19937                    generator(42);
+  std::uniform_int_distribution<> valueDistribution(0, 3);
+  std::uniform_int_distribution<> vectorDistribution(-64, 64);
+  for (unsigned poc = 0; poc < options.nrFrames; poc++)
+  {
+    for (unsigned y = 0; y + STATISTICS_BLOCK_SIZE <= frameSize.height; y += STATISTICS_BLOCK_SIZE)
+      for (unsigned x = 0; x + STATISTICS_BLOCK_SIZE <= frameSize.width; x += STATISTICS_BLOCK_SIZE)
+        file << poc << ";" << x << ";" << y << ";" << STATISTICS_BLOCK_SIZE << ";"
+             << STATISTICS_BLOCK_SIZE << ";0;" << valueDistribution(generator) << "\n";
+    for (unsigned y = 0; y + STATISTICS_BLOCK_SIZE <= frameSize.height; y += STATISTICS_BLOCK_SIZE)
+      for (unsigned x = 0; x + STATISTICS_BLOCK_SIZE <= frameSize.width; x += STATISTICS_BLOCK_SIZE)
+        file << poc << ";" << x << ";" << y << ";" << STATISTICS_BLOCK_SIZE << ";"
+             << STATISTICS_BLOCK_SIZE << ";1;" << vectorDistribution(generator) << ";"
+             << vectorDistribution(generator) << "\n";
+  }
+}
+
+void writeStatisticsFileVTMBMS(const std::string &filename, const Options &options)
+{
+  const auto    frameSize = options.frameSize;
+  std::ofstream file(filename);
+  file << "# VTMBMS Block Statistics\n";
+  file << "# Sequence size: [" << frameSize.width << "x" << frameSize.height << "]\n";
+  file << "# Block Statistic Type: PredMode; Integer; [0, 3]\n";
+  file << "# Block Statistic Type: MVL0; Vector; Scale: 4\n";
+
+  std::mt19937                    generator(42);
+  std::uniform_int_distribution<> valueDistribution(0, 3);
+  std::uniform_int_distribution<> vectorDistribution(-64, 64);
+  for (unsigned poc = 0; poc < options.nrFrames; poc++)
+  {
+    for (unsigned y = 0; y + STATISTICS_BLOCK_SIZE <= frameSize.height; y += STATISTICS_BLOCK_SIZE)
+    {
+      for (unsigned x = 0; x + STATISTICS_BLOCK_SIZE <= frameSize.width; x += STATISTICS_BLOCK_SIZE)
+      {
+        file << "BlockStat: POC " << poc << " @(" << x << "," << y << ") ["
+             << STATISTICS_BLOCK_SIZE << "x" << STATISTICS_BLOCK_SIZE
+             << "] PredMode=" << valueDistribution(generator) << "\n";
+        file << "BlockStat: POC " << poc << " @(" << x << "," << y << ") ["
+             << STATISTICS_BLOCK_SIZE << "x" << STATISTICS_BLOCK_SIZE << "] MVL0={ "
+             << vectorDistribution(generator) << ", " << vectorDistribution(generator) << "}\n";
+      }
+    }
+  }
+}
+
+// Convert every frame of a raw file of the given format. The raw data of all frames is loaded
+// once before the measurement so that only the conversion to an image is timed and not the disk.
+std::optional<Measurement> measureRawFileConversion(const Options &    options,
+                                                    const QString &    scenarioName,
+                                                    const std::string &extension,
+                                                    const std::string &pixelFormatName,
+                                                    int64_t            bytesPerFrame)
+{
+  TemporaryFile rawFile(extension);
+  writeRandomData(rawFile.getFilename(), bytesPerFrame * options.nrFrames);
+
+  playlistItemRawFile item(QString::fromStdString(rawFile.getFilename()),
+                           QSize(int(options.frameSize.width), int(options.frameSize.height)),
+                           QString::fromStdString(pixelFormatName),
+                           QString::fromStdString(extension));
+  auto video = dynamic_cast<videoHandler *>(item.getFrameHandler());
+  if (video == nullptr || !video->isFormatValid())
+  {
+    std::cerr << "Skipping scenario " << scenarioName.toStdString() << ": Invalid format\n";
+    return {};
+  }
+
+  std::vector<QByteArray> rawFrames;
+  for (unsigned frame = 0; frame < options.nrFrames; frame++)
+  {
+    rawFrames.push_back(video->loadRawFrameData(int(frame), true));
+    if (rawFrames.back().size() < bytesPerFrame)
+    {
+      std::cerr << "Skipping scenario " << scenarioName.toStdString() << ": Loading failed\n";
+      return {};
+    }
+  }
+
+  const auto yuvVideo  = dynamic_cast<videoHandlerYUV *>(video);
+  const auto rgbVideo  = dynamic_cast<videoHandlerRGB *>(video);
+  const auto yuvFormat = yuv::PixelFormatYUV(pixelFormatName);
+
+  Measurement measurement(scenarioName);
+  for (unsigned iteration = 0; iteration < options.iterations; iteration++)
+  {
+    for (const auto &rawData : rawFrames)
+    {
+      QElapsedTimer timer;
+      timer.start();
+      const auto image = (yuvVideo != nullptr)
+                             ? yuvVideo->convertRawToImage(rawData, yuvFormat, options.frameSize)
+                             : rgbVideo->convertRawToImage(rawData);
+      measurement.addRun(getElapsedSeconds(timer), 1, bytesPerFrame);
+    }
+  }
+  return measurement;
+}
+
+std::unique_ptr<parser::AnnexB> createAnnexBParser(const QString &filename)
+{
+  const auto suffix = QFileInfo(filename).suffix().toLower();
+  if (suffix == "hevc" || suffix == "h265" || suffix == "265")
+    return std::make_unique<parser::AnnexBHEVC>();
+  if (suffix == "avc" || suffix == "h264" || suffix == "264")
+    return std::make_unique<parser::AnnexBAVC>();
+  if (suffix == "vvc" || suffix == "h266" || suffix == "266")
+    return std::make_unique<parser::AnnexBVVC>();
+  return {};
+}
+
+template <typename StatisticsFile>
+Measurement measureStatisticsLoading(const Options &options,
+                                     const QString &scenarioName,
+                                     const QString &filename)
+{
+  const auto fileSize = QFileInfo(filename).size();
+
+  Measurement measurement(scenarioName);
+  for (unsigned iteration = 0; iteration < options.iterations; iteration++)
+  {
+    QElapsedTimer timer;
+    timer.start();
+
+    stats::StatisticsData statisticsData;
+    StatisticsFile        statisticsFile(filename, statisticsData);
+    std::atomic_bool      breakFunction{false};
+    statisticsFile.readFrameAndTypePositionsFromFile(breakFunction);
+
+    for (auto &type : statisticsData.getStatisticsTypes())
+      type.render = true;
+    for (unsigned frame = 0; frame < options.nrFrames; frame++)
+    {
+      statisticsData.setFrameIndex(int(frame));
+      for (auto typeID : statisticsData.getTypesThatNeedLoading(int(frame)))
+        statisticsFile.loadStatisticData(statisticsData, int(frame), typeID);
+    }
+
+    measurement.addRun(getElapsedSeconds(timer), options.nrFrames, fileSize);
+  }
+  return measurement;
+}
+
+Measurement measureStatisticsPainting(const Options &options,
+                                      const QString &scenarioName,
+                                      const QString &filename)
+{
+  stats::StatisticsData    statisticsData;
+  stats::StatisticsFileCSV statisticsFile(filename, statisticsData);
+  std::atomic_bool         breakFunction{false};
+  statisticsFile.readFrameAndTypePositionsFromFile(breakFunction);
+  for (auto &type : statisticsData.getStatisticsTypes())
+    type.render = true;
+
+  const auto frameSize = options.frameSize;
+  QImage     image(
+      int(frameSize.width), int(frameSize.height), QImage::Format_ARGB32_Premultiplied);
+
+  Measurement measurement(scenarioName);
+  for (unsigned iteration = 0; iteration < options.iterations; iteration++)
+  {
+    for (unsigned frame = 0; frame < options.nrFrames; frame++)
+    {
+      statisticsData.setFrameIndex(int(frame));
+      for (auto typeID : statisticsData.getTypesThatNeedLoading(int(frame)))
+        statisticsFile.loadStatisticData(statisticsData, int(frame), typeID);
+
+      image.fill(Qt::white);
+
+      QElapsedTimer timer;
+      timer.start();
+      {
+        // The statistics are drawn centered around the origin of the painter
+        QPainter painter(&image);
+        painter.translate(image.width() / 2, image.height() / 2);
+        stats::paintStatisticsData(&painter, statisticsData, int(frame), 1.0);
+      }
+      measurement.addRun(getElapsedSeconds(timer), 1, 0);
+    }
+  }
+  return measurement;
+}
+
+} // namespace
+
+std::vector<Measurement> runConversionScenarios(const Options &options)
+{
+  std::vector<Measurement> measurements;
+
+  std::vector<yuv::PixelFormatYUV> yuvFormats;
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_420, 8);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_420, 10);
+  yuvFormats.emplace_back(
+      yuv::Subsampling::YUV_420, 8, yuv::PlaneOrder::YUV, false, Offset(), true);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_422, 8);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_444, 8);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_444, 16);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_400, 8);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_422, 8, yuv::PackingOrder::UYVY);
+  yuvFormats.emplace_back(yuv::Subsampling::YUV_422, 8, yuv::PackingOrder::YUYV);
+  yuvFormats.emplace_back(yuv::PredefinedPixelFormat::V210);
+
+  for (auto &format : yuvFormats)
+  {
+    format.setDefaultChromaOffset();
+    const auto scenarioName = "conversion/yuv/" + QString::fromStdString(format.getName());
+    if (!isSelected(options, scenarioName))
+      continue;
+    if (auto measurement = measureRawFileConversion(options,
+                                                    scenarioName,
+                                                    "yuv",
+                                                    format.getName(),
+                                                    format.bytesPerFrame(options.frameSize)))
+      measurements.push_back(*measurement);
+  }
+
+  const std::vector<rgb::PixelFormatRGB> rgbFormats = {
+      rgb::PixelFormatRGB(8, DataLayout::Packed, rgb::ChannelOrder::RGB),
+      rgb::PixelFormatRGB(8, DataLayout::Packed, rgb::ChannelOrder::BGR),
+      rgb::PixelFormatRGB(8, DataLayout::Packed, rgb::ChannelOrder::RGB, rgb::AlphaMode::Last),
+      rgb::PixelFormatRGB(8, DataLayout::Planar, rgb::ChannelOrder::RGB),
+      rgb::PixelFormatRGB(10, DataLayout::Packed, rgb::ChannelOrder::RGB),
+      rgb::PixelFormatRGB(16, DataLayout::Planar, rgb::ChannelOrder::GBR)};
+
+  for (const auto &format : rgbFormats)
+  {
+    const auto scenarioName = "conversion/rgb/" + QString::fromStdString(format.getName());
+    if (!isSelected(options, scenarioName))
+      continue;
+    if (auto measurement = measureRawFileConversion(options,
+                                                    scenarioName,
+                                                    "rgb",
+                                                    format.getName(),
+                                                    format.bytesPerFrame(options.frameSize)))
+      measurements.push_back(*measurement);
+  }
+
+  return measurements;
+}
+
+std::vector<Measurement> runCachingScenarios(const Options &options)
+{
+  auto nrThreads = options.nrThreads;
+  if (nrThreads == 0)
+    nrThreads = std::max(functions::getCachingThreadCount(), 1u);
+
+  const auto scenarioName = QString("caching/raw/%1-threads").arg(nrThreads);
+  if (!isSelected(options, scenarioName))
+    return {};
+
+  const auto format        = yuv::PixelFormatYUV(yuv::Subsampling::YUV_420, 8);
+  const auto bytesPerFrame = format.bytesPerFrame(options.frameSize);
+
+  TemporaryFile rawFile("yuv");
+  writeRandomData(rawFile.getFilename(), bytesPerFrame * options.nrFrames);
+  playlistItemRawFile item(QString::fromStdString(rawFile.getFilename()),
+                           QSize(int(options.frameSize.width), int(options.frameSize.height)),
+                           QString::fromStdString(format.getName()));
+
+  // Like the VideoCache, every thread loads and converts different frames of the same item
+  std::vector<int> framesToCache;
+  for (unsigned iteration = 0; iteration < options.iterations; iteration++)
+    for (unsigned frame = 0; frame < options.nrFrames; frame++)
+      framesToCache.push_back(int(frame));
+
+  QThreadPool::globalInstance()->setMaxThreadCount(int(nrThreads));
+
+  Measurement   measurement(scenarioName);
+  QMutex        measurementMutex;
+  QElapsedTimer wallTimer;
+  wallTimer.start();
+  QtConcurrent::blockingMap(framesToCache, [&](int frame) {
+    QElapsedTimer timer;
+    timer.start();
+    item.cacheFrame(frame, true);
+    const auto seconds = getElapsedSeconds(timer);
+
+    QMutexLocker locker(&measurementMutex);
+    measurement.addRun(seconds, 1, bytesPerFrame);
+  });
+  measurement.setWallTime(getElapsedSeconds(wallTimer));
+
+  return {measurement};
+}
+
+std::vector<Measurement> runAnnexBScenarios(const Options &options)
+{
+  std::vector<Measurement> measurements;
+
+  const QString scanScenarioName = "parsing/annexb-scan";
+  if (isSelected(options, scanScenarioName))
+  {
+    TemporaryFile annexBFile("hevc");
+    writeSyntheticAnnexBFile(annexBFile.getFilename(), ANNEXB_SCAN_FILE_SIZE);
+    const auto filename = QString::fromStdString(annexBFile.getFilename());
+    const auto fileSize = QFileInfo(filename).size();
+
+    Measurement measurement(scanScenarioName);
+    for (unsigned iteration = 0; iteration < options.iterations; iteration++)
+    {
+      QElapsedTimer timer;
+      timer.start();
+      FileSourceAnnexBFile file(filename);
+      while (!file.atEnd())
+        file.getNextNALUnit();
+      measurement.addRun(getElapsedSeconds(timer), 0, fileSize);
+    }
+    measurements.push_back(measurement);
+  }
+
+  for (const auto &filename : options.annexBFiles)
+  {
+    const auto scenarioName = "parsing/annexb/" + QFileInfo(filename).fileName();
+    if (!isSelected(options, scenarioName))
+      continue;
+    if (!createAnnexBParser(filename))
+    {
+      std::cerr << "Skipping scenario " << scenarioName.toStdString()
+                << ": Unknown file extension\n";
+      continue;
+    }
+
+    const auto  fileSize = QFileInfo(filename).size();
+    Measurement measurement(scenarioName);
+    for (unsigned iteration = 0; iteration < options.iterations; iteration++)
+    {
+      auto          parser = createAnnexBParser(filename);
+      QElapsedTimer timer;
+      timer.start();
+      parser->runParsingOfFile(filename);
+      measurement.addRun(
+          getElapsedSeconds(timer), unsigned(parser->getNumberPOCs()), fileSize);
+    }
+    measurements.push_back(measurement);
+  }
+
+  return measurements;
+}
+
+std::vector<Measurement> runStatisticsScenarios(const Options &options)
+{
+  std::vector<Measurement> measurements;
+
+  TemporaryFile csvFile("csv");
+  writeStatisticsFileCSV(csvFile.getFilename(), options);
+  const auto csvFilename = QString::fromStdString(csvFile.getFilename());
+
+  if (isSelected(options, "statistics/load-csv"))
+    measurements.push_back(measureStatisticsLoading<stats::StatisticsFileCSV>(
+        options, "statistics/load-csv", csvFilename));
+
+  if (isSelected(options, "statistics/load-vtmbms"))
+  {
+    TemporaryFile vtmbmsFile("vtmbmsstats");
+    writeStatisticsFileVTMBMS(vtmbmsFile.getFilename(), options);
+    measurements.push_back(measureStatisticsLoading<stats::StatisticsFileVTMBMS>(
+        options, "statistics/load-vtmbms", QString::fromStdString(vtmbmsFile.getFilename())));
+  }
+
+  if (isSelected(options, "statistics/paint"))
+    measurements.push_back(
+        measureStatisticsPainting(options, "statistics/paint", csvFilename));
+
+  return measurements;
+}
+
+} // namespace benchmark
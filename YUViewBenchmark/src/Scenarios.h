@@ -0,0 +1,63 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Measurement.h"
+
+#include <QStringList>
+#include <common/Typedef.h>
+
+#include <vector>
+
+namespace benchmark
+{
+
+struct Options
+{
+  Size        frameSize{1920, 1080};
+  unsigned    nrFrames{8};
+  unsigned    iterations{10};
+  unsigned    nrThreads{0}; // 0: Use the caching thread count from the settings
+  QStringList annexBFiles;
+  QString     filter;
+};
+
+// Each function runs a group of scenarios and returns one measurement per scenario. Scenarios whose
+// name does not contain Options::filter are skipped. All input data (except for the optional AnnexB
+// files) is generated into temporary files.
+std::vector<Measurement> runConversionScenarios(const Options &options);
+std::vector<Measurement> runCachingScenarios(const Options &options);
+std::vector<Measurement> runAnnexBScenarios(const Options &options);
+std::vector<Measurement> runStatisticsScenarios(const Options &options);
+
+} // namespace benchmark
@@ -0,0 +1,140 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <iostream>
+
+#include <common/Typedef.h>
+
+#include "Scenarios.h"
+
+/* A headless benchmark of the performance critical parts of YUView. All scenarios are run without
+ * a display and the results are written as JSON so that they can be compared between builds.
+ */
+int main(int argc, char *argv[])
+{
+  // Nothing is shown, so no display is needed
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  qRegisterMetaType<recacheIndicator>("recacheIndicator");
+
+  QApplication app(argc, argv);
+  // Use the same settings (e.g. the number of caching threads) as YUView
+  QApplication::setApplicationName("YUView");
+  QApplication::setOrganizationName("Institut für Nachrichtentechnik, RWTH Aachen University");
+  QApplication::setOrganizationDomain("ient.rwth-aachen.de");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Run the YUView benchmark scenarios and print the results as "
+                                   "JSON.");
+  parser.addHelpOption();
+  QCommandLineOption frameSizeOption("frame-size", "The frame size (WxH).", "size", "1920x1080");
+  QCommandLineOption framesOption("frames", "The number of frames per scenario.", "n", "8");
+  QCommandLineOption iterationsOption(
+      "iterations", "How often each scenario is repeated.", "n", "10");
+  QCommandLineOption threadsOption(
+      "threads", "The number of caching threads (0: from the settings).", "n", "0");
+  QCommandLineOption annexBOption(
+      "annexb", "An AnnexB file (hevc, avc or vvc) to parse. Can be given multiple times.", "file");
+  QCommandLineOption filterOption(
+      "filter", "Only run the scenarios whose name contains this text.", "text");
+  QCommandLineOption outputOption(
+      "output", "Write the JSON to this file instead of the standard output.", "file");
+  parser.addOptions({frameSizeOption,
+                     framesOption,
+                     iterationsOption,
+                     threadsOption,
+                     annexBOption,
+                     filterOption,
+                     outputOption});
+  parser.process(app);
+
+  benchmark::Options options;
+  const auto         frameSize = parser.value(frameSizeOption).split('x');
+  if (frameSize.size() != 2 || frameSize[0].toInt() <= 0 || frameSize[1].toInt() <= 0)
+  {
+    std::cerr << "Invalid frame size " << parser.value(frameSizeOption).toStdString() << "\n";
+    return 1;
+  }
+  options.frameSize   = Size(frameSize[0].toInt(), frameSize[1].toInt());
+  options.nrFrames    = std::max(parser.value(framesOption).toUInt(), 1u);
+  options.iterations  = std::max(parser.value(iterationsOption).toUInt(), 1u);
+  options.nrThreads   = parser.value(threadsOption).toUInt();
+  options.annexBFiles = parser.values(annexBOption);
+  options.filter      = parser.value(filterOption);
+
+  QJsonArray scenarios;
+  for (auto runScenarios : {benchmark::runConversionScenarios,
+                            benchmark::runCachingScenarios,
+                            benchmark::runAnnexBScenarios,
+                            benchmark::runStatisticsScenarios})
+  {
+    for (const auto &measurement : runScenarios(options))
+    {
+      std::cerr << "Finished scenario " << measurement.getName().toStdString() << "\n";
+      scenarios.append(measurement.toJson());
+    }
+  }
+
+  QJsonObject result;
+  result["version"]          = QString(YUVIEW_VERSION);
+  result["qtVersion"]        = QString(qVersion());
+  result["idealThreadCount"] = QThread::idealThreadCount();
+  result["frameSize"] =
+      QString("%1x%2").arg(options.frameSize.width).arg(options.frameSize.height);
+  result["frames"]     = int(options.nrFrames);
+  result["iterations"] = int(options.iterations);
+  result["scenarios"]  = scenarios;
+
+  const auto json = QJsonDocument(result).toJson();
+  if (parser.isSet(outputOption))
+  {
+    QFile outputFile(parser.value(outputOption));
+    if (!outputFile.open(QIODevice::WriteOnly))
+    {
+      std::cerr << "Error opening output file " << outputFile.fileName().toStdString() << "\n";
+      return 1;
+    }
+    outputFile.write(json);
+  }
+  else
+    std::cout << json.toStdString();
+
+  return 0;
+}
@@ -43,6 +43,7 @@
 
 #include <algorithm>
 
+#include <QSettings>
 #include <QThread>
 
 namespace functions
@@ -57,6 +58,21 @@ unsigned int getOptimalThreadCount()
     return 1;
 }
 
+unsigned int getCachingThreadCount()
+{
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  if (!settings.value("Enabled", true).toBool())
+    return 0;
+
+  int nrThreads = int(getOptimalThreadCount());
+  if (settings.value("SetNrThreads", false).toBool())
+    nrThreads = settings.value("NrThreads", nrThreads).toInt();
+  if (nrThreads <= 0)
+    nrThreads = 1;
+  return (unsigned int)nrThreads;
+}
+
 unsigned int systemMemorySizeInMB()
 {
   static unsigned int memorySizeInMB;
@@ -43,6 +43,10 @@ namespace functions
 // so that one thread is "reserved" for the main GUI. I don't know if this is optimal.
 unsigned int getOptimalThreadCount();
 
+// Get the number of background caching threads as configured in the settings. If caching is
+// disabled, 0 is returned.
+unsigned int getCachingThreadCount();
+
 // Returns the size of system memory in megabytes.
 // This function is thread safe and inexpensive to call.
 unsigned int systemMemorySizeInMB();
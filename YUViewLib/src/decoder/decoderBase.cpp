@@ -32,8 +32,13 @@
 
 #include "decoderBase.h"
 
+#include <algorithm>
+
+#include <common/Functions.h>
+
 #include <QDir>
 #include <QSettings>
+#include <QThread>
 
 namespace decoder
 {
@@ -97,6 +102,47 @@ stats::FrameTypeData decoderBase::getCurrentFrameStatsForType(int typeId) const
   return statisticsData->getFrameTypeData(typeId);
 }
 
+ThreadingSettings decoderBase::getThreadingSettings(DecoderEngine engine) const
+{
+  const auto engineName = QString::fromStdString(DecoderEngineMapper.getName(engine));
+  const auto usage      = this->isCachingDecoder ? QString("Caching") : QString("Interactive");
+
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  auto nrThreads = settings.value("Threading/" + engineName + "/" + usage, 0).toInt();
+  auto modeName  = settings.value("Threading/" + engineName + "/Mode", "Auto").toString();
+  settings.endGroup();
+
+  ThreadingSettings threading;
+
+  if (nrThreads > 0)
+    threading.nrThreads = unsigned(nrThreads);
+  else if (this->isCachingDecoder)
+  {
+    // All caching workers decode in parallel. Share the cores between them so that we do not
+    // end up with many more busy threads than there are cores.
+    auto nrCachingThreads = std::max(functions::getCachingThreadCount(), 1u);
+    auto nrCores          = unsigned(std::max(QThread::idealThreadCount(), 1));
+    threading.nrThreads   = std::max(nrCores / nrCachingThreads, 1u);
+  }
+  else
+    threading.nrThreads = functions::getOptimalThreadCount();
+
+  auto mode = ThreadingModeMapper.getValue(modeName.toStdString());
+  if (mode && *mode != ThreadingMode::Auto)
+    threading.mode = *mode;
+  else
+    // The interactive decoder must return a frame as fast as possible. The caching decoder only
+    // cares about throughput.
+    threading.mode = this->isCachingDecoder ? ThreadingMode::Frame : ThreadingMode::Slice;
+
+  DEBUG_DECODERBASE("decoderBase::getThreadingSettings %s %d threads mode %d",
+                    engineName.toStdString().c_str(),
+                    threading.nrThreads,
+                    int(threading.mode));
+  return threading;
+}
+
 void decoderBaseSingleLib::loadDecoderLibrary(QString specificLibrary)
 {
   // Try to load the HM library from the current working directory
@@ -77,6 +77,26 @@ const auto DecodersHEVC =
 const auto DecodersVVC = std::vector<DecoderEngine>({DecoderEngine::VVDec, DecoderEngine::VTM});
 const auto DecodersAV1 = std::vector<DecoderEngine>({DecoderEngine::FFMpeg, DecoderEngine::Dav1d});
 
+// How the decoders should distribute work over their threads. Frame threading gives the highest
+// throughput but adds a delay of several frames. Slice threading (slices, tiles or wavefronts)
+// keeps the latency low which is preferable for interactive seeking.
+enum class ThreadingMode
+{
+  Auto,
+  Frame,
+  Slice
+};
+
+const auto ThreadingModeMapper = EnumMapper<ThreadingMode>({{ThreadingMode::Auto, "Auto"},
+                                                            {ThreadingMode::Frame, "Frame"},
+                                                            {ThreadingMode::Slice, "Slice"}});
+
+struct ThreadingSettings
+{
+  unsigned      nrThreads{1};
+  ThreadingMode mode{ThreadingMode::Slice};
+};
+
 /* This class is the abstract base class for all decoders. All decoders work like this:
  * 1. Create an instance and configure it (if required)
  * 2. Push data to the decoder until it returns that it can not take any more data.
@@ -144,6 +164,12 @@ public:
   virtual QString getCodecName() const   = 0;
 
 protected:
+  // Get the number of threads and the threading mode for the given decoder engine from the
+  // settings. Values set to "Auto" are resolved here (ThreadingSettings::mode is never Auto). The
+  // automatic thread count of a caching decoder takes into account that one caching decoder runs
+  // in each of the VideoCache worker threads.
+  ThreadingSettings getThreadingSettings(DecoderEngine engine) const;
+
   DecoderState decoderState{DecoderState::NeedsMoreData};
 
   int  decodeSignal{0};  ///< Which signal should be decoded?
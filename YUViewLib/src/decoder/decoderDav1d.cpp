@@ -40,6 +40,7 @@
 
 #include <common/Functions.h>
 #include <common/Typedef.h>
+#include <video/FrameBufferPool.h>
 
 namespace decoder
 {
@@ -196,6 +197,13 @@ void decoderDav1d::resolveLibraryFunctionPointers()
 
   if (!resolve(this->lib.dav1d_data_create, "dav1d_data_create"))
     return;
+  // Without these, the data is copied into a buffer created by dav1d
+  if (!resolve(this->lib.dav1d_data_wrap, "dav1d_data_wrap", true) ||
+      !resolve(this->lib.dav1d_data_unref, "dav1d_data_unref", true))
+  {
+    this->lib.dav1d_data_wrap  = nullptr;
+    this->lib.dav1d_data_unref = nullptr;
+  }
 
   DEBUG_DAV1D("decoderDav1d::resolveLibraryFunctionPointers - decoding functions found");
 
@@ -239,6 +247,18 @@ void decoderDav1d::allocateNewDecoder()
 
   this->lib.dav1d_default_settings(&settings);
 
+  auto threading = this->getThreadingSettings(DecoderEngine::Dav1d);
+  if (threading.mode == ThreadingMode::Frame)
+  {
+    this->settings.n_frame_threads = int(threading.nrThreads);
+    this->settings.n_tile_threads  = 1;
+  }
+  else
+  {
+    this->settings.n_frame_threads = 1;
+    this->settings.n_tile_threads  = int(threading.nrThreads);
+  }
+
   // Create new decoder object
   int err = this->lib.dav1d_open(&decoder, &settings);
   if (err != 0)
@@ -276,7 +296,7 @@ void decoderDav1d::allocateNewDecoder()
 
   // The decoder is ready to receive data
   decoderBase::resetDecoder();
-  currentOutputBuffer.clear();
+  video::FrameBufferPool::instance().recycle(currentOutputBuffer);
   decodedFrameWaiting = false;
   flushing            = false;
 }
@@ -338,7 +358,7 @@ bool decoderDav1d::decodeFrame()
     DEBUG_DAV1D("decoderDav1d::decodeFrame Picture decoded - switching to retrieve frame mode");
 
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(currentOutputBuffer);
     return true;
   }
   else if (res != -EAGAIN)
@@ -439,23 +459,47 @@ bool decoderDav1d::pushData(QByteArray &data)
   }
   else
   {
-    // Since dav1d consumes the data (takes ownership), we need to copy it to a new buffer from
-    // dav1d
-    Dav1dData *dav1dData      = new Dav1dData;
-    uint8_t *  rawDataPointer = this->lib.dav1d_data_create(dav1dData, data.size());
-    memcpy(rawDataPointer, data.data(), data.size());
+    // dav1d takes a reference to the data and may keep it beyond this call (e.g. with frame
+    // threading). The QByteArray is implicitly shared so we hand a reference to it to dav1d and
+    // release it in the callback. No copy of the data is made.
+    Dav1dData dav1dData{};
+    if (this->lib.dav1d_data_wrap)
+    {
+      auto dataReference = new QByteArray(data);
+      auto releaseData   = [](const uint8_t *, void *cookie) {
+        delete static_cast<QByteArray *>(cookie);
+      };
+      if (this->lib.dav1d_data_wrap(&dav1dData,
+                                    (const uint8_t *)dataReference->constData(),
+                                    size_t(dataReference->size()),
+                                    releaseData,
+                                    dataReference) != 0)
+      {
+        delete dataReference;
+        return setErrorB("Error wrapping data for the decoder (dav1d_data_wrap).");
+      }
+    }
+    else
+    {
+      auto rawDataPointer = this->lib.dav1d_data_create(&dav1dData, data.size());
+      if (rawDataPointer == nullptr)
+        return setErrorB("Error allocating data for the decoder (dav1d_data_create).");
+      memcpy(rawDataPointer, data.constData(), data.size());
+    }
 
-    int err = this->lib.dav1d_send_data(decoder, dav1dData);
+    int err = this->lib.dav1d_send_data(decoder, &dav1dData);
     if (err == -EAGAIN)
     {
       // The data was not consumed and must be pushed again after retrieving some frames
-      delete dav1dData;
+      if (this->lib.dav1d_data_unref)
+        this->lib.dav1d_data_unref(&dav1dData);
       DEBUG_DAV1D("decoderDav1d::pushData need to re-push data");
       return false;
     }
     else if (err != 0)
     {
-      delete dav1dData;
+      if (this->lib.dav1d_data_unref)
+        this->lib.dav1d_data_unref(&dav1dData);
       DEBUG_DAV1D("decoderDav1d::pushData error pushing data");
       return setErrorB("Error pushing data to the decoder.");
     }
@@ -493,8 +537,8 @@ void decoderDav1d::copyImgToByteArray(const Dav1dPictureWrapper &src, QByteArray
   DEBUG_DAV1D("decoderDav1d::copyImgToByteArray nrBytes %d", nrBytes);
 
   // Is the output big enough?
-  if (dst.capacity() < int(nrBytes))
-    dst.resize(int(nrBytes));
+  if (dst.size() != int(nrBytes))
+    dst = video::FrameBufferPool::instance().getByteArray(int(nrBytes));
 
   uint8_t *dst_c = (uint8_t *)dst.data();
 
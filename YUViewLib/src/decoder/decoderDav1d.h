@@ -56,6 +56,12 @@ struct LibraryFunctionsDav1d
   void (*dav1d_flush)(Dav1dContext *){};
 
   uint8_t *(*dav1d_data_create)(Dav1dData *data, size_t sz){};
+  int (*dav1d_data_wrap)(Dav1dData *data,
+                         const uint8_t *buf,
+                         size_t         sz,
+                         void (*free_callback)(const uint8_t *buf, void *cookie),
+                         void *cookie){};
+  void (*dav1d_data_unref)(Dav1dData *data){};
 
   // The interface for the analizer. These might not be available in the library.
   void (*dav1d_default_analyzer_settings)(Dav1dAnalyzerFlags *s){};
@@ -33,6 +33,7 @@
 #include "decoderFFmpeg.h"
 
 #include <common/Functions.h>
+#include <video/FrameBufferPool.h>
 
 #define DECODERFFMPEG_DEBUG_OUTPUT 0
 #if DECODERFFMPEG_DEBUG_OUTPUT && !NDEBUG
@@ -192,8 +193,8 @@ void decoderFFmpeg::copyCurImageToBuffer()
     const auto nrBytes = nrBytesY + 2 * nrBytesC;
 
     // Is the output big enough?
-    if (auto c = functions::clipToUnsigned(this->currentOutputBuffer.capacity()); c < nrBytes)
-      this->currentOutputBuffer.resize(nrBytes);
+    if (functions::clipToUnsigned(this->currentOutputBuffer.size()) != nrBytes)
+      this->currentOutputBuffer = video::FrameBufferPool::instance().getByteArray(int(nrBytes));
 
     // Copy line by line. The linesize of the source may be larger than the width of the frame.
     // This may be because the frame buffer is (8) byte aligned. Also the internal decoded
@@ -227,8 +228,8 @@ void decoderFFmpeg::copyCurImageToBuffer()
     const auto nrBytes = nrBytesPerComponent * pixFmt.nrChannels();
 
     // Is the output big enough?
-    if (auto c = functions::clipToUnsigned(this->currentOutputBuffer.capacity()); c < nrBytes)
-      this->currentOutputBuffer.resize(nrBytes);
+    if (functions::clipToUnsigned(this->currentOutputBuffer.size()) != nrBytes)
+      this->currentOutputBuffer = video::FrameBufferPool::instance().getByteArray(int(nrBytes));
 
     auto       dst  = this->currentOutputBuffer.data();
     const auto hDst = this->frameSize.height;
@@ -398,7 +399,7 @@ bool decoderFFmpeg::decodeFrame()
     // Checkt the size of the retrieved image
     if (this->frameSize != this->frame.getSize())
       return this->setErrorB("Received a frame of different size");
-    this->currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
     return true;
   }
   else if (retRecieve < 0 && retRecieve != AVERROR(EAGAIN) && retRecieve != -35)
@@ -473,6 +474,16 @@ bool decoderFFmpeg::createDecoder(FFmpeg::AVCodecIDWrapper         codecID,
     return this->setErrorB(
         QStringLiteral("Could not request motion vector retrieval. Return code %1").arg(ret));
 
+  auto threading = this->getThreadingSettings(DecoderEngine::FFMpeg);
+  ret            = this->ff.dictSet(
+      opts, "threads", QString::number(threading.nrThreads).toStdString().c_str(), 0);
+  if (ret >= 0)
+    ret = this->ff.dictSet(
+        opts, "thread_type", threading.mode == ThreadingMode::Frame ? "frame" : "slice", 0);
+  if (ret < 0)
+    return this->setErrorB(
+        QStringLiteral("Could not set the decoder threading options. Return code %1").arg(ret));
+
   // Open codec
   ret = this->ff.avcodecOpen2(decCtx, videoCodec, opts);
   if (ret < 0)
@@ -39,6 +39,7 @@
 
 #include <common/Functions.h>
 #include <common/Typedef.h>
+#include <video/FrameBufferPool.h>
 
 namespace decoder
 {
@@ -339,7 +340,7 @@ bool decoderHM::pushData(QByteArray &data)
   {
     decodedFrameWaiting = true;
     decoderState        = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(currentOutputBuffer);
   }
 
   // If bNewPicture is true, the decoder noticed that a new picture starts with this
@@ -405,8 +406,8 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
   DEBUG_DECHM("decoderHM::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
 
   // Is the output big enough?
-  if (dst.capacity() < nrBytesOutput)
-    dst.resize(nrBytesOutput);
+  if (dst.size() != nrBytesOutput)
+    dst = video::FrameBufferPool::instance().getByteArray(nrBytesOutput);
 
   // The source (from HM) is always short (16bit). The destination is a QByteArray so
   // we have to cast it right.
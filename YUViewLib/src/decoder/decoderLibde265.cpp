@@ -39,6 +39,7 @@
 
 #include <common/Functions.h>
 #include <common/Typedef.h>
+#include <video/FrameBufferPool.h>
 
 namespace decoder
 {
@@ -294,15 +295,16 @@ void decoderLibde265::allocateNewDecoder()
   // The highest temporal ID to decode. Set this to very high (all) by default.
   this->lib.de265_set_limit_TID(this->decoder, 100);
 
-  // Set the number of decoder threads. Libde265 can use wavefronts to utilize these.
-  // TODO: We should add a setting for this maybe?
-  auto err = this->lib.de265_start_worker_threads(this->decoder, 8);
+  // Set the number of decoder threads. Libde265 can use wavefronts and tiles to utilize these. It
+  // does not support frame threading so the threading mode is not used.
+  auto threading = this->getThreadingSettings(DecoderEngine::Libde265);
+  auto err = this->lib.de265_start_worker_threads(this->decoder, int(threading.nrThreads));
   if (err != DE265_OK)
     return setError("Error starting libde265 worker threads (de265_start_worker_threads)");
 
   // The decoder is ready to receive data
   decoderBase::resetDecoder();
-  this->currentOutputBuffer.clear();
+  video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
   this->decodedFrameWaiting = false;
   this->flushing            = false;
 }
@@ -383,7 +385,7 @@ bool decoderLibde265::decodeFrame()
     DEBUG_LIBDE265("decoderLibde265::decodeFrame Picture decoded");
 
     this->decoderState = DecoderState::RetrieveFrames;
-    this->currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
     return true;
   }
   return false;
@@ -489,8 +491,8 @@ void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst
   DEBUG_LIBDE265("decoderLibde265::copyImgToByteArray nrBytes %d", nrBytes);
 
   // Is the output big enough?
-  if (dst.capacity() < nrBytes)
-    dst.resize(nrBytes);
+  if (dst.size() != nrBytes)
+    dst = video::FrameBufferPool::instance().getByteArray(nrBytes);
 
   uint8_t *dst_c = (uint8_t *)dst.data();
 
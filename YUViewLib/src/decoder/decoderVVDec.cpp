@@ -33,6 +33,7 @@
 #include "decoderVVDec.h"
 
 #include <common/Typedef.h>
+#include <video/FrameBufferPool.h>
 
 #include <QCoreApplication>
 #include <QDir>
@@ -87,8 +88,6 @@ using Subsampling = video::yuv::Subsampling;
 namespace
 {
 
-const auto MAX_CODED_PICTURE_SIZE = 800000;
-
 void loggingCallback(void *ptr, int level, const char *msg, va_list list)
 {
   (void)ptr;
@@ -270,6 +269,10 @@ void decoderVVDec::allocateNewDecoder()
 
   params.logLevel = VVDEC_INFO;
 
+  // VVdeC decides internally how to distribute the work. We can only limit the number of threads.
+  auto threading = this->getThreadingSettings(DecoderEngine::VVDec);
+  params.threads = int(threading.nrThreads);
+
   this->decoder = this->lib.vvdec_decoder_open(&params);
   if (this->decoder == nullptr)
   {
@@ -278,7 +281,7 @@ void decoderVVDec::allocateNewDecoder()
   }
 
   this->flushing = false;
-  this->currentOutputBuffer.clear();
+  video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
   this->decoderState                  = DecoderState::NeedsMoreData;
   this->currentFrameReadyForRetrieval = false;
   this->currentFrame                  = nullptr;
@@ -289,15 +292,10 @@ void decoderVVDec::allocateNewDecoder()
 
   if (this->accessUnit == nullptr)
   {
+    // No payload is allocated. The payload pointer is set to the pushed data in pushData.
     this->accessUnit = this->lib.vvdec_accessUnit_alloc();
     if (this->accessUnit == nullptr)
-    {
       this->setError("Error allocating access unit");
-      return;
-    }
-    this->lib.vvdec_accessUnit_alloc_payload(this->accessUnit, MAX_CODED_PICTURE_SIZE);
-    if (this->accessUnit->payload == nullptr)
-      this->setError("Error allocating AU payload buffer");
   }
 }
 
@@ -331,7 +329,7 @@ bool decoderVVDec::decodeNextFrame()
       return false;
     }
 
-    this->currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
     DEBUG_vvdec("decoderVVDec::decodeNextFrame Flushing - Invalidate buffer");
   }
   else
@@ -426,18 +424,23 @@ bool decoderVVDec::pushData(QByteArray &data)
     DEBUG_vvdec("decoderVVDec::pushData: Setting flushing mode");
     this->flushing     = true;
     this->decoderState = DecoderState::RetrieveFrames;
-    this->currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
     return true;
   }
   else
   {
-    if (data.size() > this->accessUnit->payloadSize)
-      return setErrorB("Access unit too big to push");
-
-    std::memcpy(this->accessUnit->payload, data.constData(), data.size());
+    // vvdec_decode parses the access unit before it returns and does not keep a reference to the
+    // payload. So instead of copying the data, we let the access unit point to it for the duration
+    // of the call. The payload pointer is reset afterwards so that vvdec never frees our data.
+    this->accessUnit->payload         = (unsigned char *)data.constData();
+    this->accessUnit->payloadSize     = data.size();
     this->accessUnit->payloadUsedSize = data.size();
 
     auto ret = this->lib.vvdec_decode(this->decoder, this->accessUnit, &this->currentFrame);
+
+    this->accessUnit->payload         = nullptr;
+    this->accessUnit->payloadSize     = 0;
+    this->accessUnit->payloadUsedSize = 0;
     if (ret == VVDEC_EOF)
       endOfFile = true;
     else if (ret != VVDEC_TRY_AGAIN && ret != VVDEC_OK)
@@ -458,7 +461,7 @@ bool decoderVVDec::pushData(QByteArray &data)
   if (this->getNextFrameFromDecoder())
   {
     this->decoderState = DecoderState::RetrieveFrames;
-    this->currentOutputBuffer.clear();
+    video::FrameBufferPool::instance().recycle(this->currentOutputBuffer);
   }
 
   return true;
@@ -502,8 +505,8 @@ void decoderVVDec::copyImgToByteArray(QByteArray &dst)
   DEBUG_vvdec("decoderVVDec::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
 
   // Is the output big enough?
-  if (dst.capacity() < int(nrBytesOutput))
-    dst.resize(int(nrBytesOutput));
+  if (dst.size() != int(nrBytesOutput))
+    dst = video::FrameBufferPool::instance().getByteArray(int(nrBytesOutput));
 
   for (unsigned c = 0; c < nrPlanes; c++)
   {
@@ -301,6 +301,12 @@ int AVStreamWrapper::getIndex()
   return this->index;
 }
 
+int64_t AVStreamWrapper::getNbFrames()
+{
+  this->update();
+  return this->nb_frames;
+}
+
 AVCodecParametersWrapper AVStreamWrapper::getCodecpar()
 {
   this->update();
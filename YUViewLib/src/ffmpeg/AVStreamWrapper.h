@@ -60,7 +60,9 @@ public:
   int                      getFrameHeight();
   AVColorSpace             getColorspace();
   int                      getIndex();
+  int64_t                  getNbFrames();
   AVCodecParametersWrapper getCodecpar();
+  AVStream *               getStream() const { return this->stream; }
 
 private:
   void update();
@@ -59,7 +59,6 @@ struct AVFrame;
 struct AVBufferRef;
 struct AVPacketSideData;
 struct AVIOContext;
-struct AVIndexEntry;
 struct AVStreamInternal;
 struct AVFrameSideData;
 struct AVMotionVector;
@@ -148,6 +147,18 @@ struct AVDictionaryEntry
   char *value;
 };
 
+#define AVINDEX_KEYFRAME 0x0001
+#define AVINDEX_DISCARD_FRAME 0x0002 ///< Flag is used to indicate which frame should be discarded
+
+struct AVIndexEntry
+{
+  int64_t pos;
+  int64_t timestamp; ///< Timestamp in AVStream.time_base units (the DTS for most demuxers)
+  int     flags : 2;
+  int     size : 30;
+  int     min_distance; ///< Minimum distance between this and the previous keyframe
+};
+
 enum AVPictureType
 {
   AV_PICTURE_TYPE_NONE = 0, ///< Undefined
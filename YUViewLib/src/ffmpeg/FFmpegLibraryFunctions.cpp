@@ -81,6 +81,14 @@ bool bindLibraryFunctions(QLibrary &                                 lib,
     return false;
   if (!resolveFunction(lib, functions.avformat_version, "avformat_version", log))
     return false;
+
+  // The index functions are optional. Without them, the bitstream has to be scanned.
+  functions.indexAPIAvailable =
+      resolveFunction(lib,
+                      functions.avformat_index_get_entries_count,
+                      "avformat_index_get_entries_count",
+                      nullptr) &&
+      resolveFunction(lib, functions.avformat_index_get_entry, "avformat_index_get_entry", nullptr);
   return true;
 }
 
@@ -67,6 +67,10 @@ public:
     std::function<int(AVFormatContext *s, int stream_index, int64_t timestamp, int flags)>
                               av_seek_frame;
     std::function<unsigned()> avformat_version;
+    // The index of a stream can only be accessed with avformat 58.78 and newer.
+    bool                                                       indexAPIAvailable{};
+    std::function<int(const AVStream *st)>                     avformat_index_get_entries_count;
+    std::function<const AVIndexEntry *(AVStream *st, int idx)> avformat_index_get_entry;
   };
   AvFormatFunctions avformat{};
 
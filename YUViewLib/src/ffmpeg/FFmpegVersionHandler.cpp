@@ -34,6 +34,10 @@
 #include <QDateTime>
 #include <QDir>
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
+
 namespace FFmpeg
 {
 
@@ -106,6 +110,32 @@ auto SupportedLibraryVersionCombinations = {LibraryVersion(57, 59, 59, 4),
                                             LibraryVersion(55, 57, 57, 2),
                                             LibraryVersion(54, 56, 56, 1)};
 
+// Searching for the libraries means trying to load all supported versions in several paths. This
+// is only done once per process (and again if the library settings change). The loaded libraries
+// (or the failure to find them) are shared by all handlers.
+struct LoadedLibraries
+{
+  QString                                 settingsKey;
+  std::shared_ptr<FFmpegLibraryFunctions> functions; // Null if loading failed
+  LibraryVersion                          version;
+  QStringList                             log;
+};
+
+std::mutex                     loadedLibrariesMutex;
+std::optional<LoadedLibraries> loadedLibraries;
+
+QString getLibrarySettingsKey()
+{
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  return QStringList({settings.value("FFmpeg.avformat", "").toString(),
+                      settings.value("FFmpeg.avcodec", "").toString(),
+                      settings.value("FFmpeg.avutil", "").toString(),
+                      settings.value("FFmpeg.swresample", "").toString(),
+                      settings.value("SearchPath", "").toString()})
+      .join("|");
+}
+
 } // namespace
 
 // bool FFmpegVersionHandler::AVCodecContextCopyParameters(AVCodecContext *srcCtx, AVCodecContext
@@ -226,7 +256,7 @@ QString FFmpegVersionHandler::getLibVersionString() const
 
 AVCodecIDWrapper FFmpegVersionHandler::getCodecIDWrapper(AVCodecID id)
 {
-  auto codecName = QString(lib.avcodec.avcodec_get_name(id));
+  auto codecName = QString(lib->avcodec.avcodec_get_name(id));
   return AVCodecIDWrapper(id, codecName);
 }
 
@@ -239,7 +269,7 @@ AVCodecID FFmpegVersionHandler::getCodecIDFromWrapper(AVCodecIDWrapper &wrapper)
   QString codecName;
   do
   {
-    auto codecName = QString(this->lib.avcodec.avcodec_get_name(AVCodecID(codecID)));
+    auto codecName = QString(this->lib->avcodec.avcodec_get_name(AVCodecID(codecID)));
     if (codecName == wrapper.getCodecName())
     {
       wrapper.setCodecID(AVCodecID(codecID));
@@ -254,13 +284,13 @@ AVCodecID FFmpegVersionHandler::getCodecIDFromWrapper(AVCodecIDWrapper &wrapper)
 bool FFmpegVersionHandler::configureDecoder(AVCodecContextWrapper &   decCtx,
                                             AVCodecParametersWrapper &codecpar)
 {
-  if (this->lib.avcodec.newParametersAPIAvailable)
+  if (this->lib->avcodec.newParametersAPIAvailable)
   {
     // Use the new avcodec_parameters_to_context function.
     auto origin_par = codecpar.getCodecParameters();
     if (!origin_par)
       return false;
-    auto ret = this->lib.avcodec.avcodec_parameters_to_context(decCtx.getCodec(), origin_par);
+    auto ret = this->lib->avcodec.avcodec_parameters_to_context(decCtx.getCodec(), origin_par);
     if (ret < 0)
     {
       this->log(
@@ -287,19 +317,19 @@ bool FFmpegVersionHandler::configureDecoder(AVCodecContextWrapper &   decCtx,
 int FFmpegVersionHandler::pushPacketToDecoder(AVCodecContextWrapper &decCtx, AVPacketWrapper &pkt)
 {
   if (!pkt)
-    return this->lib.avcodec.avcodec_send_packet(decCtx.getCodec(), nullptr);
+    return this->lib->avcodec.avcodec_send_packet(decCtx.getCodec(), nullptr);
   else
-    return this->lib.avcodec.avcodec_send_packet(decCtx.getCodec(), pkt.getPacket());
+    return this->lib->avcodec.avcodec_send_packet(decCtx.getCodec(), pkt.getPacket());
 }
 
 int FFmpegVersionHandler::getFrameFromDecoder(AVCodecContextWrapper &decCtx, AVFrameWrapper &frame)
 {
-  return this->lib.avcodec.avcodec_receive_frame(decCtx.getCodec(), frame.getFrame());
+  return this->lib->avcodec.avcodec_receive_frame(decCtx.getCodec(), frame.getFrame());
 }
 
 void FFmpegVersionHandler::flush_buffers(AVCodecContextWrapper &decCtx)
 {
-  lib.avcodec.avcodec_flush_buffers(decCtx.getCodec());
+  lib->avcodec.avcodec_flush_buffers(decCtx.getCodec());
 }
 
 QStringList FFmpegVersionHandler::logListFFmpeg;
@@ -307,7 +337,8 @@ QStringList FFmpegVersionHandler::logListFFmpeg;
 FFmpegVersionHandler::FFmpegVersionHandler()
 {
   this->librariesLoaded = false;
-  this->lib.setLogList(&logList);
+  this->lib             = std::make_shared<FFmpegLibraryFunctions>();
+  this->lib->setLogList(&logList);
 }
 
 void FFmpegVersionHandler::avLogCallback(void *, int level, const char *fmt, va_list vargs)
@@ -324,6 +355,39 @@ void FFmpegVersionHandler::loadFFmpegLibraries()
   if (this->librariesLoaded)
     return;
 
+  const auto settingsKey = getLibrarySettingsKey();
+
+  std::lock_guard<std::mutex> lock(loadedLibrariesMutex);
+  const auto alreadySearched = loadedLibraries && loadedLibraries->settingsKey == settingsKey;
+  if (!alreadySearched)
+  {
+    FFmpegVersionHandler loader;
+    loader.searchFFmpegLibraries();
+    // The log list of the loader does not outlive this function
+    loader.lib->setLogList(nullptr);
+
+    LoadedLibraries newLibraries;
+    newLibraries.settingsKey = settingsKey;
+    if (loader.librariesLoaded)
+      newLibraries.functions = loader.lib;
+    newLibraries.version = loader.libVersion;
+    newLibraries.log     = loader.logList;
+    loadedLibraries      = newLibraries;
+  }
+
+  this->logList.append(loadedLibraries->log);
+  if (alreadySearched)
+    this->log("Reusing the result of the library search from the first FFmpeg handler.");
+  if (loadedLibraries->functions)
+  {
+    this->lib             = loadedLibraries->functions;
+    this->libVersion      = loadedLibraries->version;
+    this->librariesLoaded = true;
+  }
+}
+
+void FFmpegVersionHandler::searchFFmpegLibraries()
+{
   // Try to load the ffmpeg libraries from the current working directory and several other
   // directories. Unfortunately relative paths like "./" do not work: (at least on windows)
 
@@ -375,7 +439,7 @@ void FFmpegVersionHandler::loadFFmpegLibraries()
   }
 
   if (this->librariesLoaded)
-    this->lib.avutil.av_log_set_callback(&FFmpegVersionHandler::avLogCallback);
+    this->lib->avutil.av_log_set_callback(&FFmpegVersionHandler::avLogCallback);
 }
 
 bool FFmpegVersionHandler::loadingSuccessfull() const
@@ -387,7 +451,7 @@ bool FFmpegVersionHandler::openInput(AVFormatContextWrapper &fmt, QString url)
 {
   AVFormatContext *f_ctx = nullptr;
   int              ret =
-      this->lib.avformat.avformat_open_input(&f_ctx, url.toStdString().c_str(), nullptr, nullptr);
+      this->lib->avformat.avformat_open_input(&f_ctx, url.toStdString().c_str(), nullptr, nullptr);
   if (ret < 0)
   {
     this->log(QString("Error opening file (avformat_open_input). Ret code %1").arg(ret));
@@ -402,7 +466,7 @@ bool FFmpegVersionHandler::openInput(AVFormatContextWrapper &fmt, QString url)
   // The wrapper will take ownership of this pointer
   fmt = AVFormatContextWrapper(f_ctx, libVersion);
 
-  ret = lib.avformat.avformat_find_stream_info(fmt.getFormatCtx(), nullptr);
+  ret = lib->avformat.avformat_find_stream_info(fmt.getFormatCtx(), nullptr);
   if (ret < 0)
   {
     this->log(QString("Error opening file (avformat_find_stream_info). Ret code %1").arg(ret));
@@ -414,13 +478,13 @@ bool FFmpegVersionHandler::openInput(AVFormatContextWrapper &fmt, QString url)
 
 AVCodecParametersWrapper FFmpegVersionHandler::allocCodecParameters()
 {
-  return AVCodecParametersWrapper(this->lib.avcodec.avcodec_parameters_alloc(), libVersion);
+  return AVCodecParametersWrapper(this->lib->avcodec.avcodec_parameters_alloc(), libVersion);
 }
 
 AVCodecWrapper FFmpegVersionHandler::findDecoder(AVCodecIDWrapper codecId)
 {
   AVCodecID avCodecID = getCodecIDFromWrapper(codecId);
-  AVCodec * c         = this->lib.avcodec.avcodec_find_decoder(avCodecID);
+  AVCodec * c         = this->lib->avcodec.avcodec_find_decoder(avCodecID);
   if (c == nullptr)
   {
     this->log("Unable to find decoder for codec " + codecId.getCodecName());
@@ -431,7 +495,7 @@ AVCodecWrapper FFmpegVersionHandler::findDecoder(AVCodecIDWrapper codecId)
 
 AVCodecContextWrapper FFmpegVersionHandler::allocDecoder(AVCodecWrapper &codec)
 {
-  return AVCodecContextWrapper(this->lib.avcodec.avcodec_alloc_context3(codec.getAVCodec()),
+  return AVCodecContextWrapper(this->lib->avcodec.avcodec_alloc_context3(codec.getAVCodec()),
                                libVersion);
 }
 
@@ -441,7 +505,7 @@ int FFmpegVersionHandler::dictSet(AVDictionaryWrapper &dict,
                                   int                  flags)
 {
   AVDictionary *d   = dict.getDictionary();
-  int           ret = this->lib.avutil.av_dict_set(&d, key, value, flags);
+  int           ret = this->lib->avutil.av_dict_set(&d, key, value, flags);
   dict.setDictionary(d);
   return ret;
 }
@@ -451,7 +515,8 @@ FFmpegVersionHandler::getDictionaryEntries(AVDictionaryWrapper d, QString key, i
 {
   StringPairVec      ret;
   AVDictionaryEntry *tag = NULL;
-  while ((tag = this->lib.avutil.av_dict_get(d.getDictionary(), key.toLatin1().data(), tag, flags)))
+  while (
+      (tag = this->lib->avutil.av_dict_get(d.getDictionary(), key.toLatin1().data(), tag, flags)))
   {
     StringPair pair;
     pair.first  = std::string(tag->key);
@@ -465,7 +530,7 @@ int FFmpegVersionHandler::avcodecOpen2(AVCodecContextWrapper &decCtx,
                                        AVDictionaryWrapper &  dict)
 {
   auto d   = dict.getDictionary();
-  int  ret = this->lib.avcodec.avcodec_open2(decCtx.getCodec(), codec.getAVCodec(), &d);
+  int  ret = this->lib->avcodec.avcodec_open2(decCtx.getCodec(), codec.getAVCodec(), &d);
   dict.setDictionary(d);
   return ret;
 }
@@ -473,7 +538,7 @@ int FFmpegVersionHandler::avcodecOpen2(AVCodecContextWrapper &decCtx,
 AVFrameSideDataWrapper FFmpegVersionHandler::getSideData(AVFrameWrapper &    frame,
                                                          AVFrameSideDataType type)
 {
-  auto sd = this->lib.avutil.av_frame_get_side_data(frame.getFrame(), type);
+  auto sd = this->lib->avutil.av_frame_get_side_data(frame.getFrame(), type);
   return AVFrameSideDataWrapper(sd, libVersion);
 }
 
@@ -481,7 +546,7 @@ AVDictionaryWrapper FFmpegVersionHandler::getMetadata(AVFrameWrapper &frame)
 {
   AVDictionary *dict;
   if (this->libVersion.avutil.major < 57)
-    dict = this->lib.avutil.av_frame_get_metadata(frame.getFrame());
+    dict = this->lib->avutil.av_frame_get_metadata(frame.getFrame());
   else
     dict = frame.getMetadata();
   return AVDictionaryWrapper(dict);
@@ -490,7 +555,7 @@ AVDictionaryWrapper FFmpegVersionHandler::getMetadata(AVFrameWrapper &frame)
 int FFmpegVersionHandler::seekFrame(AVFormatContextWrapper &fmt, int stream_idx, int64_t dts)
 {
   int ret =
-      this->lib.avformat.av_seek_frame(fmt.getFormatCtx(), stream_idx, dts, AVSEEK_FLAG_BACKWARD);
+      this->lib->avformat.av_seek_frame(fmt.getFormatCtx(), stream_idx, dts, AVSEEK_FLAG_BACKWARD);
   return ret;
 }
 
@@ -499,7 +564,25 @@ int FFmpegVersionHandler::seekBeginning(AVFormatContextWrapper &fmt)
   // This is "borrowed" from the ffmpeg sources
   // (https://ffmpeg.org/doxygen/4.0/ffmpeg_8c_source.html seek_to_start)
   this->log(QString("seek_beginning time %1").arg(fmt.getStartTime()));
-  return lib.avformat.av_seek_frame(fmt.getFormatCtx(), -1, fmt.getStartTime(), 0);
+  return lib->avformat.av_seek_frame(fmt.getFormatCtx(), -1, fmt.getStartTime(), 0);
+}
+
+std::vector<AVIndexEntry> FFmpegVersionHandler::getIndexEntries(AVStreamWrapper &stream)
+{
+  if (!this->lib->avformat.indexAPIAvailable || !stream)
+    return {};
+
+  const auto nrEntries = this->lib->avformat.avformat_index_get_entries_count(stream.getStream());
+  std::vector<AVIndexEntry> entries;
+  entries.reserve(size_t(std::max(nrEntries, 0)));
+  for (int i = 0; i < nrEntries; i++)
+  {
+    auto entry = this->lib->avformat.avformat_index_get_entry(stream.getStream(), i);
+    if (entry == nullptr)
+      return {};
+    entries.push_back(*entry);
+  }
+  return entries;
 }
 
 bool FFmpegVersionHandler::loadFFmpegLibraryInPath(QString path)
@@ -507,7 +590,7 @@ bool FFmpegVersionHandler::loadFFmpegLibraryInPath(QString path)
   bool success = false;
   for (auto version : SupportedLibraryVersionCombinations)
   {
-    if (this->lib.loadFFmpegLibraryInPath(path, version))
+    if (this->lib->loadFFmpegLibraryInPath(path, version))
     {
       this->log(QString("Checking versions avutil %1, swresample %2, avcodec %3, avformat %4")
                     .arg(version.avutil.major)
@@ -515,9 +598,9 @@ bool FFmpegVersionHandler::loadFFmpegLibraryInPath(QString path)
                     .arg(version.avcodec.major)
                     .arg(version.avformat.major));
 
-      if ((success = checkVersionWithLib(this->lib, version, this->logList)))
+      if ((success = checkVersionWithLib(*this->lib, version, this->logList)))
       {
-        this->libVersion = addMinorAndMicroVersion(this->lib, version);
+        this->libVersion = addMinorAndMicroVersion(*this->lib, version);
         this->log("checking the library versions was successful.");
         break;
       }
@@ -525,7 +608,7 @@ bool FFmpegVersionHandler::loadFFmpegLibraryInPath(QString path)
   }
 
   if (success && this->libVersion.avformat.major < 59)
-    this->lib.avformat.av_register_all();
+    this->lib->avformat.av_register_all();
 
   return success;
 }
@@ -543,7 +626,7 @@ bool FFmpegVersionHandler::loadFFMpegLibrarySpecific(QString avFormatLib,
                   .arg(version.swresample.major)
                   .arg(version.avcodec.major)
                   .arg(version.avformat.major));
-    if (lib.loadFFMpegLibrarySpecific(avFormatLib, avCodecLib, avUtilLib, swResampleLib))
+    if (lib->loadFFMpegLibrarySpecific(avFormatLib, avCodecLib, avUtilLib, swResampleLib))
     {
       this->log("Testing versions of the library. Currently looking for:");
       this->log(QString("avutil: %1.xx.xx").arg(version.avutil.major));
@@ -551,9 +634,9 @@ bool FFmpegVersionHandler::loadFFMpegLibrarySpecific(QString avFormatLib,
       this->log(QString("avcodec: %1.xx.xx").arg(version.avcodec.major));
       this->log(QString("avformat: %1.xx.xx").arg(version.avformat.major));
 
-      if ((success = checkVersionWithLib(this->lib, version, this->logList)))
+      if ((success = checkVersionWithLib(*this->lib, version, this->logList)))
       {
-        this->libVersion = addMinorAndMicroVersion(this->lib, version);
+        this->libVersion = addMinorAndMicroVersion(*this->lib, version);
         this->log("checking the library versions was successful.");
         break;
       }
@@ -561,7 +644,7 @@ bool FFmpegVersionHandler::loadFFMpegLibrarySpecific(QString avFormatLib,
   }
 
   if (success && this->libVersion.avformat.major < 59)
-    this->lib.avformat.av_register_all();
+    this->lib->avformat.av_register_all();
 
   return success;
 }
@@ -581,7 +664,7 @@ bool FFmpegVersionHandler::checkLibraryFiles(QString      avCodecLib,
 
 void FFmpegVersionHandler::enableLoggingWarning()
 {
-  lib.avutil.av_log_set_level(AV_LOG_WARNING);
+  lib->avutil.av_log_set_level(AV_LOG_WARNING);
 }
 
 AVPixFmtDescriptorWrapper
@@ -589,7 +672,7 @@ FFmpegVersionHandler::getAvPixFmtDescriptionFromAvPixelFormat(AVPixelFormat pixF
 {
   if (pixFmt == AV_PIX_FMT_NONE)
     return {};
-  return AVPixFmtDescriptorWrapper(lib.avutil.av_pix_fmt_desc_get(pixFmt), libVersion);
+  return AVPixFmtDescriptorWrapper(lib->avutil.av_pix_fmt_desc_get(pixFmt), libVersion);
 }
 
 AVPixelFormat
@@ -601,16 +684,16 @@ FFmpegVersionHandler::getAVPixelFormatFromPixelFormatYUV(video::yuv::PixelFormat
   // We will have to search through all pixel formats which the library knows and compare them to
   // the one we are looking for. Unfortunately there is no other more direct search function in
   // libavutil.
-  auto desc = this->lib.avutil.av_pix_fmt_desc_next(nullptr);
+  auto desc = this->lib->avutil.av_pix_fmt_desc_next(nullptr);
   while (desc != nullptr)
   {
     AVPixFmtDescriptorWrapper descWrapper(desc, libVersion);
 
     if (descWrapper == wrapper)
-      return this->lib.avutil.av_pix_fmt_desc_get_id(desc);
+      return this->lib->avutil.av_pix_fmt_desc_get_id(desc);
 
     // Get the next descriptor
-    desc = this->lib.avutil.av_pix_fmt_desc_next(desc);
+    desc = this->lib->avutil.av_pix_fmt_desc_next(desc);
   }
 
   return AV_PIX_FMT_NONE;
@@ -618,33 +701,33 @@ FFmpegVersionHandler::getAVPixelFormatFromPixelFormatYUV(video::yuv::PixelFormat
 
 AVFrameWrapper FFmpegVersionHandler::allocateFrame()
 {
-  auto framePtr = this->lib.avutil.av_frame_alloc();
+  auto framePtr = this->lib->avutil.av_frame_alloc();
   return AVFrameWrapper(this->libVersion, framePtr);
 }
 
 void FFmpegVersionHandler::freeFrame(AVFrameWrapper &frame)
 {
   auto framePtr = frame.getFrame();
-  this->lib.avutil.av_frame_free(&framePtr);
+  this->lib->avutil.av_frame_free(&framePtr);
   frame.clear();
 }
 
 AVPacketWrapper FFmpegVersionHandler::allocatePaket()
 {
-  auto rawPacket = this->lib.avcodec.av_packet_alloc();
-  this->lib.avcodec.av_init_packet(rawPacket);
+  auto rawPacket = this->lib->avcodec.av_packet_alloc();
+  this->lib->avcodec.av_init_packet(rawPacket);
   return AVPacketWrapper(this->libVersion, rawPacket);
 }
 
 void FFmpegVersionHandler::unrefPacket(AVPacketWrapper &packet)
 {
-  this->lib.avcodec.av_packet_unref(packet.getPacket());
+  this->lib->avcodec.av_packet_unref(packet.getPacket());
 }
 
 void FFmpegVersionHandler::freePacket(AVPacketWrapper &packet)
 {
   auto packetPtr = packet.getPacket();
-  this->lib.avcodec.av_packet_free(&packetPtr);
+  this->lib->avcodec.av_packet_free(&packetPtr);
   packet.clear();
 }
 
@@ -45,6 +45,9 @@
 #include "FFmpegLibraryFunctions.h"
 #include <common/Typedef.h>
 
+#include <memory>
+#include <vector>
+
 namespace FFmpeg
 {
 
@@ -53,11 +56,12 @@ class FFmpegVersionHandler
 public:
   FFmpegVersionHandler();
 
-  // Try to load the ffmpeg libraries and get all the function pointers.
+  // Try to load the ffmpeg libraries and get all the function pointers. The libraries are only
+  // searched for once per process. All handlers share the loaded libraries.
   void loadFFmpegLibraries();
   bool loadingSuccessfull() const;
 
-  QStringList getLibPaths() const { return lib.getLibPaths(); }
+  QStringList getLibPaths() const { return lib->getLibPaths(); }
   QString     getLibVersionString() const;
 
   // Only these functions can be used to get valid versions of these wrappers (they have to use
@@ -107,8 +111,12 @@ public:
   int seekFrame(AVFormatContextWrapper &fmt, int stream_idx, int64_t dts);
   int seekBeginning(AVFormatContextWrapper &fmt);
 
-  // All the function pointers of the ffmpeg library
-  FFmpegLibraryFunctions lib;
+  // Get the index entries that the demuxer created when opening the file (e.g. from the sample
+  // tables of MP4 files). Empty if there is no index or the libraries do not provide access to it.
+  std::vector<AVIndexEntry> getIndexEntries(AVStreamWrapper &stream);
+
+  // All the function pointers of the ffmpeg library (shared by all handlers)
+  std::shared_ptr<FFmpegLibraryFunctions> lib;
 
   static AVPixelFormat convertYUVAVPixelFormat(video::yuv::PixelFormatYUV fmt);
   // Check if the given four files can be used to open FFmpeg.
@@ -126,6 +134,8 @@ public:
   QStringList getLog() const { return logList; }
 
 private:
+  // Search all paths and supported versions for the FFmpeg libraries and load them into this->lib.
+  void searchFFmpegLibraries();
   // Try to load the FFmpeg libraries from the given path.
   // Try the system paths if no path is provided. This function can be called multiple times.
   bool loadFFmpegLibraryInPath(QString path);
@@ -195,6 +195,9 @@ QByteArray FileSourceAnnexBFile::getFrameData(pairUint64 startEndFilePos)
   auto start = startEndFilePos.first;
   auto end = startEndFilePos.second;
 
+  // Allocate the output once. The returned array is handed to the decoder without further copies.
+  retArray.reserve(int(end - start + 1));
+
   // Seek the source file to the start position
   this->seek(start);
 
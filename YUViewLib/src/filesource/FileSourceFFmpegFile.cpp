@@ -35,6 +35,8 @@
 #include <QProgressDialog>
 #include <QSettings>
 
+#include <algorithm>
+
 #include <ffmpeg/AVCodecContextWrapper.h>
 #include <parser/AV1/obu_header.h>
 #include <parser/common/SubByteReaderLogging.h>
@@ -166,8 +168,12 @@ QByteArray FileSourceFFmpegFile::getNextUnit(bool getLastDataAgain, int64_t *pts
   }
   else if (this->packetDataFormat == PacketDataFormat::OBU)
   {
+    // Only the OBU header is parsed here. It is at most 10 bytes long (header, extension and the
+    // leb128 coded size). Don't convert the whole remainder of the packet for every OBU.
     SubByteReaderLogging reader(
-        SubByteReaderLogging::convertToByteVector(currentPacketData), nullptr, "", posInData);
+        SubByteReaderLogging::convertToByteVector(currentPacketData.mid(posInData, 10)),
+        nullptr,
+        "");
 
     try
     {
@@ -362,7 +368,7 @@ bool FileSourceFFmpegFile::openFile(const QString &       filePath,
     this->nrFrames     = other->nrFrames;
     this->keyFrameList = other->keyFrameList;
   }
-  else if (parseFile)
+  else if (parseFile && !this->readIndexFromContainer())
   {
     if (!this->scanBitstream(mainWindow))
       return false;
@@ -388,23 +394,62 @@ void FileSourceFFmpegFile::updateFileWatchSetting()
 
 std::pair<int64_t, size_t> FileSourceFFmpegFile::getClosestSeekableFrameBefore(int frameIdx) const
 {
-  // We are always be able to seek to the beginning of the file
-  auto bestSeekDTS    = this->keyFrameList[0].dts;
-  auto seekToFrameIdx = this->keyFrameList[0].frame;
+  // Find the last keyframe at or before the given frame. We are always able to seek to the
+  // beginning of the file.
+  const auto frame    = size_t(std::max(frameIdx, 0));
+  const auto isBefore = [](size_t f, const pictureIdx &pic) { return f < pic.frame; };
+  auto it = std::upper_bound(this->keyFrameList.begin(), this->keyFrameList.end(), frame, isBefore);
+  if (it != this->keyFrameList.begin())
+    it--;
+
+  return {it->dts, it->frame};
+}
 
-  for (const auto &pic : this->keyFrameList)
+bool FileSourceFFmpegFile::readIndexFromContainer()
+{
+  if (!this->isFileOpened)
+    return false;
+
+  // Entries flagged as discard (e.g. the priming frames of an MP4 edit list) are decoded but never
+  // shown. They do not count as frames.
+  auto entries = this->ff.getIndexEntries(this->video_stream);
+  entries.erase(std::remove_if(entries.begin(),
+                               entries.end(),
+                               [](const AVIndexEntry &e) {
+                                 return (e.flags & AVINDEX_DISCARD_FRAME) != 0;
+                               }),
+                entries.end());
+  // Seeking to the first shown frame must be possible (its keyframe may have been discarded)
+  if (entries.empty() || (entries.front().flags & AVINDEX_KEYFRAME) == 0)
+    return false;
+
+  // Some demuxers (e.g. Matroska with its cues) only index the keyframes. Then we don't know the
+  // number of frames unless the container tells us that every frame is a keyframe.
+  const auto allKeyframes = std::all_of(entries.begin(), entries.end(), [](const AVIndexEntry &e) {
+    return (e.flags & AVINDEX_KEYFRAME) != 0;
+  });
+  const auto nbFrames     = this->video_stream.getNbFrames();
+  if (allKeyframes && (nbFrames <= 0 || size_t(nbFrames) != entries.size()))
+    return false;
+
+  QList<pictureIdx> keyFrames;
+  for (size_t i = 0; i < entries.size(); i++)
   {
-    if (frameIdx > 0 && pic.frame <= unsigned(frameIdx))
-    {
-      // We could seek here
-      bestSeekDTS    = pic.dts;
-      seekToFrameIdx = pic.frame;
-    }
-    else
-      break;
+    // The entries must be in decoding order so that the position is the frame number
+    if (i > 0 && entries[i].timestamp < entries[i - 1].timestamp)
+      return false;
+    if (entries[i].flags & AVINDEX_KEYFRAME)
+      keyFrames.append(pictureIdx(i, entries[i].timestamp));
   }
+  if (keyFrames.isEmpty())
+    return false;
 
-  return {bestSeekDTS, seekToFrameIdx};
+  this->keyFrameList = keyFrames;
+  this->nrFrames     = entries.size();
+  DEBUG_FFMPEG("FileSourceFFmpegFile::readIndexFromContainer: Found %d frames and %d keyframes.",
+               int(this->nrFrames),
+               this->keyFrameList.length());
+  return true;
 }
 
 bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
@@ -553,7 +598,7 @@ bool FileSourceFFmpegFile::goToNextPacket(bool videoPacketsOnly)
       if (!ctx || !pkt)
         ret = -1;
       else
-        ret = ff.lib.avformat.av_read_frame(ctx, pkt.getPacket());
+        ret = ff.lib->avformat.av_read_frame(ctx, pkt.getPacket());
     }
 
     if (pkt.getStreamIndex() == this->streamIndices.video)
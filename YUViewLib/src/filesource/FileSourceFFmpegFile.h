@@ -173,8 +173,11 @@ protected:
 
   // In order to translate from frames to PTS, we need to count the frames and keep a list of
   // the PTS values of keyframes that we can start decoding at.
-  // If a mainWindow pointer is given, open a progress dialog. Return true on success. False if the
-  // process was canceled.
+  // If the demuxer indexed all frames of the video stream (e.g. the sample tables of MP4 files),
+  // the list is built from this index. Return false if there is no such index.
+  bool readIndexFromContainer();
+  // Otherwise, all packets of the file are read. If a mainWindow pointer is given, open a progress
+  // dialog. Return true on success. False if the process was canceled.
   bool   scanBitstream(QWidget *mainWindow);
   size_t nrFrames{0};
 
@@ -189,8 +192,8 @@ protected:
 
   FFmpeg::PacketDataFormat packetDataFormat{FFmpeg::PacketDataFormat::Unknown};
 
-  // These are filled after opening a file (after scanBitstream was called)
-  QList<pictureIdx> keyFrameList; //< A list of pairs (frameNr, PTS) that we can seek to.
+  // These are filled after opening a file (by readIndexFromContainer or scanBitstream)
+  QList<pictureIdx> keyFrameList; //< A list of pairs (frameNr, DTS) sorted by frameNr.
   // pictureIdx getClosestSeekableFrameNumberBeforeBefore(int frameIdx);
 
   // For parsing NAL units from the compressed data:
@@ -41,34 +41,52 @@
 
 #include "BitratePlotModel.h"
 
+#include <algorithm>
+
 #include <common/Functions.h>
 
+namespace
+{
+
+// The average plot averages over this many points left and right of each point
+const unsigned AVERAGE_RANGE = 10;
+
+// Entries are added in decoding order. In presentation order a new entry is only inserted a few
+// positions before the end (bounded by the reordering depth of the decoded picture buffer). Search
+// this many positions backwards from the end before falling back to a binary search.
+const size_t MAX_REORDER_SEARCH_DISTANCE = 32;
+
+} // namespace
+
 unsigned BitratePlotModel::getNrStreams() const
 {
-  return this->dataPerStream.size();
+  QMutexLocker locker(&this->dataMutex);
+  return unsigned(this->dataPerStream.size());
 }
 
 PlotModel::StreamParameter BitratePlotModel::getStreamParameter(unsigned streamIndex) const
 {
   QMutexLocker locker(&this->dataMutex);
 
-  if (this->dataPerStream.contains(streamIndex))
-  {
-    PlotModel::StreamParameter streamParameter;
-    streamParameter.xRange.min = (sortMode == SortMode::DECODE_ORDER) ? double(this->rangeDts.min)
-                                                                      : double(this->rangePts.min);
-    streamParameter.xRange.max = (sortMode == SortMode::DECODE_ORDER) ? double(this->rangeDts.max)
-                                                                      : double(this->rangePts.max);
-    streamParameter.yRange.min = double(this->rangeBitratePerStream[streamIndex].min);
-    streamParameter.yRange.max = double(this->rangeBitratePerStream[streamIndex].max);
-
-    const auto nrPoints = unsigned(this->dataPerStream[streamIndex].size());
-    streamParameter.plotParameters.append({PlotType::Bar, nrPoints});
-    streamParameter.plotParameters.append({PlotType::Line, nrPoints});
-
-    return streamParameter;
-  }
-  return {};
+  const auto it = this->dataPerStream.find(streamIndex);
+  if (it == this->dataPerStream.end())
+    return {};
+
+  const auto &stream = it->second;
+
+  PlotModel::StreamParameter streamParameter;
+  streamParameter.xRange.min = (sortMode == SortMode::DECODE_ORDER) ? double(this->rangeDts.min)
+                                                                    : double(this->rangePts.min);
+  streamParameter.xRange.max = (sortMode == SortMode::DECODE_ORDER) ? double(this->rangeDts.max)
+                                                                    : double(this->rangePts.max);
+  streamParameter.yRange.min = double(stream.rangeBitrate.min);
+  streamParameter.yRange.max = double(stream.rangeBitrate.max);
+
+  const auto nrPoints = unsigned(stream.entries.size());
+  streamParameter.plotParameters.append({PlotType::Bar, nrPoints});
+  streamParameter.plotParameters.append({PlotType::Line, nrPoints});
+
+  return streamParameter;
 }
 
 PlotModel::Point
@@ -76,29 +94,26 @@ BitratePlotModel::getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigne
 {
   QMutexLocker locker(&this->dataMutex);
 
-  if (!this->dataPerStream.contains(streamIndex))
+  const auto it = this->dataPerStream.find(streamIndex);
+  if (it == this->dataPerStream.end())
     return {};
+  return this->getPlotPoint(it->second, plotIndex, pointIndex);
+}
 
-  if (pointIndex < unsigned(this->dataPerStream[streamIndex].size()))
-  {
-    PlotModel::Point point;
-    if (this->sortMode == SortMode::DECODE_ORDER)
-      point.x = this->dataPerStream[streamIndex][pointIndex].dts;
-    else
-      point.x = this->dataPerStream[streamIndex][pointIndex].pts;
-    point.intra = this->dataPerStream[streamIndex][pointIndex].keyframe;
-
-    const auto isAveragePlot = (plotIndex == 1);
-    if (isAveragePlot)
-      point.y = this->calculateAverageValue(streamIndex, pointIndex);
-    else
-      point.y = this->dataPerStream[streamIndex][pointIndex].bitrate;
-    point.width = this->dataPerStream[streamIndex][pointIndex].duration;
-
-    return point;
-  }
+std::vector<PlotModel::Bucket> BitratePlotModel::getPlotBuckets(unsigned      streamIndex,
+                                                                unsigned      plotIndex,
+                                                                Range<double> xRange,
+                                                                double        columnWidth) const
+{
+  QMutexLocker locker(&this->dataMutex);
 
-  return {};
+  const auto it = this->dataPerStream.find(streamIndex);
+  if (plotIndex > 1 || it == this->dataPerStream.end())
+    return {};
+
+  const auto &stream  = it->second;
+  const auto &pyramid = (plotIndex == 1) ? stream.averagePyramid : stream.barPyramid;
+  return pyramid.getBuckets(xRange, columnWidth);
 }
 
 QString
@@ -106,12 +121,12 @@ BitratePlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigne
 {
   QMutexLocker locker(&this->dataMutex);
 
-  if (!this->dataPerStream.contains(streamIndex) ||
-      unsigned(this->dataPerStream[streamIndex].size()) <= pointIndex)
+  const auto it = this->dataPerStream.find(streamIndex);
+  if (it == this->dataPerStream.end() || it->second.entries.size() <= pointIndex)
     return {};
 
-  auto       entry         = this->dataPerStream[streamIndex][pointIndex];
-  const auto isAveragePlot = (plotIndex == 1);
+  const auto &entry         = it->second.entries[pointIndex];
+  const auto  isAveragePlot = (plotIndex == 1);
 
   if (isAveragePlot)
     return QString("<h4>Stream Average %1</h4>"
@@ -124,8 +139,8 @@ BitratePlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigne
         .arg(streamIndex)
         .arg(entry.pts)
         .arg(entry.dts)
-        .arg(this->calculateAverageValue(streamIndex, pointIndex))
-        .arg(entry.frameType);
+        .arg(this->calculateAverageValue(it->second, pointIndex))
+        .arg(this->frameTypeNames.value(entry.frameTypeID));
   else
     return QString("<h4>Stream %1</h4>"
                    "<table width=\"100%\">"
@@ -143,12 +158,15 @@ BitratePlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigne
 
 std::optional<unsigned> BitratePlotModel::getReasonabelRangeToShowOnXAxisPer100Pixels() const
 {
+  QMutexLocker locker(&this->dataMutex);
+
   std::optional<unsigned> range;
-  for (auto &list : this->dataPerStream)
+  for (const auto &streamData : this->dataPerStream)
   {
-    if (list.size() >= 2)
+    const auto &entries = streamData.second.entries;
+    if (entries.size() >= 2)
     {
-      const auto minDistance = unsigned(std::abs(list.at(1).dts - list.at(0).dts));
+      const auto minDistance = unsigned(std::abs(entries[1].dts - entries[0].dts));
       // Try to show 10 of these distance steps per 100 px
       const auto minDistancePer100Pix = minDistance * 10;
       if (minDistance == 0)
@@ -178,9 +196,10 @@ void BitratePlotModel::addBitratePoint(int streamIndex, BitrateEntry &entry)
 {
   QMutexLocker locker(&this->dataMutex);
 
-  const auto newStream = !this->dataPerStream.contains(streamIndex);
+  const auto newStream = (this->dataPerStream.count(streamIndex) == 0);
+  auto &     stream    = this->dataPerStream[streamIndex];
 
-  if (this->dataPerStream[streamIndex].empty())
+  if (stream.entries.empty())
   {
     rangeDts.min = entry.dts;
     rangeDts.max = entry.dts;
@@ -195,35 +214,45 @@ void BitratePlotModel::addBitratePoint(int streamIndex, BitrateEntry &entry)
     rangePts.max = std::max(rangePts.max, entry.pts);
   }
 
-  rangeBitratePerStream[streamIndex].min =
-      std::min(rangeBitratePerStream[streamIndex].min, int(entry.bitrate));
-  rangeBitratePerStream[streamIndex].max =
-      std::max(rangeBitratePerStream[streamIndex].max, int(entry.bitrate));
+  stream.rangeBitrate.min = std::min(stream.rangeBitrate.min, int(entry.bitrate));
+  stream.rangeBitrate.max = std::max(stream.rangeBitrate.max, int(entry.bitrate));
 
   // Store absolute minimum and maximum over all streams
-  yMaxStreamRange.min =
-      std::min(yMaxStreamRange.min, double(rangeBitratePerStream[streamIndex].min));
-  yMaxStreamRange.max =
-      std::max(yMaxStreamRange.max, double(rangeBitratePerStream[streamIndex].max));
+  yMaxStreamRange.min = std::min(yMaxStreamRange.min, double(stream.rangeBitrate.min));
+  yMaxStreamRange.max = std::max(yMaxStreamRange.max, double(stream.rangeBitrate.max));
 
   DEBUG_PLOT("BitrateItemModel::addBitratePoint streamIndex "
              << streamIndex << " pts " << entry.pts << " dts " << entry.dts << " rate "
              << entry.bitrate << " keyframe " << entry.keyframe);
 
-  // Keep the list sorted
-  const auto currentSortMode   = this->sortMode;
-  auto compareFunctionLessThen = [currentSortMode](const BitrateEntry &a, const BitrateEntry &b) {
-    if (currentSortMode == SortMode::DECODE_ORDER)
-      return a.dts < b.dts;
-    else
-      return b.pts < a.pts;
-  };
-
-  auto insertIterator = std::upper_bound(this->dataPerStream[streamIndex].begin(),
-                                         this->dataPerStream[streamIndex].end(),
-                                         entry,
-                                         compareFunctionLessThen);
-  this->dataPerStream[streamIndex].insert(insertIterator, entry);
+  StoredEntry storedEntry;
+  storedEntry.bitrate     = entry.bitrate;
+  storedEntry.dts         = entry.dts;
+  storedEntry.pts         = entry.pts;
+  storedEntry.duration    = entry.duration;
+  storedEntry.frameTypeID = this->getFrameTypeID(entry.frameType);
+  storedEntry.keyframe    = entry.keyframe;
+
+  // Keep the list sorted. Insert after all entries that are not after the new one.
+  auto &entries     = stream.entries;
+  auto  insertIndex = entries.size();
+  while (insertIndex > 0 && entries.size() - insertIndex < MAX_REORDER_SEARCH_DISTANCE &&
+         this->isBefore(storedEntry, entries[insertIndex - 1]))
+    insertIndex--;
+  if (insertIndex > 0 && this->isBefore(storedEntry, entries[insertIndex - 1]))
+  {
+    auto insertIterator = std::upper_bound(
+        entries.begin(),
+        entries.begin() + insertIndex,
+        storedEntry,
+        [this](const StoredEntry &a, const StoredEntry &b) { return this->isBefore(a, b); });
+    insertIndex = size_t(std::distance(entries.begin(), insertIterator));
+  }
+
+  entries.insert(entries.begin() + insertIndex, storedEntry);
+  this->updateAfterInsert(stream, unsigned(insertIndex));
+  locker.unlock();
+
   this->eventSubsampler.postEvent();
   if (newStream)
     emit nrStreamsChanged();
@@ -232,33 +261,113 @@ void BitratePlotModel::addBitratePoint(int streamIndex, BitrateEntry &entry)
 void BitratePlotModel::setBitrateSortingIndex(int index)
 {
   auto newSortMode = (index == 1) ? SortMode::PRESENTATION_ORDER : SortMode::DECODE_ORDER;
+
+  QMutexLocker locker(&this->dataMutex);
   if (this->sortMode == newSortMode)
     return;
 
   this->sortMode = newSortMode;
 
-  const auto currentSortMode   = this->sortMode;
-  auto compareFunctionLessThen = [currentSortMode](const BitrateEntry &a, const BitrateEntry &b) {
-    if (currentSortMode == SortMode::DECODE_ORDER)
-      return a.dts < b.dts;
-    else
-      return a.pts < b.pts;
-  };
+  for (auto &streamData : this->dataPerStream)
+  {
+    auto &stream = streamData.second;
+    std::stable_sort(
+        stream.entries.begin(),
+        stream.entries.end(),
+        [this](const StoredEntry &a, const StoredEntry &b) { return this->isBefore(a, b); });
+    this->rebuildBitrateSumAndPyramids(stream);
+  }
+}
 
-  QMutexLocker locker(&this->dataMutex);
-  for (auto &list : this->dataPerStream)
-    std::sort(list.begin(), list.end(), compareFunctionLessThen);
+uint16_t BitratePlotModel::getFrameTypeID(const QString &frameType)
+{
+  const auto it = this->frameTypeIDs.find(frameType);
+  if (it != this->frameTypeIDs.end())
+    return *it;
+
+  const auto id = uint16_t(this->frameTypeNames.size());
+  this->frameTypeNames.append(frameType);
+  this->frameTypeIDs.insert(frameType, id);
+  return id;
+}
+
+bool BitratePlotModel::isBefore(const StoredEntry &a, const StoredEntry &b) const
+{
+  if (this->sortMode == SortMode::DECODE_ORDER)
+    return a.dts < b.dts;
+  return a.pts < b.pts;
+}
+
+unsigned int BitratePlotModel::calculateAverageValue(const StreamData &stream,
+                                                     unsigned          pointIndex) const
+{
+  const auto nrEntries = unsigned(stream.entries.size());
+  const auto start     = (pointIndex > AVERAGE_RANGE) ? pointIndex - AVERAGE_RANGE : 0;
+  const auto end       = std::min(pointIndex + AVERAGE_RANGE, nrEntries);
+  if (end <= start)
+    return 0;
+  return unsigned((stream.bitrateSum[end] - stream.bitrateSum[start]) / (end - start));
+}
+
+PlotModel::Point BitratePlotModel::getPlotPoint(const StreamData &stream,
+                                                unsigned          plotIndex,
+                                                unsigned          pointIndex) const
+{
+  if (pointIndex >= stream.entries.size())
+    return {};
+
+  const auto &entry = stream.entries[pointIndex];
+
+  PlotModel::Point point;
+  if (this->sortMode == SortMode::DECODE_ORDER)
+    point.x = entry.dts;
+  else
+    point.x = entry.pts;
+  point.intra = entry.keyframe;
+
+  const auto isAveragePlot = (plotIndex == 1);
+  if (isAveragePlot)
+    point.y = this->calculateAverageValue(stream, pointIndex);
+  else
+    point.y = entry.bitrate;
+  point.width = entry.duration;
+
+  return point;
 }
 
-unsigned int BitratePlotModel::calculateAverageValue(unsigned streamIndex,
-                                                     unsigned pointIndex) const
+void BitratePlotModel::updateAfterInsert(StreamData &stream, unsigned insertIndex)
 {
-  const unsigned int averageRange   = 10;
-  unsigned           averageBitrate = 0;
-  const unsigned     start          = std::max(unsigned(0), pointIndex - averageRange);
-  const unsigned     end =
-      std::min(pointIndex + averageRange, unsigned(this->dataPerStream[streamIndex].size()));
-  for (unsigned i = start; i < end; i++)
-    averageBitrate += unsigned(this->dataPerStream[streamIndex][i].bitrate);
-  return averageBitrate / (end - start);
+  const auto nrEntries = unsigned(stream.entries.size());
+
+  // All sums after the inserted entry change
+  stream.bitrateSum.resize(nrEntries + 1);
+  for (auto i = insertIndex; i < nrEntries; i++)
+    stream.bitrateSum[i + 1] = stream.bitrateSum[i] + stream.entries[i].bitrate;
+
+  stream.barPyramid.insert(insertIndex, this->getPlotPoint(stream, 0, insertIndex));
+
+  // The new entry changes the average of all points that have it in their averaging window
+  stream.averagePyramid.insert(insertIndex, this->getPlotPoint(stream, 1, insertIndex));
+  const auto start = (insertIndex > AVERAGE_RANGE) ? insertIndex - AVERAGE_RANGE : 0;
+  const auto end   = std::min(insertIndex + AVERAGE_RANGE + 1, nrEntries);
+  for (auto i = start; i < end; i++)
+    if (i != insertIndex)
+      stream.averagePyramid.set(i, this->getPlotPoint(stream, 1, i));
+}
+
+void BitratePlotModel::rebuildBitrateSumAndPyramids(StreamData &stream)
+{
+  const auto nrEntries = unsigned(stream.entries.size());
+
+  stream.bitrateSum.resize(nrEntries + 1);
+  for (unsigned i = 0; i < nrEntries; i++)
+    stream.bitrateSum[i + 1] = stream.bitrateSum[i] + stream.entries[i].bitrate;
+
+  stream.barPyramid.clear();
+  stream.averagePyramid.clear();
+  for (unsigned i = 0; i < nrEntries; i++)
+  {
+    stream.barPyramid.append(this->getPlotPoint(stream, 0, i));
+    stream.averagePyramid.append(this->getPlotPoint(stream, 1, i));
+  }
 }
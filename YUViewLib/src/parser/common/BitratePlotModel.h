@@ -32,11 +32,15 @@
 
 #pragma once
 
-#include <QMap>
+#include <QHash>
 #include <QMutex>
 #include <QString>
+#include <QStringList>
+#include <map>
+#include <vector>
 
 #include <common/Typedef.h>
+#include <ui/views/PlotDecimationPyramid.h>
 #include <ui/views/PlotModel.h>
 
 class BitratePlotModel : public PlotModel
@@ -56,6 +60,11 @@ public:
   Range<double>           getYRange() const override { return yMaxStreamRange; }
   QString                 getItemInfoText(int index);
 
+  std::vector<PlotModel::Bucket> getPlotBuckets(unsigned      streamIndex,
+                                                unsigned      plotIndex,
+                                                Range<double> xRange,
+                                                double        columnWidth) const override;
+
   struct BitrateEntry
   {
     int     dts{0};
@@ -77,13 +86,45 @@ private:
   };
   SortMode sortMode{SortMode::DECODE_ORDER};
 
-  QMap<unsigned int, QList<BitrateEntry>> dataPerStream;
-  mutable QMutex                          dataMutex;
+  // The compact form of a BitrateEntry as it is stored. The frame type string is interned.
+  struct StoredEntry
+  {
+    size_t   bitrate{0};
+    int      dts{0};
+    int      pts{0};
+    int      duration{1};
+    uint16_t frameTypeID{0};
+    bool     keyframe{false};
+  };
 
-  unsigned int calculateAverageValue(unsigned streamIndex, unsigned pointIndex) const;
+  struct StreamData
+  {
+    // Sorted by the current sort mode
+    std::vector<StoredEntry> entries;
+    // bitrateSum[i] is the sum of the bitrates of the first i entries
+    std::vector<uint64_t> bitrateSum{0};
+    // Level of detail pyramids for the bar plot (0) and the average plot (1)
+    PlotDecimationPyramid barPyramid;
+    PlotDecimationPyramid averagePyramid;
+    Range<int>            rangeBitrate;
+  };
+
+  // All members must be accessed with the dataMutex locked
+  std::map<unsigned int, StreamData> dataPerStream;
+  mutable QMutex                     dataMutex;
+
+  QStringList              frameTypeNames;
+  QHash<QString, uint16_t> frameTypeIDs;
+  uint16_t                 getFrameTypeID(const QString &frameType);
+
+  bool         isBefore(const StoredEntry &a, const StoredEntry &b) const;
+  unsigned int calculateAverageValue(const StreamData &stream, unsigned pointIndex) const;
+  PlotModel::Point
+       getPlotPoint(const StreamData &stream, unsigned plotIndex, unsigned pointIndex) const;
+  void updateAfterInsert(StreamData &stream, unsigned insertIndex);
+  void rebuildBitrateSumAndPyramids(StreamData &stream);
 
-  Range<int>                     rangeDts;
-  Range<int>                     rangePts;
-  QMap<unsigned int, Range<int>> rangeBitratePerStream;
-  Range<double>                  yMaxStreamRange;
+  Range<int>    rangeDts;
+  Range<int>    rangePts;
+  Range<double> yMaxStreamRange;
 };
@@ -98,6 +98,18 @@ PlotModel::Point HRDPlotModel::getPlotPoint(unsigned streamIndex, unsigned, unsi
   return point;
 }
 
+std::vector<PlotModel::Bucket> HRDPlotModel::getPlotBuckets(unsigned streamIndex,
+                                                            unsigned,
+                                                            Range<double> xRange,
+                                                            double        columnWidth) const
+{
+  if (streamIndex > 0)
+    return {};
+
+  QMutexLocker locker(&this->dataMutex);
+  return this->pyramid.getBuckets(xRange, columnWidth);
+}
+
 QString HRDPlotModel::getPointInfo(unsigned streamIndex, unsigned, unsigned pointIndex) const
 {
   if (streamIndex > 0)
@@ -167,6 +179,10 @@ void HRDPlotModel::addHRDEntry(HRDPlotModel::HRDEntry &entry)
 
   this->data.append(entry);
 
+  if (this->pyramid.size() == 0)
+    this->pyramid.append({0, 0, 0, false});
+  this->pyramid.append({entry.time_offset_end, double(entry.cbp_fullness_end), 0, false});
+
   if (entry.time_offset_end > this->time_offset_max)
     this->time_offset_max = entry.time_offset_end;
   if (entry.cbp_fullness_end > this->bufferLevelLimits.max)
@@ -37,6 +37,7 @@
 #include <QString>
 
 #include <common/Typedef.h>
+#include <ui/views/PlotDecimationPyramid.h>
 #include <ui/views/PlotModel.h>
 
 class HRDPlotModel : public PlotModel
@@ -56,6 +57,11 @@ public:
   Range<double>           getYRange() const override { return getStreamParameter(0).yRange; }
   QString                 getItemInfoText(int index);
 
+  std::vector<PlotModel::Bucket> getPlotBuckets(unsigned      streamIndex,
+                                                unsigned      plotIndex,
+                                                Range<double> xRange,
+                                                double        columnWidth) const override;
+
   struct HRDEntry
   {
     // There are two types of entries.
@@ -84,6 +90,9 @@ private:
   QList<HRDEntry> data;
   mutable QMutex  dataMutex;
 
+  // Level of detail pyramid of the plot points (including the starting point at 0)
+  PlotDecimationPyramid pyramid;
+
   int        cpb_buffer_size{0};
   double     time_offset_max{0};
   Range<int> bufferLevelLimits{0, 0};
@@ -37,11 +37,14 @@
 #include <common/Typedef.h>
 #include <common/YUViewDomElement.h>
 #include <statistics/StatisticUIHandler.h>
+#include <video/CachePolicy.h>
 
 #include <QDir>
 #include <QObject>
 #include <QTreeWidgetItem>
 
+#include <functional>
+
 #include "ui_playlistItem.h"
 
 namespace video
@@ -161,6 +164,16 @@ public:
   // certain situations.
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues);
 
+  // A function that draws a frame of the item centered at (0,0) with the given zoom factor.
+  using DrawFunction = std::function<void(QPainter *painter, double zoomFactor)>;
+
+  // Get a function that draws the given frame like drawItem() (without the raw values) and that
+  // can be called from any thread. This is used by containers to composite the frames of their
+  // children in the background. Return an empty function if this is not possible (e.g. because
+  // the frame is not loaded). If caching is set, this is called from a caching thread and the frame
+  // may be loaded like cacheFrame() does. The default implementation returns an empty function.
+  virtual DrawFunction getDrawFunction(int, bool) { return {}; }
+
   // When a new frame is selected (by the user or by playback), it will firstly be checked if the
   // playlistitem needs to load the frame. If this returns true, the loadFrame() function will be
   // called in the background. loadRawValues is set if the raw values are also drawn.
@@ -226,6 +239,13 @@ public:
   // Remove the frame with the given index from the cache.
   virtual void removeFrameFromCache(int) {}
   virtual void removeAllFramesFromCache(){};
+  // Get the statistics of the cache of this item and when the given cached frame was last used (see
+  // video::nextCacheAccessTick()). This is used by the cache policies.
+  virtual video::CacheStatistics getCacheStatistics() const { return {}; }
+  virtual uint64_t               getFrameLastAccess(int) const { return 0; }
+  // The frame is shown without calling drawItem() (e.g. in a cached composite of an overlay).
+  // Record the access to the cache like drawItem() does, so that the cache policies know about it.
+  virtual void recordFrameAccess(int) {}
 
   // ----- Detection of source/file change events -----
 
@@ -266,6 +286,10 @@ signals:
   // restart the timer.
   void signalItemDoubleBufferLoaded();
 
+  // The item requests to show the given frame (e.g. the user wants to go to the next frame in which
+  // the inputs of a difference item differ).
+  void signalItemJumpToFrame(int frameIdx);
+
 protected:
   // The widget which is put into the stack.
   QScopedPointer<QWidget> propertiesWidget;
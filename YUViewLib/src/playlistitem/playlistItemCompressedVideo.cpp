@@ -36,7 +36,9 @@
 #include <QPlainTextEdit>
 #include <QThread>
 
+#include <algorithm>
 #include <inttypes.h>
+#include <memory>
 
 #include <common/YUViewDomElement.h>
 #include <common/Functions.h>
@@ -54,6 +56,8 @@
 #include <statistics/StatisticsDataPainting.h>
 #include <ui/Mainwindow.h>
 #include <ui_playlistItemCompressedFile_logDialog.h>
+#include <video/DiskFrameCache.h>
+#include <video/FrameBufferPool.h>
 #include <video/videoHandlerRGB.h>
 #include <video/videoHandlerYUV.h>
 
@@ -591,6 +595,36 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter,
   }
 }
 
+playlistItem::DrawFunction playlistItemCompressedVideo::getDrawFunction(int frameIdx, bool caching)
+{
+  if ((decodingNotPossibleAfter >= 0 && frameIdx >= decodingNotPossibleAfter) ||
+      unresolvableError || !decodingEnabled || loadingDecoder.isNull())
+    return {};
+  // A frame that is drawn while caching must still be valid if statistics are shown later on
+  if (caching && loadingDecoder->statisticsSupported())
+    return {};
+
+  const auto &statsTypes         = this->statisticsData.getStatisticsTypes();
+  const auto  statisticsRendered = std::any_of(
+      statsTypes.begin(), statsTypes.end(), [](const stats::StatisticsType &type) {
+        return type.render;
+      });
+  if (statisticsRendered &&
+      this->statisticsData.needsLoading(frameIdx) != ItemLoadingState::LoadingNotNeeded)
+    return {};
+
+  auto drawVideo = playlistItemWithVideo::getDrawFunction(frameIdx, caching);
+  if (!drawVideo || !statisticsRendered)
+    return drawVideo;
+
+  // The function is called from another thread. Draw a copy of the statistics of this frame.
+  auto statisticsData = std::make_shared<stats::StatisticsData>(this->statisticsData);
+  return [drawVideo, statisticsData, frameIdx](QPainter *painter, double zoomFactor) {
+    drawVideo(painter, zoomFactor);
+    stats::paintStatisticsData(painter, *statisticsData, frameIdx, zoomFactor);
+  };
+}
+
 void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
 {
   if (caching && !cachingEnabled)
@@ -621,6 +655,22 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
   auto dec         = caching ? cachingDecoder.data() : loadingDecoder.data();
   int  curFrameIdx = caching ? currentFrameIdx[1] : currentFrameIdx[0];
 
+  // The frame may have been decoded before (also in an earlier session). Statistics can only be
+  // retrieved by decoding the frame.
+  auto &diskCache = video::DiskFrameCache::instance();
+  if (diskCache.isEnabled() && !dec->statisticsEnabled())
+  {
+    auto data = diskCache.load(this->getDiskFrameCacheKey(frameIdx, dec));
+    if (!data.isEmpty())
+    {
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData frame " << frameIdx
+                                                                         << " from disk cache");
+      video::FrameBufferPool::instance().replace(video->rawData, data);
+      video->rawData_frameIndex = frameIdx;
+      return;
+    }
+  }
+
   // Should we seek?
   if (curFrameIdx == -1 || frameIdx < curFrameIdx ||
       frameIdx > curFrameIdx + FORWARD_SEEK_THRESHOLD)
@@ -783,8 +833,11 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
         {
           if (dec->statisticsEnabled())
             this->statisticsData.setFrameIndex(frameIdx);
-          video->rawData            = dec->getRawFrameData();
+          // The last frame goes back to the pool once the video handler does not use it anymore
+          video::FrameBufferPool::instance().replace(video->rawData, dec->getRawFrameData());
           video->rawData_frameIndex = frameIdx;
+          if (diskCache.isEnabled())
+            diskCache.store(this->getDiskFrameCacheKey(frameIdx, dec), video->rawData);
         }
       }
     }
@@ -821,6 +874,20 @@ void playlistItemCompressedVideo::loadRawData(int frameIdx, bool caching)
   }
 }
 
+video::DiskFrameCacheKey
+playlistItemCompressedVideo::getDiskFrameCacheKey(int frameIdx, decoder::decoderBase *dec) const
+{
+  QFileInfo fileInfo(this->properties().name);
+
+  video::DiskFrameCacheKey key;
+  key.filePath     = fileInfo.absoluteFilePath();
+  key.fileModified = fileInfo.lastModified();
+  key.decoder      = QString::fromStdString(DecoderEngineMapper.getName(this->decoderEngine));
+  key.decodeSignal = dec->getDecodeSignal();
+  key.frameIndex   = frameIdx;
+  return key;
+}
+
 void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int64_t seekToDTS, bool caching)
 {
   // Do the seek
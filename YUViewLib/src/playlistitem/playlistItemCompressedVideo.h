@@ -39,6 +39,7 @@
 #include <statistics/StatisticUIHandler.h>
 #include <statistics/StatisticsData.h>
 #include <ui_playlistItemCompressedFile.h>
+#include <video/DiskFrameCache.h>
 
 #include "playlistItemWithVideo.h"
 
@@ -77,6 +78,9 @@ public:
   // Draw the compressed item using the given painter and zoom factor.
   virtual void
   drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) override;
+  // The statistics are only drawn if they are loaded for the frame. While caching, this is only
+  // possible if the decoder can not provide statistics.
+  virtual DrawFunction getDrawFunction(int frameIdx, bool caching) override;
 
   // Return the source (YUV and statistics) values under the given pixel position.
   virtual ValuePairListSets getPixelValues(const QPoint &pixelPos, int frameIdx) override;
@@ -177,6 +181,9 @@ protected:
   // from the given position.
   void seekToPosition(int seekToFrame, int64_t seekToDTS, bool caching);
 
+  // The key of the given frame (decoded with the given decoder) in the DiskFrameCache
+  video::DiskFrameCacheKey getDiskFrameCacheKey(int frameIdx, decoder::decoderBase *dec) const;
+
   // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not switch
   // to retrieveing mode. In this case, we must re-push the packet for which pushing failed.
   bool repushData{};
@@ -230,6 +230,18 @@ void playlistItemContainer::updateSettings()
   }
 }
 
+int playlistItemContainer::cachingThreadLimit()
+{
+  int limit = -1;
+  for (int i = 0; i < childCount(); i++)
+  {
+    auto childLimit = getChildPlaylistItem(i)->cachingThreadLimit();
+    if (childLimit > 0 && (limit < 0 || childLimit < limit))
+      limit = childLimit;
+  }
+  return limit;
+}
+
 playlistItem *playlistItemContainer::getChildPlaylistItem(int index) const
 {
   if (index < 0 || index > childCount())
@@ -60,12 +60,16 @@ public:
   virtual void reloadItemSource()       override;  // Reload all child items
   virtual void updateSettings()         override;  // Install/remove the file watchers.
 
+  // A container that is cached derives its frames from the frames of the children which are loaded
+  // on the caching threads. So the most restrictive thread limit of the children applies.
+  virtual int cachingThreadLimit() override;
+
     // Return a list containing this item and all child items (if any).
   QList<playlistItem*> getAllChildPlaylistItems() const;
 
   // Return a list of all the child items (recursively) and remove (takeChild) them from the QTreeWidget tree 
   // structure and from the internal childList.
-  QList<playlistItem*> takeAllChildItemsRecursive();
+  virtual QList<playlistItem*> takeAllChildItemsRecursive();
 
 protected slots:
   virtual void childChanged(bool redraw, recacheIndicator recache);
@@ -60,11 +60,20 @@ playlistItemDifference::playlistItemDifference() : playlistItemContainer("Differ
   this->maxItemCount   = 2;
   this->frameLimitsMax = false;
   this->infoText       = DIFFERENCE_INFO_TEXT;
+  this->cachingEnabled = true;
 
   connect(&difference,
           &video::videoHandlerDifference::signalHandlerChanged,
           this,
           &playlistItemDifference::SignalItemChanged);
+  connect(&difference,
+          &video::videoHandlerDifference::signalSequenceScanRequested,
+          this,
+          [this]() { this->difference.startSequenceScan(this->properties().startEndRange); });
+  connect(&difference,
+          &video::videoHandlerDifference::signalJumpToFrame,
+          this,
+          &playlistItemDifference::signalItemJumpToFrame);
 }
 
 /* For a difference item, the info list is just a list of the names of the
@@ -249,7 +258,7 @@ void playlistItemDifference::loadFrame(int  frameIdx,
                  nextFrameIdx,
                  playing ? "(playing)" : "");
       isDifferenceLoadingToDoubleBuffer = true;
-      difference.loadFrameDifference(frameIdx, true);
+      difference.loadFrameDifference(nextFrameIdx, true);
       isDifferenceLoadingToDoubleBuffer = false;
       if (emitSignals)
         emit signalItemDoubleBufferLoaded();
@@ -267,7 +276,11 @@ bool playlistItemDifference::isLoadingDoubleBuffer() const
 void playlistItemDifference::childChanged(bool redraw, recacheIndicator recache)
 {
   // One of the child items changed and needs to redraw. This means that the difference is out of
-  // date and has to be recalculated.
-  difference.invalidateAllBuffers();
+  // date and has to be recalculated. If the frames of the child changed, the cached differences are
+  // also invalid. The recache is passed on to the video cache by the container.
+  difference.invalidateDerivedFrames(recache);
+  if (recache != RECACHE_NONE)
+    // The frames of the child changed. The results of a sequence scan are outdated.
+    difference.resetSequenceScan();
   playlistItemContainer::childChanged(redraw, recache);
 }
\ No newline at end of file
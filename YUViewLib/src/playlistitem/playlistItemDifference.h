@@ -60,6 +60,44 @@ public:
   virtual bool isLoading() const override;
   virtual bool isLoadingDoubleBuffer() const override;
 
+  // -- Caching
+  // The frames are derived from the children on the caching threads.
+  virtual bool isCachable() const override
+  {
+    return playlistItem::isCachable() && this->difference.inputsCachable();
+  }
+  virtual void cacheFrame(int frameIdx, bool testMode) override
+  {
+    if (this->isCachable())
+      this->difference.cacheFrame(frameIdx, testMode);
+  }
+  virtual QList<int> getCachedFrames() const override { return this->difference.getCachedFrames(); }
+  virtual int        getNumberCachedFrames() const override
+  {
+    return this->difference.getNumberCachedFrames();
+  }
+  virtual unsigned int getCachingFrameSize() const override
+  {
+    return this->difference.getCachedFrameSize();
+  }
+  virtual void removeFrameFromCache(int frameIdx) override
+  {
+    this->difference.removeFrameFromCache(frameIdx);
+  }
+  virtual void removeAllFramesFromCache() override { this->difference.removeAllFrameFromCache(); }
+  virtual video::CacheStatistics getCacheStatistics() const override
+  {
+    return this->difference.getCacheStatistics();
+  }
+  virtual uint64_t getFrameLastAccess(int frameIdx) const override
+  {
+    return this->difference.getFrameLastAccess(frameIdx);
+  }
+  virtual void recordFrameAccess(int frameIdx) override
+  {
+    this->difference.recordCacheAccess(frameIdx);
+  }
+
   // Overload from playlistItem. Save the playlist item to playlist.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const override;
   // Create a new playlistItemDifference from the playlist file entry. Return nullptr if parsing
@@ -35,6 +35,7 @@
 #include <QImageReader>
 #include <QSettings>
 #include <QUrl>
+#include <QtConcurrent>
 
 #include <common/FunctionsGui.h>
 #include <filesource/FileSource.h>
@@ -53,7 +54,7 @@ playlistItemImageFileSequence::playlistItemImageFileSequence(const QString &rawF
   isFrameLoading           = false;
 
   // Create the video handler
-  video.reset();
+  video = std::make_unique<video::videoHandler>();
 
   // Connect the basic signals from the video
   playlistItemWithVideo::connectVideo();
@@ -62,7 +63,8 @@ playlistItemImageFileSequence::playlistItemImageFileSequence(const QString &rawF
   connect(video.get(),
           &video::videoHandler::signalRequestFrame,
           this,
-          &playlistItemImageFileSequence::slotFrameRequest);
+          &playlistItemImageFileSequence::slotFrameRequest,
+          Qt::DirectConnection);
 
   if (!rawFilePath.isEmpty())
   {
@@ -279,20 +281,84 @@ void playlistItemImageFileSequence::getSupportedFileExtensions(QStringList &allE
   filters.append(filter);
 }
 
-void playlistItemImageFileSequence::slotFrameRequest(int frameIdx, bool)
+void playlistItemImageFileSequence::slotFrameRequest(int frameIdx, bool caching)
 {
   // Does the index/file exist?
-  if (frameIdx < 0 || frameIdx >= imageFiles.count())
-    return;
-  QFileInfo fileInfo(imageFiles[frameIdx]);
-  if (!fileInfo.exists() || !fileInfo.isFile())
+  if (!this->frameFileExists(frameIdx))
     return;
 
+  // Start decoding the next frames before we wait for this one
+  this->readAhead(frameIdx, caching);
+
+  // Take the frame from the read ahead or decode it now
+  QImage image;
+  for (auto &frames : this->readAheadFrames)
+  {
+    if (frames.contains(frameIdx))
+    {
+      image = frames.take(frameIdx).result();
+      break;
+    }
+  }
+  if (image.isNull())
+    image = loadImage(this->imageFiles[frameIdx]);
+
   // Load the given frame
-  video->requestedFrame     = QImage(imageFiles[frameIdx]);
+  video->requestedFrame     = image;
   video->requestedFrame_idx = frameIdx;
 }
 
+QImage playlistItemImageFileSequence::loadImage(const QString &filePath)
+{
+  return QImage(filePath);
+}
+
+bool playlistItemImageFileSequence::frameFileExists(int frameIdx)
+{
+  if (frameIdx < 0 || frameIdx >= this->imageFiles.count())
+    return false;
+
+  auto it = this->fileExistsCache.find(frameIdx);
+  if (it == this->fileExistsCache.end())
+  {
+    QFileInfo fileInfo(this->imageFiles[frameIdx]);
+    it = this->fileExistsCache.insert(frameIdx, fileInfo.exists() && fileInfo.isFile());
+  }
+  return it.value();
+}
+
+void playlistItemImageFileSequence::readAhead(int frameIdx, bool caching)
+{
+  auto &     lastFrame = this->lastRequestedFrame[caching ? 1 : 0];
+  const auto direction = (lastFrame != -1 && frameIdx < lastFrame) ? -1 : 1;
+  lastFrame            = frameIdx;
+
+  QList<int> framesAhead;
+  const auto nrFramesAhead = this->decoderPool.maxThreadCount() * 2;
+  for (int i = 1; i <= nrFramesAhead; i++)
+    framesAhead.append(frameIdx + i * direction);
+
+  // Forget about the frames that are not ahead anymore. Running decodes just finish.
+  auto &frames = this->readAheadFrames[caching ? 1 : 0];
+  for (auto it = frames.begin(); it != frames.end();)
+  {
+    if (framesAhead.contains(it.key()))
+      it++;
+    else
+      it = frames.erase(it);
+  }
+
+  for (auto idx : framesAhead)
+  {
+    if (frames.contains(idx) || !this->frameFileExists(idx) || video->isInCache(idx))
+      continue;
+    const auto filePath = this->imageFiles[idx];
+    frames.insert(idx, QtConcurrent::run(&this->decoderPool, [filePath]() {
+                    return loadImage(filePath);
+                  }));
+  }
+}
+
 void playlistItemImageFileSequence::setInternals(const QString &filePath)
 {
   // Set start end frame and frame size if it has not been set yet.
@@ -309,7 +375,7 @@ void playlistItemImageFileSequence::setInternals(const QString &filePath)
     video->setFrameSize(Size(s.width(), s.height()));
   }
 
-  cachingEnabled = false;
+  cachingEnabled = true;
 
   // Set the internal name
   QFileInfo fi(filePath);
@@ -333,6 +399,12 @@ void playlistItemImageFileSequence::reloadItemSource()
 {
   // Clear the video's buffers. The video will ask to reload the images.
   video->invalidateAllBuffers();
+
+  // The files may have been changed, added or removed. The frame requests use these buffers.
+  QMutexLocker lock(&video->requestDataMutex);
+  this->fileExistsCache.clear();
+  for (auto &frames : this->readAheadFrames)
+    frames.clear();
 }
 
 void playlistItemImageFileSequence::updateSettings()
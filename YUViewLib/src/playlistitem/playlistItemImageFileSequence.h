@@ -34,6 +34,8 @@
 
 #include <QFileSystemWatcher>
 #include <QFuture>
+#include <QHash>
+#include <QThreadPool>
 #include "playlistItemWithVideo.h"
 #include "playlistItemRawFile.h"
 #include "video/videoHandler.h"
@@ -73,6 +75,10 @@ public:
   // Is an image currently being loaded?
   virtual bool isLoading() const override { return isFrameLoading; }
 
+  // The images are decoded in parallel by the decoder pool (see readAhead()). One caching thread
+  // that requests the frames in order is enough to keep it busy.
+  virtual int cachingThreadLimit() override { return 1; }
+
 private slots:
   // Load the given frame from file. This slot is called by the videoHandler if the frame that is
   // requested to be drawn has not been loaded yet.
@@ -97,6 +103,21 @@ private:
   // Fill the given imageFiles list with all the files that can be found for the given file.
   static void fillImageFileList(QStringList &imageFiles, const QString &filePath);
   QStringList imageFiles;
+
+  // Decode the image from the given file. This can be called from any thread.
+  static QImage loadImage(const QString &filePath);
+
+  // Does the file of the given frame exist? The file system is only checked once per frame (until
+  // the item source is reloaded).
+  bool frameFileExists(int frameIdx);
+  QHash<int, bool> fileExistsCache;
+
+  // Start decoding the next frames after the requested one (in the direction of the requests) in
+  // the decoder pool. Interactive loading and caching (index 0/1) each have their own read ahead.
+  void readAhead(int frameIdx, bool caching);
+  QThreadPool                decoderPool;
+  QMap<int, QFuture<QImage>> readAheadFrames[2];
+  int                        lastRequestedFrame[2]{-1, -1};
   
   // This is true if the sequence was loaded from playlist and a frame is missing
   bool loadPlaylistFrameMissing;
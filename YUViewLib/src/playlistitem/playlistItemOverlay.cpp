@@ -36,6 +36,7 @@
 
 #include <QPainter>
 #include <QPointer>
+#include <QtConcurrent>
 #include <cmath>
 #include <limits>
 
@@ -60,8 +61,44 @@ const EnumMapper<OverlayLayoutMode>
                              {OverlayLayoutMode::Arange, "Average"},
                              {OverlayLayoutMode::Custom, "Custom"}});
 
+// Composites with more pixels are not made. The children are drawn directly instead.
+constexpr int64_t COMPOSITE_MAX_PIXELS = int64_t(4096) * 4096;
+// The number of composites of recently drawn frames that are kept
+constexpr int COMPOSITE_MAX_DRAWN = 4;
+
+double getZoomBucket(double zoomFactor)
+{
+  return std::pow(2.0, std::ceil(std::log2(zoomFactor)));
+}
+
+QSize getCompositeSize(const QRect &boundingRect, double zoomBucket)
+{
+  return QSize(int(boundingRect.width() * zoomBucket), int(boundingRect.height() * zoomBucket));
 }
 
+bool isCompositeSizeValid(const QRect &boundingRect, double zoomBucket)
+{
+  const auto size = getCompositeSize(boundingRect, zoomBucket);
+  return !size.isEmpty() && int64_t(size.width()) * size.height() <= COMPOSITE_MAX_PIXELS;
+}
+
+// Draw the children like playlistItemOverlay::drawItem() does
+void drawChildren(QPainter *                               painter,
+                  const QList<QRect> &                     childItemRects,
+                  const QList<playlistItem::DrawFunction> &drawFunctions,
+                  double                                   zoomFactor)
+{
+  for (int i = 0; i < drawFunctions.count(); i++)
+  {
+    auto center = centerRoundTL(childItemRects[i]);
+    painter->translate(center * zoomFactor);
+    drawFunctions[i](painter, zoomFactor);
+    painter->translate(center * zoomFactor * -1);
+  }
+}
+
+} // namespace
+
 playlistItemOverlay::playlistItemOverlay() : playlistItemContainer("Overlay Item")
 {
   this->setIcon(0, functionsGui::convertIcon(":img_overlay.png"));
@@ -74,8 +111,18 @@ playlistItemOverlay::playlistItemOverlay() : playlistItemContainer("Overlay Item
   this->infoText =
       "Please drop some items onto this overlay. All child items will be drawn on top of "
       "each other.";
+
+  // The children are composited on the caching threads if they can be cached
+  this->cachingEnabled = true;
+
+  connect(&this->compositeWatcher,
+          &QFutureWatcher<QImage>::finished,
+          this,
+          &playlistItemOverlay::compositeFinished);
 }
 
+playlistItemOverlay::~playlistItemOverlay() { this->compositeWatcher.waitForFinished(); }
+
 /* For an overlay item, the info list is just a list of the names of the
  * child elements.
  */
@@ -135,6 +182,14 @@ ValuePairListSets playlistItemOverlay::getPixelValues(const QPoint &pixelPos, in
 
 ItemLoadingState playlistItemOverlay::needsLoading(int frameIdx, bool loadRawdata)
 {
+  // The cached composite is drawn instead of the children. Only the raw values must be loaded by
+  // the children.
+  if (!loadRawdata && this->isCompositeCached(frameIdx))
+  {
+    DEBUG_OVERLAY("playlistItemOverlay::needsLoading LoadingNotNeeded composite cached");
+    return ItemLoadingState::LoadingNotNeeded;
+  }
+
   // The overlay needs to load if one of the child items needs to load
   for (int i = 0; i < this->childCount(); i++)
   {
@@ -182,6 +237,49 @@ void playlistItemOverlay::drawItem(QPainter *painter,
 
   // Update the layout if the number of items changedupdateLayout
   this->updateLayout();
+  this->recordCacheAccess(frameIdx);
+
+  // Draw a composite of the children if there is one. The raw values can only be drawn by the
+  // children themselves.
+  const auto drawValues = drawRawData && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR;
+  const auto zoomBucket = getZoomBucket(zoomFactor);
+  if (!drawValues)
+  {
+    const QRectF compositeRect(
+        QPointF(this->boundingRect.topLeft() - centerRoundTL(this->boundingRect)) * zoomFactor,
+        QSizeF(this->boundingRect.size()) * zoomFactor);
+
+    for (int i = 0; i < this->composites.count(); i++)
+    {
+      if (this->composites[i].frameIdx == frameIdx &&
+          this->composites[i].zoomBucket == zoomBucket)
+      {
+        this->composites.move(i, 0);
+        painter->drawImage(compositeRect, this->composites.first().image);
+        this->recordChildFrameAccess(frameIdx);
+        return;
+      }
+    }
+
+    QMutexLocker lock(&this->compositeMutex);
+    const auto   cachedComposite = this->cachedComposites.value(frameIdx);
+    lock.unlock();
+    if (!cachedComposite.isNull())
+    {
+      painter->drawImage(compositeRect,
+                         this->cachedCompositePyramid.getImageForZoom(cachedComposite, zoomFactor));
+      this->recordChildFrameAccess(frameIdx);
+      return;
+    }
+
+    // The view and the zoom box draw the item with different zoom factors
+    const auto drawn = qMakePair(frameIdx, zoomBucket);
+    if (this->drawnWithoutComposite.removeOne(drawn))
+      this->startComposite(frameIdx, zoomBucket);
+    this->drawnWithoutComposite.prepend(drawn);
+    while (this->drawnWithoutComposite.count() > COMPOSITE_MAX_DRAWN)
+      this->drawnWithoutComposite.removeLast();
+  }
 
   // Translate to the center of this overlay item
   painter->translate(centerRoundTL(boundingRect) * zoomFactor * -1);
@@ -202,6 +300,280 @@ void playlistItemOverlay::drawItem(QPainter *painter,
   painter->translate(centerRoundTL(boundingRect) * zoomFactor);
 }
 
+playlistItem::DrawFunction playlistItemOverlay::getDrawFunction(int frameIdx, bool caching)
+{
+  QMutexLocker lock(&this->compositeMutex);
+  const auto   layout = this->compositeLayout;
+  lock.unlock();
+
+  const auto drawFunctions = getChildDrawFunctions(layout, frameIdx, caching);
+  if (drawFunctions.isEmpty())
+    return {};
+
+  return [layout, drawFunctions](QPainter *painter, double zoomFactor) {
+    const auto center = centerRoundTL(layout.boundingRect);
+    painter->translate(center * zoomFactor * -1);
+    drawChildren(painter, layout.childItemRects, drawFunctions, zoomFactor);
+    painter->translate(center * zoomFactor);
+  };
+}
+
+QList<playlistItem::DrawFunction> playlistItemOverlay::getChildDrawFunctions(
+    const CompositeLayout &layout, int frameIdx, bool caching)
+{
+  QList<DrawFunction> drawFunctions;
+  for (const auto &childItem : layout.childItems)
+  {
+    auto drawFunction = childItem ? childItem->getDrawFunction(frameIdx, caching) : DrawFunction();
+    if (!drawFunction)
+      return {};
+    drawFunctions.append(drawFunction);
+  }
+  return drawFunctions;
+}
+
+QImage playlistItemOverlay::compositeChildren(const CompositeLayout &    layout,
+                                              const QList<DrawFunction> &drawFunctions,
+                                              double                     zoomBucket)
+{
+  QImage composite(getCompositeSize(layout.boundingRect, zoomBucket),
+                   QImage::Format_ARGB32_Premultiplied);
+  composite.fill(Qt::transparent);
+
+  QPainter painter(&composite);
+  painter.translate(layout.boundingRect.topLeft() * zoomBucket * -1);
+  drawChildren(&painter, layout.childItemRects, drawFunctions, zoomBucket);
+  return composite;
+}
+
+void playlistItemOverlay::startComposite(int frameIdx, double zoomBucket)
+{
+  if (this->compositeWatcher.isRunning())
+    return;
+
+  QMutexLocker lock(&this->compositeMutex);
+  const auto   layout = this->compositeLayout;
+  lock.unlock();
+
+  if (!isCompositeSizeValid(layout.boundingRect, zoomBucket))
+    return;
+  const auto drawFunctions = getChildDrawFunctions(layout, frameIdx, false);
+  if (drawFunctions.isEmpty())
+    return;
+
+  DEBUG_OVERLAY("playlistItemOverlay::startComposite frame %d zoom %f", frameIdx, zoomBucket);
+  this->compositeInProgress.frameIdx   = frameIdx;
+  this->compositeInProgress.zoomBucket = zoomBucket;
+  this->compositeInProgressGeneration  = this->compositeGeneration;
+  this->compositeWatcher.setFuture(QtConcurrent::run([layout, drawFunctions, zoomBucket]() {
+    return compositeChildren(layout, drawFunctions, zoomBucket);
+  }));
+}
+
+void playlistItemOverlay::compositeFinished()
+{
+  if (this->compositeInProgressGeneration != this->compositeGeneration)
+    // The children changed in the meantime
+    return;
+
+  auto composite  = this->compositeInProgress;
+  composite.image = this->compositeWatcher.result();
+  if (composite.image.isNull())
+    return;
+
+  this->composites.prepend(composite);
+  while (this->composites.count() > COMPOSITE_MAX_DRAWN)
+    this->composites.removeLast();
+
+  // Draw the composite
+  emit SignalItemChanged(true, RECACHE_NONE);
+}
+
+void playlistItemOverlay::invalidateComposites(bool clearCache)
+{
+  this->composites.clear();
+  this->compositeGeneration++;
+
+  if (clearCache)
+  {
+    QMutexLocker lock(&this->compositeMutex);
+    this->cachedComposites.clear();
+    this->cachedCompositeAccess.clear();
+    this->cacheGeneration++;
+  }
+}
+
+void playlistItemOverlay::updateCompositeLayout()
+{
+  CompositeLayout layout;
+  layout.boundingRect   = this->boundingRect;
+  layout.childItemRects = this->childItemRects;
+  for (int i = 0; i < this->childCount(); i++)
+    layout.childItems.append(this->getChildPlaylistItem(i));
+
+  QMutexLocker lock(&this->compositeMutex);
+  if (layout.boundingRect == this->compositeLayout.boundingRect &&
+      layout.childItemRects == this->compositeLayout.childItemRects &&
+      layout.childItems == this->compositeLayout.childItems)
+    return;
+
+  DEBUG_OVERLAY("playlistItemOverlay::updateCompositeLayout layout changed");
+  this->compositeLayout   = layout;
+  const auto cacheCleared = !this->cachedComposites.isEmpty();
+  lock.unlock();
+
+  this->invalidateComposites(true);
+  if (cacheCleared)
+    emit SignalItemChanged(false, RECACHE_CLEAR);
+}
+
+void playlistItemOverlay::itemAboutToBeDeleted(playlistItem *item)
+{
+  // The composite in progress may still draw the child
+  this->compositeWatcher.waitForFinished();
+  playlistItemContainer::itemAboutToBeDeleted(item);
+  this->updateLayout();
+}
+
+QList<playlistItem *> playlistItemOverlay::takeAllChildItemsRecursive()
+{
+  this->compositeWatcher.waitForFinished();
+  return playlistItemContainer::takeAllChildItemsRecursive();
+}
+
+bool playlistItemOverlay::isCachable() const
+{
+  if (!playlistItem::isCachable())
+    return false;
+
+  QMutexLocker lock(&this->compositeMutex);
+  if (this->compositeLayout.childItems.isEmpty() ||
+      !isCompositeSizeValid(this->compositeLayout.boundingRect, 1.0))
+    return false;
+  for (const auto &childItem : this->compositeLayout.childItems)
+    if (!childItem || !childItem->isCachable())
+      return false;
+  return true;
+}
+
+void playlistItemOverlay::recordChildFrameAccess(int frameIdx)
+{
+  // The children are not drawn. So they do not update their current image or decompress the next
+  // frames from their caches. The cached frames of the children are not needed to draw the
+  // composites, but their caches still know when the frames were shown.
+  for (int i = 0; i < this->childCount(); i++)
+    if (auto childItem = this->getChildPlaylistItem(i))
+      childItem->recordFrameAccess(frameIdx);
+}
+
+void playlistItemOverlay::cacheFrame(int frameIdx, bool testMode)
+{
+  if (!playlistItem::isCachable())
+    return;
+
+  QMutexLocker lock(&this->compositeMutex);
+  if (!testMode && this->cachedComposites.contains(frameIdx))
+    return;
+  const auto layout     = this->compositeLayout;
+  const auto generation = this->cacheGeneration;
+  lock.unlock();
+
+  if (!isCompositeSizeValid(layout.boundingRect, 1.0))
+    return;
+  const auto drawFunctions = getChildDrawFunctions(layout, frameIdx, true);
+  if (drawFunctions.isEmpty())
+    return;
+
+  const auto composite = compositeChildren(layout, drawFunctions, 1.0);
+  if (testMode || composite.isNull())
+    return;
+
+  lock.relock();
+  if (generation == this->cacheGeneration)
+  {
+    this->cachedComposites[frameIdx]      = composite;
+    this->cachedCompositeAccess[frameIdx] = video::nextCacheAccessTick();
+  }
+}
+
+QList<int> playlistItemOverlay::getCachedFrames() const
+{
+  QMutexLocker lock(&this->compositeMutex);
+  return this->cachedComposites.keys();
+}
+
+int playlistItemOverlay::getNumberCachedFrames() const
+{
+  QMutexLocker lock(&this->compositeMutex);
+  return this->cachedComposites.count();
+}
+
+unsigned int playlistItemOverlay::getCachingFrameSize() const
+{
+  QMutexLocker lock(&this->compositeMutex);
+  const auto   size = getCompositeSize(this->compositeLayout.boundingRect, 1.0);
+  return unsigned(size.width()) * unsigned(size.height()) * 4;
+}
+
+void playlistItemOverlay::removeFrameFromCache(int frameIdx)
+{
+  QMutexLocker lock(&this->compositeMutex);
+  if (this->cachedComposites.remove(frameIdx) > 0)
+    this->cacheStatistics.evictions++;
+  this->cachedCompositeAccess.remove(frameIdx);
+}
+
+void playlistItemOverlay::removeAllFramesFromCache()
+{
+  QMutexLocker lock(&this->compositeMutex);
+  this->cachedComposites.clear();
+  this->cachedCompositeAccess.clear();
+  this->cacheGeneration++;
+}
+
+bool playlistItemOverlay::isCompositeCached(int frameIdx) const
+{
+  QMutexLocker lock(&this->compositeMutex);
+  return this->cachedComposites.contains(frameIdx);
+}
+
+video::CacheStatistics playlistItemOverlay::getCacheStatistics() const
+{
+  QMutexLocker lock(&this->compositeMutex);
+  auto         statistics = this->cacheStatistics;
+  for (const auto &composite : this->cachedComposites)
+    statistics.bytes += int64_t(composite.bytesPerLine()) * composite.height();
+  return statistics;
+}
+
+uint64_t playlistItemOverlay::getFrameLastAccess(int frameIdx) const
+{
+  QMutexLocker lock(&this->compositeMutex);
+  return this->cachedCompositeAccess.value(frameIdx, 0);
+}
+
+void playlistItemOverlay::recordFrameAccess(int frameIdx)
+{
+  this->recordCacheAccess(frameIdx);
+  this->recordChildFrameAccess(frameIdx);
+}
+
+void playlistItemOverlay::recordCacheAccess(int frameIdx)
+{
+  if (frameIdx == this->lastAccessedFrameIdx)
+    return;
+  this->lastAccessedFrameIdx = frameIdx;
+
+  QMutexLocker lock(&this->compositeMutex);
+  if (this->cachedComposites.contains(frameIdx))
+  {
+    this->cacheStatistics.hits++;
+    this->cachedCompositeAccess[frameIdx] = video::nextCacheAccessTick();
+  }
+  else
+    this->cacheStatistics.misses++;
+}
+
 QSize playlistItemOverlay::getSize() const
 {
   if (this->childCount() == 0)
@@ -217,6 +589,7 @@ void playlistItemOverlay::updateLayout(bool onlyIfItemsChanged)
     this->childItemRects.clear();
     this->childItemsIDs.clear();
     this->boundingRect = QRect();
+    this->updateCompositeLayout();
     return;
   }
 
@@ -403,6 +776,8 @@ void playlistItemOverlay::updateLayout(bool onlyIfItemsChanged)
       this->boundingRect = this->boundingRect.united(targetRect);
     }
   }
+
+  this->updateCompositeLayout();
 }
 
 void playlistItemOverlay::createPropertiesWidget()
@@ -585,6 +960,10 @@ void playlistItemOverlay::slotControlChanged()
 
 void playlistItemOverlay::childChanged(bool redraw, recacheIndicator recache)
 {
+  // The composites are outdated. If the frames of a child changed, the cached composites are also
+  // invalid. The recache is passed on to the video cache by the container.
+  if (redraw || recache != RECACHE_NONE)
+    this->invalidateComposites(recache == RECACHE_CLEAR);
   if (redraw)
     this->updateLayout(false);
 
@@ -630,6 +1009,10 @@ void playlistItemOverlay::onGroupBoxToggled(int idx, bool on)
 
 void playlistItemOverlay::loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals)
 {
+  // The children do not need to load a frame that is drawn from the cached composite
+  if (!loadRawData && this->isCompositeCached(frameIdx))
+    return;
+
   // Does one of the items need loading?
   bool itemLoadedDoubleBuffer = false;
   bool itemLoaded             = false;
@@ -36,8 +36,12 @@
 
 #include "playlistItemContainer.h"
 #include "ui_playlistItemOverlay.h"
+#include "video/ImagePyramid.h"
 
+#include <QFutureWatcher>
 #include <QGridLayout>
+#include <QMutex>
+#include <QPointer>
 
 enum class OverlayLayoutMode
 {
@@ -52,6 +56,7 @@ class playlistItemOverlay : public playlistItemContainer
 
 public:
   playlistItemOverlay();
+  virtual ~playlistItemOverlay();
 
   virtual InfoData getInfo() const override;
 
@@ -62,9 +67,11 @@ public:
   // children are not comparable.
   virtual void
   drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) override;
+  // Draw all children like drawItem(). Only possible if all children provide a draw function.
+  virtual DrawFunction getDrawFunction(int frameIdx, bool caching) override;
 
   // The overlay item itself does not need to load anything. We just pass all of these to the child
-  // items.
+  // items. If the composite of the frame is cached, the children do not need to load it.
   virtual ItemLoadingState needsLoading(int frameIdx, bool loadRawData) override;
   // Load the frame in the video item. Emit SignalItemChanged(true,false) when done. Always called
   // from a thread.
@@ -86,6 +93,25 @@ public:
 
   void guessBestLayout();
 
+  // Wait until the composite that is made in the background is done before children are removed
+  virtual void                  itemAboutToBeDeleted(playlistItem *item) override;
+  virtual QList<playlistItem *> takeAllChildItemsRecursive() override;
+
+  // -- Caching
+  // The children are composited (with a zoom factor of 1) on the caching threads. This is possible
+  // if all children can be cached.
+  virtual bool         isCachable() const override;
+  virtual void         cacheFrame(int frameIdx, bool testMode) override;
+  virtual QList<int>   getCachedFrames() const override;
+  virtual int          getNumberCachedFrames() const override;
+  virtual unsigned int getCachingFrameSize() const override;
+  virtual void         removeFrameFromCache(int frameIdx) override;
+  virtual void         removeAllFramesFromCache() override;
+
+  virtual video::CacheStatistics getCacheStatistics() const override;
+  virtual uint64_t               getFrameLastAccess(int frameIdx) const override;
+  virtual void                   recordFrameAccess(int frameIdx) override;
+
 private:
   OverlayLayoutMode layoutMode{OverlayLayoutMode::Overlay};
 
@@ -115,8 +141,73 @@ private:
   int               arangementMode{0};
   QMap<int, QPoint> customPositions;
 
+  // ----- Compositing -----
+  // Instead of drawing all children in every paint event, the children are composited into one
+  // image in the background. A composite is made for a frame and a zoom bucket (the zoom factor
+  // rounded up to the next power of two) and is drawn scaled to the actual zoom factor.
+
+  // A copy of the layout that the composites are made with. Unlike the layout above, this can be
+  // used from the caching threads (protected by compositeMutex).
+  struct CompositeLayout
+  {
+    QRect                         boundingRect;
+    QList<QRect>                  childItemRects;
+    QList<QPointer<playlistItem>> childItems;
+  };
+  CompositeLayout compositeLayout;
+  // Update the compositeLayout from the layout. If it changed, all composites are invalid.
+  void updateCompositeLayout();
+
+  // Get the draw functions of all children (empty if one of the children can not provide one) and
+  // composite them into one image.
+  static QList<DrawFunction>
+                getChildDrawFunctions(const CompositeLayout &layout, int frameIdx, bool caching);
+  static QImage compositeChildren(const CompositeLayout &    layout,
+                                  const QList<DrawFunction> &drawFunctions,
+                                  double                     zoomBucket);
+
+  struct Composite
+  {
+    int    frameIdx{-1};
+    double zoomBucket{};
+    QImage image;
+  };
+  // The composites of the frames that were drawn recently (the most recent one first)
+  QList<Composite> composites;
+  // A composite is only made if a frame is drawn with the same zoom bucket again. So nothing is
+  // composited while playing back. These are the frames and zoom buckets that were drawn recently.
+  QList<QPair<int, double>> drawnWithoutComposite;
+  // Composite the frame in the background (if no other composite is in progress)
+  void                   startComposite(int frameIdx, double zoomBucket);
+  QFutureWatcher<QImage> compositeWatcher;
+  Composite              compositeInProgress;
+  // Incremented when the composites become invalid. A composite that was started before is
+  // discarded when it is done.
+  unsigned compositeGeneration{};
+  unsigned compositeInProgressGeneration{};
+  // Clear the composites. If clearCache is set, the cached composites are also cleared.
+  void invalidateComposites(bool clearCache);
+
+  // The composites made by the caching threads (with a zoom factor of 1). These and the
+  // cacheGeneration are protected by compositeMutex.
+  QMap<int, QImage>   cachedComposites;
+  unsigned            cacheGeneration{};
+  mutable QMutex      compositeMutex;
+  video::ImagePyramid cachedCompositePyramid;
+  bool                isCompositeCached(int frameIdx) const;
+
+  // The statistics and the last access of the cached composites like a videoHandler keeps them for
+  // its cache (also protected by compositeMutex)
+  video::CacheStatistics cacheStatistics;
+  QHash<int, uint64_t>   cachedCompositeAccess;
+  int                    lastAccessedFrameIdx{-1};
+  void                   recordCacheAccess(int frameIdx);
+  // A composite is drawn instead of the children. Tell the children that their frame was shown.
+  void recordChildFrameAccess(int frameIdx);
+
 private slots:
   void slotControlChanged();
+  void compositeFinished();
   void childChanged(bool redraw, recacheIndicator recache) override;
 
   void on_overlayGroupBox_toggled(bool on) { this->onGroupBoxToggled(0, on); }
@@ -33,12 +33,15 @@
 #include "playlistItemRawFile.h"
 
 #include <QPainter>
+#include <QTimerEvent>
 #include <QUrl>
 #include <QVBoxLayout>
+#include <QtConcurrent>
 
 #include <common/Functions.h>
 #include <common/FunctionsGui.h>
 #include <handler/ItemMemoryHandler.h>
+#include <video/FrameBufferPool.h>
 
 // Activate this if you want to know when which buffer is loaded/converted to image and so on.
 #define PLAYLISTITEMRAWFILE_DEBUG_LOADING 0
@@ -48,6 +51,32 @@
 #define DEBUG_RAWFILE(f) ((void)0)
 #endif
 
+namespace
+{
+
+// The frame parameters are optional and short. Longer frame headers are not supported.
+constexpr auto Y4M_MAX_FRAME_HEADER_LENGTH = 256;
+// When indexing the frames, read at least this many bytes at once so that one read covers the
+// headers of several small frames.
+constexpr auto Y4M_INDEX_READ_SIZE = 1024 * 1024;
+// How many frame headers (evenly spaced over the file) are checked to confirm a constant distance
+constexpr auto Y4M_NR_HEADER_CHECKS = 16;
+
+// Parse the 'FRAME' indicator and the frame parameters (which we ignore) terminated by a 0x0A
+// byte. Return the length of the frame header or 0 if there is no valid frame header.
+int parseY4MFrameHeader(const char *data, int64_t size)
+{
+  size = std::min(size, int64_t(Y4M_MAX_FRAME_HEADER_LENGTH));
+  if (size < 6 || QByteArray::fromRawData(data, 5) != "FRAME")
+    return 0;
+  for (int i = 5; i < size; i++)
+    if (data[i] == 10)
+      return i + 1;
+  return 0;
+}
+
+} // namespace
+
 playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath,
                                          const QSize    qFrameSize,
                                          const QString &sourcePixelFormat,
@@ -108,10 +137,15 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath,
 
     if (!this->video->isFormatValid())
     {
-      // Load 24883200 bytes from the input and try to get the format from the correlation.
-      QByteArray rawData;
-      this->dataSource.readBytes(rawData, 0, 24883200);
-      this->video->setFormatFromCorrelation(rawData, this->dataSource.getFileSize());
+      // Try to get the format from the correlation. Only a few lines of the first two frames
+      // are read from the file.
+      auto reader = [this](int64_t position, int64_t nrBytes) {
+        QByteArray data;
+        const auto nrBytesRead = this->dataSource.readBytes(data, position, nrBytes);
+        data.resize(nrBytesRead > 0 ? int(nrBytesRead) : 0);
+        return data;
+      };
+      this->video->setFormatFromCorrelation(reader, this->dataSource.getFileSize());
     }
   }
   else
@@ -146,6 +180,11 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath,
   this->cachingEnabled = true;
 }
 
+playlistItemRawFile::~playlistItemRawFile()
+{
+  this->stopY4MIndexing();
+}
+
 void playlistItemRawFile::updateStartEndRange()
 {
   if (!this->dataSource.isOk() || !this->video->isFormatValid())
@@ -156,7 +195,7 @@ void playlistItemRawFile::updateStartEndRange()
 
   auto nrFrames = 0;
   if (this->isY4MFile)
-    nrFrames = this->y4mFrameIndices.count();
+    nrFrames = this->getY4MNumberFrames();
   else
   {
     auto bpf = this->video->getBytesPerFrame();
@@ -206,6 +245,15 @@ bool playlistItemRawFile::parseY4MFile()
 {
   // Read a chunck of data from the file. Thecnically, the header can be arbitrarily long, but in
   // practice, 512 bytes should cover the length of all headers
+  // Forget the index of an earlier parsing (the file may have changed)
+  this->stopY4MIndexing();
+  this->y4mFrameDistance = 0;
+  this->y4mNrFrames      = 0;
+  {
+    QMutexLocker locker(&this->y4mFrameIndicesMutex);
+    this->y4mFrameIndices.clear();
+  }
+
   QByteArray rawData;
   this->dataSource.readBytes(rawData, 0, 512);
 
@@ -356,49 +404,145 @@ bool playlistItemRawFile::parseY4MFile()
   if (format.getBitsPerSample() > 8)
     stride *= 2;
 
-  while (true)
+  // Parse the first frame header
+  const auto readSize     = Y4M_MAX_FRAME_HEADER_LENGTH;
+  const auto nrBytes      = this->dataSource.readBytes(rawData, offset, readSize);
+  const auto headerLength = parseY4MFrameHeader(rawData.constData(), nrBytes);
+  if (headerLength == 0)
+    return setError("Error parsing the Y4M header: Could not locate the first 'FRAME' indicator.");
+
+  this->video->setFrameSize(Size(width, height));
+  this->getYUVVideo()->setPixelFormatYUV(format);
+
+  if (this->checkY4MConstantFrameDistance(offset, headerLength, stride))
+  {
+    DEBUG_RAWFILE("playlistItemRawFile::parseY4MFile Y4M Parsing complete. Found "
+                  << this->y4mNrFrames << " frames with a constant distance");
+    return true;
+  }
+
+  // Index the first frame now and all other frames in the background
+  {
+    QMutexLocker locker(&this->y4mFrameIndicesMutex);
+    this->y4mFrameIndices.append(offset + headerLength);
+  }
+  const auto nextHeaderOffset = offset + headerLength + int64_t(stride);
+  this->y4mIndexBreak.store(false);
+  this->y4mIndexFuture = QtConcurrent::run(
+      [this, nextHeaderOffset, stride]() { this->indexY4MFrames(nextHeaderOffset, stride); });
+  this->y4mIndexTimer.start(1000, this);
+
+  DEBUG_RAWFILE("playlistItemRawFile::parseY4MFile Y4M header parsed. Indexing in the background.");
+  return true;
+}
+
+bool playlistItemRawFile::checkY4MConstantFrameDistance(int64_t firstHeaderOffset,
+                                                        int     headerLength,
+                                                        int64_t frameDataSize)
+{
+  const auto frameDistance = int64_t(headerLength) + frameDataSize;
+  const auto dataSize      = this->dataSource.getFileSize() - firstHeaderOffset;
+  if (frameDistance <= 0 || dataSize % frameDistance != 0)
+    return false;
+
+  // Check the headers of some frames including the last one
+  const auto nrFrames = dataSize / frameDistance;
+  QByteArray header;
+  for (int i = 1; i <= Y4M_NR_HEADER_CHECKS; i++)
+  {
+    const auto frameIdx    = (nrFrames - 1) * i / Y4M_NR_HEADER_CHECKS;
+    const auto offset      = firstHeaderOffset + frameIdx * frameDistance;
+    const auto nrBytesRead = this->dataSource.readBytes(header, offset, headerLength);
+    if (parseY4MFrameHeader(header.constData(), nrBytesRead) != headerLength)
+      return false;
+  }
+
+  this->y4mFirstFrameOffset = firstHeaderOffset + headerLength;
+  this->y4mFrameDistance    = frameDistance;
+  this->y4mNrFrames         = int(nrFrames);
+  return true;
+}
+
+void playlistItemRawFile::indexY4MFrames(int64_t offset, int64_t frameDataSize)
+{
+  // If the frames are small, one read covers the headers of several frames
+  const auto readSize =
+      frameDataSize < Y4M_INDEX_READ_SIZE ? Y4M_INDEX_READ_SIZE : Y4M_MAX_FRAME_HEADER_LENGTH;
+  const auto fileSize = this->dataSource.getFileSize();
+
+  QByteArray buffer;
+  int64_t    bufferStart = 0;
+  int64_t    bufferSize  = 0;
+  while (!this->y4mIndexBreak.load() && offset < fileSize)
   {
-    // Seek the file to 'offset' and read a few bytes
-    if (this->dataSource.readBytes(rawData, offset, 20) < 20)
-      return setError("Error parsing the Y4M header: The file ended unexpectedly.");
-
-    auto frameIndicator = rawData.mid(0, 5);
-    if (frameIndicator != "FRAME")
-      return setError("Error parsing the Y4M header: Could not locate the next 'FRAME' indicator.");
-
-    // We will now ignore all frame parameters by searching for the next 0x0A byte. I don't know
-    // what we could do with these parameters.
-    offset += 5;
-    int internalOffset = 5;
-    while (rawData.at(internalOffset) != 10 && internalOffset < 20)
+    if (offset < bufferStart || offset + Y4M_MAX_FRAME_HEADER_LENGTH > bufferStart + bufferSize)
     {
-      offset++;
-      internalOffset++;
+      bufferStart = offset;
+      bufferSize  = this->dataSource.readBytes(buffer, offset, readSize);
     }
 
-    // Go to the first byte of the YUV frame
-    offset++;
-    internalOffset++;
+    const auto posInBuffer = offset - bufferStart;
+    const auto headerLength =
+        parseY4MFrameHeader(buffer.constData() + posInBuffer, bufferSize - posInBuffer);
+    if (headerLength == 0)
+    {
+      DEBUG_RAWFILE("playlistItemRawFile::indexY4MFrames No FRAME indicator at offset " << offset);
+      break;
+    }
 
-    if (internalOffset == 19)
-      return setError("Error parsing the Y4M header: The file ended unexpectedly.");
+    offset += headerLength;
+    {
+      QMutexLocker locker(&this->y4mFrameIndicesMutex);
+      this->y4mFrameIndices.append(offset);
+    }
+    offset += frameDataSize;
+  }
 
-    // Add the frame offset value
-    this->y4mFrameIndices.append(offset);
-    DEBUG_RAWFILE("playlistItemRawFile::parseY4MFile Found FRAME at offset " << offset);
+  DEBUG_RAWFILE("playlistItemRawFile::indexY4MFrames Indexing done. Found "
+                << this->getY4MNumberFrames() << " frames");
+}
 
-    offset += stride;
-    if (offset >= this->dataSource.getFileSize())
-      break;
+void playlistItemRawFile::stopY4MIndexing()
+{
+  if (this->y4mIndexFuture.isRunning())
+  {
+    this->y4mIndexBreak.store(true);
+    this->y4mIndexFuture.waitForFinished();
   }
+  this->y4mIndexTimer.stop();
+}
 
-  // Success. Set the format and return true;
-  this->video->setFrameSize(Size(width, height));
-  this->getYUVVideo()->setPixelFormatYUV(format);
-  DEBUG_RAWFILE("playlistItemRawFile::parseY4MFile Y4M Parsing complete. Found "
-                << this->y4mFrameIndices.size() << " frames");
+// This timer event is called regularly while the frames of a y4m file are indexed
+void playlistItemRawFile::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() != this->y4mIndexTimer.timerId())
+    return playlistItemWithVideo::timerEvent(event);
 
-  return true;
+  if (!this->y4mIndexFuture.isRunning())
+    this->y4mIndexTimer.stop();
+
+  this->updateStartEndRange();
+  emit SignalItemChanged(false, RECACHE_NONE);
+}
+
+int64_t playlistItemRawFile::getY4MFrameOffset(int frameIdx) const
+{
+  if (this->y4mFrameDistance > 0)
+    return this->y4mFirstFrameOffset + frameIdx * this->y4mFrameDistance;
+
+  QMutexLocker locker(&this->y4mFrameIndicesMutex);
+  if (frameIdx < 0 || frameIdx >= this->y4mFrameIndices.size())
+    return -1;
+  return this->y4mFrameIndices.at(frameIdx);
+}
+
+int playlistItemRawFile::getY4MNumberFrames() const
+{
+  if (this->y4mFrameDistance > 0)
+    return this->y4mNrFrames;
+
+  QMutexLocker locker(&this->y4mFrameIndicesMutex);
+  return this->y4mFrameIndices.size();
 }
 
 void playlistItemRawFile::setFormatFromFileName()
@@ -497,12 +641,21 @@ void playlistItemRawFile::loadRawData(int frameIdx)
   // Load the raw data for the given frameIdx from file and set it in the video
   int64_t fileStartPos;
   if (this->isY4MFile)
-    fileStartPos = this->y4mFrameIndices.at(frameIdx);
+    fileStartPos = this->getY4MFrameOffset(frameIdx);
   else
     fileStartPos = frameIdx * nrBytes;
+  if (fileStartPos < 0)
+    return; // The frame was not indexed yet
 
   DEBUG_RAWFILE("playlistItemRawFile::loadRawData Start loading frame " << frameIdx << " bytes "
                                                                         << int(nrBytes));
+
+  // The last buffer is usually still in use (e.g. as the current frame). Reading into it would
+  // detach (reallocate) it. Get an unused buffer from the pool instead. The last buffer goes back
+  // to the pool once the video handler does not use it anymore.
+  auto &pool = video::FrameBufferPool::instance();
+  pool.replace(this->video->rawData, pool.getByteArray(int(nrBytes)));
+
   if (this->dataSource.readBytes(this->video->rawData, fileStartPos, nrBytes) < nrBytes)
     return; // Error
   this->video->rawData_frameIndex = frameIdx;
@@ -545,12 +698,19 @@ void playlistItemRawFile::getSupportedFileExtensions(QStringList &allExtensions,
 
 void playlistItemRawFile::reloadItemSource()
 {
+  // The indexing reads from the file
+  this->stopY4MIndexing();
+
   // Reopen the file
   this->dataSource.openFile(this->properties().name);
   if (!this->dataSource.isOk())
     // Opening the file failed.
     return;
 
+  // The frames of a y4m file may have moved. Rebuild the index.
+  if (this->isY4MFile && !this->parseY4MFile())
+    return;
+
   this->video->invalidateAllBuffers();
   this->updateStartEndRange();
 
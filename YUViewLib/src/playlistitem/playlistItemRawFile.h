@@ -35,9 +35,13 @@
 #include <common/Typedef.h>
 #include <filesource/FileSource.h>
 
+#include <QBasicTimer>
 #include <QFuture>
+#include <QMutex>
 #include <QString>
 
+#include <atomic>
+
 #include "playlistItemWithVideo.h"
 
 class playlistItemRawFile : public playlistItemWithVideo
@@ -53,6 +57,7 @@ public:
                       const QSize    frameSize         = {},
                       const QString &sourcePixelFormat = {},
                       const QString &fmt               = {});
+  ~playlistItemRawFile();
 
   // Overload from playlistItem. Save the raw file item to playlist.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const override;
@@ -110,11 +115,34 @@ private:
   void updateStartEndRange() override;
 
   // A y4m file is a raw YUV file but it adds a header (which has information about the YUV format)
-  // and start indicators for every frame. This file will parse the header and save all the byte
+  // and start indicators for every frame. This file will parse the header and get the byte
   // offsets for each raw YUV frame.
-  bool            parseY4MFile();
-  bool            isY4MFile{};
-  QList<uint64_t> y4mFrameIndices;
+  bool parseY4MFile();
+  bool isY4MFile{};
+
+  // Usually all frame headers have the same length. Then the offsets of the frames are calculated
+  // from the offset of the first frame and the constant distance between frames.
+  int64_t y4mFirstFrameOffset{};
+  int64_t y4mFrameDistance{}; // 0 if the frame headers differ in length
+  int     y4mNrFrames{};
+  bool    checkY4MConstantFrameDistance(int64_t firstHeaderOffset,
+                                        int     headerLength,
+                                        int64_t frameDataSize);
+
+  // Otherwise, the frame offsets are indexed in the background. The number of frames grows while
+  // the index is built.
+  QList<int64_t>   y4mFrameIndices;
+  mutable QMutex   y4mFrameIndicesMutex;
+  QFuture<void>    y4mIndexFuture;
+  std::atomic_bool y4mIndexBreak{};
+  QBasicTimer      y4mIndexTimer;
+  void             indexY4MFrames(int64_t offset, int64_t frameDataSize);
+  void             stopY4MIndexing();
+  void             timerEvent(QTimerEvent *event) override;
+
+  // Get the offset of the frame data or -1 if the frame is not (yet) indexed
+  int64_t getY4MFrameOffset(int frameIdx) const;
+  int     getY4MNumberFrames() const;
 
   QString pixelFormatAfterLoading{};
 };
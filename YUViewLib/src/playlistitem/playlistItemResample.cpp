@@ -46,6 +46,19 @@
 
 #define RESAMPLE_INFO_TEXT "Please drop an item onto this item to show a resampled version of it."
 
+namespace
+{
+
+// The combo box entries are in the order of the enum. Unknown indices fall back to bilinear.
+video::videoHandlerResample::Interpolation interpolationFromIndex(int index)
+{
+  if (index < 0 || index > int(video::videoHandlerResample::Interpolation::Area))
+    return video::videoHandlerResample::Interpolation::Bilinear;
+  return video::videoHandlerResample::Interpolation(index);
+}
+
+} // namespace
+
 playlistItemResample::playlistItemResample() : playlistItemContainer("Resample Item")
 {
   this->setIcon(0, functionsGui::convertIcon(":img_resample.png"));
@@ -56,6 +69,7 @@ playlistItemResample::playlistItemResample() : playlistItemContainer("Resample I
   this->maxItemCount   = 1;
   this->frameLimitsMax = false;
   this->infoText       = RESAMPLE_INFO_TEXT;
+  this->cachingEnabled = true;
 
   this->connect(&this->video,
                 &video::FrameHandler::signalHandlerChanged,
@@ -145,10 +159,7 @@ void playlistItemResample::drawItem(QPainter *painter,
         }
 
         this->video.setScaledSize(this->scaledSize);
-        auto interpolation = (this->interpolationIndex == 0)
-                                 ? video::videoHandlerResample::Interpolation::Bilinear
-                                 : video::videoHandlerResample::Interpolation::Fast;
-        this->video.setInterpolation(interpolation);
+        this->video.setInterpolation(interpolationFromIndex(this->interpolationIndex));
         this->video.setCutAndSample(this->cutRange, this->sampling);
         auto nrFrames            = (this->cutRange.second - this->cutRange.first) / this->sampling;
         this->prop.startEndRange = indexRange(0, nrFrames);
@@ -193,7 +204,10 @@ void playlistItemResample::createPropertiesWidget()
   ui.setupUi();
 
   ui.comboBoxInterpolation->addItems(QStringList() << "Bilinear"
-                                                   << "Linear");
+                                                   << "Linear"
+                                                   << "Bicubic"
+                                                   << "Lanczos-3"
+                                                   << "Area");
   ui.comboBoxInterpolation->setCurrentIndex(this->interpolationIndex);
 
   ui.labelSAR->setEnabled(false);
@@ -329,12 +343,13 @@ void playlistItemResample::loadFrame(int frameIdx, bool playing, bool loadRawDat
 void playlistItemResample::childChanged(bool redraw, recacheIndicator recache)
 {
   // The child item changed and needs to redraw. This means that the resampled frame is out of date
-  // and has to be recalculated.
+  // and has to be recalculated. If the frames of the child changed, the cached frames are also
+  // invalid.
 
   auto nrFrames            = (this->cutRange.second - this->cutRange.first) / this->sampling;
   this->prop.startEndRange = indexRange(0, nrFrames);
 
-  this->video.invalidateAllBuffers();
+  this->video.invalidateDerivedFrames(recache);
   playlistItemContainer::childChanged(redraw, recache);
 }
 
@@ -347,10 +362,7 @@ void playlistItemResample::slotResampleControlChanged(int)
 void playlistItemResample::slotInterpolationModeChanged(int)
 {
   this->interpolationIndex = ui.comboBoxInterpolation->currentIndex();
-  auto interpolation       = (this->interpolationIndex == 0)
-                           ? video::videoHandlerResample::Interpolation::Bilinear
-                           : video::videoHandlerResample::Interpolation::Fast;
-  this->video.setInterpolation(interpolation);
+  this->video.setInterpolation(interpolationFromIndex(this->interpolationIndex));
 }
 
 void playlistItemResample::slotCutAndSampleControlChanged(int)
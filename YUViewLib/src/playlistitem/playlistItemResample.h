@@ -61,6 +61,41 @@ public:
   virtual bool isLoading() const override { return this->isFrameLoading; }
   virtual bool isLoadingDoubleBuffer() const override { return this->isFrameLoadingDoubleBuffer; }
 
+  // -- Caching
+  // The frames are derived from the children on the caching threads.
+  virtual bool isCachable() const override
+  {
+    return playlistItem::isCachable() && this->video.inputValid();
+  }
+  virtual void cacheFrame(int frameIdx, bool testMode) override
+  {
+    if (this->isCachable())
+      this->video.cacheFrame(frameIdx, testMode);
+  }
+  virtual QList<int> getCachedFrames() const override { return this->video.getCachedFrames(); }
+  virtual int        getNumberCachedFrames() const override
+  {
+    return this->video.getNumberCachedFrames();
+  }
+  virtual unsigned int getCachingFrameSize() const override
+  {
+    return this->video.getCachedFrameSize();
+  }
+  virtual void removeFrameFromCache(int frameIdx) override
+  {
+    this->video.removeFrameFromCache(frameIdx);
+  }
+  virtual void removeAllFramesFromCache() override { this->video.removeAllFrameFromCache(); }
+  virtual video::CacheStatistics getCacheStatistics() const override
+  {
+    return this->video.getCacheStatistics();
+  }
+  virtual uint64_t getFrameLastAccess(int frameIdx) const override
+  {
+    return this->video.getFrameLastAccess(frameIdx);
+  }
+  virtual void recordFrameAccess(int frameIdx) override { this->video.recordCacheAccess(frameIdx); }
+
   // Overload from playlistItem. Save the playlist item to playlist.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const override;
   // Create a new playlistItemResample from the playlist file entry. Return nullptr if parsing failed.
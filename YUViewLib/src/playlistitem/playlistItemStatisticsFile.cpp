@@ -38,6 +38,7 @@
 #include <QtConcurrent>
 #include <cassert>
 #include <iostream>
+#include <memory>
 
 #include <common/YUViewDomElement.h>
 #include <common/FunctionsGui.h>
@@ -150,6 +151,18 @@ void playlistItemStatisticsFile::drawItem(QPainter *painter, int frameIdx, doubl
   this->currentDrawnFrameIdx = frameIdx;
 }
 
+playlistItem::DrawFunction playlistItemStatisticsFile::getDrawFunction(int frameIdx, bool caching)
+{
+  if (caching || this->needsLoading(frameIdx, false) != ItemLoadingState::LoadingNotNeeded)
+    return {};
+
+  // The function is called from another thread. Draw a copy of the statistics of this frame.
+  auto statisticsData = std::make_shared<stats::StatisticsData>(this->statisticsData);
+  return [statisticsData, frameIdx](QPainter *painter, double zoomFactor) {
+    stats::paintStatisticsData(painter, *statisticsData, frameIdx, zoomFactor);
+  };
+}
+
 void playlistItemStatisticsFile::savePlaylist(QDomElement &root, const QDir &playlistDir) const
 {
   // Determine the relative path to the YUV file-> We save both in the playlist.
@@ -64,6 +64,9 @@ public:
 
   virtual void
   drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) override;
+  // The statistics are only loaded for the frame that is shown. So they can not be drawn while
+  // caching.
+  virtual DrawFunction getDrawFunction(int frameIdx, bool caching) override;
 
   static playlistItemStatisticsFile *
   newplaylistItemStatisticsFile(const YUViewDomElement &root,
@@ -92,6 +92,21 @@ void playlistItemWithVideo::drawItem(QPainter *painter,
     video->drawFrame(painter, frameIdx, zoomFactor, drawRawValues);
 }
 
+playlistItem::DrawFunction playlistItemWithVideo::getDrawFunction(int frameIdx, bool caching)
+{
+  if (this->unresolvableError || !this->video)
+    return {};
+
+  auto range = this->properties().startEndRange;
+  if (frameIdx < range.first || frameIdx > range.second)
+    // Nothing is drawn for this frame
+    return [](QPainter *, double) {};
+
+  if (caching && !this->isCachable())
+    return {};
+  return this->video->getFrameDrawFunction(frameIdx, caching);
+}
+
 void playlistItemWithVideo::loadFrame(int  frameIdx,
                                       bool playing,
                                       bool loadRawData,
@@ -50,6 +50,7 @@ public:
   // Draw the item
   virtual void
   drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues) override;
+  virtual DrawFunction getDrawFunction(int frameIdx, bool caching) override;
 
   // All the functions that we have to overload if we are using a video handler
   virtual QSize                getSize() const override;
@@ -77,10 +78,11 @@ public:
   {
     return unresolvableError ? 0 : video->getNumberCachedFrames();
   }
-  // How many bytes will caching one frame use (in bytes)?
+  // How many bytes will caching one frame use (in bytes)? If the cached frames are compressed,
+  // this is an estimate.
   virtual unsigned int getCachingFrameSize() const override
   {
-    return unresolvableError ? 0 : video->getCachingFrameSize();
+    return unresolvableError ? 0 : video->getCachedFrameSize();
   }
   // Remove the given frame from the cache
   virtual void removeFrameFromCache(int frameIdx) override
@@ -93,10 +95,24 @@ public:
     if (video)
       video->removeAllFrameFromCache();
   }
+  virtual video::CacheStatistics getCacheStatistics() const override
+  {
+    return video ? video->getCacheStatistics() : video::CacheStatistics();
+  }
+  virtual uint64_t getFrameLastAccess(int frameIdx) const override
+  {
+    return video ? video->getFrameLastAccess(frameIdx) : 0;
+  }
+  virtual void recordFrameAccess(int frameIdx) override
+  {
+    if (video)
+      video->recordCacheAccess(frameIdx);
+  }
   // This item is cachable, if caching is enabled and if the raw format is valid (can be cached).
   virtual bool isCachable() const override
   {
-    return !unresolvableError && playlistItem::isCachable() && video->isFormatValid();
+    return !unresolvableError && playlistItem::isCachable() && video->isFormatValid() &&
+           video->isFrameCachingSupported();
   }
 
   // Load the frame in the video item. Emit SignalItemChanged(true,false) when done. Always called
@@ -134,6 +134,15 @@ bool polygonContainsPoint(const stats::Polygon &polygon, const Point &pt)
   }
 }
 
+StatisticsData::StatisticsData(const StatisticsData &other)
+{
+  std::unique_lock<std::mutex> lock(other.accessMutex);
+  this->frameCache = other.frameCache;
+  this->frameIdx   = other.frameIdx;
+  this->frameSize  = other.frameSize;
+  this->statsTypes = other.statsTypes;
+}
+
 FrameTypeData StatisticsData::getFrameTypeData(int typeID)
 {
   if (this->frameCache.count(typeID) == 0)
@@ -48,6 +48,9 @@ class StatisticsData
 {
 public:
   StatisticsData() = default;
+  // Copy the statistics (e.g. of the current frame to draw them in another thread). The other
+  // object is locked while it is copied.
+  StatisticsData(const StatisticsData &other);
 
   FrameTypeData       getFrameTypeData(int typeId);
   Size                getFrameSize() const { return this->frameSize; }
@@ -142,6 +142,10 @@ MainWindow::MainWindow(bool useAlternativeSources, QWidget *parent) : QMainWindo
           &PlaylistTreeWidget::selectedItemDoubleBufferLoad,
           ui.playbackController,
           &PlaybackController::currentSelectedItemsDoubleBufferLoad);
+  connect(ui.playlistTreeWidget,
+          &PlaylistTreeWidget::selectedItemJumpToFrame,
+          ui.playbackController,
+          [this](int frameIdx) { ui.playbackController->setCurrentFrame(frameIdx); });
 
   ui.displaySplitView->setAttribute(Qt::WA_AcceptTouchEvents);
 
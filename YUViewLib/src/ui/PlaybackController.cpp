@@ -653,6 +653,7 @@ bool PlaybackController::setCurrentFrame(int frame, bool updateView)
   currentFrameIdx = frame;
   frameSpinBox->setValue(frame);
   frameSlider->setValue(frame);
+  emit signalCurrentFrameChanged(frame);
 
   if (updateView)
   {
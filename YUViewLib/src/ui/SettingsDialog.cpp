@@ -40,6 +40,8 @@
 #include <decoder/decoderVTM.h>
 #include <decoder/decoderVVDec.h>
 #include <ffmpeg/FFmpegVersionHandler.h>
+#include <video/CachePolicy.h>
+#include <video/DiskFrameCache.h>
 
 #include <QColorDialog>
 #include <QFileDialog>
@@ -124,6 +126,19 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent)
   else
     ui.spinBoxNrThreads->setValue(functions::getOptimalThreadCount());
   ui.spinBoxNrThreads->setEnabled(ui.checkBoxNrThreads->isChecked());
+  for (const auto &policyText : video::CachePolicyTypeMapper.getTextEntries())
+    ui.comboBoxEvictionPolicy->addItem(QString::fromStdString(policyText));
+  const auto policy =
+      video::CachePolicyTypeMapper
+          .getValue(settings.value("EvictionPolicy", "PlaylistOrder").toString().toStdString())
+          .value_or(video::CachePolicyType::PlaylistOrder);
+  ui.comboBoxEvictionPolicy->setCurrentIndex(int(video::CachePolicyTypeMapper.indexOf(policy)));
+  ui.checkBoxCompressFrames->setChecked(settings.value("CompressFrames", false).toBool());
+  ui.groupBoxDiskCache->setChecked(settings.value("DiskCacheEnabled", false).toBool());
+  ui.lineEditDiskCacheDirectory->setText(
+      settings.value("DiskCacheDirectory", video::DiskFrameCache::getDefaultDirectory())
+          .toString());
+  ui.spinBoxDiskCacheSize->setValue(settings.value("DiskCacheSizeMB", 10000).toInt());
   // Playback
   ui.checkBoxPausPlaybackForCaching->setChecked(
       settings.value("PlaybackPauseCaching", true).toBool());
@@ -160,6 +175,18 @@ SettingsDialog::SettingsDialog(QWidget *parent) : QDialog(parent)
   ui.lineEditAVCodec->setText(settings.value("FFmpeg.avcodec", "").toString());
   ui.lineEditAVUtil->setText(settings.value("FFmpeg.avutil", "").toString());
   ui.lineEditSWResample->setText(settings.value("FFmpeg.swresample", "").toString());
+
+  for (auto comboBox : {ui.comboBoxThreadingModeDav1d, ui.comboBoxThreadingModeFFMpeg})
+    for (const auto &mode : decoder::ThreadingModeMapper.getNames())
+      comboBox->addItem(QString::fromStdString(mode));
+  for (const auto &threads : this->getDecoderThreadWidgets())
+  {
+    const auto key = "Threading/" + threads.engineName + "/";
+    threads.interactive->setValue(settings.value(key + "Interactive", 0).toInt());
+    threads.caching->setValue(settings.value(key + "Caching", 0).toInt());
+    if (threads.mode)
+      threads.mode->setCurrentText(settings.value(key + "Mode", "Auto").toString());
+  }
   settings.endGroup();
 }
 
@@ -175,6 +202,29 @@ void SettingsDialog::initializeDefaults()
     settings.setValue("Plot/BackgroundColor", QColor(255, 255, 255));
 }
 
+std::vector<SettingsDialog::DecoderThreadWidgets> SettingsDialog::getDecoderThreadWidgets()
+{
+  auto name = [](decoder::DecoderEngine engine) {
+    return QString::fromStdString(decoder::DecoderEngineMapper.getName(engine));
+  };
+  return {{name(decoder::DecoderEngine::Libde265),
+           ui.spinBoxThreadsLibde265Interactive,
+           ui.spinBoxThreadsLibde265Caching,
+           nullptr},
+          {name(decoder::DecoderEngine::VVDec),
+           ui.spinBoxThreadsVVDecInteractive,
+           ui.spinBoxThreadsVVDecCaching,
+           nullptr},
+          {name(decoder::DecoderEngine::Dav1d),
+           ui.spinBoxThreadsDav1dInteractive,
+           ui.spinBoxThreadsDav1dCaching,
+           ui.comboBoxThreadingModeDav1d},
+          {name(decoder::DecoderEngine::FFMpeg),
+           ui.spinBoxThreadsFFMpegInteractive,
+           ui.spinBoxThreadsFFMpegCaching,
+           ui.comboBoxThreadingModeFFMpeg}};
+}
+
 unsigned int SettingsDialog::getCacheSizeInMB() const
 {
   if (!ui.groupBoxCaching->isChecked())
@@ -242,6 +292,14 @@ void SettingsDialog::on_pushButtonDecoderSelectPath_clicked()
   }
 }
 
+void SettingsDialog::on_pushButtonDiskCacheSelectDirectory_clicked()
+{
+  auto path = QFileDialog::getExistingDirectory(
+      this, "Select the disk cache directory", ui.lineEditDiskCacheDirectory->text());
+  if (!path.isEmpty())
+    ui.lineEditDiskCacheDirectory->setText(path);
+}
+
 QStringList SettingsDialog::getLibraryPath(QString currentFile, QString caption, bool multipleFiles)
 {
   // Use the currently selected dir or the dir to YUView if this one does not exist.
@@ -460,6 +518,14 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("ThresholdValueMB", getCacheSizeInMB());
   settings.setValue("SetNrThreads", ui.checkBoxNrThreads->isChecked());
   settings.setValue("NrThreads", ui.spinBoxNrThreads->value());
+  const auto policyIndex = size_t(ui.comboBoxEvictionPolicy->currentIndex());
+  if (auto policy = video::CachePolicyTypeMapper.at(policyIndex))
+    settings.setValue("EvictionPolicy",
+                      QString::fromStdString(video::CachePolicyTypeMapper.getName(*policy)));
+  settings.setValue("CompressFrames", ui.checkBoxCompressFrames->isChecked());
+  settings.setValue("DiskCacheEnabled", ui.groupBoxDiskCache->isChecked());
+  settings.setValue("DiskCacheDirectory", ui.lineEditDiskCacheDirectory->text());
+  settings.setValue("DiskCacheSizeMB", ui.spinBoxDiskCacheSize->value());
   settings.setValue("PlaybackPauseCaching", ui.checkBoxPausPlaybackForCaching->isChecked());
   settings.setValue("PlaybackCachingEnabled", ui.checkBoxEnablePlaybackCaching->isChecked());
   settings.setValue("PlaybackCachingThreadLimit", ui.spinBoxThreadLimit->value());
@@ -482,6 +548,15 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("FFmpeg.avcodec", ui.lineEditAVCodec->text());
   settings.setValue("FFmpeg.avutil", ui.lineEditAVUtil->text());
   settings.setValue("FFmpeg.swresample", ui.lineEditSWResample->text());
+  // Threading
+  for (const auto &threads : this->getDecoderThreadWidgets())
+  {
+    const auto key = "Threading/" + threads.engineName + "/";
+    settings.setValue(key + "Interactive", threads.interactive->value());
+    settings.setValue(key + "Caching", threads.caching->value());
+    if (threads.mode)
+      settings.setValue(key + "Mode", threads.mode->currentText());
+  }
   settings.endGroup();
 
   accept();
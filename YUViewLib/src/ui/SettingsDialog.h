@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <QDialog>
 
 #include "ui_settingsDialog.h"
@@ -54,6 +56,7 @@ private slots:
   // Caching threads check box
   void on_checkBoxNrThreads_stateChanged(int newState);
   void on_checkBoxEnablePlaybackCaching_stateChanged(int state);
+  void on_pushButtonDiskCacheSelectDirectory_clicked();
 
   // Colors buttons
   void on_pushButtonEditViewBackgroundColor_clicked();
@@ -84,6 +87,17 @@ private slots:
   void on_pushButtonCancel_clicked() { reject(); }
 
 private:
+  // The widgets that control the threading of one decoder engine. Not all engines support
+  // choosing the threading mode (mode is nullptr then).
+  struct DecoderThreadWidgets
+  {
+    QString    engineName;
+    QSpinBox * interactive{};
+    QSpinBox * caching{};
+    QComboBox *mode{};
+  };
+  std::vector<DecoderThreadWidgets> getDecoderThreadWidgets();
+
   // Open a file search dialog and return the selected file (or an empty string if no file was selected)
   QStringList getLibraryPath(QString currentFile, QString caption, bool multipleFiles=false);
 
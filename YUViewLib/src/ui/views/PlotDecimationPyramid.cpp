@@ -0,0 +1,232 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PlotDecimationPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// A pyramid node and a bucket hold the same values (the node with less precision). Creating and
+// combining them is shared so that both always agree.
+template <typename T> T valuesFromPoint(const PlotModel::Point &point)
+{
+  using Value = decltype(T::yMin);
+
+  T values;
+  values.xMin      = point.x - point.width / 2;
+  values.xMax      = point.x + point.width / 2;
+  values.yMin      = Value(point.y);
+  values.yMax      = Value(point.y);
+  values.yAverage  = point.y;
+  values.yFirst    = Value(point.y);
+  values.yLast     = Value(point.y);
+  values.intra     = point.intra;
+  values.yMaxIntra = point.intra ? Value(point.y) : Value(0);
+  values.nrPoints  = 1;
+  return values;
+}
+
+template <typename T> T combineValues(const T &left, const T &right)
+{
+  T values;
+  values.xMin     = std::min(left.xMin, right.xMin);
+  values.xMax     = std::max(left.xMax, right.xMax);
+  values.yMin     = std::min(left.yMin, right.yMin);
+  values.yMax     = std::max(left.yMax, right.yMax);
+  values.nrPoints = left.nrPoints + right.nrPoints;
+  values.yAverage =
+      (left.yAverage * left.nrPoints + right.yAverage * right.nrPoints) / values.nrPoints;
+  values.yFirst = left.yFirst;
+  values.yLast  = right.yLast;
+  values.intra  = left.intra || right.intra;
+  if (left.intra && right.intra)
+    values.yMaxIntra = std::max(left.yMaxIntra, right.yMaxIntra);
+  else
+    values.yMaxIntra = left.intra ? left.yMaxIntra : right.yMaxIntra;
+  return values;
+}
+
+} // namespace
+
+PlotBucketCollector::PlotBucketCollector(double xStart, double columnWidth)
+    : xStart(xStart), columnWidth(columnWidth)
+{
+}
+
+PlotModel::Bucket PlotBucketCollector::bucketFromPoint(const PlotModel::Point &point,
+                                                       unsigned                pointIndex)
+{
+  auto bucket            = valuesFromPoint<PlotModel::Bucket>(point);
+  bucket.firstPointIndex = pointIndex;
+  return bucket;
+}
+
+PlotModel::Bucket PlotBucketCollector::combine(const PlotModel::Bucket &left,
+                                               const PlotModel::Bucket &right)
+{
+  auto bucket            = combineValues(left, right);
+  bucket.firstPointIndex = left.firstPointIndex;
+  return bucket;
+}
+
+void PlotBucketCollector::add(const PlotModel::Bucket &bucket)
+{
+  const auto center = (bucket.xMin + bucket.xMax) / 2;
+  const auto column = (this->columnWidth > 0)
+                          ? (long long)(std::floor((center - this->xStart) / this->columnWidth))
+                          : this->lastColumn + 1;
+
+  if (!this->buckets.empty() && column == this->lastColumn)
+    this->buckets.back() = combine(this->buckets.back(), bucket);
+  else
+    this->buckets.push_back(bucket);
+  this->lastColumn = column;
+}
+
+void PlotDecimationPyramid::clear()
+{
+  this->levels.clear();
+}
+
+void PlotDecimationPyramid::insert(size_t index, const PlotModel::Point &point)
+{
+  if (this->levels.empty())
+    this->levels.emplace_back();
+
+  auto &points = this->levels[0];
+  index        = std::min(index, points.size());
+  points.insert(points.begin() + index, valuesFromPoint<Node>(point));
+
+  // All points after the inserted one moved by one position
+  this->updateLevels(index, points.size() - 1);
+}
+
+void PlotDecimationPyramid::set(size_t index, const PlotModel::Point &point)
+{
+  if (index >= this->size())
+    return;
+
+  this->levels[0][index] = valuesFromPoint<Node>(point);
+  this->updateLevels(index, index);
+}
+
+std::vector<PlotModel::Bucket> PlotDecimationPyramid::getBuckets(Range<double> xRange,
+                                                                 double        columnWidth) const
+{
+  if (this->size() == 0)
+    return {};
+
+  const auto &points = this->levels[0];
+  auto        center = [](const Node &node) { return (node.xMin + node.xMax) / 2; };
+
+  auto itStart = std::lower_bound(
+      points.begin(), points.end(), xRange.min, [&center](const Node &node, double x) {
+        return center(node) < x;
+      });
+  auto itEnd = std::upper_bound(
+      points.begin(), points.end(), xRange.max, [&center](double x, const Node &node) {
+        return x < center(node);
+      });
+
+  // Include one point left and right of the range
+  auto firstIndex = size_t(std::distance(points.begin(), itStart));
+  auto endIndex   = size_t(std::distance(points.begin(), itEnd));
+  if (firstIndex > 0)
+    firstIndex--;
+  if (endIndex < points.size())
+    endIndex++;
+  if (firstIndex >= endIndex)
+    return {};
+
+  size_t     level     = 0;
+  const auto nrColumns = (columnWidth > 0) ? (xRange.max - xRange.min) / columnWidth : 0.0;
+  if (nrColumns > 0)
+  {
+    const auto pointsPerColumn = double(endIndex - firstIndex) / nrColumns;
+    while (level + 1 < this->levels.size() && double(size_t(1) << (level + 1)) <= pointsPerColumn)
+      level++;
+  }
+
+  PlotBucketCollector collector(xRange.min, columnWidth);
+  const auto &        nodes = this->levels[level];
+  for (auto i = firstIndex >> level; i <= (endIndex - 1) >> level; i++)
+    collector.add(bucketFromNode(nodes[i], unsigned(i << level)));
+  return collector.takeBuckets();
+}
+
+PlotModel::Bucket PlotDecimationPyramid::bucketFromNode(const Node &node,
+                                                        unsigned    firstPointIndex)
+{
+  PlotModel::Bucket bucket;
+  bucket.xMin            = node.xMin;
+  bucket.xMax            = node.xMax;
+  bucket.yMin            = node.yMin;
+  bucket.yMax            = node.yMax;
+  bucket.yAverage        = node.yAverage;
+  bucket.yFirst          = node.yFirst;
+  bucket.yLast           = node.yLast;
+  bucket.intra           = node.intra;
+  bucket.yMaxIntra       = node.yMaxIntra;
+  bucket.firstPointIndex = firstPointIndex;
+  bucket.nrPoints        = node.nrPoints;
+  return bucket;
+}
+
+void PlotDecimationPyramid::updateLevels(size_t firstIndex, size_t lastIndex)
+{
+  size_t level = 1;
+  for (; this->levels[level - 1].size() > 1; level++)
+  {
+    if (level == this->levels.size())
+      this->levels.emplace_back();
+
+    const auto &below = this->levels[level - 1];
+    auto &      nodes = this->levels[level];
+
+    const auto newSize = (below.size() + 1) / 2;
+    firstIndex /= 2;
+    lastIndex = std::min(lastIndex / 2, newSize - 1);
+
+    nodes.resize(newSize);
+    for (auto i = firstIndex; i <= lastIndex; i++)
+    {
+      if (2 * i + 1 < below.size())
+        nodes[i] = combineValues(below[2 * i], below[2 * i + 1]);
+      else
+        nodes[i] = below[2 * i];
+    }
+  }
+  this->levels.resize(level);
+}
@@ -0,0 +1,99 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PlotModel.h"
+
+#include <vector>
+
+// Combines buckets whose center falls into the same pixel column of the given width. Buckets must
+// be added in increasing x order.
+class PlotBucketCollector
+{
+public:
+  PlotBucketCollector(double xStart, double columnWidth);
+
+  static PlotModel::Bucket bucketFromPoint(const PlotModel::Point &point, unsigned pointIndex);
+  static PlotModel::Bucket combine(const PlotModel::Bucket &left, const PlotModel::Bucket &right);
+
+  void                           add(const PlotModel::Bucket &bucket);
+  std::vector<PlotModel::Bucket> takeBuckets() { return std::move(this->buckets); }
+
+private:
+  double                         xStart{};
+  double                         columnWidth{};
+  long long                      lastColumn{};
+  std::vector<PlotModel::Bucket> buckets;
+};
+
+// A min/max/average decimation pyramid over the points of one plot. Level 0 holds the points
+// themselves, each higher level combines two neighboring entries of the level below. The points
+// must be sorted by x. Appending a point updates one entry per level. Inserting or changing a
+// point close to the end only updates the entries from that position on.
+class PlotDecimationPyramid
+{
+public:
+  PlotDecimationPyramid() = default;
+
+  void clear();
+  void insert(size_t index, const PlotModel::Point &point);
+  void append(const PlotModel::Point &point) { this->insert(this->size(), point); }
+  void set(size_t index, const PlotModel::Point &point);
+
+  size_t size() const { return this->levels.empty() ? 0 : this->levels[0].size(); }
+
+  // See PlotModel::getPlotBuckets. The level of the pyramid is chosen so that one entry is not
+  // wider than one column.
+  std::vector<PlotModel::Bucket> getBuckets(Range<double> xRange, double columnWidth) const;
+
+private:
+  // The values of a PlotModel::Bucket in a more compact form
+  struct Node
+  {
+    double   xMin{}, xMax{};
+    double   yAverage{};
+    float    yMin{}, yMax{};
+    float    yFirst{}, yLast{};
+    float    yMaxIntra{};
+    unsigned nrPoints{};
+    bool     intra{};
+  };
+
+  static PlotModel::Bucket bucketFromNode(const Node &node, unsigned firstPointIndex);
+
+  // Recalculate the entries of all levels above level 0 that depend on the points in the range
+  // [firstIndex, lastIndex].
+  void updateLevels(size_t firstIndex, size_t lastIndex);
+
+  std::vector<std::vector<Node>> levels;
+};
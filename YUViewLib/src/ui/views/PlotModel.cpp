@@ -32,6 +32,8 @@
 
 #include "PlotModel.h"
 
+#include "PlotDecimationPyramid.h"
+
 PlotModel::PlotModel()
 {
   this->connect(&this->eventSubsampler, &EventSubsampler::subsampledEvent, this, &PlotModel::dataChanged);
@@ -53,15 +55,11 @@ std::optional<unsigned> PlotModel::getPointIndex(unsigned streamIndex, unsigned
 
     auto findLineSegmentAtPos = [&](double x) -> std::optional<unsigned>
     {
-      auto prevPointX = this->getPlotPoint(streamIndex, plotIndex, 0).x;
-      for (unsigned pointIndex = 1; pointIndex < plotParam.nrpoints; pointIndex++)
-      {
-        const auto pointX = this->getPlotPoint(streamIndex, plotIndex, pointIndex).x;
-        if (x > prevPointX && x <= pointX)
-          return pointIndex;
-        prevPointX = pointX;
-      }
-      return {};
+      // The first point with a position >= x is the end of the segment
+      const auto pointIndex = this->getFirstPointIndexAtOrAfter(streamIndex, plotIndex, x);
+      if (pointIndex == 0 || pointIndex >= plotParam.nrpoints)
+        return {};
+      return pointIndex;
     };
 
     const auto lineAtPos = findLineSegmentAtPos(point.x());
@@ -110,7 +108,13 @@ std::optional<unsigned> PlotModel::getPointIndex(unsigned streamIndex, unsigned
   }
   else
   {
-    for (unsigned pointIndex = 0; pointIndex < plotParam.nrpoints; pointIndex++)
+    // The points are sorted so the bar at the position can only be the one right before or at the
+    // first point with a position >= x.
+    const auto pointAfter = this->getFirstPointIndexAtOrAfter(streamIndex, plotIndex, point.x());
+    const auto firstCandidate = (pointAfter > 0) ? pointAfter - 1 : 0;
+    for (auto pointIndex = firstCandidate;
+         pointIndex <= pointAfter && pointIndex < plotParam.nrpoints;
+         pointIndex++)
     {
       const auto barPoint = this->getPlotPoint(streamIndex, plotIndex, pointIndex);
       if (point.x() > barPoint.x - barPoint.width / 2 && point.x() <= barPoint.x + barPoint.width / 2)
@@ -119,3 +123,56 @@ std::optional<unsigned> PlotModel::getPointIndex(unsigned streamIndex, unsigned
   }
   return {};
 }
+
+unsigned
+PlotModel::getFirstPointIndexAtOrAfter(unsigned streamIndex, unsigned plotIndex, double x) const
+{
+  const auto streamParam = this->getStreamParameter(streamIndex);
+  if (plotIndex >= unsigned(streamParam.plotParameters.size()))
+    return 0;
+
+  unsigned intervalLeft  = 0;
+  unsigned intervalRight = streamParam.plotParameters[plotIndex].nrpoints;
+  while (intervalLeft < intervalRight)
+  {
+    const auto pointToCheck = intervalLeft + (intervalRight - intervalLeft) / 2;
+    if (this->getPlotPoint(streamIndex, plotIndex, pointToCheck).x < x)
+      intervalLeft = pointToCheck + 1;
+    else
+      intervalRight = pointToCheck;
+  }
+  return intervalLeft;
+}
+
+std::vector<PlotModel::Bucket> PlotModel::getPlotBuckets(unsigned      streamIndex,
+                                                         unsigned      plotIndex,
+                                                         Range<double> xRange,
+                                                         double        columnWidth) const
+{
+  const auto streamParam = this->getStreamParameter(streamIndex);
+  if (plotIndex >= unsigned(streamParam.plotParameters.size()))
+    return {};
+  const auto nrPoints = streamParam.plotParameters[plotIndex].nrpoints;
+
+  PlotBucketCollector collector(xRange.min, columnWidth);
+  std::optional<Bucket> lastBucketLeftOfRange;
+  for (unsigned pointIndex = 0; pointIndex < nrPoints; pointIndex++)
+  {
+    const auto point  = this->getPlotPoint(streamIndex, plotIndex, pointIndex);
+    const auto bucket = PlotBucketCollector::bucketFromPoint(point, pointIndex);
+    if (point.x < xRange.min)
+    {
+      lastBucketLeftOfRange = bucket;
+      continue;
+    }
+    if (lastBucketLeftOfRange)
+    {
+      collector.add(*lastBucketLeftOfRange);
+      lastBucketLeftOfRange.reset();
+    }
+    collector.add(bucket);
+    if (point.x > xRange.max)
+      break;
+  }
+  return collector.takeBuckets();
+}
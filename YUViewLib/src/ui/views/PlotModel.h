@@ -38,6 +38,7 @@
 #include <QObject>
 #include <QTimer>
 #include <optional>
+#include <vector>
 
 enum class Axis
 {
@@ -92,6 +93,19 @@ public:
     bool   intra;
   };
 
+  // A run of consecutive points of a plot combined into one value. When many points fall into one
+  // pixel column, only one bucket per column has to be drawn.
+  struct Bucket
+  {
+    double   xMin{}, xMax{};
+    double   yMin{}, yMax{}, yAverage{};
+    double   yFirst{}, yLast{};
+    bool     intra{};
+    double   yMaxIntra{};
+    unsigned firstPointIndex{};
+    unsigned nrPoints{};
+  };
+
   virtual unsigned        getNrStreams() const                           = 0;
   virtual StreamParameter getStreamParameter(unsigned streamIndex) const = 0;
   virtual Point
@@ -104,6 +118,18 @@ public:
   std::optional<unsigned>
   getPointIndex(unsigned streamIndex, unsigned plotIndex, QPointF point) const;
 
+  // Get the points in the given x range combined into at most one bucket per column of the given
+  // width. One point left and right of the range is included so that lines can be continued. The
+  // default implementation iterates over all points. Models with many points should override this.
+  virtual std::vector<Bucket> getPlotBuckets(unsigned      streamIndex,
+                                             unsigned      plotIndex,
+                                             Range<double> xRange,
+                                             double        columnWidth) const;
+
 protected:
+  // Binary search for the first point with a position on the x axis >= x. The points of a plot
+  // are sorted by their x position.
+  unsigned getFirstPointIndexAtOrAfter(unsigned streamIndex, unsigned plotIndex, double x) const;
+
   EventSubsampler eventSubsampler;
 };
@@ -620,6 +620,9 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
   const auto plotXMin = this->convertPixelPosToPlotPos(this->plotRect.bottomLeft()).x() - 0.5;
   const auto plotXMax = this->convertPixelPosToPlotPos(this->plotRect.bottomRight()).x() + 0.5;
 
+  // The width of one pixel column in the plot. The model combines all points within one column.
+  const auto columnWidth = 1.0 / (this->zoomToPixelsPerValueX * this->zoomFactor);
+
   DEBUG_PLOT("PlotViewWidget::drawPlot start");
   for (auto streamIndex : this->showStreamList)
   {
@@ -650,33 +653,41 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
 
         QVector<QRectF> normalBars;
         QVector<QRectF> intraBars;
-        for (unsigned int i = 0; i < plotParam.nrpoints; i++)
+        const auto      buckets =
+            model->getPlotBuckets(streamIndex, plotIndex, {plotXMin, plotXMax}, columnWidth);
+        for (const auto &bucket : buckets)
         {
-          const auto value = model->getPlotPoint(streamIndex, plotIndex, i);
+          const auto barTopLeft =
+              this->convertPlotPosToPixelPos(QPointF(bucket.xMin, bucket.yMax));
+          const auto barBottomRight = this->convertPlotPosToPixelPos(QPointF(bucket.xMax, 0));
+          const auto r              = QRectF(barTopLeft, barBottomRight);
 
-          if (value.x < plotXMin || value.x > plotXMax)
+          if (bucket.nrPoints > 1)
+          {
+            // Multiple bars fall into this pixel column. Draw the envelope of all bars and the
+            // highest intra bar on top of it.
+            normalBars.append(r);
+            if (bucket.intra)
+              intraBars.append(QRectF(
+                  this->convertPlotPosToPixelPos(QPointF(bucket.xMin, bucket.yMaxIntra)),
+                  barBottomRight));
             continue;
-
-          const auto halfWidth = value.width / 2;
-          const auto barTopLeft =
-              this->convertPlotPosToPixelPos(QPointF(value.x - halfWidth, value.y));
-          const auto barBottomRight =
-              this->convertPlotPosToPixelPos(QPointF(value.x + halfWidth, 0));
+          }
 
           const bool isHoveredBar =
               this->currentlyHoveredPointPerStreamAndPlot.contains(streamIndex) &&
               this->currentlyHoveredPointPerStreamAndPlot[streamIndex].contains(plotIndex) &&
-              this->currentlyHoveredPointPerStreamAndPlot[streamIndex][plotIndex] == i;
+              this->currentlyHoveredPointPerStreamAndPlot[streamIndex][plotIndex] ==
+                  bucket.firstPointIndex;
 
-          const auto r = QRectF(barTopLeft, barBottomRight);
           if (isHoveredBar)
           {
-            setPainterColor(value.intra, true);
+            setPainterColor(bucket.intra, true);
             painter.drawRect(r);
           }
           else
           {
-            if (value.intra)
+            if (bucket.intra)
               intraBars.append(r);
             else
               normalBars.append(r);
@@ -693,56 +704,28 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
       }
       else if (plotParam.type == PlotModel::PlotType::Line)
       {
-        // We can assume that the points are sorted (i.e. there is not graph that suddenly goes
-        // back)
-        auto getStartIndexBinarySearch = [](unsigned   nrpoints,
-                                            PlotModel *model,
-                                            unsigned   streamIndex,
-                                            unsigned   plotIndex,
-                                            double     plotXMin) {
-          unsigned intervalLeft  = 0;
-          unsigned intervalRight = nrpoints;
-          if (nrpoints == 0)
-            return intervalLeft;
-          while (true)
-          {
-            unsigned pointToCheck = intervalLeft + (intervalRight - intervalLeft) / 2;
-            auto     valuePoint   = model->getPlotPoint(streamIndex, plotIndex, pointToCheck);
-            if (valuePoint.x < plotXMin) // Choose right interval
-              intervalLeft = pointToCheck;
-            else // Left interval
-              intervalRight = pointToCheck;
-            if (intervalLeft + 1 == intervalRight)
-              return intervalLeft;
-          }
-        };
-
         QPolygonF  linePoints;
-        QPointF    lastPoint;
-        const auto startIndex = getStartIndexBinarySearch(
-            plotParam.nrpoints, this->model, streamIndex, plotIndex, plotXMin);
-        for (unsigned i = startIndex; i < plotParam.nrpoints; i++)
+        const auto buckets =
+            model->getPlotBuckets(streamIndex, plotIndex, {plotXMin, plotXMax}, columnWidth);
+        for (const auto &bucket : buckets)
         {
-          const auto valueStart = this->model->getPlotPoint(streamIndex, plotIndex, i);
-          const auto linePointStart =
-              this->convertPlotPosToPixelPos(QPointF(valueStart.x, valueStart.y));
-
-          if (valueStart.x < plotXMin)
+          const auto x = (bucket.xMin + bucket.xMax) / 2;
+          if (bucket.nrPoints == 1)
           {
-            lastPoint = linePointStart;
+            linePoints.append(this->convertPlotPosToPixelPos(QPointF(x, bucket.yFirst)));
             continue;
           }
 
-          if (linePoints.size() == 0 && i > 0)
-            linePoints.append(lastPoint);
-          linePoints.append(linePointStart);
-
-          if (valueStart.x > plotXMax)
-            // This means that no graph can "go back" on the x-axis. That is ok for now.
-            // If we ever need this, this needs to be smarter here.
-            break;
-
-          lastPoint = linePointStart;
+          // Multiple points fall into this pixel column. Draw the range of values as a vertical
+          // line that starts and ends at the first and last value.
+          const auto minFirst =
+              std::abs(bucket.yFirst - bucket.yMin) < std::abs(bucket.yFirst - bucket.yMax);
+          linePoints.append(this->convertPlotPosToPixelPos(QPointF(bucket.xMin, bucket.yFirst)));
+          linePoints.append(
+              this->convertPlotPosToPixelPos(QPointF(x, minFirst ? bucket.yMin : bucket.yMax)));
+          linePoints.append(
+              this->convertPlotPosToPixelPos(QPointF(x, minFirst ? bucket.yMax : bucket.yMin)));
+          linePoints.append(this->convertPlotPosToPixelPos(QPointF(bucket.xMax, bucket.yLast)));
         }
 
         DEBUG_PLOT("PlotViewWidget::drawPlot Start drawing line with " << linePoints.size()
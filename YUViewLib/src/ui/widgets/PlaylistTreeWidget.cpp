@@ -426,6 +426,8 @@ void PlaylistTreeWidget::appendNewItem(playlistItem *item, bool emitplaylistChan
           &playlistItem::signalItemDoubleBufferLoaded,
           this,
           &PlaylistTreeWidget::slotItemDoubleBufferLoaded);
+  connect(
+      item, &playlistItem::signalItemJumpToFrame, this, &PlaylistTreeWidget::slotItemJumpToFrame);
   setItemWidget(item, 1, new bufferStatusWidget(item, this));
   header()->resizeSection(1, 50);
 
@@ -522,6 +524,14 @@ void PlaylistTreeWidget::slotItemDoubleBufferLoaded()
     emit selectedItemDoubleBufferLoad(1);
 }
 
+void PlaylistTreeWidget::slotItemJumpToFrame(int frameIdx)
+{
+  auto     items  = getSelectedItems();
+  QObject *sender = QObject::sender();
+  if (sender == items[0] || sender == items[1])
+    emit selectedItemJumpToFrame(frameIdx);
+}
+
 void PlaylistTreeWidget::mousePressEvent(QMouseEvent *event)
 {
   QModelIndex item = indexAt(event->pos());
@@ -148,6 +148,9 @@ signals:
   // The selected item finished loading the double buffer.
   void selectedItemDoubleBufferLoad(int itemID);
 
+  // The selected item requests to show the given frame.
+  void selectedItemJumpToFrame(int frameIdx);
+
 protected:
   // Overload from QWidget to create a custom context menu
   virtual void contextMenuEvent(QContextMenuEvent *event) override;
@@ -181,6 +184,10 @@ protected slots:
   // currently selected, forward this to the playbackController which might me waiting for this.
   void slotItemDoubleBufferLoaded();
 
+  // All item's signals signalItemJumpToFrame are connected here. If the sending item is currently
+  // selected, forward this to the playbackController.
+  void slotItemJumpToFrame(int frameIdx);
+
 private:
   playlistItem *getDropTarget(const QPoint &pos) const;
 
@@ -0,0 +1,601 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CachePolicy.h"
+
+#include <common/Functions.h>
+#include <playlistitem/playlistItem.h>
+
+#include <QSet>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Activate this if you want to know what the cache policies decide
+#define CACHEPOLICY_DEBUG_OUTPUT 0
+#if CACHEPOLICY_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_POLICY qDebug
+#else
+#define DEBUG_POLICY(fmt, ...) ((void)0)
+#endif
+
+namespace video
+{
+
+namespace
+{
+
+using CachedFrame = QPair<playlistItem *, int>;
+
+// How many frames of the item fit into the given number of bytes?
+int64_t getNrFramesFitting(playlistItem *item, int64_t bytes)
+{
+  const auto frameSize = int64_t(item->getCachingFrameSize());
+  return frameSize > 0 ? std::max(bytes, int64_t(0)) / frameSize : 0;
+}
+
+// Add cache jobs for the given frames (in this order). Frames that are already cached are skipped
+// and runs of consecutive ascending frames are combined into one job.
+void appendCacheJobs(CachePlan &plan, playlistItem *item, const std::vector<int> &frames)
+{
+  QSet<int> cachedFrames;
+  for (const auto frame : item->getCachedFrames())
+    cachedFrames.insert(frame);
+
+  std::vector<int> missingFrames;
+  for (const auto frame : frames)
+    if (!cachedFrames.contains(frame))
+      missingFrames.push_back(frame);
+
+  for (size_t start = 0; start < missingFrames.size();)
+  {
+    auto end = start + 1;
+    while (end < missingFrames.size() && missingFrames[end] == missingFrames[end - 1] + 1)
+      end++;
+    plan.cacheJobs.append({item, indexRange(missingFrames[start], missingFrames[end - 1])});
+    start = end;
+  }
+}
+
+// Append all cached frames of the items that are not protected to the eviction order. The least
+// recently used frames are removed first.
+void appendLeastRecentlyUsed(CachePlan &                  plan,
+                             const QList<playlistItem *> &items,
+                             playlistItem *               protectedItem,
+                             const QHash<int, int> &      protectedFrames)
+{
+  std::vector<std::pair<uint64_t, CachedFrame>> frames;
+  for (const auto item : items)
+    for (const auto frame : item->getCachedFrames())
+      if (item != protectedItem || !protectedFrames.contains(frame))
+        frames.push_back({item->getFrameLastAccess(frame), {item, frame}});
+
+  std::stable_sort(frames.begin(), frames.end(), [](const auto &a, const auto &b) {
+    return a.first < b.first;
+  });
+  for (const auto &frame : frames)
+    plan.evictionOrder.append(frame.second);
+}
+
+// Protect the given frames (in order of priority) and cache them
+void protectAndCache(CachePlan &plan, playlistItem *item, const std::vector<int> &frames)
+{
+  for (const auto frame : frames)
+    plan.protectedFrames.insert(frame, plan.protectedFrames.size());
+  appendCacheJobs(plan, item, frames);
+}
+
+bool isCachableIndexedItem(playlistItem *item)
+{
+  return item != nullptr && item->isCachable() && item->properties().isIndexedByFrame();
+}
+
+/* The original policy of YUView which decides based on the position of the items in the playlist.
+ */
+class PlaylistOrderPolicy : public CachePolicy
+{
+public:
+  CachePlan plan(const CacheState &state) const override;
+};
+
+CachePlan PlaylistOrderPolicy::plan(const CacheState &state) const
+{
+  // Our caching priority list is like this:
+  // 1: Cache all the frames in the item that is currently selected. In order to achieve this, we
+  // will aggressively
+  //    delete other frames from other sequences in the cache. This has highest priority.
+  // 2: Cache all the frames from the following items (while there is space left in the cache). If
+  // case of playback
+  //    we will remove all frames from items that were already played back (are before the current
+  //    item in the playlist). If playback is not running, we will not remove any frames from other
+  //    items from the cache to achieve this.
+  //
+  // When frames have to be removed to fit the selected sequence into the cache, the following
+  // priorities apply to frames from other sequences. (The ones with highest priority get removed
+  // last). This priority list differs depending if playback is currently running or not.
+  //
+  // Playback is not running:
+  // 1: The frames from the previous item have highest priority and are removed last. It is very
+  // likely that in 'interactive'
+  //    (playback is not running) mode, the user will go back to the previous item.
+  // 2: The item after this item is next in the priority list.
+  // 3: The item after 2 is next and so on (wrap around in the playlist) until the previous item is
+  // reached.
+  //
+  // Playback is running:
+  // 1: The item after this item has the highest priority (it will be played next)
+  // 2: The item after 2 is next and so on (wrap around in the playlist) until the previous item is
+  // reached.
+
+  CachePlan   plan;
+  const auto &allItems      = state.allItems;
+  const auto  selectedItem  = state.selectedItem;
+  const auto  itemPos       = state.selectedItemPos;
+  const auto  cacheLevelMax = state.cacheLevelMax;
+  auto        cacheLevel    = state.cacheLevel;
+
+  // How much space do we need to cache the entire item?
+  indexRange range =
+      selectedItem->properties().startEndRange; // These are the frames that we want to cache
+  int64_t cachingFrameSize          = selectedItem->getCachingFrameSize();
+  int64_t itemSpaceNeeded           = (range.second - range.first + 1) * cachingFrameSize;
+  int64_t alreadyCached             = selectedItem->getNumberCachedFrames() * cachingFrameSize;
+  int64_t additionalItemSpaceNeeded = itemSpaceNeeded - alreadyCached;
+
+  if (state.playing)
+  {
+    // Go through the playlist starting with the currently selected item.
+    // Add as much of all items as possible. When the cache is full, mark the remaining frames as
+    // "can be deleted"
+    int     i             = itemPos;
+    int64_t newCacheLevel = 0;
+
+    // We start in "adding" mode where items are added. If the cache is full, we switch to
+    // "deleting" mode where all frames of all items are removed. This is done for all items in the
+    // playlist.
+    bool adding = true;
+    do
+    {
+      if (allItems[i]->properties().isIndexedByFrame())
+      {
+        // How much space do we need to cache the current item?
+        auto    itemRange = allItems[i]->properties().startEndRange;
+        int64_t itemCacheSize =
+            (itemRange.second - itemRange.first + 1) * int64_t(allItems[i]->getCachingFrameSize());
+
+        if (adding && allItems[i]->isCachable())
+        {
+          if (newCacheLevel + itemCacheSize <= cacheLevelMax)
+          {
+            // All frames of the item fit and there is even more space. We remain in "adding" mode.
+            plan.cacheJobs.append({allItems[i], itemRange});
+            newCacheLevel += itemCacheSize;
+          }
+          else
+          {
+            // Not all frames fit. Enqueue the ones that fit and set the ones that don't as "can be
+            // deleted".
+            int64_t availableSpace   = cacheLevelMax - newCacheLevel;
+            int64_t nrFramesCachable = availableSpace / allItems[i]->getCachingFrameSize() + 1;
+
+            // These frames should be added...
+            indexRange addFrames =
+                indexRange(itemRange.first, itemRange.first + nrFramesCachable - 1);
+            plan.cacheJobs.append({allItems[i], addFrames});
+            newCacheLevel += nrFramesCachable * allItems[i]->getCachingFrameSize();
+            // ... and the rest should be removed (if they are cached)
+            QList<int> cachedFrames = allItems[i]->getCachedFrames();
+            for (int f : cachedFrames)
+              if (f < addFrames.first || f > addFrames.second)
+                plan.evictionOrder.append({allItems[i], f});
+
+            // The cache is now full. We switch to "deleting" mode.
+            adding = false;
+          }
+        }
+        else
+        {
+          // Enqueue all frames (that are cached) from the item as "can be deleted".
+          QList<int> cachedFrames = allItems[i]->getCachedFrames();
+          for (int f : cachedFrames)
+            plan.evictionOrder.append({allItems[i], f});
+        }
+      }
+
+      // Goto the next item in the list
+      i++;
+      if (i >= allItems.count())
+        i = 0;
+    } while (i != itemPos);
+
+    // Done. However, the list of frames that can be deleted is sorted the wrong way around. Reverse
+    // it.
+    std::reverse(plan.evictionOrder.begin(), plan.evictionOrder.end());
+  }
+  else // playback is not running
+  {
+    if (selectedItem->isCachable() && itemSpaceNeeded > cacheLevelMax &&
+        additionalItemSpaceNeeded > 0)
+    {
+      DEBUG_POLICY("PlaylistOrderPolicy::plan Item needs more space than cacheLevelMax");
+      // All frames of the currently selected item will not fit into the cache
+      // Delete all frames from all other items in the playlist from the cache and cache all frames
+      // from this item that fit
+      for (playlistItem *item : allItems)
+      {
+        if (item != selectedItem)
+        {
+          // Mark all frames of this item as "can be removed if required"
+          QList<int> cachedFrames = item->getCachedFrames();
+          for (int f : cachedFrames)
+            plan.evictionOrder.append({item, f});
+        }
+      }
+
+      // Adjust the range so that only the number of frames are cached that will fit
+      int64_t nrFramesCachable = cacheLevelMax / selectedItem->getCachingFrameSize();
+      range.second             = range.first + nrFramesCachable - 1;
+
+      plan.cacheJobs.append({selectedItem, range});
+    }
+    else if (selectedItem->isCachable() &&
+             additionalItemSpaceNeeded > (cacheLevelMax - cacheLevel) &&
+             additionalItemSpaceNeeded > 0)
+    {
+      DEBUG_POLICY("PlaylistOrderPolicy::plan Not enough space for caching, deleting frames");
+      // There is currently not enough space in the cache to cache all remaining frames but in
+      // general the cache can hold all frames. Delete frames from the cache until it fits.
+
+      // We go through all other items and get the frames that we will delete.
+      // We start with the item before the one before the currently selected one and go back through
+      // the list, wrap around and keep going until we are at the current selected item. Then (as
+      // the last resort) we go to the item before the currently selected one.
+      int i = itemPos - 1;
+      // Go back in the list to the previous item that is indexed
+      while (true)
+      {
+        if (i < 0)
+          i = allItems.count() - 1;
+        if (allItems[i]->properties().isIndexedByFrame())
+          break;
+        i--;
+      }
+      // Go back one item further to the one before the one before the currently selected one.
+      i--;
+      while (true)
+      {
+        if (i < 0)
+          i = allItems.count() - 1;
+        if (allItems[i]->properties().isIndexedByFrame())
+          break;
+        i--;
+      }
+
+      // Get the cache level without the current item (frames from the current item do not really
+      // occupy space in the cache. We want to cache them anyways)
+      int64_t cacheLevelWithoutCurrent =
+          cacheLevel -
+          selectedItem->getNumberCachedFrames() * int64_t(selectedItem->getCachingFrameSize());
+      while ((itemSpaceNeeded + cacheLevelWithoutCurrent) > cacheLevelMax)
+      {
+        if (i == itemPos)
+          // We went through the whole list and arrived back at the beginning.
+          // If playback is running, we go to the previous item at last.
+          i--;
+        if (i < 0)
+        {
+          // There is no previous item or the previous item is the first one in the list
+          i = allItems.count() - 1;
+        }
+        if (allItems[i]->getNumberCachedFrames() == 0)
+        {
+          i--;
+          continue; // Nothing to delete for this item
+        }
+
+        // Which frames are cached for the item at position i?
+        QList<int> cachedFrames = allItems[i]->getCachedFrames();
+        int64_t    cachedFramesSize =
+            cachedFrames.count() * int64_t(allItems[i]->getCachingFrameSize());
+
+        if (additionalItemSpaceNeeded < cachedFramesSize)
+        {
+          // If we delete all frames from item i, there is more than enough space. So we only delete
+          // as many frames as needed.
+          int64_t nrFrames = additionalItemSpaceNeeded / allItems[i]->getCachingFrameSize() + 1;
+
+          // Delete nrFrames frames from the back
+          for (int f = cachedFrames.count() - 1; f >= 0 && nrFrames > 0; f--)
+          {
+            plan.evictionOrder.append({allItems[i], cachedFrames[f]});
+            cacheLevelWithoutCurrent -= allItems[i]->getCachingFrameSize();
+            if ((cacheLevelWithoutCurrent + itemSpaceNeeded) <= cacheLevelMax)
+              // Now there is enough space
+              break;
+          }
+        }
+        else
+        {
+          // Deleting all frames from this item will not be enough.
+          // Mark all frames of this item as "can be removed if required"
+          QList<int> cachedFrames = allItems[i]->getCachedFrames();
+          for (int f : cachedFrames)
+          {
+            plan.evictionOrder.append({allItems[i], f});
+          }
+          cacheLevelWithoutCurrent -= cachedFramesSize;
+        }
+
+        if (i == itemPos - 1)
+        {
+          // We went through all items and tried to delete frames but there is still not enough
+          // space. That is not possible because we determined that the curretn item should fit if
+          // we just delete enough frames.
+          DEBUG_POLICY("PlaylistOrderPolicy::plan ERROR! Deleting loop processed all frames "
+                        "but still not enough space in the cache.");
+          break;
+        }
+
+        // Go to the next (previous) item
+        i--;
+      }
+
+      // Enqueue the job. This is the only job.
+      // We will not delete any frames from any other items to cache frames from other items.
+      plan.cacheJobs.append({selectedItem, range});
+    }
+    else
+    {
+      if (additionalItemSpaceNeeded > 0)
+      {
+        DEBUG_POLICY("PlaylistOrderPolicy::plan All frames of %s fit.",
+                      selectedItem->getName().toLatin1().data());
+        // All frames from the current item will fit and there is probably even space for more
+        // items. In case of playback, we will continue with the next items and delete all frames
+        // that were already played out. Otherwise, we don't delete any frames from the cache but we
+        // will cache as many items as possible.
+        plan.cacheJobs.append({selectedItem, range});
+        cacheLevel = cacheLevel + additionalItemSpaceNeeded;
+      }
+
+      // Continue caching with the next item
+      int i = itemPos + 1;
+
+      while (true)
+      {
+        // There is still space
+        DEBUG_POLICY("PlaylistOrderPolicy::plan Cache not full yet, attempting next item");
+
+        if (i >= allItems.count())
+          // Last item. Continue with item 0.
+          i = 0;
+        if (i == itemPos)
+        {
+          // We went through all items, wrapped around and are back at the current item. No more
+          // items to cache.
+          DEBUG_POLICY("PlaylistOrderPolicy::plan No more items to cache.");
+          break;
+        }
+        if (!allItems[i]->isCachable())
+        {
+          // Nothing to cache for this item.
+          i++;
+          continue;
+        }
+
+        DEBUG_POLICY("PlaylistOrderPolicy::plan Attempt caching of next item %s.",
+                      allItems[i]->getName().toLatin1().data());
+        // How much space is there in the cache (excluding what is cached from the current item)?
+        // Get the cache level without the current item (frames from the current item do not really
+        // occupy space in the cache. We want to cache them anyways)
+        int64_t cacheLevelWithoutCurrent =
+            cacheLevel -
+            allItems[i]->getNumberCachedFrames() * int64_t(allItems[i]->getCachingFrameSize());
+        // How much space do we need to cache the entire item?
+        range = allItems[i]->properties().startEndRange;
+        int64_t itemCacheSize =
+            (range.second - range.first + 1) * int64_t(allItems[i]->getCachingFrameSize());
+
+        if ((itemCacheSize + cacheLevelWithoutCurrent) <= cacheLevelMax)
+        {
+          DEBUG_POLICY("PlaylistOrderPolicy::plan Entire next item %s fits.",
+                        allItems[i]->getName().toLatin1().data());
+          // The entire item fits
+          plan.cacheJobs.append({allItems[i], range});
+        }
+        else
+        {
+          // Only a part of the next item fits without deleting frames
+          if ((itemCacheSize + cacheLevelWithoutCurrent) > cacheLevelMax)
+          {
+            // Only a part of the item fits.
+            int64_t nrFramesCachable =
+                (cacheLevelMax - cacheLevelWithoutCurrent) / allItems[i]->getCachingFrameSize();
+            DEBUG_POLICY("PlaylistOrderPolicy::plan Only %lld frames of next item %s fit.",
+                          nrFramesCachable,
+                          allItems[i]->getName().toLatin1().data());
+            range.second = range.first + nrFramesCachable - 1;
+            plan.cacheJobs.append({allItems[i], range});
+
+            // The cache is now full
+            break;
+          }
+        }
+
+        i++;
+      }
+    }
+  }
+
+  return plan;
+}
+
+/* Keep the frames that will be shown next (in the direction that the user is moving through the
+ * selected item) and remove the least recently used frames of all items first.
+ */
+class RecentlyUsedPolicy : public CachePolicy
+{
+public:
+  CachePlan plan(const CacheState &state) const override;
+};
+
+CachePlan RecentlyUsedPolicy::plan(const CacheState &state) const
+{
+  CachePlan plan;
+  auto      bytesLeft = state.cacheLevelMax;
+
+  if (isCachableIndexedItem(state.selectedItem))
+  {
+    const auto range   = state.selectedItem->properties().startEndRange;
+    const auto current = functions::clip(state.currentFrame, range.first, range.second);
+    const auto nrFrames =
+        std::min(getNrFramesFitting(state.selectedItem, bytesLeft),
+                 int64_t(state.playbackDirection > 0 ? range.second - current + 1
+                                                     : current - range.first + 1));
+
+    std::vector<int> frames;
+    for (int i = 0; i < nrFrames; i++)
+      frames.push_back(current + i * state.playbackDirection);
+    protectAndCache(plan, state.selectedItem, frames);
+    bytesLeft -= nrFrames * int64_t(state.selectedItem->getCachingFrameSize());
+  }
+
+  // While playing, use the remaining space for the items that are played next
+  if (state.playing)
+  {
+    for (int i = 1; i < state.allItems.count(); i++)
+    {
+      auto item = state.allItems[(state.selectedItemPos + i) % state.allItems.count()];
+      if (!isCachableIndexedItem(item))
+        continue;
+      const auto nrFrames = getNrFramesFitting(item, bytesLeft);
+      if (nrFrames == 0)
+        break;
+
+      const auto range = item->properties().startEndRange;
+      std::vector<int> frames;
+      for (int frame = range.first; frame <= range.second && frame < range.first + nrFrames;
+           frame++)
+        frames.push_back(frame);
+      appendCacheJobs(plan, item, frames);
+      bytesLeft -= int64_t(frames.size()) * item->getCachingFrameSize();
+    }
+  }
+
+  appendLeastRecentlyUsed(plan, state.allItems, state.selectedItem, plan.protectedFrames);
+
+  DEBUG_POLICY("RecentlyUsedPolicy::plan protect %d frames from frame %d direction %d",
+               plan.protectedFrames.size(),
+               state.currentFrame,
+               state.playbackDirection);
+  return plan;
+}
+
+/* Repeated playback of the range of the selected item (between its start and end frame). The
+ * frames of the loop are kept starting at the playhead in loop order (wrapping around at the end of
+ * the range). All other items are removed from the cache first. Then the frames of the loop which
+ * will be shown last.
+ */
+class LoopRegionPolicy : public CachePolicy
+{
+public:
+  CachePlan plan(const CacheState &state) const override;
+};
+
+CachePlan LoopRegionPolicy::plan(const CacheState &state) const
+{
+  CachePlan plan;
+
+  if (!isCachableIndexedItem(state.selectedItem))
+  {
+    appendLeastRecentlyUsed(plan, state.allItems, nullptr, {});
+    return plan;
+  }
+
+  const auto item       = state.selectedItem;
+  const auto range      = item->properties().startEndRange;
+  const auto loopLength = range.second - range.first + 1;
+  const auto current    = functions::clip(state.currentFrame, range.first, range.second);
+  const auto nrFrames =
+      std::min(getNrFramesFitting(item, state.cacheLevelMax), int64_t(loopLength));
+
+  // The distance (in frames) from the playhead to the given frame when following the loop
+  const auto loopDistance = [&](int frame) {
+    return (frame - current + loopLength) % loopLength;
+  };
+
+  std::vector<int> frames;
+  for (int i = 0; i < nrFrames; i++)
+    frames.push_back(range.first + (current - range.first + i) % loopLength);
+  protectAndCache(plan, item, frames);
+
+  auto otherItems = state.allItems;
+  otherItems.removeAll(item);
+  appendLeastRecentlyUsed(plan, otherItems, nullptr, {});
+
+  std::vector<int> loopFrames;
+  for (const auto frame : item->getCachedFrames())
+    if (!plan.protectedFrames.contains(frame))
+      loopFrames.push_back(frame);
+  std::sort(loopFrames.begin(), loopFrames.end(), [&](int a, int b) {
+    return loopDistance(a) > loopDistance(b);
+  });
+  for (const auto frame : loopFrames)
+    plan.evictionOrder.append({item, frame});
+
+  DEBUG_POLICY("LoopRegionPolicy::plan protect %d of %d frames from frame %d",
+               plan.protectedFrames.size(),
+               loopLength,
+               current);
+  return plan;
+}
+
+} // namespace
+
+uint64_t nextCacheAccessTick()
+{
+  static std::atomic<uint64_t> tick{1};
+  return tick++;
+}
+
+std::unique_ptr<CachePolicy> createCachePolicy(CachePolicyType type)
+{
+  if (type == CachePolicyType::RecentlyUsed)
+    return std::make_unique<RecentlyUsedPolicy>();
+  if (type == CachePolicyType::LoopRegion)
+    return std::make_unique<LoopRegionPolicy>();
+  return std::make_unique<PlaylistOrderPolicy>();
+}
+
+} // namespace video
@@ -0,0 +1,137 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/EnumMapper.h>
+#include <common/Typedef.h>
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+#include <memory>
+
+class playlistItem;
+
+namespace video
+{
+
+// Statistics about the use of the frame cache of one item. These can be used to decide how large
+// the cache should be.
+struct CacheStatistics
+{
+  // A frame that was drawn was found in the cache or had to be loaded
+  uint64_t hits{};
+  uint64_t misses{};
+  // Frames that were removed from the cache to make space for other frames
+  uint64_t evictions{};
+  // The number of bytes that the cached frames occupy
+  int64_t bytes{};
+  // The size of the compressed frames in the cache (compressed and uncompressed)
+  int64_t compressedBytes{};
+  int64_t uncompressedBytes{};
+  // The number of bytes that were decompressed and the time that this took
+  int64_t decompressedBytes{};
+  int64_t decompressionNs{};
+
+  double hitRate() const { return hits + misses == 0 ? 0.0 : double(hits) / (hits + misses); }
+  double compressionRatio() const
+  {
+    return compressedBytes == 0 ? 0.0 : double(uncompressedBytes) / compressedBytes;
+  }
+  // The decompression throughput in MB (of decompressed data) per second
+  double decompressionMBps() const
+  {
+    return decompressionNs == 0 ? 0.0 : double(decompressedBytes) * 1000.0 / decompressionNs;
+  }
+};
+
+// Get the next value of a global counter that orders all accesses to cached frames (of all items)
+uint64_t nextCacheAccessTick();
+
+enum class CachePolicyType
+{
+  PlaylistOrder,
+  RecentlyUsed,
+  LoopRegion
+};
+
+const auto CachePolicyTypeMapper = EnumMapper<CachePolicyType>(
+    {{CachePolicyType::PlaylistOrder, "PlaylistOrder", "Playlist order"},
+     {CachePolicyType::RecentlyUsed, "RecentlyUsed", "Least recently used (playback direction)"},
+     {CachePolicyType::LoopRegion, "LoopRegion", "Loop region"}});
+
+// The state of the playlist and the playback that a cache policy bases its decisions on
+struct CacheState
+{
+  // All items in the playlist and the selected one (with its position in allItems)
+  QList<playlistItem *> allItems;
+  playlistItem *        selectedItem{};
+  int                   selectedItemPos{};
+
+  bool playing{};
+  // The frame that is shown and the direction that the user is moving in (1 or -1)
+  int currentFrame{};
+  int playbackDirection{1};
+
+  // The number of bytes that are currently cached and the maximum
+  int64_t cacheLevel{};
+  int64_t cacheLevelMax{};
+};
+
+// What a cache policy decided
+struct CachePlan
+{
+  // The frames to cache next (in this order)
+  QList<QPair<playlistItem *, indexRange>> cacheJobs;
+  // Cached frames that may be removed to make space (in this order)
+  QList<QPair<playlistItem *, int>> evictionOrder;
+  // The frames of the selected item that the plan keeps in the cache, ranked by priority (0 is the
+  // highest). If the playhead leaves the first half of these, the plan should be updated.
+  QHash<int, int> protectedFrames;
+};
+
+/* A cache policy decides which frames to cache next and which cached frames to remove first when
+ * the cache is full. It is queried by the VideoCache whenever the caching queue is updated.
+ */
+class CachePolicy
+{
+public:
+  virtual ~CachePolicy() = default;
+
+  virtual CachePlan plan(const CacheState &state) const = 0;
+};
+
+std::unique_ptr<CachePolicy> createCachePolicy(CachePolicyType type);
+
+} // namespace video
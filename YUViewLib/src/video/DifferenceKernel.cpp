@@ -0,0 +1,508 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DifferenceKernel.h"
+
+#include "PlanarYUV.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DIFFERENCE_KERNEL_SSE2 1
+#else
+#define DIFFERENCE_KERNEL_SSE2 0
+#endif
+
+namespace video::yuv
+{
+
+namespace
+{
+
+// Stripes are aligned to this many luma lines. This is a multiple of the block size and of all
+// vertical subsamplings so that each stripe writes its own lines of blocks and chroma lines.
+constexpr unsigned STRIPE_ALIGNMENT = 16;
+// Don't split frames into stripes that are smaller than this (the overhead would dominate)
+constexpr unsigned MIN_STRIPE_HEIGHT = 64;
+
+struct LineParameters
+{
+  unsigned width{};
+  unsigned valueSkip[2]{};
+  int      shift[2]{};
+  int      amplification{};
+  int      diffZero{};
+  int      maxVal{};
+};
+
+// Calculate the difference of one line. Returns the sum of squared errors and updates the maximum
+// absolute difference. The loop has no data dependent branches so that it can be vectorized.
+template <unsigned Bytes0, bool BigEndian0, unsigned Bytes1, bool BigEndian1, bool Contiguous>
+uint64_t differenceLine(const unsigned char * src0,
+                        const unsigned char * src1,
+                        unsigned char *       dst,
+                        const LineParameters &p,
+                        unsigned &            maxAbsDifference)
+{
+  constexpr auto BytesOut = std::max(Bytes0, Bytes1);
+
+  const auto skip0 = Contiguous ? 1 : p.valueSkip[0];
+  const auto skip1 = Contiguous ? 1 : p.valueSkip[1];
+
+  uint64_t sse    = 0;
+  int      maxAbs = 0;
+  for (unsigned x = 0; x < p.width; x++)
+  {
+    const auto val0 = readSample<Bytes0, BigEndian0>(src0, size_t(x) * skip0) << p.shift[0];
+    const auto val1 = readSample<Bytes1, BigEndian1>(src1, size_t(x) * skip1) << p.shift[1];
+    const auto diff = val0 - val1;
+    sse += uint64_t(int64_t(diff) * diff);
+    maxAbs = std::max(maxAbs, std::abs(diff));
+    const auto out = std::clamp(diff * p.amplification + p.diffZero, 0, p.maxVal);
+    writeSample<BytesOut>(dst, x, out);
+  }
+  maxAbsDifference = std::max(maxAbsDifference, unsigned(maxAbs));
+  return sse;
+}
+
+#if DIFFERENCE_KERNEL_SSE2
+// The most common case: Two 8 bit planes without interleaving. The amplification must be small
+// enough so that the amplified difference fits into 16 bit.
+uint64_t differenceLine8BitSSE2(const unsigned char * src0,
+                                const unsigned char * src1,
+                                unsigned char *       dst,
+                                const LineParameters &p,
+                                unsigned &            maxAbsDifference)
+{
+  const auto zero          = _mm_setzero_si128();
+  const auto diffZero      = _mm_set1_epi16(short(p.diffZero));
+  const auto amplification = _mm_set1_epi16(short(p.amplification));
+
+  auto     sseAcc = _mm_setzero_si128();
+  auto     maxAcc = _mm_setzero_si128();
+  unsigned x      = 0;
+  for (; x + 16 <= p.width; x += 16)
+  {
+    const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src0 + x));
+    const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1 + x));
+
+    const auto diffLo = _mm_sub_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    const auto diffHi = _mm_sub_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+    // The squared differences of two neighbors are added in 32 bit
+    sseAcc = _mm_add_epi32(sseAcc, _mm_madd_epi16(diffLo, diffLo));
+    sseAcc = _mm_add_epi32(sseAcc, _mm_madd_epi16(diffHi, diffHi));
+
+    const auto absLo = _mm_max_epi16(diffLo, _mm_sub_epi16(zero, diffLo));
+    const auto absHi = _mm_max_epi16(diffHi, _mm_sub_epi16(zero, diffHi));
+    maxAcc           = _mm_max_epi16(maxAcc, _mm_max_epi16(absLo, absHi));
+
+    // Amplify, add the offset and clip to 0...255 (packus saturates)
+    const auto outLo = _mm_adds_epi16(_mm_mullo_epi16(diffLo, amplification), diffZero);
+    const auto outHi = _mm_adds_epi16(_mm_mullo_epi16(diffHi, amplification), diffZero);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_packus_epi16(outLo, outHi));
+  }
+
+  uint32_t sseLanes[4];
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(sseLanes), sseAcc);
+  int16_t maxLanes[8];
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(maxLanes), maxAcc);
+
+  uint64_t sse = uint64_t(sseLanes[0]) + sseLanes[1] + sseLanes[2] + sseLanes[3];
+  for (auto lane : maxLanes)
+    maxAbsDifference = std::max(maxAbsDifference, unsigned(lane));
+
+  // The remaining samples
+  if (x < p.width)
+  {
+    auto rest  = p;
+    rest.width = p.width - x;
+    sse += differenceLine<1, false, 1, false, true>(
+        src0 + x, src1 + x, dst + x, rest, maxAbsDifference);
+  }
+  return sse;
+}
+#endif
+
+using DifferenceLineFunction = uint64_t (*)(const unsigned char *,
+                                            const unsigned char *,
+                                            unsigned char *,
+                                            const LineParameters &,
+                                            unsigned &);
+
+template <unsigned Bytes0, bool BigEndian0, unsigned Bytes1, bool BigEndian1>
+DifferenceLineFunction selectLineFunction(bool contiguous)
+{
+  if (contiguous)
+    return differenceLine<Bytes0, BigEndian0, Bytes1, BigEndian1, true>;
+  return differenceLine<Bytes0, BigEndian0, Bytes1, BigEndian1, false>;
+}
+
+template <unsigned Bytes0, bool BigEndian0>
+DifferenceLineFunction selectLineFunction(const PlaneView &plane1, bool contiguous)
+{
+  if (plane1.bitDepth <= 8)
+    return selectLineFunction<Bytes0, BigEndian0, 1, false>(contiguous);
+  if (plane1.bigEndian)
+    return selectLineFunction<Bytes0, BigEndian0, 2, true>(contiguous);
+  return selectLineFunction<Bytes0, BigEndian0, 2, false>(contiguous);
+}
+
+DifferenceLineFunction selectLineFunction(const PlaneView &     plane0,
+                                          const PlaneView &     plane1,
+                                          const LineParameters &p)
+{
+  const auto contiguous = plane0.valueSkip == 1 && plane1.valueSkip == 1;
+
+#if DIFFERENCE_KERNEL_SSE2
+  if (contiguous && plane0.bitDepth == 8 && plane1.bitDepth == 8 && p.amplification <= 128)
+    return differenceLine8BitSSE2;
+#else
+  (void)p;
+#endif
+
+  if (plane0.bitDepth <= 8)
+    return selectLineFunction<1, false>(plane1, contiguous);
+  if (plane0.bigEndian)
+    return selectLineFunction<2, true>(plane1, contiguous);
+  return selectLineFunction<2, false>(plane1, contiguous);
+}
+
+// Mark the blocks of the line that contain a difference. This is only called for lines with
+// differences. It is not performance critical if the frames are similar.
+void markDifferenceBlocks(const PlaneView & plane0,
+                          const PlaneView & plane1,
+                          const unsigned    lineIndex,
+                          const unsigned    width,
+                          const unsigned    subsamplingHor,
+                          const unsigned    subsamplingVer,
+                          DifferenceResult &result)
+{
+  const auto line0 = plane0.data + plane0.stride * lineIndex;
+  const auto line1 = plane1.data + plane1.stride * lineIndex;
+  auto       read  = [](const PlaneView &plane, const unsigned char *line, unsigned x) {
+    const auto idx = size_t(x) * plane.valueSkip;
+    if (plane.bitDepth <= 8)
+      return int(line[idx]);
+    if (plane.bigEndian)
+      return (line[idx * 2] << 8) | line[idx * 2 + 1];
+    return line[idx * 2] | (line[idx * 2 + 1] << 8);
+  };
+
+  const auto maxBitDepth = std::max(plane0.bitDepth, plane1.bitDepth);
+  const auto shift0      = maxBitDepth - plane0.bitDepth;
+  const auto shift1      = maxBitDepth - plane1.bitDepth;
+  const auto blockLine   = lineIndex * subsamplingVer / DIFFERENCE_BLOCK_SIZE;
+  auto       blocks      = result.blockHasDifference.data() + size_t(blockLine) * result.blocksHor;
+  for (unsigned x = 0; x < width; x++)
+    if ((read(plane0, line0, x) << shift0) != (read(plane1, line1, x) << shift1))
+      blocks[x * subsamplingHor / DIFFERENCE_BLOCK_SIZE] = 1;
+}
+
+// Call the function for horizontal stripes of the frame (in parallel if the frame is big enough).
+// The function gets the first and last (exclusive) luma line of the stripe.
+template <typename Function> void forEachStripe(const unsigned height, Function function)
+{
+  const auto maxStripes = unsigned(std::max(QThreadPool::globalInstance()->maxThreadCount(), 1));
+  const auto nrStripes  = std::min(maxStripes, std::max(height / MIN_STRIPE_HEIGHT, 1u));
+  if (nrStripes <= 1)
+  {
+    function(0u, height);
+    return;
+  }
+
+  auto stripeHeight = (height + nrStripes - 1) / nrStripes;
+  stripeHeight      = (stripeHeight + STRIPE_ALIGNMENT - 1) / STRIPE_ALIGNMENT * STRIPE_ALIGNMENT;
+
+  std::vector<std::pair<unsigned, unsigned>> stripes;
+  for (unsigned y = 0; y < height; y += stripeHeight)
+    stripes.push_back({y, std::min(y + stripeHeight, height)});
+
+  QtConcurrent::blockingMap(stripes, [&function](const std::pair<unsigned, unsigned> &stripe) {
+    function(stripe.first, stripe.second);
+  });
+}
+
+template <unsigned Bytes> inline int readDiffSample(const unsigned char *src, const size_t idx)
+{
+  return readSample<Bytes, false>(src, idx);
+}
+
+template <unsigned Bytes>
+void markDifferencesLines(const unsigned char *srcY,
+                          const unsigned char *srcU,
+                          const unsigned char *srcV,
+                          const Size           frameSize,
+                          const unsigned       subsamplingHor,
+                          const unsigned       subsamplingVer,
+                          const int            diffZero,
+                          const unsigned       firstLine,
+                          const unsigned       lastLine,
+                          unsigned char *      dst)
+{
+  const auto w       = frameSize.width;
+  const auto strideC = w / subsamplingHor;
+  for (unsigned y = firstLine; y < lastLine; y++)
+  {
+    const auto lineY   = srcY + size_t(y) * w * Bytes;
+    const auto lineU   = srcU ? srcU + size_t(y / subsamplingVer) * strideC * Bytes : nullptr;
+    const auto lineV   = srcV ? srcV + size_t(y / subsamplingVer) * strideC * Bytes : nullptr;
+    auto       lineDst = dst + size_t(y) * w * 4;
+    for (unsigned x = 0; x < w; x++)
+    {
+      const auto diffY = readDiffSample<Bytes>(lineY, x) != diffZero;
+      const auto diffU = lineU && readDiffSample<Bytes>(lineU, x / subsamplingHor) != diffZero;
+      const auto diffV = lineV && readDiffSample<Bytes>(lineV, x / subsamplingHor) != diffZero;
+
+      // Gray: Only luma differs. Green/Blue: U/V differs (dark if luma is identical).
+      unsigned char R = 0, G = 0, B = 0;
+      if (!diffY)
+      {
+        G = diffU ? 70 : 0;
+        B = diffV ? 70 : 0;
+      }
+      else if (!diffU && !diffV)
+      {
+        R = 70;
+        G = 70;
+        B = 70;
+      }
+      else
+      {
+        G = diffU ? 255 : 0;
+        B = diffV ? 255 : 0;
+      }
+
+      lineDst[x * 4]     = B;
+      lineDst[x * 4 + 1] = G;
+      lineDst[x * 4 + 2] = R;
+      lineDst[x * 4 + 3] = 255;
+    }
+  }
+}
+
+// Recursively scan the block in z-order. Count the scanned 4x4 blocks in partIndex.
+bool findFirstDifferenceInBlock(const DifferenceResult & result,
+                                unsigned                 blockX,
+                                unsigned                 blockY,
+                                unsigned                 nrBlocks,
+                                FirstDifferencePosition &position)
+{
+  if (blockX >= result.blocksHor || blockY >= result.blocksVer)
+    // This block is entirely outside of the picture
+    return false;
+
+  if (nrBlocks == 1)
+  {
+    if (result.hasDifference(blockX, blockY))
+    {
+      position.x = blockX * DIFFERENCE_BLOCK_SIZE;
+      position.y = blockY * DIFFERENCE_BLOCK_SIZE;
+      return true;
+    }
+    position.partIndex++;
+    return false;
+  }
+
+  const auto half = nrBlocks / 2;
+  return findFirstDifferenceInBlock(result, blockX, blockY, half, position) ||
+         findFirstDifferenceInBlock(result, blockX + half, blockY, half, position) ||
+         findFirstDifferenceInBlock(result, blockX, blockY + half, half, position) ||
+         findFirstDifferenceInBlock(result, blockX + half, blockY + half, half, position);
+}
+
+} // namespace
+
+DifferenceResult calculateDifferencePlanar(const QByteArray &    frame0,
+                                           const PixelFormatYUV &format0,
+                                           const Size            frameSize0,
+                                           const QByteArray &    frame1,
+                                           const PixelFormatYUV &format1,
+                                           const Size            frameSize1,
+                                           const int             amplificationFactor,
+                                           QByteArray &          diffYUV,
+                                           PixelFormatYUV &      diffFormat)
+{
+  // The chroma planes of both frames are indexed with the same geometry. The callers must fall
+  // back to another comparison (e.g. of the RGB values) if the subsampling differs.
+  assert(format0.getSubsampling() == format1.getSubsampling());
+  if (format0.getSubsampling() != format1.getSubsampling())
+  {
+    diffYUV.clear();
+    return {};
+  }
+
+  const auto subsampling = format0.getSubsampling();
+  const auto planes0     = getPlaneViews(frame0, format0, frameSize0);
+  const auto planes1     = getPlaneViews(frame1, format1, frameSize1);
+  const auto bitDepth    = std::max(format0.getBitsPerSample(), format1.getBitsPerSample());
+  const auto sampleBytes = bitDepth > 8 ? 2u : 1u;
+  const auto w           = std::min(frameSize0.width, frameSize1.width);
+  const auto h           = std::min(frameSize0.height, frameSize1.height);
+  const auto subH        = unsigned(format0.getSubsamplingHor());
+  const auto subV        = unsigned(format0.getSubsamplingVer());
+
+  diffFormat = PixelFormatYUV(subsampling, bitDepth, PlaneOrder::YUV, false);
+
+  // The output planes (Y, U, V)
+  const auto lumaBytes   = size_t(w) * h * sampleBytes;
+  const auto chromaBytes = size_t(w / subH) * (h / subV) * sampleBytes;
+  diffYUV.resize(int(lumaBytes + (planes0.size() - 1) * chromaBytes));
+  const auto dstData = reinterpret_cast<unsigned char *>(diffYUV.data());
+
+  DifferenceResult result;
+  result.planes.resize(planes0.size());
+  result.blocksHor = (w + DIFFERENCE_BLOCK_SIZE - 1) / DIFFERENCE_BLOCK_SIZE;
+  result.blocksVer = (h + DIFFERENCE_BLOCK_SIZE - 1) / DIFFERENCE_BLOCK_SIZE;
+  result.blockHasDifference.assign(size_t(result.blocksHor) * result.blocksVer, 0);
+
+  LineParameters         lineParameters[3];
+  DifferenceLineFunction lineFunctions[3];
+  for (size_t c = 0; c < planes0.size(); c++)
+  {
+    auto &p          = lineParameters[c];
+    p.width          = (c == 0) ? w : w / subH;
+    p.valueSkip[0]   = planes0[c].valueSkip;
+    p.valueSkip[1]   = planes1[c].valueSkip;
+    p.shift[0]       = int(bitDepth - planes0[c].bitDepth);
+    p.shift[1]       = int(bitDepth - planes1[c].bitDepth);
+    p.amplification  = std::max(amplificationFactor, 1);
+    p.diffZero       = 128 << (bitDepth - 8);
+    p.maxVal         = (1 << bitDepth) - 1;
+    lineFunctions[c] = selectLineFunction(planes0[c], planes1[c], p);
+
+    result.planes[c].nrSamples = uint64_t(p.width) * ((c == 0) ? h : h / subV);
+  }
+
+  std::mutex resultMutex;
+  forEachStripe(h, [&](unsigned firstLine, unsigned lastLine) {
+    std::vector<DifferencePlaneStatistics> stripeStatistics(planes0.size());
+    for (size_t c = 0; c < planes0.size(); c++)
+    {
+      const auto isLuma     = (c == 0);
+      const auto first      = isLuma ? firstLine : firstLine / subV;
+      const auto last       = isLuma ? lastLine : lastLine / subV;
+      const auto dstStride  = size_t(lineParameters[c].width) * sampleBytes;
+      const auto dstPlane   = dstData + (isLuma ? 0 : lumaBytes + (c - 1) * chromaBytes);
+      auto &     statistics = stripeStatistics[c];
+      for (unsigned y = first; y < last; y++)
+      {
+        unsigned   lineMax = 0;
+        const auto sse     = lineFunctions[c](planes0[c].data + planes0[c].stride * y,
+                                              planes1[c].data + planes1[c].stride * y,
+                                              dstPlane + dstStride * y,
+                                              lineParameters[c],
+                                              lineMax);
+        if (lineMax > 0)
+        {
+          statistics.sumSquaredError += sse;
+          statistics.maxAbsDifference = std::max(statistics.maxAbsDifference, lineMax);
+          markDifferenceBlocks(planes0[c],
+                               planes1[c],
+                               y,
+                               lineParameters[c].width,
+                               isLuma ? 1 : subH,
+                               isLuma ? 1 : subV,
+                               result);
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(resultMutex);
+    for (size_t c = 0; c < planes0.size(); c++)
+    {
+      result.planes[c].sumSquaredError += stripeStatistics[c].sumSquaredError;
+      result.planes[c].maxAbsDifference =
+          std::max(result.planes[c].maxAbsDifference, stripeStatistics[c].maxAbsDifference);
+    }
+  });
+
+  return result;
+}
+
+void markDifferencesToRGB(const QByteArray &    diffYUV,
+                          const PixelFormatYUV &diffFormat,
+                          const Size            frameSize,
+                          unsigned char *       targetBuffer)
+{
+  const auto bitDepth    = diffFormat.getBitsPerSample();
+  const auto sampleBytes = bitDepth > 8 ? 2u : 1u;
+  const auto diffZero    = 128 << (bitDepth - 8);
+  const auto subH        = unsigned(diffFormat.getSubsamplingHor());
+  const auto subV        = unsigned(diffFormat.getSubsamplingVer());
+  const auto hasChroma   = diffFormat.getSubsampling() != Subsampling::YUV_400;
+
+  const auto lumaBytes   = size_t(frameSize.width) * frameSize.height * sampleBytes;
+  const auto chromaBytes = size_t(frameSize.width / subH) * (frameSize.height / subV) * sampleBytes;
+  const auto srcY        = reinterpret_cast<const unsigned char *>(diffYUV.constData());
+  const auto srcU        = hasChroma ? srcY + lumaBytes : nullptr;
+  const auto srcV        = hasChroma ? srcY + lumaBytes + chromaBytes : nullptr;
+
+  forEachStripe(frameSize.height, [&](unsigned firstLine, unsigned lastLine) {
+    if (sampleBytes == 1)
+      markDifferencesLines<1>(
+          srcY, srcU, srcV, frameSize, subH, subV, diffZero, firstLine, lastLine, targetBuffer);
+    else
+      markDifferencesLines<2>(
+          srcY, srcU, srcV, frameSize, subH, subV, diffZero, firstLine, lastLine, targetBuffer);
+  });
+}
+
+std::optional<FirstDifferencePosition> findFirstDifferenceHEVC(const DifferenceResult &result)
+{
+  const auto blocksPerLCU = 64 / DIFFERENCE_BLOCK_SIZE;
+  const auto widthLCU     = (result.blocksHor + blocksPerLCU - 1) / blocksPerLCU;
+  const auto heightLCU    = (result.blocksVer + blocksPerLCU - 1) / blocksPerLCU;
+
+  for (unsigned y = 0; y < heightLCU; y++)
+  {
+    for (unsigned x = 0; x < widthLCU; x++)
+    {
+      FirstDifferencePosition position;
+      position.lcu = y * widthLCU + x;
+      if (findFirstDifferenceInBlock(
+              result, x * blocksPerLCU, y * blocksPerLCU, blocksPerLCU, position))
+        return position;
+    }
+  }
+
+  return {};
+}
+
+} // namespace video::yuv
@@ -0,0 +1,117 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PixelFormatYUV.h"
+
+#include <QByteArray>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace video::yuv
+{
+
+struct DifferencePlaneStatistics
+{
+  uint64_t sumSquaredError{};
+  unsigned maxAbsDifference{};
+  uint64_t nrSamples{};
+
+  double getMSE() const
+  {
+    return this->nrSamples > 0 ? double(this->sumSquaredError) / double(this->nrSamples) : 0.0;
+  }
+};
+
+/* The result of the difference calculation of two YUV frames. Next to the statistics per plane, the
+ * positions of the differences are kept on a grid of 4x4 luma samples so that the first difference
+ * (e.g. in coding order) can be found without scanning the difference image again. A difference in
+ * a chroma sample is marked in the block of the co-located luma sample.
+ */
+struct DifferenceResult
+{
+  std::vector<DifferencePlaneStatistics> planes;
+
+  unsigned             blocksHor{};
+  unsigned             blocksVer{};
+  std::vector<uint8_t> blockHasDifference;
+
+  bool hasDifference(unsigned blockX, unsigned blockY) const
+  {
+    return blockX < this->blocksHor && blockY < this->blocksVer &&
+           this->blockHasDifference[blockY * this->blocksHor + blockX] != 0;
+  }
+};
+
+constexpr unsigned DIFFERENCE_BLOCK_SIZE = 4;
+
+struct FirstDifferencePosition
+{
+  unsigned lcu{};
+  unsigned x{};
+  unsigned y{};
+  unsigned partIndex{}; // The number of 4x4 blocks in the LCU before the difference in z-scan
+};
+
+// Find the first block with a difference in HEVC coding order. The picture is split into LCUs of
+// 64x64 samples in raster scan and each LCU is scanned in a quad tree (z-scan) down to 4x4 blocks.
+std::optional<FirstDifferencePosition> findFirstDifferenceHEVC(const DifferenceResult &result);
+
+// Calculate the difference between two planar YUV frames with the same subsampling in one pass.
+// Frames with a different subsampling are not supported (an empty result is returned).
+// The frames may differ in size (the top left aligned overlapping part is compared), bit depth
+// (the lower bit depth is scaled up), plane order, UV interleaving and endianness.
+// The difference (multiplied by the amplification factor and offset to the middle of the value
+// range) is written to diffYUV in diffFormat (planar YUV, little endian, the higher bit depth).
+// The work is split into horizontal stripes which are processed in parallel.
+DifferenceResult calculateDifferencePlanar(const QByteArray &    frame0,
+                                           const PixelFormatYUV &format0,
+                                           const Size            frameSize0,
+                                           const QByteArray &    frame1,
+                                           const PixelFormatYUV &format1,
+                                           const Size            frameSize1,
+                                           const int             amplificationFactor,
+                                           QByteArray &          diffYUV,
+                                           PixelFormatYUV &      diffFormat);
+
+// Convert a difference buffer (as returned by calculateDifferencePlanar) to an image which only
+// marks the positions of differences in luma (gray), U (green) and V (blue). The target buffer
+// must hold 4 bytes (BGRA) per pixel.
+void markDifferencesToRGB(const QByteArray &    diffYUV,
+                          const PixelFormatYUV &diffFormat,
+                          const Size            frameSize,
+                          unsigned char *       targetBuffer);
+
+} // namespace video::yuv
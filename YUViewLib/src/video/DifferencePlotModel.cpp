@@ -0,0 +1,210 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DifferencePlotModel.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace video
+{
+
+namespace
+{
+
+// If all frames are identical, the plot still needs a y range to draw the axis
+const double MIN_Y_RANGE = 1.0;
+
+} // namespace
+
+unsigned DifferencePlotModel::getNrStreams() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return this->frames.empty() ? 0 : 1;
+}
+
+PlotModel::StreamParameter DifferencePlotModel::getStreamParameter(unsigned streamIndex) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (streamIndex > 0 || this->frames.empty())
+    return {};
+
+  PlotModel::StreamParameter streamParameter;
+  streamParameter.xRange = {double(this->frames.front().frameIndex),
+                            double(this->frames.back().frameIndex)};
+  streamParameter.yRange = {0, std::max(this->maxMSE, MIN_Y_RANGE)};
+  streamParameter.plotParameters.append({PlotType::Bar, unsigned(this->frames.size())});
+
+  return streamParameter;
+}
+
+PlotModel::Point DifferencePlotModel::getPlotPoint(unsigned streamIndex,
+                                                   unsigned plotIndex,
+                                                   unsigned pointIndex) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (streamIndex > 0 || plotIndex > 0 || pointIndex >= this->frames.size())
+    return {};
+  return DifferencePlotModel::toPlotPoint(this->frames[pointIndex]);
+}
+
+QString DifferencePlotModel::getPointInfo(unsigned streamIndex,
+                                          unsigned plotIndex,
+                                          unsigned pointIndex) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (streamIndex > 0 || plotIndex > 0 || pointIndex >= this->frames.size())
+    return {};
+
+  const auto &frame = this->frames[pointIndex];
+  if (!frame.valid)
+    return QString("<h4>Frame %1</h4>Comparing the frames failed.").arg(frame.frameIndex);
+
+  const auto firstDifference =
+      frame.firstDifference
+          ? QString("%1,%2").arg(frame.firstDifference->x).arg(frame.firstDifference->y)
+          : QString("-");
+  return QString("<h4>Frame %1</h4>"
+                 "<table width=\"100%\">"
+                 "<tr><td>MSE:</td><td align=\"right\">%2</td></tr>"
+                 "<tr><td>Max abs diff:</td><td align=\"right\">%3</td></tr>"
+                 "<tr><td>First diff X,Y:</td><td align=\"right\">%4</td></tr>"
+                 "</table>")
+      .arg(frame.frameIndex)
+      .arg(frame.mse, 0, 'f', 2)
+      .arg(frame.maxAbsDifference)
+      .arg(firstDifference);
+}
+
+std::optional<unsigned> DifferencePlotModel::getReasonabelRangeToShowOnXAxisPer100Pixels() const
+{
+  // Try to show 10 frames per 100 px
+  return 10;
+}
+
+QString DifferencePlotModel::formatValue(Axis axis, double value) const
+{
+  if (axis == Axis::X)
+    return QString("%1").arg(value);
+  return QString("%1").arg(value, 0, 'f', 1);
+}
+
+Range<double> DifferencePlotModel::getYRange() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return {0, std::max(this->maxMSE, MIN_Y_RANGE)};
+}
+
+std::vector<PlotModel::Bucket> DifferencePlotModel::getPlotBuckets(unsigned      streamIndex,
+                                                                   unsigned      plotIndex,
+                                                                   Range<double> xRange,
+                                                                   double        columnWidth) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (streamIndex > 0 || plotIndex > 0)
+    return {};
+  return this->pyramid.getBuckets(xRange, columnWidth);
+}
+
+void DifferencePlotModel::addFrame(const FrameDifference &frame)
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  assert(this->frames.empty() || this->frames.back().frameIndex < frame.frameIndex);
+
+  const auto newStream = this->frames.empty();
+  this->frames.push_back(frame);
+  if (frame.differs)
+    this->differingFrames.push_back(frame.frameIndex);
+  this->maxMSE = std::max(this->maxMSE, frame.mse);
+  this->pyramid.append(DifferencePlotModel::toPlotPoint(frame));
+  locker.unlock();
+
+  this->eventSubsampler.postEvent();
+  if (newStream)
+    emit nrStreamsChanged();
+}
+
+void DifferencePlotModel::clear()
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (this->frames.empty())
+    return;
+
+  this->frames.clear();
+  this->differingFrames.clear();
+  this->pyramid.clear();
+  this->maxMSE = 0;
+  locker.unlock();
+
+  emit nrStreamsChanged();
+}
+
+unsigned DifferencePlotModel::getNrFrames() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return unsigned(this->frames.size());
+}
+
+unsigned DifferencePlotModel::getNrDifferingFrames() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return unsigned(this->differingFrames.size());
+}
+
+std::optional<int> DifferencePlotModel::getNextDifferingFrame(int frameIndex) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  const auto it =
+      std::upper_bound(this->differingFrames.begin(), this->differingFrames.end(), frameIndex);
+  if (it == this->differingFrames.end())
+    return {};
+  return *it;
+}
+
+PlotModel::Point DifferencePlotModel::toPlotPoint(const FrameDifference &frame)
+{
+  PlotModel::Point point;
+  point.x     = frame.frameIndex;
+  point.y     = frame.mse;
+  point.width = 1;
+  point.intra = frame.differs;
+  return point;
+}
+
+} // namespace video
@@ -0,0 +1,101 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <optional>
+#include <vector>
+
+#include <ui/views/PlotDecimationPyramid.h>
+#include <ui/views/PlotModel.h>
+#include <video/DifferenceKernel.h>
+
+namespace video
+{
+
+// The result of the comparison of one frame of a sequence difference scan
+struct FrameDifference
+{
+  int      frameIndex{};
+  bool     valid{}; // False if the frames could not be loaded or compared
+  bool     differs{};
+  double   mse{}; // Over all samples of all planes
+  unsigned maxAbsDifference{};
+
+  std::optional<yuv::FirstDifferencePosition> firstDifference; // In HEVC coding order
+};
+
+// Holds the per frame results of a sequence difference scan and plots the MSE of each frame. Frames
+// that differ are drawn highlighted. The frames must be added in increasing frame order.
+class DifferencePlotModel : public PlotModel
+{
+public:
+  DifferencePlotModel()          = default;
+  virtual ~DifferencePlotModel() = default;
+
+  unsigned                   getNrStreams() const override;
+  PlotModel::StreamParameter getStreamParameter(unsigned streamIndex) const override;
+  PlotModel::Point
+  getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
+  QString
+  getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
+  std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const override;
+  QString                 formatValue(Axis axis, double value) const override;
+  Range<double>           getYRange() const override;
+
+  std::vector<PlotModel::Bucket> getPlotBuckets(unsigned      streamIndex,
+                                                unsigned      plotIndex,
+                                                Range<double> xRange,
+                                                double        columnWidth) const override;
+
+  void addFrame(const FrameDifference &frame);
+  void clear();
+
+  unsigned getNrFrames() const;
+  unsigned getNrDifferingFrames() const;
+
+  // The first differing frame after the given frame index (if it was already scanned)
+  std::optional<int> getNextDifferingFrame(int frameIndex) const;
+
+private:
+  static PlotModel::Point toPlotPoint(const FrameDifference &frame);
+
+  // All members must be accessed with the dataMutex locked
+  std::vector<FrameDifference> frames;
+  std::vector<int>             differingFrames;
+  PlotDecimationPyramid        pyramid;
+  double                       maxMSE{};
+  mutable QMutex               dataMutex;
+};
+
+} // namespace video
@@ -0,0 +1,185 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DifferenceScan.h"
+
+#include <QtConcurrent>
+
+#include <deque>
+
+namespace video
+{
+
+DifferenceScan::DifferenceScan()
+{
+  connect(&this->scanWatcher, &QFutureWatcher<void>::finished, this, &DifferenceScan::scanFinished);
+}
+
+DifferenceScan::~DifferenceScan() { this->stop(); }
+
+void DifferenceScan::start(yuv::videoHandlerYUV *video0,
+                           yuv::videoHandlerYUV *video1,
+                           indexRange            frameRange)
+{
+  this->reset();
+
+  if (video0 == nullptr || video1 == nullptr || frameRange.second < frameRange.first)
+    return;
+
+  this->abortRequested = false;
+  this->scanFuture     = QtConcurrent::run(
+      [this, video0, video1, frameRange]() { this->run(video0, video1, frameRange); });
+  this->scanWatcher.setFuture(this->scanFuture);
+}
+
+void DifferenceScan::stop()
+{
+  this->abortRequested = true;
+  this->scanFuture.waitForFinished();
+}
+
+void DifferenceScan::reset()
+{
+  this->stop();
+  this->plotModel.clear();
+}
+
+DifferenceScan::RawFrame DifferenceScan::loadFrame(yuv::videoHandlerYUV *video, int frameIndex)
+{
+  RawFrame frame;
+  // Request the frame like the caching threads do so that the frame that is currently shown (and
+  // e.g. the position of the decoder used for it) is not changed. If caching is not possible for
+  // the item, load it directly.
+  frame.data = video->loadRawFrameData(frameIndex, true);
+  if (frame.data.isEmpty())
+    frame.data = video->loadRawFrameData(frameIndex, false);
+  // The format of a compressed sequence is only known once the decoder provided a frame
+  frame.format    = yuv::PixelFormatYUV(video->getRawPixelFormatYUVName().toStdString());
+  frame.frameSize = video->getFrameSize();
+  return frame;
+}
+
+FrameDifference
+DifferenceScan::compareFrames(int frameIndex, const RawFrame &frame0, const RawFrame &frame1)
+{
+  FrameDifference result;
+  result.frameIndex = frameIndex;
+
+  if (frame0.data.isEmpty() || frame1.data.isEmpty() ||
+      frame0.format.getSubsampling() != frame1.format.getSubsampling())
+    return result;
+
+  QByteArray          planarData[2];
+  yuv::PixelFormatYUV planarFormat[2];
+  bool                convOK[2];
+  std::tie(convOK[0], planarFormat[0]) =
+      yuv::convertToPlanarYUV(frame0.data, planarData[0], frame0.frameSize, frame0.format);
+  std::tie(convOK[1], planarFormat[1]) =
+      yuv::convertToPlanarYUV(frame1.data, planarData[1], frame1.frameSize, frame1.format);
+  if (!convOK[0] || !convOK[1])
+    return result;
+
+  // Only the statistics and the positions of the differences are needed, not the difference image
+  QByteArray          diffYUV;
+  yuv::PixelFormatYUV diffFormat;
+
+  const auto differenceResult = yuv::calculateDifferencePlanar(planarData[0],
+                                                               planarFormat[0],
+                                                               frame0.frameSize,
+                                                               planarData[1],
+                                                               planarFormat[1],
+                                                               frame1.frameSize,
+                                                               1,
+                                                               diffYUV,
+                                                               diffFormat);
+
+  uint64_t sumSquaredError = 0;
+  uint64_t nrSamples       = 0;
+  for (const auto &plane : differenceResult.planes)
+  {
+    sumSquaredError += plane.sumSquaredError;
+    nrSamples += plane.nrSamples;
+    result.maxAbsDifference = std::max(result.maxAbsDifference, plane.maxAbsDifference);
+  }
+
+  result.valid           = true;
+  result.differs         = result.maxAbsDifference > 0;
+  result.mse             = nrSamples > 0 ? double(sumSquaredError) / double(nrSamples) : 0.0;
+  result.firstDifference = yuv::findFirstDifferenceHEVC(differenceResult);
+  return result;
+}
+
+void DifferenceScan::run(yuv::videoHandlerYUV *video0,
+                         yuv::videoHandlerYUV *video1,
+                         indexRange            frameRange)
+{
+  const auto nrFrames = frameRange.second - frameRange.first + 1;
+
+  // Limit the number of frames that are kept in memory
+  const auto maxFramesInFlight = size_t(this->threadPool.maxThreadCount()) * 2;
+
+  std::deque<QFuture<FrameDifference>> framesInFlight;
+  int                                  nrFramesDone = 0;
+
+  auto finishOldestFrame = [&]() {
+    this->plotModel.addFrame(framesInFlight.front().result());
+    framesInFlight.pop_front();
+    emit scanProgress(++nrFramesDone, nrFrames);
+  };
+
+  for (auto frameIndex = frameRange.first; frameIndex <= frameRange.second; frameIndex++)
+  {
+    if (this->abortRequested)
+      break;
+
+    // Both sequences are read at the same time. Each handler can only load one frame at a time so
+    // this is where the frames are read in order.
+    auto frame1Future = QtConcurrent::run(
+        &this->threadPool, [video1, frameIndex]() { return loadFrame(video1, frameIndex); });
+    const auto frame0 = loadFrame(video0, frameIndex);
+    const auto frame1 = frame1Future.result();
+
+    framesInFlight.push_back(
+        QtConcurrent::run(&this->threadPool, [frameIndex, frame0, frame1]() {
+          return DifferenceScan::compareFrames(frameIndex, frame0, frame1);
+        }));
+
+    while (framesInFlight.size() >= maxFramesInFlight)
+      finishOldestFrame();
+  }
+
+  // Frames that are already being compared are still added when the scan is aborted
+  while (!framesInFlight.empty())
+    finishOldestFrame();
+}
+
+} // namespace video
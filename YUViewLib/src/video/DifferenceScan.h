@@ -0,0 +1,103 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QThreadPool>
+
+#include <common/Typedef.h>
+#include <video/DifferencePlotModel.h>
+#include <video/videoHandlerYUV.h>
+
+#include <atomic>
+
+namespace video
+{
+
+/* Scan all frames of two YUV sequences for differences in the background. The frames are loaded
+ * in order (one thread per input, each handler can only load one frame at a time) while the
+ * difference of each pair of frames is calculated in a thread pool that uses all cores. The
+ * results are added to the plot model in frame order.
+ */
+class DifferenceScan : public QObject
+{
+  Q_OBJECT
+
+public:
+  DifferenceScan();
+  ~DifferenceScan();
+
+  // Start scanning the given (inclusive) range of frames. The results of a previous scan are
+  // cleared.
+  void start(yuv::videoHandlerYUV *video0, yuv::videoHandlerYUV *video1, indexRange frameRange);
+
+  // Abort a running scan and wait until it stopped. The frames scanned so far are kept.
+  void stop();
+
+  // Stop the scan and clear all results
+  void reset();
+
+  bool isRunning() const { return this->scanFuture.isRunning(); }
+
+  DifferencePlotModel *getPlotModel() { return &this->plotModel; }
+
+signals:
+  // Emitted from the scan thread after each frame
+  void scanProgress(int nrFramesDone, int nrFrames);
+  // Emitted (in the thread of this object) when the scan ended or was stopped
+  void scanFinished();
+
+private:
+  struct RawFrame
+  {
+    QByteArray          data;
+    yuv::PixelFormatYUV format;
+    Size                frameSize;
+  };
+
+  static RawFrame loadFrame(yuv::videoHandlerYUV *video, int frameIndex);
+  static FrameDifference
+  compareFrames(int frameIndex, const RawFrame &frame0, const RawFrame &frame1);
+
+  void run(yuv::videoHandlerYUV *video0, yuv::videoHandlerYUV *video1, indexRange frameRange);
+
+  DifferencePlotModel  plotModel;
+  QThreadPool          threadPool;
+  QFuture<void>        scanFuture;
+  QFutureWatcher<void> scanWatcher;
+  std::atomic_bool     abortRequested{false};
+};
+
+} // namespace video
@@ -0,0 +1,274 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiskFrameCache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <limits>
+
+#include <video/FrameBufferPool.h>
+
+#define DISKFRAMECACHE_DEBUG_OUTPUT 0
+#if DISKFRAMECACHE_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_DISKCACHE(f) qDebug() << f
+#else
+#define DEBUG_DISKCACHE(f) ((void)0)
+#endif
+
+namespace video
+{
+
+namespace
+{
+
+const auto    FILE_SUFFIX     = QString(".frame");
+constexpr int DEFAULT_SIZE_MB = 10000;
+
+// If more data than this is waiting to be written, new frames are not stored
+constexpr int64_t MAX_PENDING_BYTES = 512 * 1000 * 1000;
+
+} // namespace
+
+QString DiskFrameCacheKey::getFileName() const
+{
+  const auto keyString = QString("%1\n%2\n%3\n%4\n%5")
+                             .arg(this->filePath)
+                             .arg(this->fileModified.toMSecsSinceEpoch())
+                             .arg(this->decoder)
+                             .arg(this->decodeSignal)
+                             .arg(this->frameIndex);
+  const auto hash = QCryptographicHash::hash(keyString.toUtf8(), QCryptographicHash::Sha1);
+  return QString::fromLatin1(hash.toHex()) + FILE_SUFFIX;
+}
+
+DiskFrameCache::DiskFrameCache()
+{
+  this->writerPool.setMaxThreadCount(1);
+}
+
+DiskFrameCache &DiskFrameCache::instance()
+{
+  static DiskFrameCache cache;
+  return cache;
+}
+
+QString DiskFrameCache::getDefaultDirectory()
+{
+  return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("frames");
+}
+
+void DiskFrameCache::updateSettings()
+{
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  const auto enabled   = settings.value("DiskCacheEnabled", false).toBool();
+  const auto directory = settings.value("DiskCacheDirectory", getDefaultDirectory()).toString();
+  const auto maxMB     = settings.value("DiskCacheSizeMB", DEFAULT_SIZE_MB).toUInt();
+  settings.endGroup();
+
+  QMutexLocker lock(&this->mutex);
+  this->enabled  = enabled;
+  this->maxBytes = int64_t(maxMB) * 1000 * 1000;
+  if (enabled && directory != this->directory)
+  {
+    DEBUG_DISKCACHE("DiskFrameCache::updateSettings new directory " << directory);
+    this->directory = directory;
+    QDir().mkpath(directory);
+    this->readIndex();
+  }
+  const auto filesToDelete = this->limitSize();
+  lock.unlock();
+
+  for (const auto &path : filesToDelete)
+    QFile::remove(path);
+}
+
+bool DiskFrameCache::isEnabled() const
+{
+  QMutexLocker lock(&this->mutex);
+  return this->enabled;
+}
+
+QByteArray DiskFrameCache::load(const DiskFrameCacheKey &key)
+{
+  const auto fileName = key.getFileName();
+
+  QMutexLocker lock(&this->mutex);
+  if (!this->enabled)
+    return {};
+  auto it = this->entries.find(fileName);
+  if (it == this->entries.end())
+  {
+    this->statistics.misses++;
+    return {};
+  }
+  this->lru.splice(this->lru.begin(), this->lru, it->lruPosition);
+  const auto filePath = QDir(this->directory).filePath(fileName);
+  lock.unlock();
+
+  QByteArray data;
+  QFile      file(filePath);
+  if (file.open(QIODevice::ReadOnly) && file.size() > 0 &&
+      file.size() <= std::numeric_limits<int>::max())
+  {
+    const auto size = file.size();
+    data            = FrameBufferPool::instance().getByteArray(int(size));
+    if (file.read(data.data(), size) != size)
+      data.clear();
+  }
+  file.close();
+
+  if (!data.isEmpty())
+  {
+    // The modification time is the last access. This way, the order is kept across sessions.
+    // Setting it requires write access.
+    QtConcurrent::run(&this->writerPool, [filePath]() {
+      QFile file(filePath);
+      if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    });
+  }
+
+  lock.relock();
+  if (data.isEmpty())
+  {
+    // The file was deleted or can not be read. Forget about it.
+    DEBUG_DISKCACHE("DiskFrameCache::load reading " << filePath << " failed");
+    it = this->entries.find(fileName);
+    if (it != this->entries.end())
+    {
+      this->statistics.bytes -= it->bytes;
+      this->lru.erase(it->lruPosition);
+      this->entries.erase(it);
+    }
+    this->statistics.misses++;
+    return {};
+  }
+
+  this->statistics.hits++;
+  return data;
+}
+
+void DiskFrameCache::store(const DiskFrameCacheKey &key, const QByteArray &data)
+{
+  if (data.isEmpty())
+    return;
+  const auto fileName = key.getFileName();
+
+  QMutexLocker lock(&this->mutex);
+  if (!this->enabled || this->entries.contains(fileName) ||
+      this->pendingStores.contains(fileName) || data.size() > this->maxBytes ||
+      this->pendingBytes + data.size() > MAX_PENDING_BYTES)
+    return;
+  this->pendingStores.insert(fileName);
+  this->pendingBytes += data.size();
+  const auto directory = this->directory;
+  lock.unlock();
+
+  // The data is implicitly shared, so this does not copy the frame
+  QtConcurrent::run(&this->writerPool, [this, directory, fileName, data]() {
+    this->writeFrame(directory, fileName, data);
+  });
+}
+
+void DiskFrameCache::writeFrame(const QString &   directory,
+                                const QString &   fileName,
+                                const QByteArray &data)
+{
+  // Write to a temporary file first so that there never is an incomplete frame in the cache
+  QSaveFile  file(QDir(directory).filePath(fileName));
+  const auto written =
+      file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+
+  QMutexLocker lock(&this->mutex);
+  this->pendingStores.remove(fileName);
+  this->pendingBytes -= data.size();
+  if (!written)
+  {
+    DEBUG_DISKCACHE("DiskFrameCache::writeFrame writing " << fileName << " failed");
+    return;
+  }
+  if (directory != this->directory || this->entries.contains(fileName))
+    return;
+  this->lru.push_front(fileName);
+  this->entries.insert(fileName, {data.size(), this->lru.begin()});
+  this->statistics.bytes += data.size();
+  const auto filesToDelete = this->limitSize();
+  lock.unlock();
+
+  for (const auto &path : filesToDelete)
+    QFile::remove(path);
+}
+
+DiskFrameCache::Statistics DiskFrameCache::getStatistics() const
+{
+  QMutexLocker lock(&this->mutex);
+  return this->statistics;
+}
+
+void DiskFrameCache::readIndex()
+{
+  this->lru.clear();
+  this->entries.clear();
+  this->statistics.bytes = 0;
+
+  QDir dir(this->directory);
+  for (const auto &fileInfo : dir.entryInfoList({"*" + FILE_SUFFIX}, QDir::Files, QDir::Time))
+  {
+    this->lru.push_back(fileInfo.fileName());
+    this->entries.insert(fileInfo.fileName(), {fileInfo.size(), std::prev(this->lru.end())});
+    this->statistics.bytes += fileInfo.size();
+  }
+  DEBUG_DISKCACHE("DiskFrameCache::readIndex found " << this->entries.size() << " frames");
+}
+
+QStringList DiskFrameCache::limitSize()
+{
+  QStringList filesToDelete;
+  while (this->statistics.bytes > this->maxBytes && !this->lru.empty())
+  {
+    const auto fileName = this->lru.back();
+    this->lru.pop_back();
+    this->statistics.bytes -= this->entries.take(fileName).bytes;
+    filesToDelete.append(QDir(this->directory).filePath(fileName));
+  }
+  return filesToDelete;
+}
+
+} // namespace video
@@ -0,0 +1,131 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+#include <list>
+
+namespace video
+{
+
+// Identifies one decoded frame of a compressed file. If the file is modified, the key changes.
+struct DiskFrameCacheKey
+{
+  QString   filePath;
+  QDateTime fileModified;
+  QString   decoder;
+  int       decodeSignal{};
+  int       frameIndex{};
+
+  // The name of the file that the frame is saved in
+  QString getFileName() const;
+};
+
+/* A persistent cache of decoded raw frames in a local directory (ideally on a fast SSD). Decoding
+ * with the reference decoders is very slow. With this cache, frames that were decoded before (also
+ * in a previous session) are read from disk instead. Every frame is saved in its own file which is
+ * read directly into a pooled buffer. Files are written in a background thread so that storing a
+ * frame does not slow down decoding. If the size of all files exceeds the limit, the least recently
+ * used frames are deleted.
+ * The settings are read from the "VideoCache" group (DiskCacheEnabled, DiskCacheDirectory and
+ * DiskCacheSizeMB). All functions are thread safe.
+ */
+class DiskFrameCache
+{
+public:
+  static DiskFrameCache &instance();
+
+  // Read the settings. If the directory changed, the index of the new directory is read.
+  void updateSettings();
+  bool isEnabled() const;
+
+  // Get the raw data of the frame. An empty array is returned if the frame is not in the cache.
+  QByteArray load(const DiskFrameCacheKey &key);
+  // Save the raw data of the frame. The file is written in the background.
+  void store(const DiskFrameCacheKey &key, const QByteArray &data);
+
+  struct Statistics
+  {
+    uint64_t hits{};
+    uint64_t misses{};
+    int64_t  bytes{};
+    double   hitRate() const { return hits + misses == 0 ? 0.0 : double(hits) / (hits + misses); }
+  };
+  Statistics getStatistics() const;
+
+  static QString getDefaultDirectory();
+
+private:
+  DiskFrameCache();
+
+  // Write the frame file and add it to the index (runs in the writer thread)
+  void writeFrame(const QString &directory, const QString &fileName, const QByteArray &data);
+
+  // Build the index from the files in the directory (the most recently modified first)
+  void readIndex();
+  // Remove the least recently used frames until the size limit is met. Returns the file names of
+  // the frames that must be deleted.
+  QStringList limitSize();
+
+  mutable QMutex mutex;
+  bool           enabled{};
+  QString        directory;
+  int64_t        maxBytes{};
+
+  struct Entry
+  {
+    int64_t                      bytes{};
+    std::list<QString>::iterator lruPosition;
+  };
+  // The most recently used frame is in front
+  std::list<QString>    lru;
+  QHash<QString, Entry> entries;
+  Statistics            statistics;
+
+  // Frames that are queued for writing and their total size
+  QSet<QString> pendingStores;
+  int64_t       pendingBytes{};
+
+  // Writes the files one after another. This is the last member so that it is destroyed (and waits
+  // for the queued writes) first.
+  QThreadPool writerPool;
+};
+
+} // namespace video
@@ -0,0 +1,232 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameBufferPool.h"
+
+#include <algorithm>
+
+#include <common/Functions.h>
+
+namespace video
+{
+
+namespace
+{
+
+// Never keep more than this many buffers of one size. Two items with double buffering, the
+// decoder output and some buffers that are still in use elsewhere should fit.
+constexpr size_t MAX_BUFFERS_PER_BUCKET = 16;
+
+int64_t bytesOf(const QByteArray &buffer)
+{
+  return buffer.size();
+}
+
+int64_t bytesOf(const QImage &image)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+  return image.byteCount();
+#else
+  return image.sizeInBytes();
+#endif
+}
+
+} // namespace
+
+FrameBufferPool &FrameBufferPool::instance()
+{
+  static FrameBufferPool pool;
+  return pool;
+}
+
+FrameBufferPool::FrameBufferPool()
+{
+  // Free buffers are not accounted for by the video cache, so keep this reasonably small.
+  const int64_t systemMemory = int64_t(functions::systemMemorySizeInMB()) * 1000 * 1000;
+  this->maxPooledBytes       = std::max(systemMemory / 32, int64_t(256) * 1000 * 1000);
+}
+
+template <typename T, typename Key>
+T FrameBufferPool::take(std::map<Key, std::deque<T>> &buckets, const Key &key)
+{
+  this->statistics.requests++;
+
+  auto bucket = buckets.find(key);
+  if (bucket == buckets.end())
+    return {};
+
+  // Hand out the most recently recycled buffer. It is most likely still in the CPU caches.
+  auto &buffers = bucket->second;
+  if (buffers.empty())
+    return {};
+  T buffer = std::move(buffers.back());
+  buffers.pop_back();
+  this->statistics.hits++;
+  this->statistics.pooledBytes -= bytesOf(buffer);
+  return buffer;
+}
+
+template <typename T, typename Key>
+void FrameBufferPool::put(std::map<Key, std::deque<T>> &buckets,
+                          const Key &                   key,
+                          T &                           buffer,
+                          int64_t                       bytes)
+{
+  // A buffer that is still referenced elsewhere must not be pooled. Its memory is not free and
+  // it could be recycled a second time by the other owner.
+  if (!buffer.isDetached())
+  {
+    buffer = T();
+    return;
+  }
+
+  auto &buffers = buckets[key];
+  if (buffers.size() >= MAX_BUFFERS_PER_BUCKET)
+  {
+    this->statistics.pooledBytes -= bytesOf(buffers.front());
+    buffers.pop_front();
+  }
+  buffers.push_back(std::move(buffer));
+  this->statistics.pooledBytes += bytes;
+  buffer = T();
+
+  this->limitPoolSize();
+}
+
+void FrameBufferPool::limitPoolSize()
+{
+  // Drop the oldest buffers of the biggest buckets first. These are most likely of a format
+  // that is not used anymore.
+  auto dropOldest = [this](auto &buckets) {
+    for (auto it = buckets.begin(); it != buckets.end();)
+    {
+      auto &buffers = it->second;
+      while (!buffers.empty() && this->statistics.pooledBytes > this->maxPooledBytes)
+      {
+        this->statistics.pooledBytes -= bytesOf(buffers.front());
+        buffers.pop_front();
+      }
+      if (buffers.empty())
+        it = buckets.erase(it);
+      else
+        it++;
+    }
+  };
+
+  if (this->statistics.pooledBytes > this->maxPooledBytes)
+    dropOldest(this->images);
+  if (this->statistics.pooledBytes > this->maxPooledBytes)
+    dropOldest(this->byteArrays);
+}
+
+QByteArray FrameBufferPool::getByteArray(int size)
+{
+  if (size <= 0)
+    return {};
+
+  {
+    QMutexLocker lock(&this->mutex);
+    auto         buffer = this->take(this->byteArrays, size);
+    if (buffer.size() == size)
+      return buffer;
+  }
+
+  // Allocate outside of the lock
+  return QByteArray(size, Qt::Uninitialized);
+}
+
+QImage FrameBufferPool::getImage(const QSize &size, QImage::Format format)
+{
+  if (size.isEmpty())
+    return {};
+
+  {
+    QMutexLocker lock(&this->mutex);
+    auto image = this->take(this->images, ImageKey(size.width(), size.height(), int(format)));
+    if (!image.isNull())
+      return image;
+  }
+
+  return QImage(size, format);
+}
+
+void FrameBufferPool::recycle(QByteArray &buffer)
+{
+  if (buffer.isEmpty())
+  {
+    buffer.clear();
+    return;
+  }
+
+  QMutexLocker lock(&this->mutex);
+  auto         key = buffer.size();
+  this->put(this->byteArrays, key, buffer, bytesOf(buffer));
+}
+
+void FrameBufferPool::recycle(QImage &image)
+{
+  if (image.isNull())
+    return;
+
+  QMutexLocker lock(&this->mutex);
+  auto         key = ImageKey(image.width(), image.height(), int(image.format()));
+  this->put(this->images, key, image, bytesOf(image));
+}
+
+void FrameBufferPool::replace(QByteArray &buffer, QByteArray newBuffer)
+{
+  std::swap(buffer, newBuffer);
+  this->recycle(newBuffer);
+}
+
+void FrameBufferPool::clear()
+{
+  QMutexLocker lock(&this->mutex);
+  this->byteArrays.clear();
+  this->images.clear();
+  this->statistics.pooledBytes = 0;
+}
+
+void FrameBufferPool::setMaxPooledBytes(int64_t maxBytes)
+{
+  QMutexLocker lock(&this->mutex);
+  this->maxPooledBytes = maxBytes;
+  this->limitPoolSize();
+}
+
+FrameBufferPool::Statistics FrameBufferPool::getStatistics() const
+{
+  QMutexLocker lock(&this->mutex);
+  return this->statistics;
+}
+
+} // namespace video
@@ -0,0 +1,109 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <tuple>
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+
+namespace video
+{
+
+/* A process wide pool of large frame buffers (raw frame data and converted images).
+ * Decoding, conversion and caching allocate and free buffers of the same few sizes over and over
+ * again. Instead of freeing a buffer, hand it back to the pool using recycle(). Only buffers that
+ * are not referenced anywhere else (QByteArray and QImage are implicitly shared) are kept. A shared
+ * buffer is just released, so that its memory belongs to the other owner (e.g. the video cache)
+ * alone. So every owner of a frame buffer (e.g. the decoder output, the raw data and the current
+ * frame of a video handler) must hand it back when it drops it. The last one of them pools it.
+ * All functions are thread safe.
+ */
+class FrameBufferPool
+{
+public:
+  static FrameBufferPool &instance();
+
+  // Get a byte array of the given size. The content of the array is undefined.
+  QByteArray getByteArray(int size);
+  // Get an image of the given size and format. The content of the image is undefined.
+  QImage getImage(const QSize &size, QImage::Format format);
+
+  // Hand the buffer back to the pool. The given buffer/image is empty afterwards.
+  void recycle(QByteArray &buffer);
+  void recycle(QImage &image);
+  // Replace the buffer with the new one and hand the old one back to the pool. The old buffer is
+  // only kept if this was its last reference. Use this wherever a frame buffer is replaced, so
+  // that the buffer is recycled by the last one of its owners (e.g. the current frame of the
+  // video handler).
+  void replace(QByteArray &buffer, QByteArray newBuffer);
+
+  // Drop all buffers that are currently held by the pool.
+  void clear();
+
+  // Set the maximum number of bytes that the pool keeps. Buffers are dropped if necessary.
+  void setMaxPooledBytes(int64_t maxBytes);
+
+  struct Statistics
+  {
+    uint64_t requests{};
+    uint64_t hits{};
+    int64_t  pooledBytes{};
+    double   hitRate() const
+    {
+      return this->requests > 0 ? double(this->hits) / this->requests : 0;
+    }
+  };
+  Statistics getStatistics() const;
+
+private:
+  FrameBufferPool();
+
+  using ImageKey = std::tuple<int, int, int>;
+
+  template <typename T, typename Key> T take(std::map<Key, std::deque<T>> &buckets, const Key &key);
+  template <typename T, typename Key>
+  void put(std::map<Key, std::deque<T>> &buckets, const Key &key, T &buffer, int64_t bytes);
+  void limitPoolSize();
+
+  mutable QMutex                         mutex;
+  std::map<int, std::deque<QByteArray>>  byteArrays;
+  std::map<ImageKey, std::deque<QImage>> images;
+  Statistics                             statistics;
+  int64_t                                maxPooledBytes{};
+};
+
+} // namespace video
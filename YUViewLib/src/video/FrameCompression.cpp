@@ -0,0 +1,143 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameCompression.h"
+
+#include <atomic>
+
+#include <video/FrameBufferPool.h>
+
+namespace video
+{
+
+namespace
+{
+
+// The fastest zlib level. Higher levels cost a lot more time and only save a few percent.
+constexpr int COMPRESSION_LEVEL = 1;
+constexpr int BYTES_PER_PIXEL   = 4;
+
+std::atomic_bool frameCacheCompression{false};
+
+int64_t bytesOf(const QImage &image)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+  return image.byteCount();
+#else
+  return image.sizeInBytes();
+#endif
+}
+
+} // namespace
+
+void setFrameCacheCompression(bool enabled)
+{
+  frameCacheCompression = enabled;
+}
+
+bool isFrameCacheCompressionEnabled()
+{
+  return frameCacheCompression;
+}
+
+CachedFrame::CachedFrame(const QImage &image, bool compress) : image(image)
+{
+  if (!compress || image.isNull() || image.depth() != BYTES_PER_PIXEL * 8)
+    return;
+
+  const auto bytesPerLine = image.width() * BYTES_PER_PIXEL;
+  auto       residuals    = FrameBufferPool::instance().getByteArray(bytesPerLine * image.height());
+  for (int y = 0; y < image.height(); y++)
+  {
+    auto src = image.constScanLine(y);
+    auto dst = reinterpret_cast<unsigned char *>(residuals.data()) + y * bytesPerLine;
+    for (int i = 0; i < BYTES_PER_PIXEL; i++)
+      dst[i] = src[i];
+    for (int i = BYTES_PER_PIXEL; i < bytesPerLine; i++)
+      dst[i] = src[i] - src[i - BYTES_PER_PIXEL];
+  }
+
+  auto compressed = qCompress(residuals, COMPRESSION_LEVEL);
+  FrameBufferPool::instance().recycle(residuals);
+
+  // Only keep the compressed data if it is actually smaller (e.g. not for noise)
+  if (compressed.size() >= bytesOf(image))
+    return;
+
+  this->compressedData = compressed;
+  this->size           = image.size();
+  this->format         = image.format();
+  this->image          = QImage();
+}
+
+int64_t CachedFrame::getBytes() const
+{
+  return this->isCompressed() ? this->compressedData.size() : bytesOf(this->image);
+}
+
+int64_t CachedFrame::getUncompressedBytes() const
+{
+  if (this->isCompressed())
+    return int64_t(this->size.width()) * this->size.height() * BYTES_PER_PIXEL;
+  return bytesOf(this->image);
+}
+
+QImage CachedFrame::getImage() const
+{
+  if (!this->isCompressed())
+    return this->image;
+
+  const auto residuals    = qUncompress(this->compressedData);
+  const auto bytesPerLine = this->size.width() * BYTES_PER_PIXEL;
+  if (residuals.size() != bytesPerLine * this->size.height())
+    return {};
+
+  auto image = FrameBufferPool::instance().getImage(this->size, this->format);
+  for (int y = 0; y < image.height(); y++)
+  {
+    auto src = reinterpret_cast<const unsigned char *>(residuals.constData()) + y * bytesPerLine;
+    auto dst = image.scanLine(y);
+    for (int i = 0; i < BYTES_PER_PIXEL; i++)
+      dst[i] = src[i];
+    for (int i = BYTES_PER_PIXEL; i < bytesPerLine; i++)
+      dst[i] = src[i] + dst[i - BYTES_PER_PIXEL];
+  }
+  return image;
+}
+
+void CachedFrame::recycle()
+{
+  FrameBufferPool::instance().recycle(this->image);
+  this->compressedData.clear();
+}
+
+} // namespace video
@@ -0,0 +1,81 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+
+namespace video
+{
+
+// Should frames that are put into the cache be compressed? This trades the CPU time for
+// compression/decompression for the number of frames that fit into the cache. This is a global
+// setting for all video handlers.
+void setFrameCacheCompression(bool enabled);
+bool isFrameCacheCompressionEnabled();
+
+/* A frame in the video cache. The image is either kept as it is or it is compressed losslessly.
+ * For compression, each byte of a line is predicted from the same byte of the pixel left of it.
+ * The residuals are then compressed using zlib (on the fastest level). This works well for the
+ * 32 bit images that the cache holds because neighboring pixels are usually very similar.
+ * Images with other formats are never compressed.
+ */
+class CachedFrame
+{
+public:
+  CachedFrame() = default;
+  CachedFrame(const QImage &image, bool compress);
+
+  bool isNull() const { return this->image.isNull() && this->compressedData.isEmpty(); }
+  bool isCompressed() const { return !this->compressedData.isEmpty(); }
+
+  // The number of bytes that the frame occupies in memory and how many bytes the image occupies
+  // when it is decompressed.
+  int64_t getBytes() const;
+  int64_t getUncompressedBytes() const;
+
+  // Get the image. If the frame is compressed, a new image (from the FrameBufferPool) is
+  // decompressed. This can be called from any thread.
+  QImage getImage() const;
+
+  // Hand the uncompressed image back to the FrameBufferPool. The frame is null afterwards.
+  void recycle();
+
+private:
+  QImage         image;
+  QByteArray     compressedData;
+  QSize          size;
+  QImage::Format format{QImage::Format_Invalid};
+};
+
+} // namespace video
@@ -268,7 +268,8 @@ void FrameHandler::drawFrame(QPainter *painter, double zoomFactor, bool drawRawV
   videoRect.moveCenter(QPoint(0, 0));
 
   // Draw the current image (currentFrame)
-  painter->drawImage(videoRect, this->currentImage);
+  painter->drawImage(videoRect,
+                     this->currentImagePyramid.getImageForZoom(this->currentImage, zoomFactor));
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
   {
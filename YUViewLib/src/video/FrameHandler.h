@@ -41,6 +41,7 @@
 #include <QObject>
 #include <QSettings>
 
+#include "ImagePyramid.h"
 #include "ui_FrameHandler.h"
 
 namespace video
@@ -123,7 +124,8 @@ public:
                                const bool    markDifference = false,
                                const int     frameIdxItem1  = 0);
 
-  QImage getCurrentFrameAsImage() const { return currentImage; }
+  // Get the current frame as an image (e.g. to process it further)
+  virtual QImage getCurrentFrameAsImage() { return currentImage; }
 
   // Load the current image from file and set the correct size.
   bool loadCurrentImageFromFile(const QString &filePath);
@@ -140,6 +142,9 @@ protected:
   QImage currentImage;
   Size   frameSize;
 
+  // Downscaled versions of currentImage which are drawn if the view is zoomed out
+  ImagePyramid currentImagePyramid;
+
   // Get the pixel value from currentImage. Make sure that currentImage is the correct image.
   QRgb         getPixelVal(const QPoint &pos) { return getPixelVal(pos.x(), pos.y()); }
   virtual QRgb getPixelVal(int x, int y) { return currentImage.pixel(x, y); }
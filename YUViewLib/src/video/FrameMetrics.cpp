@@ -0,0 +1,271 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameMetrics.h"
+
+#include "videoHandlerYUV.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace video::yuv
+{
+
+namespace
+{
+
+// SSIM is calculated on 8x8 windows which overlap by 4 samples in each direction. The sums are
+// first calculated for the 4x4 blocks and then combined for each window.
+constexpr unsigned SSIM_BLOCK_SIZE = 4;
+
+inline unsigned readSample(const unsigned char *src, size_t idx, bool twoBytes, bool bigEndian)
+{
+  if (!twoBytes)
+    return src[idx];
+  if (bigEndian)
+    return (unsigned(src[idx * 2]) << 8) + src[idx * 2 + 1];
+  return unsigned(src[idx * 2]) + (unsigned(src[idx * 2 + 1]) << 8);
+}
+
+void readPlane(const unsigned char *src,
+               const Size           size,
+               const unsigned       valueSkip,
+               const bool           twoBytes,
+               const bool           bigEndian,
+               ComponentPlane &     plane)
+{
+  plane.size = size;
+  plane.samples.resize(size_t(size.width) * size.height);
+  for (size_t i = 0; i < plane.samples.size(); i++)
+    plane.samples[i] = uint16_t(readSample(src, i * valueSkip, twoBytes, bigEndian));
+}
+
+struct BlockSums
+{
+  uint64_t sum0{};
+  uint64_t sum1{};
+  uint64_t sumSquares{};
+  uint64_t sumCross{};
+
+  BlockSums &operator+=(const BlockSums &other)
+  {
+    this->sum0 += other.sum0;
+    this->sum1 += other.sum1;
+    this->sumSquares += other.sumSquares;
+    this->sumCross += other.sumCross;
+    return *this;
+  }
+};
+
+double ssimFromSums(const BlockSums &sums, const double nrSamples, const double maxValue)
+{
+  const auto c1 = (0.01 * maxValue) * (0.01 * maxValue) * nrSamples * nrSamples;
+  const auto c2 = (0.03 * maxValue) * (0.03 * maxValue) * nrSamples * (nrSamples - 1);
+
+  const auto s0       = double(sums.sum0);
+  const auto s1       = double(sums.sum1);
+  const auto variance = double(sums.sumSquares) * nrSamples - s0 * s0 - s1 * s1;
+  const auto covar    = double(sums.sumCross) * nrSamples - s0 * s1;
+
+  return (2 * s0 * s1 + c1) * (2 * covar + c2) / ((s0 * s0 + s1 * s1 + c1) * (variance + c2));
+}
+
+ComponentMetrics calculateComponentMetrics(const ComponentPlane &plane0,
+                                           const ComponentPlane &plane1,
+                                           const unsigned        shift0,
+                                           const unsigned        shift1,
+                                           const unsigned        bitDepth)
+{
+  const auto w       = std::min(plane0.size.width, plane1.size.width);
+  const auto h       = std::min(plane0.size.height, plane1.size.height);
+  const auto stride0 = plane0.size.width;
+  const auto stride1 = plane1.size.width;
+
+  auto sampleSums = [&](unsigned x0, unsigned y0, unsigned width, unsigned height) {
+    BlockSums sums;
+    for (unsigned y = y0; y < y0 + height; y++)
+    {
+      const auto row0 = plane0.samples.data() + size_t(y) * stride0;
+      const auto row1 = plane1.samples.data() + size_t(y) * stride1;
+      for (unsigned x = x0; x < x0 + width; x++)
+      {
+        const uint64_t a = unsigned(row0[x]) << shift0;
+        const uint64_t b = unsigned(row1[x]) << shift1;
+        sums.sum0 += a;
+        sums.sum1 += b;
+        sums.sumSquares += a * a + b * b;
+        sums.sumCross += a * b;
+      }
+    }
+    return sums;
+  };
+
+  ComponentMetrics metrics;
+  if (w == 0 || h == 0)
+    return metrics;
+
+  uint64_t sumSquaredDiff = 0;
+  for (unsigned y = 0; y < h; y++)
+  {
+    const auto row0 = plane0.samples.data() + size_t(y) * stride0;
+    const auto row1 = plane1.samples.data() + size_t(y) * stride1;
+    for (unsigned x = 0; x < w; x++)
+    {
+      const auto diff =
+          int64_t(unsigned(row0[x]) << shift0) - int64_t(unsigned(row1[x]) << shift1);
+      sumSquaredDiff += uint64_t(diff * diff);
+    }
+  }
+  metrics.mse  = double(sumSquaredDiff) / (double(w) * h);
+  metrics.psnr = psnrFromMSE(metrics.mse, bitDepth);
+
+  const auto maxValue  = double((1u << bitDepth) - 1);
+  const auto blocksHor = w / SSIM_BLOCK_SIZE;
+  const auto blocksVer = h / SSIM_BLOCK_SIZE;
+  if (blocksHor < 2 || blocksVer < 2)
+  {
+    // Too small for a window. Use the whole component as one window.
+    metrics.ssim = ssimFromSums(sampleSums(0, 0, w, h), double(w) * h, maxValue);
+    return metrics;
+  }
+
+  // Keep the sums of two rows of blocks
+  std::vector<BlockSums> previousRow(blocksHor);
+  std::vector<BlockSums> currentRow(blocksHor);
+  double                 ssimSum = 0;
+  for (unsigned by = 0; by < blocksVer; by++)
+  {
+    for (unsigned bx = 0; bx < blocksHor; bx++)
+      currentRow[bx] = sampleSums(
+          bx * SSIM_BLOCK_SIZE, by * SSIM_BLOCK_SIZE, SSIM_BLOCK_SIZE, SSIM_BLOCK_SIZE);
+
+    if (by > 0)
+    {
+      for (unsigned bx = 0; bx + 1 < blocksHor; bx++)
+      {
+        auto window = previousRow[bx];
+        window += previousRow[bx + 1];
+        window += currentRow[bx];
+        window += currentRow[bx + 1];
+        ssimSum += ssimFromSums(window, 4 * SSIM_BLOCK_SIZE * SSIM_BLOCK_SIZE, maxValue);
+      }
+    }
+    std::swap(previousRow, currentRow);
+  }
+  metrics.ssim = ssimSum / (double(blocksHor - 1) * (blocksVer - 1));
+
+  return metrics;
+}
+
+} // namespace
+
+bool convertToPlanarFrame(const QByteArray &    rawData,
+                          const PixelFormatYUV &format,
+                          const Size            frameSize,
+                          PlanarFrame &         frame)
+{
+  if (rawData.isEmpty() || !format.canConvertToRGB(frameSize))
+    return false;
+
+  QByteArray planarData;
+  auto [convOK, planarFormat] = convertToPlanarYUV(rawData, planarData, frameSize, format);
+  if (!convOK || planarData.size() < planarFormat.bytesPerFrame(frameSize))
+    return false;
+
+  const auto bitDepth   = planarFormat.getBitsPerSample();
+  const auto twoBytes   = bitDepth > 8;
+  const auto bigEndian  = planarFormat.isBigEndian();
+  const auto planeOrder = planarFormat.getPlaneOrder();
+  const auto src        = reinterpret_cast<const unsigned char *>(planarData.constData());
+
+  frame.bitDepth    = bitDepth;
+  frame.subsampling = planarFormat.getSubsampling();
+  frame.planes.resize(frame.subsampling == Subsampling::YUV_400 ? 1 : 3);
+  readPlane(src, frameSize, 1, twoBytes, bigEndian, frame.planes[0]);
+  if (frame.subsampling == Subsampling::YUV_400)
+    return true;
+
+  const auto chromaSize = Size(frameSize.width / planarFormat.getSubsamplingHor(),
+                               frameSize.height / planarFormat.getSubsamplingVer());
+  const auto sampleBytes = twoBytes ? 2 : 1;
+  const auto lumaBytes   = size_t(frameSize.width) * frameSize.height * sampleBytes;
+  const auto chromaBytes = size_t(chromaSize.width) * chromaSize.height * sampleBytes;
+
+  // The planes are always returned in the order Y, U, V
+  const auto swapUV = (planeOrder == PlaneOrder::YVU || planeOrder == PlaneOrder::YVUA);
+  auto &     planeU = frame.planes[swapUV ? 2 : 1];
+  auto &     planeV = frame.planes[swapUV ? 1 : 2];
+
+  if (planarFormat.isUVInterleaved())
+  {
+    // One plane with the (alpha and) chroma values interleaved
+    const auto valueSkip =
+        (planeOrder == PlaneOrder::YUV || planeOrder == PlaneOrder::YVU) ? 2u : 3u;
+    readPlane(src + lumaBytes, chromaSize, valueSkip, twoBytes, bigEndian, planeU);
+    readPlane(src + lumaBytes + sampleBytes, chromaSize, valueSkip, twoBytes, bigEndian, planeV);
+  }
+  else
+  {
+    readPlane(src + lumaBytes, chromaSize, 1, twoBytes, bigEndian, planeU);
+    readPlane(src + lumaBytes + chromaBytes, chromaSize, 1, twoBytes, bigEndian, planeV);
+  }
+
+  return true;
+}
+
+std::vector<ComponentMetrics> calculateMetrics(const PlanarFrame &frame0,
+                                               const PlanarFrame &frame1)
+{
+  if (frame0.subsampling != frame1.subsampling || frame0.planes.size() != frame1.planes.size())
+    return {};
+
+  const auto bitDepth = std::max(frame0.bitDepth, frame1.bitDepth);
+  const auto shift0   = bitDepth - frame0.bitDepth;
+  const auto shift1   = bitDepth - frame1.bitDepth;
+
+  std::vector<ComponentMetrics> metrics;
+  for (size_t i = 0; i < frame0.planes.size(); i++)
+    metrics.push_back(
+        calculateComponentMetrics(frame0.planes[i], frame1.planes[i], shift0, shift1, bitDepth));
+  return metrics;
+}
+
+double psnrFromMSE(double mse, unsigned bitDepth)
+{
+  if (mse <= 0)
+    return std::numeric_limits<double>::infinity();
+  const auto maxValue = double((1u << bitDepth) - 1);
+  return 10.0 * std::log10(maxValue * maxValue / mse);
+}
+
+} // namespace video::yuv
@@ -0,0 +1,87 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PixelFormatYUV.h"
+
+#include <QByteArray>
+
+#include <cstdint>
+#include <vector>
+
+namespace video::yuv
+{
+
+// One component of a frame with one 16 bit value per sample
+struct ComponentPlane
+{
+  Size                  size;
+  std::vector<uint16_t> samples;
+};
+
+// A YUV frame with each component (Y, U, V) in a separate plane. Every raw YUV format that YUView
+// can read (planar, interleaved UV, packed and predefined formats) can be converted to this. An
+// alpha channel is dropped.
+struct PlanarFrame
+{
+  unsigned                    bitDepth{};
+  Subsampling                 subsampling{Subsampling::UNKNOWN};
+  std::vector<ComponentPlane> planes;
+};
+
+// Split the raw data of a frame into its components. Returns false if the format is not supported
+// or if the data is too short for the format and frame size.
+bool convertToPlanarFrame(const QByteArray &    rawData,
+                          const PixelFormatYUV &format,
+                          const Size            frameSize,
+                          PlanarFrame &         frame);
+
+struct ComponentMetrics
+{
+  double mse{};
+  // Infinite if both components are identical
+  double psnr{};
+  double ssim{};
+};
+
+// Calculate the objective metrics between two frames for each component. The frames must have the
+// same subsampling. If the frame sizes differ, only the overlapping (top left) area is compared. If
+// the bit depths differ, the samples with the lower bit depth are scaled up first.
+// An empty list is returned if the frames can not be compared.
+std::vector<ComponentMetrics> calculateMetrics(const PlanarFrame &frame0,
+                                               const PlanarFrame &frame1);
+
+// Get the PSNR in dB for the given MSE of samples with the given bit depth
+double psnrFromMSE(double mse, unsigned bitDepth);
+
+} // namespace video::yuv
@@ -0,0 +1,133 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImagePyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace video
+{
+
+namespace
+{
+
+bool canBeFiltered(QImage::Format format)
+{
+  return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32 ||
+         format == QImage::Format_ARGB32_Premultiplied;
+}
+
+// Average 4 pixels. All four 8 bit channels are averaged at once by splitting the pixels into two
+// words with two channels each so that the sums of four values can not overflow.
+inline uint32_t average(uint32_t p0, uint32_t p1, uint32_t p2, uint32_t p3)
+{
+  const auto sumRB = (p0 & 0x00ff00ff) + (p1 & 0x00ff00ff) + (p2 & 0x00ff00ff) +
+                     (p3 & 0x00ff00ff) + 0x00020002;
+  const auto sumAG = ((p0 >> 8) & 0x00ff00ff) + ((p1 >> 8) & 0x00ff00ff) +
+                     ((p2 >> 8) & 0x00ff00ff) + ((p3 >> 8) & 0x00ff00ff) + 0x00020002;
+  return ((sumRB >> 2) & 0x00ff00ff) | (((sumAG >> 2) & 0x00ff00ff) << 8);
+}
+
+// Average each block of 2x2 pixels. If the width or height of the source is odd, the last column
+// or row of the destination averages only the pixels that exist in the source (the last pixel is
+// repeated).
+void downscaleHalf(const QImage &src, QImage &dst)
+{
+  const auto fullBlocksX = src.width() / 2;
+  const auto oddWidth    = (src.width() % 2) == 1;
+
+  for (int y = 0; y < dst.height(); y++)
+  {
+    const auto y1   = std::min(y * 2 + 1, src.height() - 1);
+    const auto src0 = reinterpret_cast<const uint32_t *>(src.constScanLine(y * 2));
+    const auto src1 = reinterpret_cast<const uint32_t *>(src.constScanLine(y1));
+    const auto out  = reinterpret_cast<uint32_t *>(dst.scanLine(y));
+
+    for (int x = 0; x < fullBlocksX; x++)
+      out[x] = average(src0[x * 2], src0[x * 2 + 1], src1[x * 2], src1[x * 2 + 1]);
+    if (oddWidth)
+    {
+      const auto x     = fullBlocksX * 2;
+      out[fullBlocksX] = average(src0[x], src0[x], src1[x], src1[x]);
+    }
+  }
+}
+
+} // namespace
+
+const QImage &ImagePyramid::getImageForZoom(const QImage &image, double zoomFactor)
+{
+  if (zoomFactor >= 0.5 || zoomFactor <= 0.0 || image.isNull() || !canBeFiltered(image.format()))
+    return image;
+
+  if (image.cacheKey() != this->sourceCacheKey)
+  {
+    this->sourceCacheKey = image.cacheKey();
+    this->nrValidLevels  = 0;
+  }
+
+  // The smallest level that is not smaller than the image is drawn
+  const auto level = size_t(std::floor(std::log2(1.0 / zoomFactor)));
+
+  while (this->nrValidLevels < level)
+  {
+    const auto &src = (this->nrValidLevels == 0) ? image : this->levels[this->nrValidLevels - 1];
+    if (src.width() < 2 || src.height() < 2)
+      break;
+
+    if (this->levels.size() <= this->nrValidLevels)
+      this->levels.emplace_back();
+
+    // Reuse the memory of the level if the size and format did not change
+    auto &     dst      = this->levels[this->nrValidLevels];
+    const auto halfSize = QSize((src.width() + 1) / 2, (src.height() + 1) / 2);
+    if (dst.size() != halfSize || dst.format() != src.format())
+      dst = QImage(halfSize, src.format());
+
+    downscaleHalf(src, dst);
+    this->nrValidLevels++;
+  }
+
+  if (this->nrValidLevels == 0)
+    return image;
+  return this->levels[std::min(level, this->nrValidLevels) - 1];
+}
+
+void ImagePyramid::clear()
+{
+  this->sourceCacheKey = 0;
+  this->levels.clear();
+  this->nrValidLevels = 0;
+}
+
+} // namespace video
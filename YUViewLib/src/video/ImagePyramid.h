@@ -0,0 +1,70 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QImage>
+
+#include <vector>
+
+namespace video
+{
+
+/* A lazily built pyramid of an image where each level is box filtered to half the size of the
+ * level below. When a large image is drawn zoomed out, QPainter samples the full image without
+ * filtering on every paint event. Drawing from the smallest level that is still at least as large
+ * as the drawn image is much faster and does not alias.
+ * The levels are built on request and are kept until the source image changes (this is detected
+ * using the cache key of the image). Only 32 bit RGB images are filtered. For other formats, the
+ * source image itself is used.
+ */
+class ImagePyramid
+{
+public:
+  ImagePyramid() = default;
+
+  // Get the image to draw the given image with the given zoom factor. This is either the image
+  // itself or one of the levels of the pyramid. The reference is valid until the next call.
+  const QImage &getImageForZoom(const QImage &image, double zoomFactor);
+
+  void clear();
+
+private:
+  qint64 sourceCacheKey{};
+
+  // levels[i] has half the size of levels[i - 1] (or of the source for i == 0). Only the first
+  // nrValidLevels levels belong to the current source. The others are kept to reuse their memory.
+  std::vector<QImage> levels;
+  size_t              nrValidLevels{};
+};
+
+} // namespace video
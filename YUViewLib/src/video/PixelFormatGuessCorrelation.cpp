@@ -0,0 +1,257 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PixelFormatGuessCorrelation.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GUESS_CORRELATION_SSE2 1
+#else
+#define GUESS_CORRELATION_SSE2 0
+#endif
+
+namespace video
+{
+
+namespace
+{
+
+// The number of lines that are compared in each stage of the detection
+constexpr unsigned NR_LINES_PER_STAGE[] = {8, 32};
+// A candidate is a clear winner if the MSE of the next best candidate is this many times larger
+constexpr double CLEAR_WINNER_FACTOR = 4.0;
+
+struct CandidateScore
+{
+  size_t candidateIndex{};
+  double mse{};
+  // The compared lines of the first and the second frame
+  std::vector<std::pair<QByteArray, QByteArray>> lines;
+};
+
+uint64_t lineSSE8Bit(const unsigned char *src0, const unsigned char *src1, int64_t nrSamples)
+{
+  uint64_t sse = 0;
+  int64_t  i   = 0;
+#if GUESS_CORRELATION_SSE2
+  const auto zero = _mm_setzero_si128();
+  while (i + 16 <= nrSamples)
+  {
+    // The 32 bit sums can not overflow within a block of 4096 samples
+    auto       sum32    = _mm_setzero_si128();
+    const auto blockEnd = std::min(nrSamples, i + 4096);
+    for (; i + 16 <= blockEnd; i += 16)
+    {
+      const auto a       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src0 + i));
+      const auto b       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1 + i));
+      const auto absDiff = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+      const auto lo      = _mm_unpacklo_epi8(absDiff, zero);
+      const auto hi      = _mm_unpackhi_epi8(absDiff, zero);
+      sum32              = _mm_add_epi32(sum32, _mm_madd_epi16(lo, lo));
+      sum32              = _mm_add_epi32(sum32, _mm_madd_epi16(hi, hi));
+    }
+    alignas(16) uint32_t sums[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(sums), sum32);
+    sse += uint64_t(sums[0]) + sums[1] + sums[2] + sums[3];
+  }
+#endif
+  for (; i < nrSamples; i++)
+  {
+    const auto diff = int64_t(src0[i]) - int64_t(src1[i]);
+    sse += uint64_t(diff * diff);
+  }
+  return sse;
+}
+
+uint64_t lineSSE16Bit(const unsigned char *src0, const unsigned char *src1, int64_t nrSamples)
+{
+  uint64_t sse = 0;
+  int64_t  i   = 0;
+#if GUESS_CORRELATION_SSE2
+  const auto zero  = _mm_setzero_si128();
+  auto       sum64 = _mm_setzero_si128();
+  for (; i + 8 <= nrSamples; i += 8)
+  {
+    const auto a       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src0 + i * 2));
+    const auto b       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1 + i * 2));
+    const auto absDiff = _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+    // Square the absolute differences as 64 bit values (even and odd 32 bit lanes separately)
+    for (const auto d : {_mm_unpacklo_epi16(absDiff, zero), _mm_unpackhi_epi16(absDiff, zero)})
+    {
+      const auto odd = _mm_srli_epi64(d, 32);
+      sum64          = _mm_add_epi64(sum64, _mm_mul_epu32(d, d));
+      sum64          = _mm_add_epi64(sum64, _mm_mul_epu32(odd, odd));
+    }
+  }
+  alignas(16) uint64_t sums[2];
+  _mm_store_si128(reinterpret_cast<__m128i *>(sums), sum64);
+  sse = sums[0] + sums[1];
+#endif
+  for (; i < nrSamples; i++)
+  {
+    const auto value0 = int64_t(src0[i * 2]) | (int64_t(src0[i * 2 + 1]) << 8);
+    const auto value1 = int64_t(src1[i * 2]) | (int64_t(src1[i * 2 + 1]) << 8);
+    const auto diff   = value0 - value1;
+    sse += uint64_t(diff * diff);
+  }
+  return sse;
+}
+
+// Read nrLines lines (evenly spaced over the frame) of the first two frames
+void readLines(const CorrelationCandidate &candidate,
+               unsigned                    nrLines,
+               const FileReader &          reader,
+               CandidateScore &            score)
+{
+  const auto height = candidate.frameSize.height;
+  nrLines           = std::min(nrLines, height);
+
+  score.lines.clear();
+  for (unsigned i = 0; i < nrLines; i++)
+  {
+    const auto y      = (2 * i + 1) * height / (2 * nrLines);
+    const auto offset = int64_t(y) * candidate.bytesPerLine;
+    score.lines.push_back({reader(offset, candidate.bytesPerLine),
+                           reader(candidate.bytesPerFrame + offset, candidate.bytesPerLine)});
+  }
+}
+
+double computeMSE(const CorrelationCandidate &candidate, const CandidateScore &score)
+{
+  uint64_t sse = 0;
+  for (const auto &line : score.lines)
+  {
+    if (line.first.size() < candidate.bytesPerLine || line.second.size() < candidate.bytesPerLine)
+      return std::numeric_limits<double>::max();
+    sse += computeLineSSE(line.first.constData(),
+                          line.second.constData(),
+                          candidate.bytesPerLine,
+                          candidate.bytesPerSample);
+  }
+
+  const auto nrSamples =
+      int64_t(score.lines.size()) * candidate.bytesPerLine / candidate.bytesPerSample;
+  if (nrSamples == 0)
+    return std::numeric_limits<double>::max();
+  return double(sse) / double(nrSamples);
+}
+
+} // namespace
+
+std::vector<Size> getCorrelationTestFrameSizes()
+{
+  return {Size(176, 144),
+          Size(352, 240),
+          Size(352, 288),
+          Size(480, 480),
+          Size(480, 576),
+          Size(704, 480),
+          Size(720, 480),
+          Size(704, 576),
+          Size(720, 576),
+          Size(1024, 768),
+          Size(1280, 720),
+          Size(1280, 960),
+          Size(1920, 1072),
+          Size(1920, 1080)};
+}
+
+uint64_t computeLineSSE(const char *line0,
+                        const char *line1,
+                        int64_t     nrBytes,
+                        unsigned    bytesPerSample)
+{
+  const auto src0 = reinterpret_cast<const unsigned char *>(line0);
+  const auto src1 = reinterpret_cast<const unsigned char *>(line1);
+  if (bytesPerSample == 2)
+    return lineSSE16Bit(src0, src1, nrBytes / 2);
+  return lineSSE8Bit(src0, src1, nrBytes);
+}
+
+std::optional<size_t>
+findBestCandidateByCorrelation(const std::vector<CorrelationCandidate> &candidates,
+                               const FileReader &                       reader,
+                               int64_t                                  fileSize,
+                               double                                   mseThreshold)
+{
+  if (fileSize <= 0)
+    return {};
+
+  // Stage 1: At least two frames must fit and the file size must be a multiple of the frame size
+  std::vector<CandidateScore> scores;
+  for (size_t i = 0; i < candidates.size(); i++)
+  {
+    const auto &candidate = candidates[i];
+    if (candidate.bytesPerFrame > 0 && candidate.bytesPerLine > 0 &&
+        fileSize >= candidate.bytesPerFrame * 2 && fileSize % candidate.bytesPerFrame == 0)
+    {
+      CandidateScore score;
+      score.candidateIndex = i;
+      scores.push_back(score);
+    }
+  }
+
+  for (const auto nrLines : NR_LINES_PER_STAGE)
+  {
+    // Stage 2: The reader does not have to be thread safe. So only the comparison is parallel.
+    for (auto &score : scores)
+      readLines(candidates[score.candidateIndex], nrLines, reader, score);
+    QtConcurrent::blockingMap(scores, [&candidates](CandidateScore &score) {
+      score.mse = computeMSE(candidates[score.candidateIndex], score);
+    });
+
+    // Stage 3: Drop all candidates above the threshold and check for a clear winner
+    scores.erase(std::remove_if(scores.begin(),
+                                scores.end(),
+                                [mseThreshold](const CandidateScore &score) {
+                                  return score.mse >= mseThreshold;
+                                }),
+                 scores.end());
+    if (scores.empty())
+      return {};
+
+    std::sort(scores.begin(), scores.end(), [](const CandidateScore &a, const CandidateScore &b) {
+      return a.mse < b.mse || (a.mse == b.mse && a.candidateIndex < b.candidateIndex);
+    });
+    if (scores.size() == 1 || scores[0].mse * CLEAR_WINNER_FACTOR < scores[1].mse)
+      return scores[0].candidateIndex;
+  }
+
+  return scores[0].candidateIndex;
+}
+
+} // namespace video
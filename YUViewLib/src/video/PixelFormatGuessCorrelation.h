@@ -0,0 +1,85 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <common/Typedef.h>
+
+#include <QByteArray>
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace video
+{
+
+// Read the given number of bytes from the given position in the file. Fewer bytes may be returned
+// at the end of the file.
+using FileReader = std::function<QByteArray(int64_t position, int64_t nrBytes)>;
+
+// A candidate format for the correlation test. The lines of the first plane (or all interleaved
+// components) of the first two frames are compared.
+struct CorrelationCandidate
+{
+  Size     frameSize;
+  int64_t  bytesPerFrame{};
+  int64_t  bytesPerLine{};    // The bytes of one line of the compared samples
+  unsigned bytesPerSample{1}; // 1 or 2 (little endian)
+};
+
+/* Find the candidate for which the first two frames of the file are most similar. This is done in
+ * stages so that only a few lines of the file are read:
+ * 1. Only candidates of which at least two frames fit into the file and where the file size is a
+ *    multiple of the frame size are tested.
+ * 2. A sparse set of lines of the first two frames is compared for all remaining candidates (in
+ *    parallel). Candidates with an MSE above the threshold are dropped.
+ * 3. If one candidate is clearly better than all others, it is returned. Otherwise the remaining
+ *    candidates are compared again using more lines.
+ * Return the index of the best candidate. If two candidates are equally good, the first one wins.
+ */
+std::optional<size_t>
+findBestCandidateByCorrelation(const std::vector<CorrelationCandidate> &candidates,
+                               const FileReader &                       reader,
+                               int64_t                                  fileSize,
+                               double                                   mseThreshold);
+
+// The frame sizes that are tested when guessing a format from the correlation
+std::vector<Size> getCorrelationTestFrameSizes();
+
+// Compute the sum of squared differences between the samples of the two lines
+uint64_t computeLineSSE(const char *line0,
+                        const char *line1,
+                        int64_t     nrBytes,
+                        unsigned    bytesPerSample);
+
+} // namespace video
@@ -159,4 +159,37 @@ guessFormatFromSizeAndName(const QFileInfo &fileInfo, Size frameSize, int64_t fi
   return PixelFormatRGB(8, DataLayout::Packed, ChannelOrder::RGB);
 }
 
+std::optional<std::pair<Size, PixelFormatRGB>> guessFormatFromCorrelation(const FileReader &reader,
+                                                                          int64_t fileSize)
+{
+  // Test packed RGB and RGBA with 8 and 16 bit. All interleaved components of a line are compared.
+  std::vector<std::pair<Size, PixelFormatRGB>> formatList;
+  std::vector<CorrelationCandidate>            candidates;
+  for (const auto bits : {8u, 16u})
+  {
+    for (const auto alphaMode : {AlphaMode::None, AlphaMode::Last})
+    {
+      for (const auto &size : getCorrelationTestFrameSizes())
+      {
+        const auto format = PixelFormatRGB(bits, DataLayout::Packed, ChannelOrder::RGB, alphaMode);
+        const auto bytesPerSample = (bits > 8) ? 2u : 1u;
+
+        CorrelationCandidate candidate;
+        candidate.frameSize      = size;
+        candidate.bytesPerFrame  = int64_t(format.bytesPerFrame(size));
+        candidate.bytesPerLine   = int64_t(size.width) * format.nrChannels() * bytesPerSample;
+        candidate.bytesPerSample = bytesPerSample;
+
+        formatList.push_back({size, format});
+        candidates.push_back(candidate);
+      }
+    }
+  }
+
+  const auto mseThreshold = 400.0;
+  if (auto best = findBestCandidateByCorrelation(candidates, reader, fileSize, mseThreshold))
+    return formatList.at(*best);
+  return {};
+}
+
 } // namespace video::rgb
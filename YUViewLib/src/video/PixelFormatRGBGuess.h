@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include "PixelFormatGuessCorrelation.h"
 #include "PixelFormatRGB.h"
 
 #include <QFileInfo>
@@ -44,4 +45,10 @@ namespace video::rgb
 PixelFormatRGB
 guessFormatFromSizeAndName(const QFileInfo &fileInfo, Size frameSize, int64_t fileSize);
 
+// Guess the frame size and the format from the correlation of the first two frames of the file.
+// Only a few lines of the first two frames are read using the reader. The channel order can not
+// be detected like this so RGB order is assumed.
+std::optional<std::pair<Size, PixelFormatRGB>> guessFormatFromCorrelation(const FileReader &reader,
+                                                                          int64_t fileSize);
+
 } // namespace video::rgb
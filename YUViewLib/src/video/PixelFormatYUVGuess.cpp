@@ -372,4 +372,37 @@ PixelFormatYUV guessFormatFromSizeAndName(const Size       size,
   return {};
 }
 
+std::optional<std::pair<Size, PixelFormatYUV>> guessFormatFromCorrelation(const FileReader &reader,
+                                                                          int64_t fileSize)
+{
+  // Test all subsamplings with bit depths 8, 10 and 16. Only the luma plane is compared.
+  std::vector<std::pair<Size, PixelFormatYUV>> formatList;
+  std::vector<CorrelationCandidate>            candidates;
+  for (const auto bits : {8, 10, 16})
+  {
+    for (const auto &subsampling : SubsamplingMapper.getEnums())
+    {
+      for (const auto &size : getCorrelationTestFrameSizes())
+      {
+        const auto format         = PixelFormatYUV(subsampling, bits, PlaneOrder::YUV);
+        const auto bytesPerSample = (bits > 8) ? 2u : 1u;
+
+        CorrelationCandidate candidate;
+        candidate.frameSize      = size;
+        candidate.bytesPerFrame  = format.bytesPerFrame(size);
+        candidate.bytesPerLine   = int64_t(size.width) * bytesPerSample;
+        candidate.bytesPerSample = bytesPerSample;
+
+        formatList.push_back({size, format});
+        candidates.push_back(candidate);
+      }
+    }
+  }
+
+  const auto mseThreshold = 400.0;
+  if (auto best = findBestCandidateByCorrelation(candidates, reader, fileSize, mseThreshold))
+    return formatList.at(*best);
+  return {};
+}
+
 } // namespace video::yuv
@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include "PixelFormatGuessCorrelation.h"
 #include "PixelFormatYUV.h"
 
 #include <QFileInfo>
@@ -47,4 +48,9 @@ PixelFormatYUV guessFormatFromSizeAndName(const Size       size,
                                           int64_t          fileSize,
                                           const QFileInfo &fileInfo);
 
+// Guess the frame size and the format from the correlation of the first two frames of the file.
+// Only a few lines of the first two frames are read using the reader.
+std::optional<std::pair<Size, PixelFormatYUV>> guessFormatFromCorrelation(const FileReader &reader,
+                                                                          int64_t fileSize);
+
 } // namespace video::yuv
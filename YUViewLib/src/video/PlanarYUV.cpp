@@ -0,0 +1,169 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PlanarYUV.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace video::yuv
+{
+
+namespace
+{
+
+template <unsigned Bytes, bool BigEndian>
+void extractScaledPlane(const PlaneView &plane,
+                        const unsigned   x,
+                        const unsigned   y,
+                        const unsigned   width,
+                        const unsigned   height,
+                        const unsigned   scaleShift,
+                        unsigned char *  dst)
+{
+  const auto factor = 1u << scaleShift;
+  const auto round  = (uint64_t(1) << (2 * scaleShift)) / 2;
+
+  std::vector<uint64_t> sums(width);
+  for (unsigned outY = 0; outY < height; outY++)
+  {
+    std::fill(sums.begin(), sums.end(), 0);
+    for (unsigned dy = 0; dy < factor; dy++)
+    {
+      const auto line = plane.data + size_t(y + outY * factor + dy) * plane.stride;
+      for (unsigned outX = 0; outX < width; outX++)
+      {
+        const auto firstSample = size_t(x + outX * factor) * plane.valueSkip;
+        for (unsigned dx = 0; dx < factor; dx++)
+          sums[outX] += readSample<Bytes, BigEndian>(line, firstSample + dx * plane.valueSkip);
+      }
+    }
+
+    const auto dstLine = dst + size_t(outY) * width * Bytes;
+    for (unsigned outX = 0; outX < width; outX++)
+      writeSample<Bytes>(dstLine, outX, int((sums[outX] + round) >> (2 * scaleShift)));
+  }
+}
+
+} // namespace
+
+std::vector<PlaneView>
+getPlaneViews(const QByteArray &data, const PixelFormatYUV &format, const Size frameSize)
+{
+  const auto bitDepth    = format.getBitsPerSample();
+  const auto sampleBytes = bitDepth > 8 ? 2u : 1u;
+  const auto bigEndian   = format.isBigEndian();
+  const auto src         = reinterpret_cast<const unsigned char *>(data.constData());
+
+  std::vector<PlaneView> planes;
+  planes.push_back({src, size_t(frameSize.width) * sampleBytes, 1, bitDepth, bigEndian});
+  if (format.getSubsampling() == Subsampling::YUV_400)
+    return planes;
+
+  const auto chromaWidth  = frameSize.width / format.getSubsamplingHor();
+  const auto chromaHeight = frameSize.height / format.getSubsamplingVer();
+  const auto lumaBytes    = size_t(frameSize.width) * frameSize.height * sampleBytes;
+  const auto chromaBytes  = size_t(chromaWidth) * chromaHeight * sampleBytes;
+  const auto planeOrder   = format.getPlaneOrder();
+  const auto swapUV       = (planeOrder == PlaneOrder::YVU || planeOrder == PlaneOrder::YVUA);
+
+  PlaneView first, second;
+  if (format.isUVInterleaved())
+  {
+    const auto valueSkip =
+        (planeOrder == PlaneOrder::YUV || planeOrder == PlaneOrder::YVU) ? 2u : 3u;
+    const auto stride = size_t(chromaWidth) * valueSkip * sampleBytes;
+    first             = {src + lumaBytes, stride, valueSkip, bitDepth, bigEndian};
+    second            = first;
+    second.data += sampleBytes;
+  }
+  else
+  {
+    first  = {src + lumaBytes, chromaWidth * sampleBytes, 1, bitDepth, bigEndian};
+    second = {src + lumaBytes + chromaBytes, chromaWidth * sampleBytes, 1, bitDepth, bigEndian};
+  }
+  planes.push_back(swapUV ? second : first);
+  planes.push_back(swapUV ? first : second);
+  return planes;
+}
+
+QByteArray extractScaledRegion(const QByteArray &    data,
+                               const PixelFormatYUV &format,
+                               const Size            frameSize,
+                               const unsigned        x,
+                               const unsigned        y,
+                               const Size            outputSize,
+                               const unsigned        scaleShift,
+                               PixelFormatYUV &      outputFormat)
+{
+  const auto bitDepth    = format.getBitsPerSample();
+  const auto sampleBytes = bitDepth > 8 ? 2u : 1u;
+  const auto subH        = unsigned(format.getSubsamplingHor());
+  const auto subV        = unsigned(format.getSubsamplingVer());
+
+  outputFormat = PixelFormatYUV(
+      format.getSubsampling(), bitDepth, PlaneOrder::YUV, false, format.getChromaOffset());
+
+  const auto planes     = getPlaneViews(data, format, frameSize);
+  const auto lumaBytes  = size_t(outputSize.width) * outputSize.height * sampleBytes;
+  const auto chromaSize = Size(outputSize.width / subH, outputSize.height / subV);
+  const auto chromaBytes =
+      planes.size() > 1 ? size_t(chromaSize.width) * chromaSize.height * sampleBytes : size_t(0);
+
+  QByteArray output;
+  output.resize(int(lumaBytes + 2 * chromaBytes));
+  auto dst = reinterpret_cast<unsigned char *>(output.data());
+
+  for (size_t i = 0; i < planes.size(); i++)
+  {
+    const auto &plane     = planes[i];
+    const auto  isChroma  = i > 0;
+    const auto  planeX    = isChroma ? x / subH : x;
+    const auto  planeY    = isChroma ? y / subV : y;
+    const auto  planeSize = isChroma ? chromaSize : outputSize;
+    auto        planeDst  = dst + (isChroma ? lumaBytes + (i - 1) * chromaBytes : 0);
+
+    if (sampleBytes == 1)
+      extractScaledPlane<1, false>(
+          plane, planeX, planeY, planeSize.width, planeSize.height, scaleShift, planeDst);
+    else if (plane.bigEndian)
+      extractScaledPlane<2, true>(
+          plane, planeX, planeY, planeSize.width, planeSize.height, scaleShift, planeDst);
+    else
+      extractScaledPlane<2, false>(
+          plane, planeX, planeY, planeSize.width, planeSize.height, scaleShift, planeDst);
+  }
+
+  return output;
+}
+
+} // namespace video::yuv
@@ -0,0 +1,96 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PixelFormatYUV.h"
+
+#include <QByteArray>
+
+#include <vector>
+
+namespace video::yuv
+{
+
+// Where to find the samples of one plane of a planar YUV frame
+struct PlaneView
+{
+  const unsigned char *data{};
+  size_t               stride{};    // Bytes from one line to the next
+  unsigned             valueSkip{}; // Samples from one value to the next (interleaved UV)
+  unsigned             bitDepth{};
+  bool                 bigEndian{};
+};
+
+// Get the views of the Y, U and V planes (only Y for 4:0:0) in the given planar frame. The plane
+// order and UV interleaving of the format are resolved. An alpha plane is not returned.
+std::vector<PlaneView>
+getPlaneViews(const QByteArray &data, const PixelFormatYUV &format, const Size frameSize);
+
+template <unsigned Bytes, bool BigEndian>
+inline int readSample(const unsigned char *src, const size_t idx)
+{
+  if constexpr (Bytes == 1)
+    return src[idx];
+  else if constexpr (BigEndian)
+    return (src[idx * 2] << 8) | src[idx * 2 + 1];
+  else
+    return src[idx * 2] | (src[idx * 2 + 1] << 8);
+}
+
+// Write a sample (little endian for 2 bytes)
+template <unsigned Bytes>
+inline void writeSample(unsigned char *dst, const size_t idx, const int val)
+{
+  if constexpr (Bytes == 1)
+    dst[idx] = (unsigned char)(val);
+  else
+  {
+    dst[idx * 2]     = (unsigned char)(val & 0xff);
+    dst[idx * 2 + 1] = (unsigned char)(val >> 8);
+  }
+}
+
+// Copy a region of a planar frame into a new planar frame (YUV plane order, no interleaving,
+// little endian) while scaling it down by 2^scaleShift in both directions. Each output sample is
+// the average of the 2^scaleShift x 2^scaleShift input samples it covers. The position and the
+// output size must be multiples of the chroma subsampling and the region must be inside the frame.
+QByteArray extractScaledRegion(const QByteArray &    data,
+                               const PixelFormatYUV &format,
+                               const Size            frameSize,
+                               const unsigned        x,
+                               const unsigned        y,
+                               const Size            outputSize,
+                               const unsigned        scaleShift,
+                               PixelFormatYUV &      outputFormat);
+
+} // namespace video::yuv
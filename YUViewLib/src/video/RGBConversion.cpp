@@ -0,0 +1,583 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RGBConversion.h"
+
+#include <common/Functions.h>
+#include <video/PlanarYUV.h>
+#include <video/videoHandler.h>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RGB_CONVERSION_SSE2 1
+#else
+#define RGB_CONVERSION_SSE2 0
+#endif
+
+namespace video::rgb
+{
+
+namespace
+{
+
+// Convert the input raw RGB(A) format to the output RGBA format. The bit depth is either 8 or 16
+// (for all formats with more than 8 bit per sample). All scalings and alpha modes are supported.
+template <int bitDepth>
+void convertInputRGBToRGBAGeneric(const QByteArray &    sourceBuffer,
+                                  const PixelFormatRGB &srcPixelFormat,
+                                  unsigned char *       targetBuffer,
+                                  const Size            frameSize,
+                                  const bool            componentInvert[4],
+                                  const int             componentScale[4],
+                                  const bool            limitedRange,
+                                  const bool            hasAlpha,
+                                  const bool            premultiplyAlpha)
+{
+  const int  rightShift = bitDepth == 8 ? 0 : (srcPixelFormat.getBitsPerSample() - 8);
+  const auto offsetToNextValue =
+      srcPixelFormat.getDataLayout() == DataLayout::Planar ? 1 : srcPixelFormat.nrChannels();
+
+  typedef typename std::conditional<bitDepth == 8, uint8_t *, uint16_t *>::type InValueType;
+
+  auto offsetR = srcPixelFormat.getComponentPosition(Channel::Red);
+  auto offsetG = srcPixelFormat.getComponentPosition(Channel::Green);
+  auto offsetB = srcPixelFormat.getComponentPosition(Channel::Blue);
+  auto offsetA = srcPixelFormat.getComponentPosition(Channel::Alpha);
+  if (srcPixelFormat.getDataLayout() == DataLayout::Planar)
+  {
+    offsetR *= frameSize.width * frameSize.height;
+    offsetG *= frameSize.width * frameSize.height;
+    offsetB *= frameSize.width * frameSize.height;
+    offsetA *= frameSize.width * frameSize.height;
+  }
+
+  auto srcR = ((InValueType)sourceBuffer.data()) + offsetR;
+  auto srcG = ((InValueType)sourceBuffer.data()) + offsetG;
+  auto srcB = ((InValueType)sourceBuffer.data()) + offsetB;
+  auto srcA = ((InValueType)sourceBuffer.data()) + offsetA;
+
+  // Now we just have to iterate over all values and always skip "offsetToNextValue" values in
+  // the sources and write 4 values in dst.
+  for (unsigned i = 0; i < frameSize.width * frameSize.height; i++)
+  {
+    int valR = (int)srcR[0];
+    int valG = (int)srcG[0];
+    int valB = (int)srcB[0];
+    // Formats without alpha have no alpha position. Don't read outside of the buffer.
+    int valA = hasAlpha ? (int)srcA[0] : 255;
+
+    if (bitDepth > 8 && srcPixelFormat.getEndianess() == Endianness::Big)
+    {
+      valR = swapLowestBytes(valR);
+      valG = swapLowestBytes(valG);
+      valB = swapLowestBytes(valB);
+      valA = swapLowestBytes(valA);
+    }
+
+    valR = (valR * componentScale[0]) >> rightShift;
+    valR = functions::clip(valR, 0, 255);
+    if (componentInvert[0])
+      valR = 255 - valR;
+
+    valG = (valG * componentScale[1]) >> rightShift;
+    valG = functions::clip(valG, 0, 255);
+    if (componentInvert[1])
+      valG = 255 - valG;
+
+    valB = (valB * componentScale[2]) >> rightShift;
+    valB = functions::clip(valB, 0, 255);
+    if (componentInvert[2])
+      valB = 255 - valB;
+
+    if (hasAlpha)
+    {
+      valA = (valA * componentScale[3]) >> rightShift;
+      valA = functions::clip(valA, 0, 255);
+      if (componentInvert[3])
+        valA = 255 - valA;
+    }
+    else
+      valA = 255;
+
+    if (limitedRange)
+    {
+      valR = videoHandler::convScaleLimitedRange(valR);
+      valG = videoHandler::convScaleLimitedRange(valG);
+      valB = videoHandler::convScaleLimitedRange(valB);
+      // No limited range for alpha
+    }
+
+    if (hasAlpha && premultiplyAlpha)
+    {
+      valR = ((valR * 255) * valA) / (255 * 255);
+      valG = ((valG * 255) * valA) / (255 * 255);
+      valB = ((valB * 255) * valA) / (255 * 255);
+    }
+
+    srcR += offsetToNextValue;
+    srcG += offsetToNextValue;
+    srcB += offsetToNextValue;
+    if (hasAlpha)
+      srcA += offsetToNextValue;
+
+    targetBuffer[0] = valB;
+    targetBuffer[1] = valG;
+    targetBuffer[2] = valR;
+    targetBuffer[3] = valA;
+
+    targetBuffer += 4;
+  }
+}
+
+// Convert one component of the input raw RGB(A) format to a grey RGBA output. The bit depth is
+// either 8 or 16.
+template <int bitDepth>
+void convertSinglePlaneRGBToGreyscaleRGBAGeneric(const QByteArray &    sourceBuffer,
+                                                 const PixelFormatRGB &srcPixelFormat,
+                                                 unsigned char *       targetBuffer,
+                                                 const Size            frameSize,
+                                                 const int             scale,
+                                                 const bool            invert,
+                                                 const int             displayComponentOffset,
+                                                 const bool            limitedRange)
+{
+  // The source values have to be shifted left by this many bits to get 8 bit output
+  const auto rightShift = srcPixelFormat.getBitsPerSample() - 8;
+  const auto offsetToNextValue =
+      srcPixelFormat.getDataLayout() == DataLayout::Planar ? 1 : srcPixelFormat.nrChannels();
+
+  typedef typename std::conditional<bitDepth == 8, uint8_t *, uint16_t *>::type InValueType;
+
+  // First get the pointer to the first value that we will need.
+  auto src = (InValueType)sourceBuffer.data();
+  if (srcPixelFormat.getDataLayout() == DataLayout::Planar)
+    src += displayComponentOffset * frameSize.width * frameSize.height;
+  else
+    src += displayComponentOffset;
+
+  // Now we just have to iterate over all values and always skip "offsetToNextValue" values in
+  // src and write 4 values in dst.
+  for (unsigned i = 0; i < frameSize.width * frameSize.height; i++)
+  {
+    auto val = (int)src[0];
+    if (bitDepth > 8 && srcPixelFormat.getEndianess() == Endianness::Big)
+      val = swapLowestBytes(val);
+    val = (val * scale) >> rightShift;
+    val = functions::clip(val, 0, 255);
+    if (invert)
+      val = 255 - val;
+    if (limitedRange)
+      val = videoHandler::convScaleLimitedRange(val);
+    targetBuffer[0] = val;
+    targetBuffer[1] = val;
+    targetBuffer[2] = val;
+    targetBuffer[3] = 255;
+
+    src += offsetToNextValue;
+    targetBuffer += 4;
+  }
+}
+
+// The sample format of the input resolved at compile time
+template <unsigned BitsPerSample, bool BigEndian> struct SampleTraits
+{
+  static constexpr unsigned Bytes = (BitsPerSample > 8) ? 2 : 1;
+  static constexpr unsigned Shift = BitsPerSample - 8;
+
+  // Read the sample with the given index and convert it to 8 bit
+  static unsigned readValue(const unsigned char *src, const size_t idx)
+  {
+    const auto value = unsigned(yuv::readSample<Bytes, BigEndian>(src, idx)) >> Shift;
+    return std::min(value, 255u);
+  }
+
+#if RGB_CONVERSION_SSE2
+  // Read 16 consecutive samples and convert them to 8 bit
+  static __m128i read16Values(const unsigned char *src)
+  {
+    if constexpr (Bytes == 1)
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    else
+    {
+      auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+      auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+      if constexpr (BigEndian)
+      {
+        lo = _mm_or_si128(_mm_slli_epi16(lo, 8), _mm_srli_epi16(lo, 8));
+        hi = _mm_or_si128(_mm_slli_epi16(hi, 8), _mm_srli_epi16(hi, 8));
+      }
+      // After the shift all values are below 2^15 so that the signed saturation clips to 255
+      return _mm_packus_epi16(_mm_srli_epi16(lo, Shift), _mm_srli_epi16(hi, Shift));
+    }
+  }
+#endif
+};
+
+// Where to find the R, G, B and A samples of the first pixel (in samples from the start of the
+// buffer) and how to modify them
+struct ComponentLayout
+{
+  size_t        offset[4]{};
+  unsigned char invertMask[4]{}; // 0xff to invert the component
+  bool          readAlpha{};
+};
+
+template <typename Traits, unsigned ValueSkip>
+void convertToRGBAKernel(const unsigned char * src,
+                         const ComponentLayout &layout,
+                         unsigned char *        dst,
+                         const size_t           nrPixels)
+{
+  size_t i = 0;
+#if RGB_CONVERSION_SSE2
+  if constexpr (ValueSkip == 1)
+  {
+    // Planar: Read 16 samples from every plane and interleave them to 16 BGRA pixels
+    const auto invertR = _mm_set1_epi8(char(layout.invertMask[0]));
+    const auto invertG = _mm_set1_epi8(char(layout.invertMask[1]));
+    const auto invertB = _mm_set1_epi8(char(layout.invertMask[2]));
+    const auto invertA = _mm_set1_epi8(char(layout.invertMask[3]));
+    const auto opaque  = _mm_set1_epi8(char(0xff));
+    const auto srcR    = src + layout.offset[0] * Traits::Bytes;
+    const auto srcG    = src + layout.offset[1] * Traits::Bytes;
+    const auto srcB    = src + layout.offset[2] * Traits::Bytes;
+    const auto srcA    = src + layout.offset[3] * Traits::Bytes;
+    for (; i + 16 <= nrPixels; i += 16)
+    {
+      const auto r = _mm_xor_si128(Traits::read16Values(srcR + i * Traits::Bytes), invertR);
+      const auto g = _mm_xor_si128(Traits::read16Values(srcG + i * Traits::Bytes), invertG);
+      const auto b = _mm_xor_si128(Traits::read16Values(srcB + i * Traits::Bytes), invertB);
+      const auto a = layout.readAlpha
+                         ? _mm_xor_si128(Traits::read16Values(srcA + i * Traits::Bytes), invertA)
+                         : opaque;
+
+      const auto bgLo = _mm_unpacklo_epi8(b, g);
+      const auto bgHi = _mm_unpackhi_epi8(b, g);
+      const auto raLo = _mm_unpacklo_epi8(r, a);
+      const auto raHi = _mm_unpackhi_epi8(r, a);
+
+      const auto out = reinterpret_cast<__m128i *>(dst + i * 4);
+      _mm_storeu_si128(out, _mm_unpacklo_epi16(bgLo, raLo));
+      _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bgLo, raLo));
+      _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bgHi, raHi));
+      _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bgHi, raHi));
+    }
+  }
+  else if constexpr (ValueSkip == 4)
+  {
+    // Packed with 4 components: 16 samples are 4 pixels. Move the components to their position
+    // in BGRA using shifts and masks within each 32 bit pixel.
+    const auto byteMask = _mm_set1_epi32(0xff);
+    const auto shiftR   = _mm_cvtsi32_si128(int(layout.offset[0] * 8));
+    const auto shiftG   = _mm_cvtsi32_si128(int(layout.offset[1] * 8));
+    const auto shiftB   = _mm_cvtsi32_si128(int(layout.offset[2] * 8));
+    const auto shiftA   = _mm_cvtsi32_si128(int(layout.offset[3] * 8));
+    const auto invert   = _mm_set1_epi32(int(unsigned(layout.invertMask[2]) |
+                                           unsigned(layout.invertMask[1]) << 8 |
+                                           unsigned(layout.invertMask[0]) << 16 |
+                                           unsigned(layout.invertMask[3]) << 24));
+    const auto opaque = layout.readAlpha ? _mm_setzero_si128() : _mm_set1_epi32(int(0xff000000));
+    for (; i + 4 <= nrPixels; i += 4)
+    {
+      const auto v = Traits::read16Values(src + i * 4 * Traits::Bytes);
+
+      const auto b = _mm_and_si128(_mm_srl_epi32(v, shiftB), byteMask);
+      const auto g = _mm_and_si128(_mm_srl_epi32(v, shiftG), byteMask);
+      const auto r = _mm_and_si128(_mm_srl_epi32(v, shiftR), byteMask);
+
+      auto out = _mm_or_si128(b, _mm_or_si128(_mm_slli_epi32(g, 8), _mm_slli_epi32(r, 16)));
+      if (layout.readAlpha)
+        out = _mm_or_si128(out, _mm_slli_epi32(_mm_srl_epi32(v, shiftA), 24));
+      out = _mm_or_si128(_mm_xor_si128(out, invert), opaque);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), out);
+    }
+  }
+#endif
+
+  auto readComponent = [&](const unsigned c, const size_t pixel) {
+    const auto value = Traits::readValue(src, layout.offset[c] + pixel * ValueSkip);
+    return (unsigned char)(value ^ layout.invertMask[c]);
+  };
+  for (; i < nrPixels; i++)
+  {
+    dst[i * 4]     = readComponent(2, i);
+    dst[i * 4 + 1] = readComponent(1, i);
+    dst[i * 4 + 2] = readComponent(0, i);
+    dst[i * 4 + 3] = layout.readAlpha ? readComponent(3, i) : 255;
+  }
+}
+
+template <typename Traits, unsigned ValueSkip>
+void convertToGreyscaleKernel(const unsigned char *src,
+                              const size_t         offset,
+                              const unsigned char  invertMask,
+                              unsigned char *      dst,
+                              const size_t         nrPixels)
+{
+  size_t i = 0;
+#if RGB_CONVERSION_SSE2
+  if constexpr (ValueSkip == 1)
+  {
+    // Planar: Read 16 samples and replicate them to 16 grey BGRA pixels
+    const auto invert = _mm_set1_epi8(char(invertMask));
+    const auto opaque = _mm_set1_epi8(char(0xff));
+    const auto srcC   = src + offset * Traits::Bytes;
+    for (; i + 16 <= nrPixels; i += 16)
+    {
+      const auto v = _mm_xor_si128(Traits::read16Values(srcC + i * Traits::Bytes), invert);
+
+      const auto vvLo = _mm_unpacklo_epi8(v, v);
+      const auto vvHi = _mm_unpackhi_epi8(v, v);
+      const auto vaLo = _mm_unpacklo_epi8(v, opaque);
+      const auto vaHi = _mm_unpackhi_epi8(v, opaque);
+
+      const auto out = reinterpret_cast<__m128i *>(dst + i * 4);
+      _mm_storeu_si128(out, _mm_unpacklo_epi16(vvLo, vaLo));
+      _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(vvLo, vaLo));
+      _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(vvHi, vaHi));
+      _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(vvHi, vaHi));
+    }
+  }
+  else if constexpr (ValueSkip == 4)
+  {
+    // Packed with 4 components: 16 samples are 4 pixels
+    const auto byteMask = _mm_set1_epi32(0xff);
+    const auto shift    = _mm_cvtsi32_si128(int(offset * 8));
+    const auto invert   = _mm_set1_epi32(int(invertMask));
+    const auto opaque   = _mm_set1_epi32(int(0xff000000));
+    for (; i + 4 <= nrPixels; i += 4)
+    {
+      const auto v = Traits::read16Values(src + i * 4 * Traits::Bytes);
+      const auto c = _mm_xor_si128(_mm_and_si128(_mm_srl_epi32(v, shift), byteMask), invert);
+
+      auto out = _mm_or_si128(c, _mm_slli_epi32(c, 8));
+      out      = _mm_or_si128(out, _mm_or_si128(_mm_slli_epi32(c, 16), opaque));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), out);
+    }
+  }
+#endif
+
+  for (; i < nrPixels; i++)
+  {
+    const auto val =
+        (unsigned char)(Traits::readValue(src, offset + i * ValueSkip) ^ invertMask);
+    dst[i * 4]     = val;
+    dst[i * 4 + 1] = val;
+    dst[i * 4 + 2] = val;
+    dst[i * 4 + 3] = 255;
+  }
+}
+
+template <typename Traits, typename Function>
+bool dispatchValueSkip(const unsigned valueSkip, Function function)
+{
+  switch (valueSkip)
+  {
+  case 1:
+    function(Traits(), std::integral_constant<unsigned, 1>());
+    return true;
+  case 3:
+    function(Traits(), std::integral_constant<unsigned, 3>());
+    return true;
+  case 4:
+    function(Traits(), std::integral_constant<unsigned, 4>());
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Call the function with the SampleTraits and the value skip of the format as compile time
+// constants. Returns false if there is no specialization for the format.
+template <typename Function>
+bool dispatchFormat(const PixelFormatRGB &format, Function function)
+{
+  const auto valueSkip =
+      format.getDataLayout() == DataLayout::Planar ? 1u : format.nrChannels();
+  const auto bigEndian = format.getEndianess() == Endianness::Big;
+
+  switch (format.getBitsPerSample())
+  {
+  case 8:
+    return dispatchValueSkip<SampleTraits<8, false>>(valueSkip, function);
+  case 10:
+    return bigEndian ? dispatchValueSkip<SampleTraits<10, true>>(valueSkip, function)
+                     : dispatchValueSkip<SampleTraits<10, false>>(valueSkip, function);
+  case 12:
+    return bigEndian ? dispatchValueSkip<SampleTraits<12, true>>(valueSkip, function)
+                     : dispatchValueSkip<SampleTraits<12, false>>(valueSkip, function);
+  case 16:
+    return bigEndian ? dispatchValueSkip<SampleTraits<16, true>>(valueSkip, function)
+                     : dispatchValueSkip<SampleTraits<16, false>>(valueSkip, function);
+  default:
+    return false;
+  }
+}
+
+// Apply the limited range scaling to the R, G and B values of the BGRA pixels
+void applyLimitedRange(unsigned char *targetBuffer, const size_t nrPixels)
+{
+  static const auto table = [] {
+    std::array<unsigned char, 256> t;
+    for (int i = 0; i < 256; i++)
+      t[i] = (unsigned char)(videoHandler::convScaleLimitedRange(i));
+    return t;
+  }();
+
+  for (size_t i = 0; i < nrPixels * 4; i += 4)
+  {
+    targetBuffer[i]     = table[targetBuffer[i]];
+    targetBuffer[i + 1] = table[targetBuffer[i + 1]];
+    targetBuffer[i + 2] = table[targetBuffer[i + 2]];
+  }
+}
+
+} // namespace
+
+void convertInputRGBToRGBA(const QByteArray &    sourceBuffer,
+                           const PixelFormatRGB &srcPixelFormat,
+                           unsigned char *       targetBuffer,
+                           const Size            frameSize,
+                           const bool            componentInvert[4],
+                           const int             componentScale[4],
+                           const bool            limitedRange,
+                           const bool            hasAlpha,
+                           const bool            premultiplyAlpha)
+{
+  const auto unscaled = componentScale[0] == 1 && componentScale[1] == 1 &&
+                        componentScale[2] == 1 && (!hasAlpha || componentScale[3] == 1);
+  if (unscaled && !(hasAlpha && premultiplyAlpha))
+  {
+    const auto nrPixels = size_t(frameSize.width) * size_t(frameSize.height);
+    const auto planar   = srcPixelFormat.getDataLayout() == DataLayout::Planar;
+
+    ComponentLayout layout;
+    layout.readAlpha = hasAlpha;
+    for (const auto channel : {Channel::Red, Channel::Green, Channel::Blue, Channel::Alpha})
+    {
+      const auto c        = int(channel);
+      const auto position = srcPixelFormat.getComponentPosition(channel);
+      if (position < 0 || (channel == Channel::Alpha && !hasAlpha))
+        continue;
+      layout.offset[c]     = size_t(position) * (planar ? nrPixels : 1);
+      layout.invertMask[c] = componentInvert[c] ? 0xff : 0;
+    }
+
+    const auto src       = reinterpret_cast<const unsigned char *>(sourceBuffer.constData());
+    const auto converted = dispatchFormat(srcPixelFormat, [&](auto traits, auto valueSkip) {
+      convertToRGBAKernel<decltype(traits), decltype(valueSkip)::value>(
+          src, layout, targetBuffer, nrPixels);
+    });
+    if (converted)
+    {
+      if (limitedRange)
+        applyLimitedRange(targetBuffer, nrPixels);
+      return;
+    }
+  }
+
+  if (srcPixelFormat.getBitsPerSample() == 8)
+    convertInputRGBToRGBAGeneric<8>(sourceBuffer,
+                                    srcPixelFormat,
+                                    targetBuffer,
+                                    frameSize,
+                                    componentInvert,
+                                    componentScale,
+                                    limitedRange,
+                                    hasAlpha,
+                                    premultiplyAlpha);
+  else
+    convertInputRGBToRGBAGeneric<16>(sourceBuffer,
+                                     srcPixelFormat,
+                                     targetBuffer,
+                                     frameSize,
+                                     componentInvert,
+                                     componentScale,
+                                     limitedRange,
+                                     hasAlpha,
+                                     premultiplyAlpha);
+}
+
+void convertSinglePlaneRGBToGreyscaleRGBA(const QByteArray &    sourceBuffer,
+                                          const PixelFormatRGB &srcPixelFormat,
+                                          unsigned char *       targetBuffer,
+                                          const Size            frameSize,
+                                          const int             scale,
+                                          const bool            invert,
+                                          const int             displayComponentOffset,
+                                          const bool            limitedRange)
+{
+  if (scale == 1 && displayComponentOffset >= 0)
+  {
+    const auto nrPixels = size_t(frameSize.width) * size_t(frameSize.height);
+    const auto planar   = srcPixelFormat.getDataLayout() == DataLayout::Planar;
+    const auto offset   = size_t(displayComponentOffset) * (planar ? nrPixels : 1);
+
+    const auto src       = reinterpret_cast<const unsigned char *>(sourceBuffer.constData());
+    const auto converted = dispatchFormat(srcPixelFormat, [&](auto traits, auto valueSkip) {
+      convertToGreyscaleKernel<decltype(traits), decltype(valueSkip)::value>(
+          src, offset, invert ? 0xff : 0, targetBuffer, nrPixels);
+    });
+    if (converted)
+    {
+      if (limitedRange)
+        applyLimitedRange(targetBuffer, nrPixels);
+      return;
+    }
+  }
+
+  if (srcPixelFormat.getBitsPerSample() == 8)
+    convertSinglePlaneRGBToGreyscaleRGBAGeneric<8>(sourceBuffer,
+                                                   srcPixelFormat,
+                                                   targetBuffer,
+                                                   frameSize,
+                                                   scale,
+                                                   invert,
+                                                   displayComponentOffset,
+                                                   limitedRange);
+  else
+    convertSinglePlaneRGBToGreyscaleRGBAGeneric<16>(sourceBuffer,
+                                                    srcPixelFormat,
+                                                    targetBuffer,
+                                                    frameSize,
+                                                    scale,
+                                                    invert,
+                                                    displayComponentOffset,
+                                                    limitedRange);
+}
+
+} // namespace video::rgb
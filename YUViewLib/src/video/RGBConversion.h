@@ -0,0 +1,74 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PixelFormatRGB.h"
+
+#include <QByteArray>
+
+namespace video::rgb
+{
+
+// Swap the two lowest bytes of the value (big endian 16 bit samples to little endian)
+template <typename T> inline T swapLowestBytes(const T &val)
+{
+  return ((val & 0xff) << 8) + ((val & 0xff00) >> 8);
+}
+
+// Convert the input raw RGB(A) format to 32 bit BGRA (the byte order of the RGB32 QImage formats).
+// Each component is scaled, clipped to 8 bit and optionally inverted. The common formats (8, 10,
+// 12 and 16 bit packed and planar layouts without scaling or premultiplication) are converted by
+// kernels that are specialized for the format at compile time. All other cases use a generic
+// per pixel conversion.
+void convertInputRGBToRGBA(const QByteArray &    sourceBuffer,
+                           const PixelFormatRGB &srcPixelFormat,
+                           unsigned char *       targetBuffer,
+                           const Size            frameSize,
+                           const bool            componentInvert[4],
+                           const int             componentScale[4],
+                           const bool            limitedRange,
+                           const bool            hasAlpha,
+                           const bool            premultiplyAlpha);
+
+// Convert one component of the input raw RGB(A) format to a grey 32 bit BGRA image. The
+// displayComponentOffset is the position of the component in the pixel format.
+void convertSinglePlaneRGBToGreyscaleRGBA(const QByteArray &    sourceBuffer,
+                                          const PixelFormatRGB &srcPixelFormat,
+                                          unsigned char *       targetBuffer,
+                                          const Size            frameSize,
+                                          const int             scale,
+                                          const bool            invert,
+                                          const int             displayComponentOffset,
+                                          const bool            limitedRange);
+
+} // namespace video::rgb
@@ -0,0 +1,392 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Resampler.h"
+
+#include "PlanarYUV.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESAMPLER_SSE2 1
+#else
+#define RESAMPLER_SSE2 0
+#endif
+
+namespace video::yuv
+{
+
+namespace
+{
+
+// Don't split planes into stripes with less output lines than this
+constexpr unsigned MIN_STRIPE_HEIGHT = 32;
+// The number of filter tables that are kept. The tables are small but there is no need to keep
+// the tables of all sizes that were ever used.
+constexpr size_t MAX_CACHED_FILTER_TABLES = 32;
+
+constexpr double PI = 3.14159265358979323846;
+
+double sinc(double x)
+{
+  if (x == 0.0)
+    return 1.0;
+  x *= PI;
+  return std::sin(x) / x;
+}
+
+// The support of the filter kernel (in input samples when not scaling down)
+double filterSupport(const ResampleFilter filter)
+{
+  switch (filter)
+  {
+  case ResampleFilter::Bilinear:
+    return 1.0;
+  case ResampleFilter::Bicubic:
+    return 2.0;
+  case ResampleFilter::Lanczos3:
+    return 3.0;
+  case ResampleFilter::Area:
+  default:
+    // Half an output sample plus half an input sample
+    return 1.0;
+  }
+}
+
+double filterWeight(const ResampleFilter filter, const double x)
+{
+  const auto absX = std::abs(x);
+  switch (filter)
+  {
+  case ResampleFilter::Bilinear:
+    return std::max(0.0, 1.0 - absX);
+  case ResampleFilter::Bicubic:
+  {
+    // Keys' cubic convolution with a = -0.5 (Catmull-Rom)
+    constexpr double a = -0.5;
+    if (absX < 1.0)
+      return ((a + 2.0) * absX - (a + 3.0)) * absX * absX + 1.0;
+    if (absX < 2.0)
+      return ((a * absX - 5.0 * a) * absX + 8.0 * a) * absX - 4.0 * a;
+    return 0.0;
+  }
+  case ResampleFilter::Lanczos3:
+    return absX < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+  default:
+    return 0.0;
+  }
+}
+
+// The area filter weights the input samples by how much of the output sample they cover
+double areaWeight(const int inputSample, const double center, const double outputSampleSize)
+{
+  const auto overlap = std::min(inputSample + 0.5, center + outputSampleSize / 2) -
+                       std::max(inputSample - 0.5, center - outputSampleSize / 2);
+  return std::max(overlap, 0.0);
+}
+
+template <unsigned Bytes, bool BigEndian>
+void readLine(const PlaneView &plane, const unsigned lineIndex, const unsigned width, float *dst)
+{
+  const auto line = plane.data + size_t(lineIndex) * plane.stride;
+  if (plane.valueSkip == 1)
+    for (unsigned x = 0; x < width; x++)
+      dst[x] = float(readSample<Bytes, BigEndian>(line, x));
+  else
+    for (unsigned x = 0; x < width; x++)
+      dst[x] = float(readSample<Bytes, BigEndian>(line, size_t(x) * plane.valueSkip));
+}
+
+using ReadLineFunction = void (*)(const PlaneView &, const unsigned, const unsigned, float *);
+
+ReadLineFunction selectReadLineFunction(const PlaneView &plane)
+{
+  if (plane.bitDepth <= 8)
+    return readLine<1, false>;
+  if (plane.bigEndian)
+    return readLine<2, true>;
+  return readLine<2, false>;
+}
+
+void filterHorizontal(const float *src, const ResampleFilterTable &table, float *dst)
+{
+  const auto taps = table.taps;
+  for (size_t x = 0; x < table.firstSample.size(); x++)
+  {
+    const auto in   = src + table.firstSample[x];
+    const auto coef = table.coefficients.data() + x * taps;
+    float      sum  = 0.0f;
+    for (unsigned t = 0; t < taps; t++)
+      sum += in[t] * coef[t];
+    dst[x] = sum;
+  }
+}
+
+// Filter the given lines vertically and write the result (rounded and clipped) to the output line
+template <unsigned Bytes>
+void filterVertical(const float *const *lines,
+                    const float *       coef,
+                    const unsigned      taps,
+                    const unsigned      width,
+                    const int           maxVal,
+                    float *             sumLine,
+                    unsigned char *     dst)
+{
+  unsigned x = 0;
+#if RESAMPLER_SSE2
+  for (; x + 4 <= width; x += 4)
+  {
+    auto sum = _mm_setzero_ps();
+    for (unsigned t = 0; t < taps; t++)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(lines[t] + x), _mm_set1_ps(coef[t])));
+    _mm_storeu_ps(sumLine + x, sum);
+  }
+#endif
+  for (; x < width; x++)
+  {
+    float sum = 0.0f;
+    for (unsigned t = 0; t < taps; t++)
+      sum += lines[t][x] * coef[t];
+    sumLine[x] = sum;
+  }
+
+  for (x = 0; x < width; x++)
+    writeSample<Bytes>(dst, x, std::clamp(int(std::lround(sumLine[x])), 0, maxVal));
+}
+
+struct Stripe
+{
+  PlaneView      plane;
+  Size           planeSize;
+  Size           outputPlaneSize;
+  unsigned char *dst{};
+  unsigned       firstLine{};
+  unsigned       lastLine{}; // exclusive
+};
+
+void resampleStripe(const Stripe &stripe, const ResampleFilter filter)
+{
+  const auto horTable = getResampleFilterTable(
+      stripe.planeSize.width, stripe.outputPlaneSize.width, filter);
+  const auto verTable = getResampleFilterTable(
+      stripe.planeSize.height, stripe.outputPlaneSize.height, filter);
+
+  // Filter all input lines that the stripe needs horizontally
+  const auto firstInputLine = verTable->firstSample[stripe.firstLine];
+  const auto lastInputLine  = verTable->firstSample[stripe.lastLine - 1] + verTable->taps;
+  const auto outputWidth    = stripe.outputPlaneSize.width;
+
+  const auto         readLine = selectReadLineFunction(stripe.plane);
+  std::vector<float> inputLine(stripe.planeSize.width);
+  std::vector<float> filteredLines(size_t(lastInputLine - firstInputLine) * outputWidth);
+  for (auto y = firstInputLine; y < lastInputLine; y++)
+  {
+    readLine(stripe.plane, y, stripe.planeSize.width, inputLine.data());
+    filterHorizontal(inputLine.data(),
+                     *horTable,
+                     filteredLines.data() + size_t(y - firstInputLine) * outputWidth);
+  }
+
+  const auto           sampleBytes = stripe.plane.bitDepth > 8 ? 2u : 1u;
+  const auto           maxVal      = (1 << stripe.plane.bitDepth) - 1;
+  std::vector<float>   sumLine(outputWidth);
+  std::vector<float *> lines(verTable->taps);
+  for (auto y = stripe.firstLine; y < stripe.lastLine; y++)
+  {
+    for (unsigned t = 0; t < verTable->taps; t++)
+      lines[t] = filteredLines.data() +
+                 size_t(verTable->firstSample[y] + t - firstInputLine) * outputWidth;
+
+    const auto coef = verTable->coefficients.data() + size_t(y) * verTable->taps;
+    const auto dst  = stripe.dst + size_t(y) * outputWidth * sampleBytes;
+    if (sampleBytes == 1)
+      filterVertical<1>(
+          lines.data(), coef, verTable->taps, outputWidth, maxVal, sumLine.data(), dst);
+    else
+      filterVertical<2>(
+          lines.data(), coef, verTable->taps, outputWidth, maxVal, sumLine.data(), dst);
+  }
+}
+
+} // namespace
+
+ResampleFilterTable createResampleFilterTable(const unsigned       srcSize,
+                                              const unsigned       dstSize,
+                                              const ResampleFilter filter)
+{
+  ResampleFilterTable table;
+  if (srcSize == 0 || dstSize == 0)
+    return table;
+
+  // When scaling down, the filter is stretched to the size of the output samples
+  const auto scale       = double(srcSize) / double(dstSize);
+  const auto filterScale = std::max(scale, 1.0);
+  const auto support     = filterSupport(filter) * filterScale;
+
+  // Calculate the weights of the input samples for every output sample. The samples outside of
+  // the line are replaced by the border samples.
+  std::vector<std::map<int, double>> weights(dstSize);
+  unsigned                           taps = 1;
+  for (unsigned x = 0; x < dstSize; x++)
+  {
+    const auto center = (x + 0.5) * scale - 0.5;
+    const auto first  = int(std::floor(center - support));
+    const auto last   = int(std::ceil(center + support));
+
+    double sum = 0.0;
+    for (int i = first; i <= last; i++)
+    {
+      const auto weight = (filter == ResampleFilter::Area)
+                              ? areaWeight(i, center, filterScale)
+                              : filterWeight(filter, (i - center) / filterScale);
+      // Skip the zeros of the kernel (which are not exactly zero for Lanczos)
+      if (std::abs(weight) < 1e-9)
+        continue;
+      weights[x][std::clamp(i, 0, int(srcSize) - 1)] += weight;
+      sum += weight;
+    }
+    if (weights[x].empty() || sum == 0.0)
+    {
+      weights[x] = {{std::clamp(int(std::lround(center)), 0, int(srcSize) - 1), 1.0}};
+      sum        = 1.0;
+    }
+    for (auto &weight : weights[x])
+      weight.second /= sum;
+
+    const auto span = weights[x].rbegin()->first - weights[x].begin()->first + 1;
+    taps            = std::max(taps, unsigned(span));
+  }
+
+  table.taps = taps;
+  table.firstSample.resize(dstSize);
+  table.coefficients.resize(size_t(dstSize) * taps);
+  for (unsigned x = 0; x < dstSize; x++)
+  {
+    const auto firstSample = std::min(unsigned(weights[x].begin()->first), srcSize - taps);
+    table.firstSample[x] = firstSample;
+    for (const auto &weight : weights[x])
+      table.coefficients[size_t(x) * taps + weight.first - firstSample] = float(weight.second);
+  }
+  return table;
+}
+
+std::shared_ptr<const ResampleFilterTable> getResampleFilterTable(const unsigned       srcSize,
+                                                                  const unsigned       dstSize,
+                                                                  const ResampleFilter filter)
+{
+  using Key = std::tuple<unsigned, unsigned, ResampleFilter>;
+  static std::mutex                                                  tablesMutex;
+  static std::map<Key, std::shared_ptr<const ResampleFilterTable>> tables;
+
+  const auto                  key = Key(srcSize, dstSize, filter);
+  std::lock_guard<std::mutex> lock(tablesMutex);
+  auto                        it = tables.find(key);
+  if (it != tables.end())
+    return it->second;
+
+  if (tables.size() >= MAX_CACHED_FILTER_TABLES)
+    tables.clear();
+  auto table = std::make_shared<const ResampleFilterTable>(
+      createResampleFilterTable(srcSize, dstSize, filter));
+  tables[key] = table;
+  return table;
+}
+
+QByteArray resamplePlanarYUV(const QByteArray &    data,
+                             const PixelFormatYUV &format,
+                             const Size            frameSize,
+                             const Size            outputSize,
+                             const ResampleFilter  filter,
+                             PixelFormatYUV &      outputFormat)
+{
+  const auto subH = unsigned(format.getSubsamplingHor());
+  const auto subV = unsigned(format.getSubsamplingVer());
+  if (!format.isPlanar() || !frameSize.isValid() || !outputSize.isValid() ||
+      outputSize.width % subH != 0 || outputSize.height % subV != 0 ||
+      data.size() < format.bytesPerFrame(frameSize))
+    return {};
+
+  const auto bitDepth    = format.getBitsPerSample();
+  const auto sampleBytes = bitDepth > 8 ? 2u : 1u;
+  outputFormat           = PixelFormatYUV(
+      format.getSubsampling(), bitDepth, PlaneOrder::YUV, false, format.getChromaOffset());
+
+  const auto planes           = getPlaneViews(data, format, frameSize);
+  const auto chromaSize       = Size(frameSize.width / subH, frameSize.height / subV);
+  const auto outputChromaSize = Size(outputSize.width / subH, outputSize.height / subV);
+  const auto lumaBytes        = size_t(outputSize.width) * outputSize.height * sampleBytes;
+  const auto chromaBytes = size_t(outputChromaSize.width) * outputChromaSize.height * sampleBytes;
+
+  QByteArray output;
+  output.resize(int(lumaBytes + chromaBytes * (planes.size() - 1)));
+  auto dst = reinterpret_cast<unsigned char *>(output.data());
+
+  // Split the output lines of all planes into stripes (as many as there are threads)
+  const auto maxStripes = unsigned(std::max(QThreadPool::globalInstance()->maxThreadCount(), 1));
+  std::vector<Stripe> stripes;
+  for (size_t c = 0; c < planes.size(); c++)
+  {
+    Stripe stripe;
+    stripe.plane           = planes[c];
+    stripe.planeSize       = (c == 0) ? frameSize : chromaSize;
+    stripe.outputPlaneSize = (c == 0) ? outputSize : outputChromaSize;
+    stripe.dst             = (c == 0) ? dst : dst + lumaBytes + chromaBytes * (c - 1);
+
+    const auto height       = stripe.outputPlaneSize.height;
+    const auto nrStripes    = std::min(maxStripes, std::max(height / MIN_STRIPE_HEIGHT, 1u));
+    const auto stripeHeight = (height + nrStripes - 1) / nrStripes;
+    for (unsigned y = 0; y < height; y += stripeHeight)
+    {
+      stripe.firstLine = y;
+      stripe.lastLine  = std::min(y + stripeHeight, height);
+      stripes.push_back(stripe);
+    }
+  }
+
+  if (stripes.size() == 1)
+    resampleStripe(stripes[0], filter);
+  else
+    QtConcurrent::blockingMap(
+        stripes, [filter](const Stripe &stripe) { resampleStripe(stripe, filter); });
+
+  return output;
+}
+
+} // namespace video::yuv
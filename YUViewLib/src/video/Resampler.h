@@ -0,0 +1,87 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "PixelFormatYUV.h"
+
+#include <QByteArray>
+
+#include <memory>
+#include <vector>
+
+namespace video::yuv
+{
+
+enum class ResampleFilter
+{
+  Bilinear,
+  Bicubic,
+  Lanczos3,
+  Area
+};
+
+/* The filter coefficients to resample a line of samples to a new length. Every output sample is
+ * the weighted sum of `taps` consecutive input samples starting at firstSample. The samples at the
+ * border are repeated and the filter is stretched when scaling down so that no aliasing occurs.
+ */
+struct ResampleFilterTable
+{
+  unsigned              taps{};
+  std::vector<unsigned> firstSample;
+  std::vector<float>    coefficients; // taps coefficients per output sample (the sum is 1)
+};
+
+ResampleFilterTable createResampleFilterTable(const unsigned       srcSize,
+                                              const unsigned       dstSize,
+                                              const ResampleFilter filter);
+
+// Get the (cached) filter table for the given scale. The tables are shared between all frames and
+// threads.
+std::shared_ptr<const ResampleFilterTable> getResampleFilterTable(const unsigned       srcSize,
+                                                                  const unsigned       dstSize,
+                                                                  const ResampleFilter filter);
+
+// Resample a planar YUV frame to the given size at the bit depth of the input. The planes are
+// filtered horizontally and then vertically. The output lines are split into stripes which are
+// processed in parallel. The output is planar YUV (YUV plane order, no interleaving, little endian)
+// with the subsampling, bit depth and chroma offset of the input (without an alpha plane). The
+// output size must be a multiple of the subsampling. An empty array is returned if the format is
+// not planar or the sizes are invalid.
+QByteArray resamplePlanarYUV(const QByteArray &    data,
+                             const PixelFormatYUV &format,
+                             const Size            frameSize,
+                             const Size            outputSize,
+                             const ResampleFilter  filter,
+                             PixelFormatYUV &      outputFormat);
+
+} // namespace video::yuv
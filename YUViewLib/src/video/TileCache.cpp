@@ -0,0 +1,105 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TileCache.h"
+
+#include <QHash>
+
+#include <functional>
+
+namespace video
+{
+
+namespace
+{
+
+size_t imageBytes(const QImage &image)
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
+  return size_t(image.byteCount());
+#else
+  return size_t(image.sizeInBytes());
+#endif
+}
+
+} // namespace
+
+size_t TileCache::KeyHash::operator()(const TileKey &key) const
+{
+  auto hash = std::hash<int>()(key.frameIndex);
+  for (const auto value : {key.level, key.tileX, key.tileY})
+    hash = hash * 31 + std::hash<unsigned>()(value);
+  return hash * 31 + qHash(key.settings);
+}
+
+QImage TileCache::get(const TileKey &key)
+{
+  auto it = this->index.find(key);
+  if (it == this->index.end())
+    return {};
+
+  this->tiles.splice(this->tiles.begin(), this->tiles, it->second);
+  return it->second->second;
+}
+
+void TileCache::insert(const TileKey &key, const QImage &tile)
+{
+  auto it = this->index.find(key);
+  if (it != this->index.end())
+  {
+    this->currentBytes -= imageBytes(it->second->second);
+    this->tiles.erase(it->second);
+    this->index.erase(it);
+  }
+
+  this->tiles.emplace_front(key, tile);
+  this->index[key] = this->tiles.begin();
+  this->currentBytes += imageBytes(tile);
+
+  // Never drop the tile that was just inserted
+  while (this->currentBytes > this->maxBytes && this->tiles.size() > 1)
+  {
+    const auto &last = this->tiles.back();
+    this->currentBytes -= imageBytes(last.second);
+    this->index.erase(last.first);
+    this->tiles.pop_back();
+  }
+}
+
+void TileCache::clear()
+{
+  this->tiles.clear();
+  this->index.clear();
+  this->currentBytes = 0;
+}
+
+} // namespace video
@@ -0,0 +1,96 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+#include <list>
+#include <unordered_map>
+
+namespace video
+{
+
+// Identifies one converted tile of a frame. The level is the downscaling (a tile of level l covers
+// 2^l x 2^l frame pixels per tile pixel). The settings describe the format and conversion settings
+// that the tile was converted with. They are compared as a whole so that tiles of different
+// settings can never be mixed up.
+struct TileKey
+{
+  int      frameIndex{};
+  unsigned level{};
+  unsigned tileX{};
+  unsigned tileY{};
+  QString  settings;
+
+  bool operator==(const TileKey &other) const
+  {
+    return this->frameIndex == other.frameIndex && this->level == other.level &&
+           this->tileX == other.tileX && this->tileY == other.tileY &&
+           this->settings == other.settings;
+  }
+};
+
+/* A least recently used cache of converted tiles with a limit on the total number of bytes of all
+ * tiles. Used to draw frames that are too large to be converted as a whole. This is not thread-safe
+ * and should only be used from the thread that draws the frame.
+ */
+class TileCache
+{
+public:
+  explicit TileCache(size_t maxBytes) : maxBytes(maxBytes) {}
+
+  // Get the tile with the given key (a null image if it is not in the cache). The tile becomes the
+  // most recently used one.
+  QImage get(const TileKey &key);
+  // Insert the tile. The least recently used tiles are dropped if the byte limit is exceeded.
+  void insert(const TileKey &key, const QImage &tile);
+  void clear();
+
+private:
+  struct KeyHash
+  {
+    size_t operator()(const TileKey &key) const;
+  };
+
+  using Entry = std::pair<TileKey, QImage>;
+
+  // The most recently used tile is in front
+  std::list<Entry>                                                 tiles;
+  std::unordered_map<TileKey, std::list<Entry>::iterator, KeyHash> index;
+
+  size_t maxBytes{};
+  size_t currentBytes{};
+};
+
+} // namespace video
@@ -41,7 +41,11 @@
 
 #include <common/Functions.h>
 #include <playlistitem/playlistItem.h>
+#include <playlistitem/playlistItemContainer.h>
 #include <ui/PlaybackController.h>
+#include <video/DiskFrameCache.h>
+#include <video/FrameBufferPool.h>
+#include <video/FrameCompression.h>
 
 namespace video
 {
@@ -94,6 +98,13 @@ public:
   {
     return QString("T%1: %2").arg(id).arg(working ? QString::number(currentFrame) : QString("-"));
   }
+  // Is the item used by the current job? This is the case for the item of the job and, if that is a
+  // container, for all of its children.
+  bool isUsingItem(playlistItem *item)
+  {
+    return currentCacheItem != nullptr &&
+           (currentCacheItem == item || currentJobChildren.contains(item));
+  }
   // Process the job in the thread that this worker was moved to. This function can be directly
   // called from the main thread. It will still process the call in the separate thread.
   void processCacheJob();
@@ -111,6 +122,9 @@ private:
   bool          testMode;
   int           id; // A static ID of the thread. Only used in getStatus().
   static int    id_counter;
+
+  // The children of the item if it is a container. These are set with the job in the main thread.
+  QList<playlistItem *> currentJobChildren;
 };
 // Initially this is 0. The threads will number themselves so that there are never two threads with
 // the same id
@@ -125,6 +139,10 @@ void loadingWorker::setJob(playlistItem *item, int frame, bool test)
   currentCacheItem = item;
   currentFrame     = frame;
   testMode         = test;
+
+  currentJobChildren.clear();
+  if (auto containerItem = dynamic_cast<playlistItemContainer *>(item))
+    currentJobChildren = containerItem->getAllChildPlaylistItems();
 }
 
 void loadingWorker::processCacheJob()
@@ -264,6 +282,10 @@ VideoCache::VideoCache(PlaylistTreeWidget *playlistTreeWidget,
           &PlaybackController::signalPlaybackStarting,
           this,
           &VideoCache::updateCacheQueue);
+  connect(playback.data(),
+          &PlaybackController::signalCurrentFrameChanged,
+          this,
+          &VideoCache::currentFrameChanged);
   connect(&statusUpdateTimer, &QTimer::timeout, this, [=] { emit updateCacheStatus(); });
   connect(&testProgrssUpdateTimer, &QTimer::timeout, this, [=] { updateTestProgress(); });
 }
@@ -333,14 +355,21 @@ void VideoCache::updateSettings()
   cachingEnabled = settings.value("Enabled", true).toBool();
   cacheLevelMax  = (int64_t)settings.value("ThresholdValueMB", 49).toUInt() * 1000 * 1000;
 
+  const auto policyName = settings.value("EvictionPolicy", "PlaylistOrder").toString();
+  const auto policyType = CachePolicyTypeMapper.getValue(policyName.toStdString())
+                              .value_or(CachePolicyType::PlaylistOrder);
+  if (!this->cachePolicy || policyType != this->cachePolicyType)
+  {
+    this->cachePolicyType = policyType;
+    this->cachePolicy     = createCachePolicy(policyType);
+    this->plannedFrames.clear();
+  }
+
+  setFrameCacheCompression(settings.value("CompressFrames", false).toBool());
+  DiskFrameCache::instance().updateSettings();
+
   // See if the user changed the number of threads
-  int targetNrThreads = functions::getOptimalThreadCount();
-  if (settings.value("SetNrThreads", false).toBool())
-    targetNrThreads = settings.value("NrThreads", targetNrThreads).toInt();
-  if (targetNrThreads <= 0)
-    targetNrThreads = 1;
-  if (!cachingEnabled)
-    targetNrThreads = 0;
+  int targetNrThreads = int(functions::getCachingThreadCount());
 
   // How many threads should be used when playback is running?
   if (settings.value("PlaybackCachingEnabled", false).toBool())
@@ -437,14 +466,14 @@ void VideoCache::interactiveLoaderFinished()
     // Is the item still being cached?
     bool itemCaching = false;
     for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == *it)
+      if (t->worker()->isUsingItem(*it))
       {
         itemCaching = true;
         break;
       }
     // Is the item still being loaded?
-    bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == *it ||
-                        interactiveThread[1]->worker()->getCacheItem() == *it);
+    bool loadingItem = (interactiveThread[0]->worker()->isUsingItem(*it) ||
+                        interactiveThread[1]->worker()->isUsingItem(*it));
 
     if (!itemCaching && !loadingItem)
     {
@@ -540,33 +569,6 @@ void VideoCache::updateCacheQueue()
   const bool play = playback->playing();
   DEBUG_CACHING("VideoCache::updateCacheQueue Playback is %srunning", play ? "" : "not ");
 
-  // Our caching priority list is like this:
-  // 1: Cache all the frames in the item that is currently selected. In order to achieve this, we
-  // will aggressively
-  //    delete other frames from other sequences in the cache. This has highest priority.
-  // 2: Cache all the frames from the following items (while there is space left in the cache). If
-  // case of playback
-  //    we will remove all frames from items that were already played back (are before the current
-  //    item in the playlist). If playback is not running, we will not remove any frames from other
-  //    items from the cache to achieve this.
-  //
-  // When frames have to be removed to fit the selected sequence into the cache, the following
-  // priorities apply to frames from other sequences. (The ones with highest priority get removed
-  // last). This priority list differs depending if playback is currently running or not.
-  //
-  // Playback is not running:
-  // 1: The frames from the previous item have highest priority and are removed last. It is very
-  // likely that in 'interactive'
-  //    (playback is not running) mode, the user will go back to the previous item.
-  // 2: The item after this item is next in the priority list.
-  // 3: The item after 2 is next and so on (wrap around in the playlist) until the previous item is
-  // reached.
-  //
-  // Playback is running:
-  // 1: The item after this item has the highest priority (it will be played next)
-  // 2: The item after 2 is next and so on (wrap around in the playlist) until the previous item is
-  // reached.
-
   // Let's start with the currently selected item (if no item is selected, the first item in the
   // playlist is considered as being selected)
   auto selection = playlist->getSelectedItems();
@@ -625,299 +627,23 @@ void VideoCache::updateCacheQueue()
   // Save the current level of the cache
   cacheLevelCurrent = cacheLevel;
 
-  // How much space do we need to cache the entire item?
-  indexRange range =
-      selection[0]->properties().startEndRange; // These are the frames that we want to cache
-  int64_t cachingFrameSize          = selection[0]->getCachingFrameSize();
-  int64_t itemSpaceNeeded           = (range.second - range.first + 1) * cachingFrameSize;
-  int64_t alreadyCached             = selection[0]->getNumberCachedFrames() * cachingFrameSize;
-  int64_t additionalItemSpaceNeeded = itemSpaceNeeded - alreadyCached;
-
-  if (play)
-  {
-    // Go through the playlist starting with the currently selected item.
-    // Add as much of all items as possible. When the cache is full, mark the remaining frames as
-    // "can be deleted"
-    int     i             = itemPos;
-    int64_t newCacheLevel = 0;
-
-    // We start in "adding" mode where items are added. If the cache is full, we switch to
-    // "deleting" mode where all frames of all items are removed. This is done for all items in the
-    // playlist.
-    bool adding = true;
-    do
-    {
-      if (allItems[i]->properties().isIndexedByFrame())
-      {
-        // How much space do we need to cache the current item?
-        auto    itemRange = allItems[i]->properties().startEndRange;
-        int64_t itemCacheSize =
-            (itemRange.second - itemRange.first + 1) * int64_t(allItems[i]->getCachingFrameSize());
-
-        if (adding && allItems[i]->isCachable())
-        {
-          if (newCacheLevel + itemCacheSize <= cacheLevelMax)
-          {
-            // All frames of the item fit and there is even more space. We remain in "adding" mode.
-            enqueueCacheJob(allItems[i], itemRange);
-            newCacheLevel += itemCacheSize;
-          }
-          else
-          {
-            // Not all frames fit. Enqueue the ones that fit and set the ones that don't as "can be
-            // deleted".
-            int64_t availableSpace   = cacheLevelMax - newCacheLevel;
-            int64_t nrFramesCachable = availableSpace / allItems[i]->getCachingFrameSize() + 1;
-
-            // These frames should be added...
-            indexRange addFrames =
-                indexRange(itemRange.first, itemRange.first + nrFramesCachable - 1);
-            enqueueCacheJob(allItems[i], addFrames);
-            newCacheLevel += nrFramesCachable * allItems[i]->getCachingFrameSize();
-            // ... and the rest should be removed (if they are cached)
-            QList<int> cachedFrames = allItems[i]->getCachedFrames();
-            for (int f : cachedFrames)
-              if (f < addFrames.first || f > addFrames.second)
-                cacheDeQueue.enqueue(plItemFrame(allItems[i], f));
-
-            // The cache is now full. We switch to "deleting" mode.
-            adding = false;
-          }
-        }
-        else
-        {
-          // Enqueue all frames (that are cached) from the item as "can be deleted".
-          QList<int> cachedFrames = allItems[i]->getCachedFrames();
-          for (int f : cachedFrames)
-            cacheDeQueue.enqueue(plItemFrame(allItems[i], f));
-        }
-      }
-
-      // Goto the next item in the list
-      i++;
-      if (i >= allItems.count())
-        i = 0;
-    } while (i != itemPos);
-
-    // Done. However, the list of frames that can be deleted is sorted the wrong way around. Reverse
-    // it.
-    std::reverse(cacheDeQueue.begin(), cacheDeQueue.end());
-  }
-  else // playback is not running
-  {
-    if (selection[0]->isCachable() && itemSpaceNeeded > cacheLevelMax &&
-        additionalItemSpaceNeeded > 0)
-    {
-      DEBUG_CACHING("VideoCache::updateCacheQueue Item needs more space than cacheLevelMax");
-      // All frames of the currently selected item will not fit into the cache
-      // Delete all frames from all other items in the playlist from the cache and cache all frames
-      // from this item that fit
-      for (playlistItem *item : allItems)
-      {
-        if (item != selection[0])
-        {
-          // Mark all frames of this item as "can be removed if required"
-          QList<int> cachedFrames = item->getCachedFrames();
-          for (int f : cachedFrames)
-            cacheDeQueue.enqueue(plItemFrame(item, f));
-        }
-      }
-
-      // Adjust the range so that only the number of frames are cached that will fit
-      int64_t nrFramesCachable = cacheLevelMax / selection[0]->getCachingFrameSize();
-      range.second             = range.first + nrFramesCachable - 1;
-
-      enqueueCacheJob(selection[0], range);
-    }
-    else if (selection[0]->isCachable() &&
-             additionalItemSpaceNeeded > (cacheLevelMax - cacheLevel) &&
-             additionalItemSpaceNeeded > 0)
-    {
-      DEBUG_CACHING("VideoCache::updateCacheQueue Not enough space for caching, deleting frames");
-      // There is currently not enough space in the cache to cache all remaining frames but in
-      // general the cache can hold all frames. Delete frames from the cache until it fits.
-
-      // We go through all other items and get the frames that we will delete.
-      // We start with the item before the one before the currently selected one and go back through
-      // the list, wrap around and keep going until we are at the current selected item. Then (as
-      // the last resort) we go to the item before the currently selected one.
-      int i = itemPos - 1;
-      // Go back in the list to the previous item that is indexed
-      while (true)
-      {
-        if (i < 0)
-          i = allItems.count() - 1;
-        if (allItems[i]->properties().isIndexedByFrame())
-          break;
-        i--;
-      }
-      // Go back one item further to the one before the one before the currently selected one.
-      i--;
-      while (true)
-      {
-        if (i < 0)
-          i = allItems.count() - 1;
-        if (allItems[i]->properties().isIndexedByFrame())
-          break;
-        i--;
-      }
-
-      // Get the cache level without the current item (frames from the current item do not really
-      // occupy space in the cache. We want to cache them anyways)
-      int64_t cacheLevelWithoutCurrent =
-          cacheLevel -
-          selection[0]->getNumberCachedFrames() * int64_t(selection[0]->getCachingFrameSize());
-      while ((itemSpaceNeeded + cacheLevelWithoutCurrent) > cacheLevelMax)
-      {
-        if (i == itemPos)
-          // We went through the whole list and arrived back at the beginning.
-          // If playback is running, we go to the previous item at last.
-          i--;
-        if (i < 0)
-        {
-          // There is no previous item or the previous item is the first one in the list
-          i = allItems.count() - 1;
-        }
-        if (allItems[i]->getNumberCachedFrames() == 0)
-        {
-          i--;
-          continue; // Nothing to delete for this item
-        }
-
-        // Which frames are cached for the item at position i?
-        QList<int> cachedFrames = allItems[i]->getCachedFrames();
-        int64_t    cachedFramesSize =
-            cachedFrames.count() * int64_t(allItems[i]->getCachingFrameSize());
-
-        if (additionalItemSpaceNeeded < cachedFramesSize)
-        {
-          // If we delete all frames from item i, there is more than enough space. So we only delete
-          // as many frames as needed.
-          int64_t nrFrames = additionalItemSpaceNeeded / allItems[i]->getCachingFrameSize() + 1;
-
-          // Delete nrFrames frames from the back
-          for (int f = cachedFrames.count() - 1; f >= 0 && nrFrames > 0; f--)
-          {
-            cacheDeQueue.enqueue(plItemFrame(allItems[i], cachedFrames[f]));
-            cacheLevelWithoutCurrent -= allItems[i]->getCachingFrameSize();
-            if ((cacheLevelWithoutCurrent + itemSpaceNeeded) <= cacheLevelMax)
-              // Now there is enough space
-              break;
-          }
-        }
-        else
-        {
-          // Deleting all frames from this item will not be enough.
-          // Mark all frames of this item as "can be removed if required"
-          QList<int> cachedFrames = allItems[i]->getCachedFrames();
-          for (int f : cachedFrames)
-          {
-            cacheDeQueue.enqueue(plItemFrame(allItems[i], f));
-          }
-          cacheLevelWithoutCurrent -= cachedFramesSize;
-        }
-
-        if (i == itemPos - 1)
-        {
-          // We went through all items and tried to delete frames but there is still not enough
-          // space. That is not possible because we determined that the curretn item should fit if
-          // we just delete enough frames.
-          DEBUG_CACHING("VideoCache::updateCacheQueue ERROR! Deleting loop processed all frames "
-                        "but still not enough space in the cache.");
-          break;
-        }
-
-        // Go to the next (previous) item
-        i--;
-      }
-
-      // Enqueue the job. This is the only job.
-      // We will not delete any frames from any other items to cache frames from other items.
-      enqueueCacheJob(selection[0], range);
-    }
-    else
-    {
-      if (additionalItemSpaceNeeded > 0)
-      {
-        DEBUG_CACHING("VideoCache::updateCacheQueue All frames of %s fit.",
-                      selection[0]->getName().toLatin1().data());
-        // All frames from the current item will fit and there is probably even space for more
-        // items. In case of playback, we will continue with the next items and delete all frames
-        // that were already played out. Otherwise, we don't delete any frames from the cache but we
-        // will cache as many items as possible.
-        enqueueCacheJob(selection[0], range);
-        cacheLevel = cacheLevel + additionalItemSpaceNeeded;
-      }
-
-      // Continue caching with the next item
-      int i = itemPos + 1;
-
-      while (true)
-      {
-        // There is still space
-        DEBUG_CACHING("VideoCache::updateCacheQueue Cache not full yet, attempting next item");
-
-        if (i >= allItems.count())
-          // Last item. Continue with item 0.
-          i = 0;
-        if (i == itemPos)
-        {
-          // We went through all items, wrapped around and are back at the current item. No more
-          // items to cache.
-          DEBUG_CACHING("VideoCache::updateCacheQueue No more items to cache.");
-          break;
-        }
-        if (!allItems[i]->isCachable())
-        {
-          // Nothing to cache for this item.
-          i++;
-          continue;
-        }
-
-        DEBUG_CACHING("VideoCache::updateCacheQueue Attempt caching of next item %s.",
-                      allItems[i]->getName().toLatin1().data());
-        // How much space is there in the cache (excluding what is cached from the current item)?
-        // Get the cache level without the current item (frames from the current item do not really
-        // occupy space in the cache. We want to cache them anyways)
-        int64_t cacheLevelWithoutCurrent =
-            cacheLevel -
-            allItems[i]->getNumberCachedFrames() * int64_t(allItems[i]->getCachingFrameSize());
-        // How much space do we need to cache the entire item?
-        range = allItems[i]->properties().startEndRange;
-        int64_t itemCacheSize =
-            (range.second - range.first + 1) * int64_t(allItems[i]->getCachingFrameSize());
-
-        if ((itemCacheSize + cacheLevelWithoutCurrent) <= cacheLevelMax)
-        {
-          DEBUG_CACHING("VideoCache::updateCacheQueue Entire next item %s fits.",
-                        allItems[i]->getName().toLatin1().data());
-          // The entire item fits
-          enqueueCacheJob(allItems[i], range);
-        }
-        else
-        {
-          // Only a part of the next item fits without deleting frames
-          if ((itemCacheSize + cacheLevelWithoutCurrent) > cacheLevelMax)
-          {
-            // Only a part of the item fits.
-            int64_t nrFramesCachable =
-                (cacheLevelMax - cacheLevelWithoutCurrent) / allItems[i]->getCachingFrameSize();
-            DEBUG_CACHING("VideoCache::updateCacheQueue Only %lld frames of next item %s fit.",
-                          nrFramesCachable,
-                          allItems[i]->getName().toLatin1().data());
-            range.second = range.first + nrFramesCachable - 1;
-            enqueueCacheJob(allItems[i], range);
-
-            // The cache is now full
-            break;
-          }
-        }
-
-        i++;
-      }
-    }
-  }
-
+  CacheState state;
+  state.allItems          = allItems;
+  state.selectedItem      = selection[0];
+  state.selectedItemPos   = itemPos;
+  state.playing           = play;
+  state.currentFrame      = playback->getCurrentFrame();
+  state.playbackDirection = play ? 1 : this->playbackDirection;
+  state.cacheLevel        = cacheLevel;
+  state.cacheLevelMax     = cacheLevelMax;
+
+  // Let the policy decide what to cache next and what to remove first
+  const auto plan = this->cachePolicy->plan(state);
+  for (const auto &job : plan.cacheJobs)
+    enqueueCacheJob(job.first, job.second);
+  for (const auto &frame : plan.evictionOrder)
+    cacheDeQueue.enqueue(plItemFrame(frame.first, frame.second));
+  this->plannedFrames = plan.protectedFrames;
 #if CACHING_DEBUG_OUTPUT && !NDEBUG
   if (!cacheQueue.isEmpty())
   {
@@ -959,13 +685,35 @@ void VideoCache::enqueueCacheJob(playlistItem *item, indexRange range)
 {
   // Only schedule frames for caching that were not yet cached.
   QList<int> cachedFrames = item->getCachedFrames();
-  int        i            = range.first;
-  while (cachedFrames.contains(i) && i < range.second)
-    range.first = ++i;
-  if (range.first != range.second)
+  while (range.first <= range.second && cachedFrames.contains(range.first))
+    range.first++;
+  if (range.first <= range.second)
     cacheQueue.append(cacheJob(item, range));
 }
 
+void VideoCache::currentFrameChanged(int frameIndex)
+{
+  const auto lastDirection = this->playbackDirection;
+  if (playback->playing())
+    this->playbackDirection = 1;
+  else if (this->lastFrameIndex >= 0 && frameIndex != this->lastFrameIndex)
+    this->playbackDirection = (frameIndex < this->lastFrameIndex) ? -1 : 1;
+  this->lastFrameIndex = frameIndex;
+
+  if (this->plannedFrames.isEmpty() || frameIndex < 0)
+    return;
+
+  // Update the plan if the playhead left the first half of the planned frames or turned around
+  const auto rank = this->plannedFrames.value(frameIndex, -1);
+  if (rank < 0 || rank >= this->plannedFrames.size() / 2 ||
+      lastDirection != this->playbackDirection)
+  {
+    DEBUG_CACHING("VideoCache::currentFrameChanged frame %d outside of plan - update", frameIndex);
+    this->plannedFrames.clear();
+    scheduleCachingListUpdate();
+  }
+}
+
 void VideoCache::startCaching()
 {
   DEBUG_CACHING("VideoCache::startCaching %s", testMode ? "Test mode" : "");
@@ -1085,14 +833,14 @@ void VideoCache::threadCachingFinished()
     // Is the item still being cached?
     bool itemCaching = false;
     for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == *it)
+      if (t->worker()->isUsingItem(*it))
       {
         itemCaching = true;
         break;
       }
     // Is the item still being loaded?
-    bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == *it ||
-                        interactiveThread[1]->worker()->getCacheItem() == *it);
+    bool loadingItem = (interactiveThread[0]->worker()->isUsingItem(*it) ||
+                        interactiveThread[1]->worker()->isUsingItem(*it));
 
     if (!itemCaching && !loadingItem)
     {
@@ -1369,16 +1117,17 @@ void VideoCache::itemAboutToBeDeleted(playlistItem *item)
   // One of the items is about to be deleted. Let's stop the caching. Then the item can be deleted
   // and then we can re-think our caching strategy.
 
-  // Are we currently loading a frame from this item in one of the interactive loading threads?
-  bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == item ||
-                      interactiveThread[1]->worker()->getCacheItem() == item);
+  // Are we currently loading a frame from this item (or from a container that the item was in) in
+  // one of the interactive loading threads?
+  bool loadingItem = (interactiveThread[0]->worker()->isUsingItem(item) ||
+                      interactiveThread[1]->worker()->isUsingItem(item));
   bool cachingItem = false;
 
   if (workersState != workersIdle)
   {
-    // Are we currently caching a frame from this item?
+    // Are we currently caching a frame from this item (or from a container that the item was in)?
     for (loadingThread *t : cachingThreadList)
-      if (t->worker()->getCacheItem() == item)
+      if (t->worker()->isUsingItem(item))
         cachingItem = true;
 
     // An item is about to be deleted. We need to rethink what to cache next.
@@ -1503,6 +1252,46 @@ QStringList VideoCache::getCacheStatusText()
   txt.append("Caching:");
   for (loadingThread *t : cachingThreadList)
     txt.append(t->worker()->getStatus());
+
+  txt.append("Policy: " +
+             QString::fromStdString(CachePolicyTypeMapper.getText(this->cachePolicyType)));
+  for (auto item : playlist->getAllPlaylistItems())
+  {
+    const auto statistics = item->getCacheStatistics();
+    if (statistics.hits + statistics.misses + statistics.evictions == 0 && statistics.bytes == 0)
+      continue;
+    txt.append(QString("%1: Hit rate %2% (%3 hits, %4 misses), %5 evictions, %6")
+                   .arg(item->properties().name)
+                   .arg(statistics.hitRate() * 100, 0, 'f', 1)
+                   .arg(statistics.hits)
+                   .arg(statistics.misses)
+                   .arg(statistics.evictions)
+                   .arg(functions::formatDataSize(double(statistics.bytes))));
+    if (statistics.compressedBytes > 0)
+      txt.append(QString("  Compression ratio %1:1, decompression %2 MB/s")
+                     .arg(statistics.compressionRatio(), 0, 'f', 2)
+                     .arg(statistics.decompressionMBps(), 0, 'f', 0));
+  }
+
+  auto poolStatistics = FrameBufferPool::instance().getStatistics();
+  txt.append("Buffer Pool:");
+  txt.append(QString("Hit rate %1% (%2 of %3 requests)")
+                 .arg(poolStatistics.hitRate() * 100, 0, 'f', 1)
+                 .arg(poolStatistics.hits)
+                 .arg(poolStatistics.requests));
+  txt.append(
+      QString("Pooled %1").arg(functions::formatDataSize(double(poolStatistics.pooledBytes))));
+
+  if (DiskFrameCache::instance().isEnabled())
+  {
+    auto diskStatistics = DiskFrameCache::instance().getStatistics();
+    txt.append("Disk Cache:");
+    txt.append(QString("Hit rate %1% (%2 hits, %3 misses), %4")
+                   .arg(diskStatistics.hitRate() * 100, 0, 'f', 1)
+                   .arg(diskStatistics.hits)
+                   .arg(diskStatistics.misses)
+                   .arg(functions::formatDataSize(double(diskStatistics.bytes))));
+  }
   return txt;
 }
 
@@ -42,6 +42,9 @@
 #include <QWidget>
 
 #include "ui/widgets/PlaylistTreeWidget.h"
+#include <video/CachePolicy.h>
+
+#include <memory>
 
 namespace video
 {
@@ -108,6 +111,10 @@ private slots:
   // which frames can be removed from the cache.
   void updateCacheQueue();
 
+  // The playback controller moved to another frame. Track the direction and update the cache queue
+  // if the frame is not in the part of the item that the cache policy planned for.
+  void currentFrameChanged(int frameIndex);
+
 private:
   // A cache job. Has a pointer to a playlist item and a range of frames to be cached.
   struct cacheJob
@@ -141,6 +148,15 @@ private:
   int64_t cacheLevelMax;
   int64_t cacheLevelCurrent;
 
+  // The policy that decides what to put into the cacheQueue and the cacheDeQueue
+  CachePolicyType              cachePolicyType{CachePolicyType::PlaylistOrder};
+  std::unique_ptr<CachePolicy> cachePolicy;
+  // The frames of the selected item (with their priority) that the last plan of the policy keeps
+  QHash<int, int> plannedFrames;
+  // The last frame that was shown and the direction that the user moved in (1 or -1)
+  int lastFrameIndex{-1};
+  int playbackDirection{1};
+
   // Enqueue the job in the queue. If all frames within the range are already cached in the item, do
   // nothing.
   void enqueueCacheJob(playlistItem *item, indexRange range);
@@ -32,9 +32,13 @@
 
 #include "videoHandler.h"
 
+#include <QElapsedTimer>
 #include <QPainter>
+#include <QtConcurrent>
+#include <algorithm>
 
 #include <common/FunctionsGui.h>
+#include <video/FrameBufferPool.h>
 
 namespace video
 {
@@ -47,10 +51,33 @@ namespace video
 #define DEBUG_VIDEO(fmt, ...) ((void)0)
 #endif
 
+namespace
+{
+
+// The number of compressed frames ahead of the current frame that are decompressed in the
+// background
+constexpr int DECOMPRESS_AHEAD_FRAMES = 4;
+
+// Replace the image and hand the old one back to the buffer pool. The pool only keeps it if it is
+// not shared with anything else (e.g. the image cache).
+void replaceImage(QImage &image, const QImage &newImage)
+{
+  auto oldImage = image;
+  image         = newImage;
+  FrameBufferPool::instance().recycle(oldImage);
+}
+
+} // namespace
+
 videoHandler::videoHandler()
 {
 }
 
+videoHandler::~videoHandler()
+{
+  this->decompressAheadFuture.waitForFinished();
+}
+
 void videoHandler::slotVideoControlChanged()
 {
   // Update the controls and get the new selected size
@@ -177,6 +204,8 @@ ItemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
 
 void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues)
 {
+  this->recordCacheAccess(frameIdx);
+
   // Check if the frameIdx changed and if we have to load a new frame
   if (frameIdx != currentImageIndex)
   {
@@ -185,21 +214,22 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
     // Check the double buffer
     if (frameIdx == doubleBufferImageFrameIndex)
     {
-      currentImage      = doubleBufferImage;
+      replaceImage(currentImage, doubleBufferImage);
       currentImageIndex = frameIdx;
       DEBUG_VIDEO("videoHandler::drawFrame %d loaded from double buffer", frameIdx);
     }
     else
     {
-      QMutexLocker lock(&imageCacheAccess);
-      if (cacheValid && imageCache.contains(frameIdx))
+      auto cachedImage = this->getCachedImage(frameIdx);
+      if (!cachedImage.isNull())
       {
-        currentImage      = imageCache[frameIdx];
+        replaceImage(currentImage, cachedImage);
         currentImageIndex = frameIdx;
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
       }
     }
   }
+  this->decompressAhead(frameIdx);
 
   DEBUG_VIDEO(
       "videoHandler::drawFrame frameIdx %d currentImageIndex %d", frameIdx, currentImageIndex);
@@ -211,7 +241,7 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
 
   // Draw the current image (currentImage)
   currentImageSetMutex.lock();
-  painter->drawImage(videoRect, currentImage);
+  painter->drawImage(videoRect, currentImagePyramid.getImageForZoom(currentImage, zoomFactor));
   currentImageSetMutex.unlock();
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
@@ -265,11 +295,92 @@ int videoHandler::getNrFramesCached() const
   return imageCache.size();
 }
 
+QByteArray videoHandler::loadRawFrameData(int frameIndex, bool caching)
+{
+  DEBUG_VIDEO("videoHandler::loadRawFrameData %d %s", frameIndex, caching ? "caching" : "");
+
+  QMutexLocker locker(&this->requestDataMutex);
+  emit signalRequestRawData(frameIndex, caching);
+
+  if (frameIndex != this->rawData_frameIndex)
+    return {};
+  return this->rawData;
+}
+
+QImage videoHandler::getFrameForCaching(int frameIndex)
+{
+  DEBUG_VIDEO("videoHandler::getFrameForCaching %d", frameIndex);
+
+  QMutexLocker lock(&imageCacheAccess);
+  const auto   frame = this->cacheValid ? imageCache.value(frameIndex) : CachedFrame();
+  if (!frame.isNull())
+    frameAccessTick[frameIndex] = nextCacheAccessTick();
+  lock.unlock();
+
+  if (frame.isNull())
+  {
+    // Load the frame without adding it to the cache. Only the video cache decides what is cached
+    // (within its memory limit).
+    QImage image;
+    this->loadFrameForCaching(frameIndex, image);
+    return image;
+  }
+  return frame.isCompressed() ? this->decompressFrame(frame) : frame.getImage();
+}
+
+std::function<void(QPainter *, double)> videoHandler::getFrameDrawFunction(int frameIndex,
+                                                                          bool caching)
+{
+  QImage image;
+  if (caching)
+    image = this->getFrameForCaching(frameIndex);
+  else
+  {
+    {
+      QMutexLocker imageLock(&this->currentImageSetMutex);
+      if (frameIndex == this->currentImageIndex)
+        image = this->currentImage;
+    }
+    if (image.isNull())
+      image = this->getCachedImage(frameIndex);
+  }
+  if (image.isNull())
+    return {};
+
+  std::shared_ptr<DrawFunctionPyramid> pyramid;
+  if (caching)
+    // A frame that is cached is drawn only once (with a zoom factor of 1)
+    pyramid = std::make_shared<DrawFunctionPyramid>();
+  else
+  {
+    // Keep the pyramid in case the frame is drawn again with another zoom factor
+    if (!this->drawFunctionPyramid || this->drawFunctionPyramidFrameIndex != frameIndex)
+    {
+      this->drawFunctionPyramid           = std::make_shared<DrawFunctionPyramid>();
+      this->drawFunctionPyramidFrameIndex = frameIndex;
+    }
+    pyramid = this->drawFunctionPyramid;
+  }
+
+  const auto frameSize = this->frameSize;
+  return [image, frameSize, pyramid](QPainter *painter, double zoomFactor) {
+    QRect videoRect;
+    videoRect.setSize(QSize(frameSize.width * zoomFactor, frameSize.height * zoomFactor));
+    videoRect.moveCenter(QPoint(0, 0));
+
+    QMutexLocker lock(&pyramid->mutex);
+    painter->drawImage(videoRect, pyramid->pyramid.getImageForZoom(image, zoomFactor));
+  };
+}
+
 // Put the frame into the cache (if it is not already in there)
 void videoHandler::cacheFrame(int frameIdx, bool testMode)
 {
   DEBUG_VIDEO("videoHandler::cacheFrame %d %s", frameIdx, testMode ? "testMode" : "");
 
+  if (!this->isFrameCachingSupported())
+    return;
+
   if (cacheValid && isInCache(frameIdx) && !testMode)
   {
     // No need to add it again
@@ -285,9 +396,18 @@ void videoHandler::cacheFrame(int frameIdx, bool testMode)
   if (!cacheImage.isNull())
   {
     DEBUG_VIDEO("videoHandler::cacheFrame insert frame %i into cache", frameIdx);
+    // Compress the frame here (in the caching thread) and not while holding the lock
+    const auto  compress = isFrameCacheCompressionEnabled() && !testMode;
+    CachedFrame cachedFrame(cacheImage, compress);
+
     QMutexLocker imageCacheLock(&imageCacheAccess);
     if (cacheValid && !testMode)
-      imageCache.insert(frameIdx, cacheImage);
+    {
+      this->countCompressedBytes(imageCache.value(frameIdx), -1);
+      this->countCompressedBytes(cachedFrame, 1);
+      imageCache.insert(frameIdx, cachedFrame);
+      frameAccessTick[frameIdx] = nextCacheAccessTick();
+    }
   }
   else
     DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
@@ -300,6 +420,17 @@ unsigned videoHandler::getCachingFrameSize() const
   return this->frameSize.width * this->frameSize.height * bytes;
 }
 
+unsigned videoHandler::getCachedFrameSize() const
+{
+  const auto frameSize = this->getCachingFrameSize();
+
+  QMutexLocker lock(&imageCacheAccess);
+  if (this->compressedCacheBytes == 0 || !isFrameCacheCompressionEnabled())
+    return frameSize;
+  const auto ratio = double(this->compressedCacheBytes) / this->uncompressedCacheBytes;
+  return std::max(unsigned(frameSize * ratio), 1u);
+}
+
 QList<int> videoHandler::getCachedFrames() const
 {
   QMutexLocker lock(&imageCacheAccess);
@@ -318,21 +449,173 @@ bool videoHandler::isInCache(int idx) const
   return imageCache.contains(idx);
 }
 
+CacheStatistics videoHandler::getCacheStatistics() const
+{
+  QMutexLocker lock(&imageCacheAccess);
+  auto         statistics = cacheStatistics;
+  for (const auto &frame : imageCache)
+    statistics.bytes += frame.getBytes();
+  statistics.compressedBytes   = this->compressedCacheBytes;
+  statistics.uncompressedBytes = this->uncompressedCacheBytes;
+  return statistics;
+}
+
+uint64_t videoHandler::getFrameLastAccess(int frameIndex) const
+{
+  QMutexLocker lock(&imageCacheAccess);
+  return frameAccessTick.value(frameIndex, 0);
+}
+
+void videoHandler::recordCacheAccess(int frameIndex)
+{
+  if (frameIndex == lastAccessedFrameIndex)
+    return;
+  if (lastAccessedFrameIndex != -1)
+    this->cacheAccessDirection = (frameIndex < lastAccessedFrameIndex) ? -1 : 1;
+  lastAccessedFrameIndex = frameIndex;
+
+  QMutexLocker lock(&imageCacheAccess);
+  if (cacheValid && imageCache.contains(frameIndex))
+  {
+    cacheStatistics.hits++;
+    frameAccessTick[frameIndex] = nextCacheAccessTick();
+  }
+  else
+    cacheStatistics.misses++;
+}
+
 void videoHandler::removeFrameFromCache(int frameIdx)
 {
   DEBUG_VIDEO("removeFrameFromCache %d", frameIdx);
   QMutexLocker lock(&imageCacheAccess);
-  imageCache.remove(frameIdx);
+  auto         frame = imageCache.take(frameIdx);
+  if (!frame.isNull())
+    cacheStatistics.evictions++;
+  this->countCompressedBytes(frame, -1);
+  frameAccessTick.remove(frameIdx);
+  auto decompressedImage = decompressedFrames.take(frameIdx);
   lock.unlock();
+  frame.recycle();
+  FrameBufferPool::instance().recycle(decompressedImage);
 }
 
 void videoHandler::removeAllFrameFromCache()
 {
   DEBUG_VIDEO("removeAllFrameFromCache");
   QMutexLocker lock(&imageCacheAccess);
+  auto         frames = imageCache.values();
   imageCache.clear();
+  this->compressedCacheBytes   = 0;
+  this->uncompressedCacheBytes = 0;
+  frameAccessTick.clear();
   cacheValid = true;
   lock.unlock();
+  for (auto &frame : frames)
+    frame.recycle();
+  this->clearDecompressedFrames();
+}
+
+QImage videoHandler::getCachedImage(int frameIdx)
+{
+  QMutexLocker lock(&imageCacheAccess);
+  if (!cacheValid || !imageCache.contains(frameIdx))
+    return {};
+  const auto frame = imageCache[frameIdx];
+  if (!frame.isCompressed())
+    return frame.getImage();
+
+  auto image = decompressedFrames.take(frameIdx);
+  lock.unlock();
+  if (image.isNull())
+  {
+    DEBUG_VIDEO("videoHandler::getCachedImage %d was not decompressed ahead of time", frameIdx);
+    image = this->decompressFrame(frame);
+  }
+  return image;
+}
+
+QImage videoHandler::decompressFrame(const CachedFrame &frame)
+{
+  QElapsedTimer timer;
+  timer.start();
+  auto image = frame.getImage();
+
+  QMutexLocker lock(&imageCacheAccess);
+  cacheStatistics.decompressedBytes += frame.getUncompressedBytes();
+  cacheStatistics.decompressionNs += timer.nsecsElapsed();
+  return image;
+}
+
+void videoHandler::decompressAhead(int frameIdx)
+{
+  if (this->decompressAheadFuture.isRunning())
+    return;
+
+  QList<QPair<int, CachedFrame>> framesToDecompress;
+  QList<QImage>                  outdatedImages;
+  {
+    QMutexLocker lock(&imageCacheAccess);
+    if (!cacheValid || this->compressedCacheBytes == 0)
+      return;
+
+    // Keep the frames ahead of the current frame. Drop everything else.
+    QList<int> framesAhead;
+    for (int i = 1; i <= DECOMPRESS_AHEAD_FRAMES; i++)
+      framesAhead.append(frameIdx + i * this->cacheAccessDirection);
+    for (auto it = decompressedFrames.begin(); it != decompressedFrames.end();)
+    {
+      if (framesAhead.contains(it.key()))
+        it++;
+      else
+      {
+        outdatedImages.append(it.value());
+        it = decompressedFrames.erase(it);
+      }
+    }
+
+    for (auto idx : framesAhead)
+    {
+      auto it = imageCache.constFind(idx);
+      if (it != imageCache.constEnd() && it->isCompressed() && !decompressedFrames.contains(idx))
+        framesToDecompress.append({idx, *it});
+    }
+  }
+
+  for (auto &image : outdatedImages)
+    FrameBufferPool::instance().recycle(image);
+  if (framesToDecompress.isEmpty())
+    return;
+
+  DEBUG_VIDEO("videoHandler::decompressAhead %d frames", framesToDecompress.size());
+  this->decompressAheadFuture = QtConcurrent::run([this, framesToDecompress]() {
+    for (const auto &frame : framesToDecompress)
+    {
+      auto image = this->decompressFrame(frame.second);
+
+      // The frame might have been removed from the cache in the meantime
+      QMutexLocker lock(&imageCacheAccess);
+      if (cacheValid && imageCache.contains(frame.first))
+        decompressedFrames.insert(frame.first, image);
+    }
+  });
+}
+
+void videoHandler::clearDecompressedFrames()
+{
+  QMutexLocker lock(&imageCacheAccess);
+  auto         images = decompressedFrames.values();
+  decompressedFrames.clear();
+  lock.unlock();
+  for (auto &image : images)
+    FrameBufferPool::instance().recycle(image);
+}
+
+void videoHandler::countCompressedBytes(const CachedFrame &frame, int sign)
+{
+  if (!frame.isCompressed())
+    return;
+  this->compressedCacheBytes += sign * frame.getBytes();
+  this->uncompressedCacheBytes += sign * frame.getUncompressedBytes();
 }
 
 void videoHandler::loadFrame(int frameIndex, bool loadToDoubleBuffer)
@@ -397,16 +680,36 @@ void videoHandler::invalidateAllBuffers()
   currentImage = QImage();
   currentImageSetMutex.unlock();
   requestedFrame_idx = -1;
+  this->drawFunctionPyramid.reset();
 
+  QMutexLocker lock(&imageCacheAccess);
   imageCache.clear();
-  cacheValid = true;
+  decompressedFrames.clear();
+  this->compressedCacheBytes   = 0;
+  this->uncompressedCacheBytes = 0;
+  frameAccessTick.clear();
+  lastAccessedFrameIndex = -1;
+  cacheValid             = true;
+}
+
+void videoHandler::invalidateDerivedFrames(recacheIndicator recache)
+{
+  currentImageIndex           = -1;
+  currentImage_frameIndex     = -1;
+  doubleBufferImageFrameIndex = -1;
+
+  if (recache == RECACHE_CLEAR)
+  {
+    QMutexLocker lock(&imageCacheAccess);
+    setCacheInvalid();
+  }
 }
 
 void videoHandler::activateDoubleBuffer()
 {
   if (doubleBufferImageFrameIndex != -1)
   {
-    currentImage      = doubleBufferImage;
+    replaceImage(currentImage, doubleBufferImage);
     currentImageIndex = doubleBufferImageFrameIndex;
     DEBUG_VIDEO("videoHandler::drawFrame %d loaded from double buffer", currentImageIndex);
   }
@@ -33,12 +33,19 @@
 #pragma once
 
 #include "PixelFormat.h"
+#include "CachePolicy.h"
+#include "FrameCompression.h"
 #include "FrameHandler.h"
+#include "PixelFormatGuessCorrelation.h"
 
 #include <QBasicTimer>
 #include <QFileInfo>
+#include <QFuture>
 #include <QMutex>
 
+#include <functional>
+#include <memory>
+
 namespace video
 {
 
@@ -50,6 +57,7 @@ public:
   /*
    */
   videoHandler();
+  virtual ~videoHandler();
 
   // Draw the frame with the given frame index and zoom factor. If onLoadShowLasFrame is set, show
   // the last frame if the frame with the current frame index is loaded in the background.
@@ -60,16 +68,48 @@ public:
   int              getNrFramesCached() const;
   void             cacheFrame(int frameIndex, bool testMode);
   virtual unsigned getCachingFrameSize() const;
+  // The number of bytes that one frame will occupy in the cache. If the cached frames are
+  // compressed, this is estimated from the compression ratio of the frames that are cached.
+  unsigned         getCachedFrameSize() const;
   QList<int>       getCachedFrames() const;
   int              getNumberCachedFrames() const;
   bool             isInCache(int idx) const;
   virtual void     removeFrameFromCache(int frameIndex);
   virtual void     removeAllFrameFromCache();
+  CacheStatistics  getCacheStatistics() const;
+  // When was the cached frame last used (see nextCacheAccessTick())? 0 if it is not cached.
+  uint64_t getFrameLastAccess(int frameIndex) const;
+  // Count a hit or a miss if the frame is drawn for the first time (since another frame was drawn).
+  // This is done by drawFrame(). Call it if the frame is shown without drawFrame().
+  void recordCacheAccess(int frameIndex);
 
   // Get the number of bytes for one frame (RGB or YUV) with the current format (if this video
   // handler uses raw data)
   virtual int64_t getBytesPerFrame() const { return -1; }
 
+  // Load the raw data (RGB or YUV in the source format) of the given frame and return it. The
+  // current frame buffers are not modified. This is thread-safe but the requests are serialized.
+  // If caching is set, the data is requested like the caching threads do (e.g. a compressed item
+  // uses its caching decoder). An empty array is returned if loading failed.
+  QByteArray loadRawFrameData(int frameIndex, bool caching = false);
+
+  // Get the image of the given frame for a handler that derives its frames from this one (e.g. a
+  // resampled version of it) while it is caching. The frame is taken from the cache of this handler
+  // if it is there. Otherwise it is loaded but not added to the cache. The current frame buffers
+  // are not modified. This is thread-safe.
+  QImage getFrameForCaching(int frameIndex);
+
+  // Get a function that draws the given frame like drawFrame() (without the pixel values). The
+  // function can be called from any thread. If caching is set, the frame is requested like
+  // getFrameForCaching() does. Otherwise, the frame must be the current frame or it must be cached
+  // (an empty function is returned if it is not) and this must be called from the main thread.
+  virtual std::function<void(QPainter *, double)> getFrameDrawFunction(int frameIndex,
+                                                                       bool caching);
+
+  // Can the frames of this video be put into the cache? Frames that are only converted in parts
+  // when they are drawn are never converted and cached as a whole.
+  virtual bool isFrameCachingSupported() const { return true; }
+
   // The Frame size is about to change. If this happens, our local buffers all need updating.
   virtual void setFrameSize(Size size) override;
 
@@ -82,31 +122,35 @@ public:
                                      const int        amplificationFactor,
                                      const bool       markDifference) override;
 
-  // Try to guess and set the format (frameSize/srcPixelFormat) from the raw data in the right raw
-  // format. If a file size is given, it is tested if the guessed format and the file size match.
-  // You can overload this for any specific raw format. The default implementation does nothing.
-  virtual void setFormatFromCorrelation(const QByteArray &, int64_t fileSize = -1)
-  {
-    (void)fileSize;
-  }
+  // Try to guess and set the format (frameSize/srcPixelFormat) from the correlation of the first
+  // two frames of the file. The reader is used to read only the needed parts of the file. You can
+  // overload this for any specific raw format. The default implementation does nothing.
+  virtual void setFormatFromCorrelation(const FileReader &, int64_t) {}
 
   // If you know the frame size and the bit depth and the file size then we can try to guess
   // the format from that. You can override this for a specific raw format. The default
   // implementation does nothing.
-  virtual void setFormatFromSizeAndName(const Size       frameSize,
-                                        int              bitDepth,
-                                        DataLayout       dataLayout,
-                                        int64_t          fileSize,
-                                        const QFileInfo &fileInfo) = 0;
+  virtual void setFormatFromSizeAndName(const Size, int, DataLayout, int64_t, const QFileInfo &)
+  {
+  }
 
   // The input frame buffer. After the signal signalRequestFrame(int) is emitted, the corresponding
   // frame should be in here and requestedFrame_idx should be set.
   QImage requestedFrame;
   int    requestedFrame_idx;
 
+  // Only one thread at a time should request something to be loaded. The signals that request data
+  // are emitted while this is locked, so an item can use it to protect the state of its requests.
+  QMutex requestDataMutex;
+
   // If reloading a raw file (because it changed), this function will clear all buffers (also the
   // cache). With the next drawFrame(), the data will be reloaded from file.
-  void invalidateAllBuffers();
+  virtual void invalidateAllBuffers();
+
+  // One of the inputs of a handler that derives its frames from other handlers changed. The current
+  // frame and the double buffer are outdated. If the frames of the input changed (RECACHE_CLEAR),
+  // the cached frames are also invalid until the video cache cleared them.
+  void invalidateDerivedFrames(recacheIndicator recache);
 
   // The user changed the frame. Do we need to load something before we can draw it? Do we need to
   // update the double buffer? loadRawValues: Do we also need to update the buffer of the raw values
@@ -176,9 +220,6 @@ protected:
   // background thread.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache);
 
-  // Only one thread at a time should request something to be loaded.
-  QMutex requestDataMutex;
-
   // We might need to update the currentImage
   int currentImage_frameIndex{-1};
 
@@ -200,7 +241,7 @@ protected:
 
   // --- Caching
   QMutex mutable imageCacheAccess;
-  QMap<int, QImage> imageCache;
+  QMap<int, CachedFrame> imageCache;
   // Is the cache valid? The cache can be ivalid in the following scenario:
   // Somethign about how an item is shown changes (e.g. the resolution) but caching of the item is
   // currently performed. If we just cleared the cache, the wrong (currently being cached) frames
@@ -209,6 +250,40 @@ protected:
   // however, the items that are in the cache (or are being put into the cache by the still running
   // threads) are invalid.
   bool cacheValid{true};
+  // The counters of the cache statistics and the last access of each cached frame. These are also
+  // protected by the imageCacheAccess mutex.
+  CacheStatistics      cacheStatistics;
+  QHash<int, uint64_t> frameAccessTick;
+  int                  lastAccessedFrameIndex{-1};
+  // The direction (1 or -1) in which the user is moving through the frames
+  int cacheAccessDirection{1};
+
+  // Get the image of the given frame from the cache (or a null image if it is not cached). A
+  // compressed frame is decompressed (if it was not already decompressed ahead of time).
+  QImage getCachedImage(int frameIndex);
+  QImage decompressFrame(const CachedFrame &frame);
+  // Decompress the next few compressed frames (in the access direction) in the background so that
+  // they are ready when they are drawn. The decompressed frames are protected by imageCacheAccess.
+  void              decompressAhead(int frameIndex);
+  void              clearDecompressedFrames();
+  QMap<int, QImage> decompressedFrames;
+  QFuture<void>     decompressAheadFuture;
+  // The sizes of the compressed frames in the cache (compressed and uncompressed). Use
+  // countCompressedBytes() to add (sign 1) or remove (sign -1) a frame.
+  int64_t compressedCacheBytes{};
+  int64_t uncompressedCacheBytes{};
+  void    countCompressedBytes(const CachedFrame &frame, int sign);
+
+  // The pyramid of the frame that was last drawn with a draw function (not for caching). It is
+  // kept so that the levels are not rebuilt when the frame is drawn with another zoom factor. The
+  // draw functions are called from other threads, so the pyramid is locked while it is used.
+  struct DrawFunctionPyramid
+  {
+    QMutex       mutex;
+    ImagePyramid pyramid;
+  };
+  std::shared_ptr<DrawFunctionPyramid> drawFunctionPyramid;
+  int                                  drawFunctionPyramidFrameIndex{-1};
 
 private slots:
   // Override the slotVideoControlChanged slot. For a videoHandler, also the number of frames might
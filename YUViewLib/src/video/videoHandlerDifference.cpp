@@ -49,8 +49,45 @@ namespace video
 #define DEBUG_VIDEO(fmt, ...) ((void)0)
 #endif
 
+namespace
+{
+
+// Load the raw data of the given frame like the caching threads do so that the current frame of
+// the video is not changed. If caching is not possible for the item, load it directly.
+QByteArray loadRawFrameForCaching(yuv::videoHandlerYUV *video, int frameIndex)
+{
+  auto data = video->loadRawFrameData(frameIndex, true);
+  if (data.isEmpty())
+    data = video->loadRawFrameData(frameIndex, false);
+  return data;
+}
+
+// Add the position of the first difference in HEVC coding order to the list. Return false if there
+// is no difference.
+bool appendFirstDifferencePosition(const yuv::DifferenceResult &result, QList<InfoItem> &infoList)
+{
+  auto position = yuv::findFirstDifferenceHEVC(result);
+  if (!position)
+    return false;
+
+  infoList.append(InfoItem("First diff LCU", QString::number(position->lcu)));
+  infoList.append(InfoItem("First diff X,Y", QString("%1,%2").arg(position->x).arg(position->y)));
+  infoList.append(InfoItem("First diff partIndex", QString::number(position->partIndex)));
+  return true;
+}
+
+} // namespace
+
 videoHandlerDifference::videoHandlerDifference() : videoHandler()
 {
+  connect(&this->sequenceScan,
+          &DifferenceScan::scanProgress,
+          this,
+          &videoHandlerDifference::slotSequenceScanProgress);
+  connect(&this->sequenceScan,
+          &DifferenceScan::scanFinished,
+          this,
+          &videoHandlerDifference::slotSequenceScanFinished);
 }
 
 void videoHandlerDifference::drawDifferenceFrame(QPainter *painter,
@@ -75,12 +112,18 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter,
     }
     else
     {
-      QMutexLocker lock(&imageCacheAccess);
-      if (cacheValid && imageCache.contains(frameIdx))
+      auto cachedImage = this->getCachedImage(frameIdx);
+      if (!cachedImage.isNull())
       {
-        currentImage      = imageCache[frameIdx];
+        currentImage      = cachedImage;
         currentImageIndex = frameIdx;
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
+
+        QMutexLocker lock(&this->imageCacheAccess);
+        const auto   info             = this->cachedDifferenceInfo.value(frameIdx);
+        this->firstDifferenceInfoList = info.firstDifference;
+        this->differenceInfoList      = info.difference;
+        this->differenceInfoFromCache = true;
       }
     }
   }
@@ -92,7 +135,7 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter,
 
   // Draw the current image (currentImage)
   currentImageSetMutex.lock();
-  painter->drawImage(videoRect, currentImage);
+  painter->drawImage(videoRect, currentImagePyramid.getImageForZoom(currentImage, zoomFactor));
   currentImageSetMutex.unlock();
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
@@ -110,6 +153,7 @@ void videoHandlerDifference::loadFrameDifference(int frameIndex, bool)
     return;
 
   differenceInfoList.clear();
+  differenceInfoFromCache = false;
 
   // Check if the second item is a video and the first one is not. In that case,
   // make sure that the right frame is loaded for the video item.
@@ -147,11 +191,99 @@ bool videoHandlerDifference::inputsValid() const
   return true;
 }
 
+bool videoHandlerDifference::inputsCachable() const
+{
+  if (!this->inputsValid())
+    return false;
+
+  auto videoYUV0 = dynamic_cast<yuv::videoHandlerYUV *>(this->inputVideo[0].data());
+  auto videoYUV1 = dynamic_cast<yuv::videoHandlerYUV *>(this->inputVideo[1].data());
+  if (videoYUV0 == nullptr || videoYUV1 == nullptr)
+    return false;
+
+  // The YUV difference kernel needs the same subsampling. Otherwise, the difference is calculated
+  // from the RGB values when the frame is drawn.
+  const auto format0 = yuv::PixelFormatYUV(videoYUV0->getRawPixelFormatYUVName().toStdString());
+  const auto format1 = yuv::PixelFormatYUV(videoYUV1->getRawPixelFormatYUVName().toStdString());
+  return format0.getSubsampling() == format1.getSubsampling();
+}
+
+void videoHandlerDifference::removeFrameFromCache(int frameIndex)
+{
+  videoHandler::removeFrameFromCache(frameIndex);
+  QMutexLocker lock(&this->imageCacheAccess);
+  this->cachedDifferenceInfo.remove(frameIndex);
+}
+
+void videoHandlerDifference::removeAllFrameFromCache()
+{
+  videoHandler::removeAllFrameFromCache();
+  QMutexLocker lock(&this->imageCacheAccess);
+  this->cachedDifferenceInfo.clear();
+}
+
+void videoHandlerDifference::invalidateAllBuffers()
+{
+  videoHandler::invalidateAllBuffers();
+  QMutexLocker lock(&this->imageCacheAccess);
+  this->cachedDifferenceInfo.clear();
+}
+
+void videoHandlerDifference::loadFrameForCaching(int frameIndex, QImage &frameToCache)
+{
+  DEBUG_VIDEO("videoHandlerDifference::loadFrameForCaching %d", frameIndex);
+
+  auto videoYUV0 = dynamic_cast<yuv::videoHandlerYUV *>(this->inputVideo[0].data());
+  auto videoYUV1 = dynamic_cast<yuv::videoHandlerYUV *>(this->inputVideo[1].data());
+  if (!this->inputsCachable())
+    return;
+
+  // Get the settings here so that the caching process does not change if they change.
+  const auto amplificationFactor = this->amplificationFactor;
+  const auto markDifference      = this->markDifference;
+
+  // The format of a compressed sequence is only known once the decoder provided a frame
+  const auto data0   = loadRawFrameForCaching(videoYUV0, frameIndex);
+  const auto format0 = yuv::PixelFormatYUV(videoYUV0->getRawPixelFormatYUVName().toStdString());
+  const auto data1   = loadRawFrameForCaching(videoYUV1, frameIndex);
+  const auto format1 = yuv::PixelFormatYUV(videoYUV1->getRawPixelFormatYUVName().toStdString());
+  if (data0.isEmpty() || data1.isEmpty())
+    return;
+
+  DifferenceInfo        info;
+  yuv::DifferenceResult result;
+  QByteArray            diffYUV;
+  yuv::PixelFormatYUV   diffYUVFormat;
+
+  const auto image = yuv::videoHandlerYUV::calculateDifferenceImage(data0,
+                                                                    format0,
+                                                                    videoYUV0->getFrameSize(),
+                                                                    data1,
+                                                                    format1,
+                                                                    videoYUV1->getFrameSize(),
+                                                                    info.difference,
+                                                                    amplificationFactor,
+                                                                    markDifference,
+                                                                    result,
+                                                                    diffYUV,
+                                                                    diffYUVFormat);
+  if (image.isNull())
+    return;
+
+  if (!appendFirstDifferencePosition(result, info.firstDifference))
+    info.firstDifference.append(InfoItem("Difference", "Frames are identical"));
+
+  QMutexLocker lock(&this->imageCacheAccess);
+  this->cachedDifferenceInfo[frameIndex] = info;
+  frameToCache                           = image;
+}
+
 void videoHandlerDifference::setInputVideos(FrameHandler *childVideo0, FrameHandler *childVideo1)
 {
   if (inputVideo[0] != childVideo0 || inputVideo[1] != childVideo1)
   {
     // Something changed
+    this->resetSequenceScan();
     inputVideo[0] = childVideo0;
     inputVideo[1] = childVideo1;
 
@@ -167,8 +299,9 @@ void videoHandlerDifference::setInputVideos(FrameHandler *childVideo0, FrameHand
       setFrameSize(diffSize);
     }
 
-    // If something changed, we might need a redraw
-    emit signalHandlerChanged(true, RECACHE_NONE);
+    // If something changed, we might need a redraw. The cached differences are invalid.
+    this->setCacheInvalid();
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
   }
 }
 
@@ -215,6 +348,17 @@ QLayout *videoHandlerDifference::createDifferenceHandlerControls()
           this,
           &videoHandlerDifference::slotDifferenceControlChanged);
 
+  ui.sequenceScanPlotWidget->setModel(this->sequenceScan.getPlotModel());
+  connect(ui.sequenceScanButton,
+          &QPushButton::clicked,
+          this,
+          &videoHandlerDifference::slotSequenceScanButtonClicked);
+  connect(ui.nextDifferenceButton,
+          &QPushButton::clicked,
+          this,
+          &videoHandlerDifference::slotNextDifferenceButtonClicked);
+  this->updateSequenceScanControls();
+
   return ui.topVBoxLayout;
 }
 
@@ -227,10 +371,11 @@ void videoHandlerDifference::slotDifferenceControlChanged()
   {
     markDifference = ui.markDifferenceCheckBox->isChecked();
 
-    // Set the current frame in the buffer to be invalid and emit the signal that something has
-    // changed
+    // Set the current frame in the buffer and the cache to be invalid and emit the signal that
+    // something has changed
     currentImageIndex = -1;
-    emit signalHandlerChanged(true, RECACHE_NONE);
+    this->setCacheInvalid();
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
   }
   else if (sender == ui.codingOrderComboBox)
   {
@@ -243,13 +388,95 @@ void videoHandlerDifference::slotDifferenceControlChanged()
   {
     amplificationFactor = ui.amplificationFactorSpinBox->value();
 
-    // Set the current frame in the buffer to be invalid and emit the signal that something has
-    // changed
+    // Set the current frame in the buffer and the cache to be invalid and emit the signal that
+    // something has changed
     currentImageIndex = -1;
-    emit signalHandlerChanged(true, RECACHE_NONE);
+    this->setCacheInvalid();
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
   }
 }
 
+void videoHandlerDifference::startSequenceScan(indexRange frameRange)
+{
+  auto videoYUV0 = dynamic_cast<yuv::videoHandlerYUV *>(inputVideo[0].data());
+  auto videoYUV1 = dynamic_cast<yuv::videoHandlerYUV *>(inputVideo[1].data());
+  if (!inputsValid() || videoYUV0 == nullptr || videoYUV1 == nullptr)
+  {
+    if (ui.created())
+      ui.sequenceScanStatusLabel->setText("Scanning is only supported for two YUV items.");
+    return;
+  }
+
+  this->sequenceScan.start(videoYUV0, videoYUV1, frameRange);
+  this->updateSequenceScanControls();
+}
+
+void videoHandlerDifference::stopSequenceScan()
+{
+  this->sequenceScan.stop();
+  this->updateSequenceScanControls();
+}
+
+void videoHandlerDifference::resetSequenceScan()
+{
+  this->sequenceScan.reset();
+  this->updateSequenceScanControls();
+}
+
+void videoHandlerDifference::slotSequenceScanButtonClicked()
+{
+  if (this->sequenceScan.isRunning())
+    this->stopSequenceScan();
+  else
+    emit signalSequenceScanRequested();
+}
+
+void videoHandlerDifference::slotNextDifferenceButtonClicked()
+{
+  const auto plotModel = this->sequenceScan.getPlotModel();
+  if (auto nextFrame = plotModel->getNextDifferingFrame(this->currentImageIndex))
+    emit signalJumpToFrame(*nextFrame);
+  else if (ui.created())
+    ui.sequenceScanStatusLabel->setText(
+        QString("No difference after frame %1 found.").arg(this->currentImageIndex));
+}
+
+void videoHandlerDifference::slotSequenceScanProgress(int nrFramesDone, int nrFrames)
+{
+  if (!ui.created() || !this->sequenceScan.isRunning())
+    return;
+
+  const auto nrDifferingFrames = this->sequenceScan.getPlotModel()->getNrDifferingFrames();
+  ui.sequenceScanStatusLabel->setText(QString("Scanned %1 of %2 frames. %3 frames differ.")
+                                          .arg(nrFramesDone)
+                                          .arg(nrFrames)
+                                          .arg(nrDifferingFrames));
+  ui.nextDifferenceButton->setEnabled(nrDifferingFrames > 0);
+}
+
+void videoHandlerDifference::slotSequenceScanFinished() { this->updateSequenceScanControls(); }
+
+void videoHandlerDifference::updateSequenceScanControls()
+{
+  if (!ui.created())
+    return;
+
+  const auto plotModel         = this->sequenceScan.getPlotModel();
+  const auto nrDifferingFrames = plotModel->getNrDifferingFrames();
+  const auto running           = this->sequenceScan.isRunning();
+
+  ui.sequenceScanButton->setText(running ? "Stop scan" : "Scan all frames");
+  ui.nextDifferenceButton->setEnabled(nrDifferingFrames > 0);
+  if (running)
+    ui.sequenceScanStatusLabel->setText("Scanning ...");
+  else if (plotModel->getNrFrames() == 0)
+    ui.sequenceScanStatusLabel->clear();
+  else
+    ui.sequenceScanStatusLabel->setText(QString("Scanned %1 frames. %2 frames differ.")
+                                            .arg(plotModel->getNrFrames())
+                                            .arg(nrDifferingFrames));
+}
+
 void videoHandlerDifference::reportFirstDifferencePosition(QList<InfoItem> &infoList) const
 {
   if (!inputsValid())
@@ -266,39 +493,32 @@ void videoHandlerDifference::reportFirstDifferencePosition(QList<InfoItem> &info
     // - Each LCU is scanned in a hierarchical tree until the smallest unit size (4x4 pixels) is
     // reached This is exactly what we are going to do here now
 
-    int widthLCU  = (frameSize.width + 63) / 64; // Round up
-    int heightLCU = (frameSize.height + 63) / 64;
-
-    for (int y = 0; y < heightLCU; y++)
+    auto videoYUV0 = dynamic_cast<yuv::videoHandlerYUV *>(inputVideo[0].data());
+    if (this->differenceInfoFromCache)
     {
-      for (int x = 0; x < widthLCU; x++)
-      {
-        // Now take the tree approach
-        int firstX, firstY, partIndex = 0;
+      // The position was found while the difference was cached
+      infoList.append(this->firstDifferenceInfoList);
+      return;
+    }
+    else if (videoYUV0 != NULL && videoYUV0->isDiffReady())
+    {
+      // Find the first difference using the positions of the differences that were recorded
+      // while calculating the YUV difference. The QImage does not work for 10bit videos and
+      // very small differences, since it only supports 8bit.
+      if (appendFirstDifferencePosition(videoYUV0->getDiffResult(), infoList))
+        return;
+    }
+    else
+    {
+      int widthLCU  = (frameSize.width + 63) / 64; // Round up
+      int heightLCU = (frameSize.height + 63) / 64;
 
-        auto videoYUV0 = dynamic_cast<yuv::videoHandlerYUV *>(inputVideo[0].data());
-        if (videoYUV0 != NULL && videoYUV0->isDiffReady())
-        {
-          // find first difference using YUV instead of QImage. The latter does not work for 10bit
-          // videos and very small differences, since it only supports 8bit
-          if (hierarchicalPositionYUV(x * 64,
-                                      y * 64,
-                                      64,
-                                      firstX,
-                                      firstY,
-                                      partIndex,
-                                      videoYUV0->getDiffYUV(),
-                                      videoYUV0->getDiffYUVFormat()))
-          {
-            // We found a difference in this block
-            infoList.append(InfoItem("First diff LCU", QString::number(y * widthLCU + x)));
-            infoList.append(InfoItem("First diff X,Y", QString("%1,%2").arg(firstX).arg(firstY)));
-            infoList.append(InfoItem("First diff partIndex", QString::number(partIndex)));
-            return;
-          }
-        }
-        else
+      for (int y = 0; y < heightLCU; y++)
+      {
+        for (int x = 0; x < widthLCU; x++)
         {
+          // Now take the tree approach
+          int firstX, firstY, partIndex = 0;
           if (hierarchicalPosition(x * 64, y * 64, 64, firstX, firstY, partIndex, currentImage))
           {
             // We found a difference in this block
@@ -423,137 +643,4 @@ bool videoHandlerDifference::hierarchicalPosition(int           x,
   return false;
 }
 
-inline int
-getValueFromSource(const unsigned char *src, const int idx, const int bps, const bool bigEndian)
-{
-  if (bps > 8)
-    // Read two bytes in the right order
-    return (bigEndian) ? src[idx * 2] << 8 | src[idx * 2 + 1]
-                       : src[idx * 2] | src[idx * 2 + 1] << 8;
-  else
-    // Just read one byte
-    return src[idx];
-}
-
-bool videoHandlerDifference::hierarchicalPositionYUV(int                        x,
-                                                     int                        y,
-                                                     int                        blockSize,
-                                                     int &                      firstX,
-                                                     int &                      firstY,
-                                                     int &                      partIndex,
-                                                     const QByteArray &         diffYUV,
-                                                     const yuv::PixelFormatYUV &diffYUVFormat) const
-{
-  if (x >= int(frameSize.width) || y >= int(frameSize.height))
-    // This block is entirely outside of the picture
-    return false;
-
-  // The items can be of different size (we then calculate the difference of the top left aligned
-  // part)
-  const int w_in = frameSize.width;
-  const int h_in = frameSize.height;
-
-  // Get subsampling modes (they are identical for both inputs and the output)
-  const int subH = diffYUVFormat.getSubsamplingHor();
-  const int subV = diffYUVFormat.getSubsamplingVer();
-
-  // Get the endianness of the inputs
-  const bool bigEndian = diffYUVFormat.isBigEndian();
-
-  // Get/Set the bit depth of the input
-  const int bps_in   = diffYUVFormat.getBitsPerSample();
-  const int diffZero = 128 << (bps_in - 8);
-
-  // Get pointers to the inputs
-  const int componentSizeLuma_In   = w_in * h_in;
-  const int componentSizeChroma_In = (w_in / subH) * (h_in / subV);
-  const int nrBytesLumaPlane_In    = bps_in > 8 ? 2 * componentSizeLuma_In : componentSizeLuma_In;
-  const int nrBytesChromaPlane_In =
-      bps_in > 8 ? 2 * componentSizeChroma_In : componentSizeChroma_In;
-  // Current item
-
-  // Calculate Luma sample difference
-  const int stride_in = bps_in > 8 ? w_in * 2 : w_in; // How many bytes to the next y line?
-  const int strideC_in =
-      w_in / subH * (bps_in > 8 ? 2 : 1); // How many bytes to the next U/V y line
-
-  if (blockSize == 4)
-  {
-    const unsigned char *srcY1 = (unsigned char *)diffYUV.data();
-    const unsigned char *srcU1 = (diffYUVFormat.getPlaneOrder() == yuv::PlaneOrder::YUV ||
-                                  diffYUVFormat.getPlaneOrder() == yuv::PlaneOrder::YUVA)
-                                     ? srcY1 + nrBytesLumaPlane_In
-                                     : srcY1 + nrBytesLumaPlane_In + nrBytesChromaPlane_In;
-    const unsigned char *srcV1 = (diffYUVFormat.getPlaneOrder() == yuv::PlaneOrder::YUV ||
-                                  diffYUVFormat.getPlaneOrder() == yuv::PlaneOrder::YUVA)
-                                     ? srcY1 + nrBytesLumaPlane_In + nrBytesChromaPlane_In
-                                     : srcY1 + nrBytesLumaPlane_In;
-
-    // adjust source pointer according to block position
-    srcY1 += y * stride_in;
-    srcU1 += y / subV * strideC_in;
-    srcV1 += y / subV * strideC_in;
-
-    // Check for a difference
-    for (int subY = y; subY < y + 4; subY++)
-    {
-
-      for (int subX = x; subX < x + 4; subX++)
-      {
-
-        int val1 = getValueFromSource(srcY1, subX, bps_in, bigEndian);
-        if (val1 != diffZero)
-        {
-          firstX = x;
-          firstY = y;
-          return true;
-        }
-
-        // is this a position at which we have a chroma sample?
-        if (subX % subH == 0 && subY % subV == 0 && subX * subV < w_in)
-        {
-          int valU1 = getValueFromSource(srcU1, subX, bps_in, bigEndian);
-          int valV1 = getValueFromSource(srcV1, subX, bps_in, bigEndian);
-          if (valU1 != diffZero || valV1 != diffZero)
-          {
-            firstX = x * subV;
-            firstY = y;
-            return true;
-          }
-        }
-      }
-
-      // Goto the next y line
-      srcY1 += stride_in;
-
-      // is this a position at which we have a chroma line?
-      if (subY % subV == 0)
-      {
-        // Goto the next y line
-        srcU1 += strideC_in;
-        srcV1 += strideC_in;
-      }
-    }
-
-    // No difference found in this block. Count the number of 4x4 blocks scanned (that is the
-    // partIndex)
-    partIndex++;
-  }
-  else
-  {
-    // Walk further into the hierarchy
-    const int b2 = blockSize / 2;
-    if (hierarchicalPositionYUV(x, y, b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-    if (hierarchicalPositionYUV(x + b2, y, b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-    if (hierarchicalPositionYUV(x, y + b2, b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-    if (hierarchicalPositionYUV(
-            x + b2, y + b2, b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-  }
-  return false;
-}
-
 } // namespace video
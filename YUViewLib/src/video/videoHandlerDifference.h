@@ -34,6 +34,7 @@
 
 #include <common/FileInfo.h>
 
+#include "DifferenceScan.h"
 #include "videoHandler.h"
 #include "videoHandlerYUV.h"
 
@@ -59,6 +60,14 @@ public:
 
   // Are both inputs valid and can be used?
   bool inputsValid() const;
+  // The difference can be cached if both inputs are YUV videos with the same subsampling. The
+  // difference is then calculated from the raw data of the inputs on the caching threads.
+  bool inputsCachable() const;
+
+  // Also remove the difference info of the cached frames
+  void removeFrameFromCache(int frameIndex) override;
+  void removeAllFrameFromCache() override;
+  void invalidateAllBuffers() override;
 
   // Create the YUV controls and return a pointer to the layout.
   virtual QLayout *createDifferenceHandlerControls();
@@ -87,11 +96,29 @@ public:
   virtual void savePlaylist(YUViewDomElement &root) const override;
   virtual void loadPlaylist(const YUViewDomElement &root) override;
 
+  // Compare all frames in the given range in the background. The MSE of every frame is plotted in
+  // the controls and the next differing frame can be selected. Only YUV inputs are supported.
+  void startSequenceScan(indexRange frameRange);
+  void stopSequenceScan();
+  // Stop the scan and discard its results (e.g. because one of the inputs changed)
+  void resetSequenceScan();
+
+signals:
+  // The user wants to scan all frames. The playlist item knows which range of frames to scan.
+  void signalSequenceScanRequested();
+  // Show the given frame (e.g. the next frame with a difference)
+  void signalJumpToFrame(int frameIndex);
+
 private slots:
   void slotDifferenceControlChanged();
+  void slotSequenceScanButtonClicked();
+  void slotNextDifferenceButtonClicked();
+  void slotSequenceScanProgress(int nrFramesDone, int nrFrames);
+  void slotSequenceScanFinished();
 
 protected:
   ItemLoadingState needsLoadingRawValues(int frameIndex) override;
+  void             loadFrameForCaching(int frameIndex, QImage &frameToCache) override;
 
   bool markDifference{}; // Mark differences?
   int  amplificationFactor{1};
@@ -114,14 +141,21 @@ private:
                             int &         firstY,
                             int &         partIndex,
                             const QImage &diffImg) const;
-  bool hierarchicalPositionYUV(int                        x,
-                               int                        y,
-                               int                        blockSize,
-                               int &                      firstX,
-                               int &                      firstY,
-                               int &                      partIndex,
-                               const QByteArray &         diffYUV,
-                               const yuv::PixelFormatYUV &diffYUVFormat) const;
+
+  DifferenceScan sequenceScan;
+  void           updateSequenceScanControls();
+
+  // The info of every cached difference frame (protected by the imageCacheAccess mutex). If the
+  // current frame was taken from the cache, its info is in differenceInfoList and
+  // firstDifferenceInfoList.
+  struct DifferenceInfo
+  {
+    QList<InfoItem> firstDifference;
+    QList<InfoItem> difference;
+  };
+  QMap<int, DifferenceInfo> cachedDifferenceInfo;
+  QList<InfoItem>           firstDifferenceInfoList;
+  bool                      differenceInfoFromCache{};
 
   SafeUi<Ui::videoHandlerDifference> ui;
 };
@@ -76,6 +76,10 @@ public:
                                          FrameHandler *item2,
                                          const int     frameIdx1 = 0) override;
 
+  // Convert the given raw RGB frame to an image using the current format and conversion settings
+  // of this video. This does not change the state of the handler.
+  QImage convertRawToImage(const QByteArray &rawData);
+
   // Get the number of bytes for one RGB frame with the current format
   virtual int64_t getBytesPerFrame() const override
   {
@@ -83,9 +87,7 @@ public:
   }
 
   // Try to guess and set the format (frameSize/srcPixelFormat) from the raw RGB data.
-  // If a file size is given, it is tested if the RGB format and the file size match.
-  virtual void setFormatFromCorrelation(const QByteArray &rawRGBData,
-                                        int64_t           fileSize = -1) override;
+  virtual void setFormatFromCorrelation(const FileReader &reader, int64_t fileSize) override;
 
   virtual QString getFormatAsString() const override
   {
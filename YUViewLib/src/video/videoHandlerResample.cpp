@@ -53,35 +53,9 @@ videoHandlerResample::videoHandlerResample() : videoHandler()
 {
 }
 
-void videoHandlerResample::drawFrame(QPainter *painter,
-                                     int       frameIndex,
-                                     double    zoomFactor,
-                                     bool      drawRawValues)
+void videoHandlerResample::loadFrame(int frameIndex, bool loadToDoubleBuffer)
 {
-  auto mappedIndex = this->mapFrameIndex(frameIndex);
-  DEBUG_RESAMPLE("videoHandlerResample::drawFrame idx %d", mappedIndex);
-  videoHandler::drawFrame(painter, mappedIndex, zoomFactor, drawRawValues);
-}
-
-QImage videoHandlerResample::calculateDifference(FrameHandler *   item2,
-                                                 const int        frameIndex0,
-                                                 const int        frameIndex1,
-                                                 QList<InfoItem> &differenceInfoList,
-                                                 const int        amplificationFactor,
-                                                 const bool       markDifference)
-{
-  if (!this->inputValid())
-    return {};
-
-  auto mappedIndex = this->mapFrameIndex(frameIndex0);
-  return videoHandler::calculateDifference(
-      item2, mappedIndex, frameIndex1, differenceInfoList, amplificationFactor, markDifference);
-}
-
-ItemLoadingState videoHandlerResample::needsLoading(int frameIndex, bool loadRawValues)
-{
-  auto mappedIndex = this->mapFrameIndex(frameIndex);
-  return videoHandler::needsLoading(mappedIndex, loadRawValues);
+  this->loadResampledFrame(frameIndex, loadToDoubleBuffer);
 }
 
 void videoHandlerResample::loadResampledFrame(int frameIndex, bool loadToDoubleBuffer)
@@ -91,39 +65,56 @@ void videoHandlerResample::loadResampledFrame(int frameIndex, bool loadToDoubleB
 
   auto mappedIndex = this->mapFrameIndex(frameIndex);
 
-  auto video = dynamic_cast<videoHandler *>(this->inputVideo.data());
-  if (video && video->getCurrentImageIndex() != mappedIndex)
-    video->loadFrame(mappedIndex);
-
-  auto interpolationMode = (this->interpolation == Interpolation::Bilinear)
-                               ? Qt::SmoothTransformation
-                               : Qt::FastTransformation;
-
-  auto qFrameSize = QSize(this->getFrameSize().width, this->getFrameSize().height);
-  auto newFrame   = this->inputVideo->getCurrentFrameAsImage().scaled(
-      qFrameSize, Qt::IgnoreAspectRatio, interpolationMode);
+  auto newFrame = this->resampleYUVFrame(mappedIndex, false);
+  if (newFrame.isNull())
+  {
+    auto video = dynamic_cast<videoHandler *>(this->inputVideo.data());
+    if (video && video->getCurrentImageIndex() != mappedIndex)
+      video->loadFrame(mappedIndex);
 
+    newFrame = this->resampleImage(this->inputVideo->getCurrentFrameAsImage());
+  }
   if (newFrame.isNull())
     return;
 
   if (loadToDoubleBuffer)
   {
     doubleBufferImage           = newFrame;
-    doubleBufferImageFrameIndex = mappedIndex;
+    doubleBufferImageFrameIndex = frameIndex;
     DEBUG_RESAMPLE("videoHandlerResample::loadResampledFrame Loaded frame %d to double buffer",
-                   mappedIndex);
+                   frameIndex);
   }
   else
   {
     // The new difference frame is ready
     QMutexLocker lock(&this->currentImageSetMutex);
     currentImage      = newFrame;
-    currentImageIndex = mappedIndex;
+    currentImageIndex = frameIndex;
     DEBUG_RESAMPLE("videoHandlerResample::loadResampledFrame Loaded frame %d to current buffer",
-                   mappedIndex);
+                   frameIndex);
   }
 }
 
+void videoHandlerResample::loadFrameForCaching(int frameIndex, QImage &frameToCache)
+{
+  if (!this->inputValid())
+    return;
+
+  DEBUG_RESAMPLE("videoHandlerResample::loadFrameForCaching frame %d", frameIndex);
+
+  auto mappedIndex = this->mapFrameIndex(frameIndex);
+  frameToCache     = this->resampleYUVFrame(mappedIndex, true);
+  if (!frameToCache.isNull())
+    return;
+
+  QImage inputImage;
+  if (auto video = dynamic_cast<videoHandler *>(this->inputVideo.data()))
+    inputImage = video->getFrameForCaching(mappedIndex);
+  else
+    inputImage = this->inputVideo->getCurrentFrameAsImage();
+  frameToCache = this->resampleImage(inputImage);
+}
+
 bool videoHandlerResample::inputValid() const
 {
   return (!this->inputVideo.isNull() && this->inputVideo->isFormatValid());
@@ -140,7 +131,8 @@ void videoHandlerResample::setInputVideo(FrameHandler *childVideo)
   if (this->inputValid())
     this->setFrameSize(childVideo->getFrameSize());
 
-  emit signalHandlerChanged(true, RECACHE_NONE);
+  this->setCacheInvalid();
+  emit signalHandlerChanged(true, RECACHE_CLEAR);
 }
 
 void videoHandlerResample::setScaledSize(Size scaledSize)
@@ -152,6 +144,7 @@ void videoHandlerResample::setScaledSize(Size scaledSize)
   this->setFrameSize(scaledSize);
 
   this->invalidateAllBuffers();
+  this->setCacheInvalid();
   emit signalHandlerChanged(true, RECACHE_CLEAR);
 }
 
@@ -159,6 +152,7 @@ void videoHandlerResample::setInterpolation(Interpolation interpolation)
 {
   this->interpolation = interpolation;
   this->invalidateAllBuffers();
+  this->setCacheInvalid();
   emit signalHandlerChanged(true, RECACHE_CLEAR);
 }
 
@@ -171,6 +165,7 @@ void videoHandlerResample::setCutAndSample(indexRange startEnd, int sampling)
   this->sampling = sampling;
 
   this->invalidateAllBuffers();
+  this->setCacheInvalid();
   emit signalHandlerChanged(true, RECACHE_CLEAR);
 }
 
@@ -188,4 +183,57 @@ int videoHandlerResample::mapFrameIndex(int frameIndex)
   return mappedIndex;
 }
 
+QImage videoHandlerResample::resampleImage(const QImage &inputImage) const
+{
+  if (inputImage.isNull())
+    return {};
+
+  auto interpolationMode = (this->interpolation == Interpolation::Bilinear)
+                               ? Qt::SmoothTransformation
+                               : Qt::FastTransformation;
+
+  auto qFrameSize = QSize(this->getFrameSize().width, this->getFrameSize().height);
+  return inputImage.scaled(qFrameSize, Qt::IgnoreAspectRatio, interpolationMode);
+}
+
+QImage videoHandlerResample::resampleYUVFrame(int mappedIndex, bool caching)
+{
+  auto video = dynamic_cast<yuv::videoHandlerYUV *>(this->inputVideo.data());
+  if (video == nullptr || this->interpolation == Interpolation::Fast)
+    return {};
+
+  auto filter = yuv::ResampleFilter::Bilinear;
+  if (this->interpolation == Interpolation::Bicubic)
+    filter = yuv::ResampleFilter::Bicubic;
+  else if (this->interpolation == Interpolation::Lanczos3)
+    filter = yuv::ResampleFilter::Lanczos3;
+  else if (this->interpolation == Interpolation::Area)
+    filter = yuv::ResampleFilter::Area;
+
+  // The format of a compressed sequence is only known once the decoder provided a frame
+  const auto data = video->loadRawFrameData(mappedIndex, caching);
+  if (data.isEmpty())
+    return {};
+  const auto format     = yuv::PixelFormatYUV(video->getRawPixelFormatYUVName().toStdString());
+  const auto inputSize  = video->getFrameSize();
+  const auto outputSize = this->getFrameSize();
+
+  // Packed formats are converted to planar first
+  QByteArray          planarData;
+  yuv::PixelFormatYUV planarFormat;
+  bool                convOK;
+  std::tie(convOK, planarFormat) = yuv::convertToPlanarYUV(data, planarData, inputSize, format);
+  if (!convOK)
+    return {};
+
+  yuv::PixelFormatYUV outputFormat;
+  const auto          resampled = yuv::resamplePlanarYUV(
+      planarData, planarFormat, inputSize, outputSize, filter, outputFormat);
+  if (resampled.isEmpty())
+    return {};
+
+  DEBUG_RESAMPLE("videoHandlerResample::resampleYUVFrame frame %d", mappedIndex);
+  return video->convertRawToImage(resampled, outputFormat, outputSize);
+}
+
 } // namespace video
@@ -34,6 +34,7 @@
 
 #include <common/FileInfo.h>
 
+#include "Resampler.h"
 #include "videoHandler.h"
 #include "videoHandlerYUV.h"
 
@@ -47,23 +48,22 @@ class videoHandlerResample : public videoHandler
   Q_OBJECT
 
 public:
+  // Except for Fast, YUV inputs are resampled in the YUV domain at the bit depth of the input.
+  // Other inputs are resampled with the smooth transformation of QImage.
   enum class Interpolation
   {
     Bilinear,
-    Fast
+    Fast,
+    Bicubic,
+    Lanczos3,
+    Area
   };
 
   explicit videoHandlerResample();
 
-  // We need to override these videoHandler functions in order to map the frameIndex
-  void drawFrame(QPainter *painter, int frameIndex, double zoomFactor, bool drawRawValues) override;
-  QImage           calculateDifference(FrameHandler *   item2,
-                                       const int        frameIndex0,
-                                       const int        frameIndex1,
-                                       QList<InfoItem> &differenceInfoList,
-                                       const int        amplificationFactor,
-                                       const bool       markDifference) override;
-  ItemLoadingState needsLoading(int frameIndex, bool loadRawValues) override;
+  // The frames (also in the cache) are indexed by the frame index of the resample item. Only the
+  // frames of the input video are requested with the mapped index.
+  void loadFrame(int frameIndex, bool loadToDoubleBuffer = false) override;
 
   void loadResampledFrame(int frameIndex, bool loadToDoubleBuffer = false);
   bool inputValid() const;
@@ -84,8 +84,18 @@ public:
 
   QList<InfoItem> resampleInfoList;
 
+protected:
+  // Resample the frame of the input video on the caching thread. If the input is a video, its
+  // frame is taken from the cache of the input if it is there. Otherwise it is loaded without
+  // adding it to that cache.
+  void loadFrameForCaching(int frameIndex, QImage &frameToCache) override;
+
 private:
-  int mapFrameIndex(int frameIndex);
+  int    mapFrameIndex(int frameIndex);
+  QImage resampleImage(const QImage &inputImage) const;
+  // Resample the frame of a YUV input in the YUV domain and convert it with the conversion settings
+  // of the input. A null image is returned if this is not possible (e.g. the input is not YUV).
+  QImage resampleYUVFrame(int mappedIndex, bool caching);
 
   // The input video we will resample
   QPointer<FrameHandler> inputVideo;
@@ -41,12 +41,22 @@
 #if SSE_CONVERSION_420_ALT
 #include <xmmintrin.h>
 #endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YUV_PACKED_SSE2 1
+#else
+#define YUV_PACKED_SSE2 0
+#endif
 #include <QDir>
 #include <QPainter>
+#include <QtConcurrent>
 
 #include <common/FileInfo.h>
 #include <common/Functions.h>
 #include <common/FunctionsGui.h>
+#include <video/FrameBufferPool.h>
+#include <video/FrameMetrics.h>
+#include <video/PlanarYUV.h>
 #include <video/PixelFormatYUVGuess.h>
 #include <video/videoHandlerYUVCustomFormatDialog.h>
 
@@ -81,6 +91,16 @@ namespace video::yuv
 namespace
 {
 
+// Frames with at least this many pixels are not converted as a whole. Only the visible tiles are
+// converted when the frame is drawn.
+constexpr auto TILED_CONVERSION_MIN_PIXELS = size_t(8192) * 8192;
+// The width/height of a converted tile
+constexpr unsigned TILE_SIZE = 256;
+// The maximum number of bytes of converted tiles that are kept
+constexpr size_t TILE_CACHE_MAX_BYTES = size_t(256) * 1024 * 1024;
+// Don't downscale the tiles further than this (one tile pixel covers 2^16 x 2^16 frame pixels)
+constexpr unsigned TILE_MAX_LEVEL = 16;
+
 static unsigned char clp_buf[384 + 256 + 384];
 static bool          clp_buf_initialized = false;
 
@@ -95,22 +115,6 @@ void initClippingTable()
   clp_buf_initialized = true;
 }
 
-// Compute the MSE between the given char sources for numPixels bytes
-template <typename T> double computeMSE(T ptr, T ptr2, int numPixels)
-{
-  if (numPixels <= 0)
-    return 0.0;
-
-  uint64_t sad = 0;
-  for (int i = 0; i < numPixels; i++)
-  {
-    int diff = (int)ptr[i] - (int)ptr2[i];
-    sad += diff * diff;
-  }
-
-  return (double)sad / numPixels;
-}
-
 bool isFullRange(const ColorConversion colorConversion)
 {
   return colorConversion == ColorConversion::BT709_FullRange ||
@@ -118,168 +122,332 @@ bool isFullRange(const ColorConversion colorConversion)
          colorConversion == ColorConversion::BT2020_FullRange;
 }
 
-std::pair<bool, PixelFormatYUV> convertYUVPackedToPlanar(const QByteArray &    sourceBuffer,
-                                                         QByteArray &          targetBuffer,
-                                                         const Size            curFrameSize,
-                                                         const PixelFormatYUV &format)
+// The offsets of the Y, U and V samples within one block of samples of a packed format. For 4:2:2
+// a block contains 4 samples (2 pixels), the second Y sample is at y + 2. For 4:4:4 a block
+// contains the 3 or 4 samples of one pixel.
+struct PackedOffsets
 {
-  const auto packing = format.getPackingOrder();
+  int y{};
+  int u{};
+  int v{};
+};
 
-  // Make sure that the target buffer is big enough. It should be as big as the input buffer.
-  if (targetBuffer.size() != sourceBuffer.size())
-    targetBuffer.resize(sourceBuffer.size());
-
-  const auto w = curFrameSize.width;
-  const auto h = curFrameSize.height;
+PackedOffsets getPackedOffsets422(const PackingOrder packing)
+{
+  PackedOffsets offsets;
+  offsets.y = (packing == PackingOrder::YUYV || packing == PackingOrder::YVYU) ? 0 : 1;
+  offsets.u = (packing == PackingOrder::UYVY)   ? 0
+              : (packing == PackingOrder::YUYV) ? 1
+              : (packing == PackingOrder::VYUY) ? 2
+                                                : 3;
+  offsets.v = (packing == PackingOrder::VYUY)   ? 0
+              : (packing == PackingOrder::YVYU) ? 1
+              : (packing == PackingOrder::UYVY) ? 2
+                                                : 3;
+  return offsets;
+}
 
-  // Bytes per sample
-  const auto bps = (format.getBitsPerSample() > 8) ? 2u : 1u;
+PackedOffsets getPackedOffsets444(const PackingOrder packing)
+{
+  PackedOffsets offsets;
+  offsets.y = (packing == PackingOrder::AYUV) ? 1 : (packing == PackingOrder::VUYA) ? 2 : 0;
+  offsets.u = (packing == PackingOrder::YUV || packing == PackingOrder::YUVA ||
+               packing == PackingOrder::VUYA)
+                  ? 1
+                  : 2;
+  offsets.v = (packing == PackingOrder::YVU)    ? 1
+              : (packing == PackingOrder::AYUV) ? 3
+              : (packing == PackingOrder::VUYA) ? 0
+                                                : 2;
+  return offsets;
+}
 
-  if (format.getSubsampling() == Subsampling::YUV_422)
+// Split nrBlocks blocks of 4 packed 8 bit 4:2:2 samples into the Y, U and V planes.
+void unpackPacked422Samples8Bit(const unsigned char *restrict src,
+                                const unsigned                nrBlocks,
+                                const PackedOffsets           offsets,
+                                unsigned char *restrict       dstY,
+                                unsigned char *restrict       dstU,
+                                unsigned char *restrict       dstV)
+{
+  unsigned i = 0;
+#if YUV_PACKED_SSE2
+  // Process 8 blocks (16 pixels) at a time. The Y samples are either all the even or all the odd
+  // bytes. The remaining chroma bytes alternate between U and V.
+  const auto lowBytes  = _mm_set1_epi16(0x00ff);
+  const auto uFirst    = offsets.u < offsets.v;
+  const auto lumaEven  = offsets.y == 0;
+  const auto splitEven = [&lowBytes](const __m128i value) {
+    return _mm_and_si128(value, lowBytes);
+  };
+  const auto splitOdd = [](const __m128i value) { return _mm_srli_epi16(value, 8); };
+  for (; i + 8 <= nrBlocks; i += 8)
   {
-    // The data is arranged in blocks of 4 samples. How many of these are there?
-    const auto nr4Samples = w * h / 2;
-
-    // What are the offsets withing the 4 samples for the components?
-    const int oY = (packing == PackingOrder::YUYV || packing == PackingOrder::YVYU) ? 0 : 1;
-    const int oU = (packing == PackingOrder::UYVY)   ? 0
-                   : (packing == PackingOrder::YUYV) ? 1
-                   : (packing == PackingOrder::VYUY) ? 2
-                                                     : 3;
-    const int oV = (packing == PackingOrder::VYUY)   ? 0
-                   : (packing == PackingOrder::YVYU) ? 1
-                   : (packing == PackingOrder::UYVY) ? 2
-                                                     : 3;
+    const auto in0 = _mm_loadu_si128((const __m128i *)(src + i * 4));
+    const auto in1 = _mm_loadu_si128((const __m128i *)(src + i * 4 + 16));
+
+    const auto luma   = lumaEven ? _mm_packus_epi16(splitEven(in0), splitEven(in1))
+                                 : _mm_packus_epi16(splitOdd(in0), splitOdd(in1));
+    const auto chroma = lumaEven ? _mm_packus_epi16(splitOdd(in0), splitOdd(in1))
+                                 : _mm_packus_epi16(splitEven(in0), splitEven(in1));
+    const auto chromaEven = _mm_packus_epi16(splitEven(chroma), _mm_setzero_si128());
+    const auto chromaOdd  = _mm_packus_epi16(splitOdd(chroma), _mm_setzero_si128());
+
+    _mm_storeu_si128((__m128i *)(dstY + i * 2), luma);
+    _mm_storel_epi64((__m128i *)(dstU + i), uFirst ? chromaEven : chromaOdd);
+    _mm_storel_epi64((__m128i *)(dstV + i), uFirst ? chromaOdd : chromaEven);
+  }
+#endif
+  for (; i < nrBlocks; i++)
+  {
+    const auto block = src + i * 4;
+    dstY[i * 2]      = block[offsets.y];
+    dstY[i * 2 + 1]  = block[offsets.y + 2];
+    dstU[i]          = block[offsets.u];
+    dstV[i]          = block[offsets.v];
+  }
+}
 
-    if (format.getBitsPerSample() == 10 && format.isBytePacking())
-    {
-      // Byte packing in 422 with 10 bit. So for each 2 pixels we have 4 10 bit values which
-      // are exactly 5 bytes (40 bits).
-      auto fmt        = PixelFormatYUV(Subsampling::YUV_422, 10, PlaneOrder::YUV);
-      auto outputSize = fmt.bytesPerFrame(curFrameSize);
-      if (targetBuffer.size() < outputSize)
-        targetBuffer.resize(outputSize);
-
-      const unsigned char *restrict src  = (unsigned char *)sourceBuffer.data();
-      unsigned short *restrict      dstY = (unsigned short *)targetBuffer.data();
-      unsigned short *restrict      dstU = dstY + w * h;
-      unsigned short *restrict      dstV = dstU + w / 2 * h;
-
-      for (unsigned i = 0; i < nr4Samples; i++)
-      {
-        unsigned short values[4];
-        values[0] = (src[0] << 2) + (src[1] >> 6);
-        values[1] = ((src[1] & 0x3f) << 4) + (src[2] >> 4);
-        values[2] = ((src[2] & 0x0f) << 6) + (src[3] >> 2);
-        values[3] = ((src[3] & 0x03) << 8) + src[4];
+// Split nrBlocks blocks of 4 packed 16 bit 4:2:2 samples into the Y, U and V planes. The byte
+// order of the samples is not changed.
+void unpackPacked422Samples16Bit(const unsigned short *restrict src,
+                                 const unsigned                 nrBlocks,
+                                 const PackedOffsets            offsets,
+                                 unsigned short *restrict       dstY,
+                                 unsigned short *restrict       dstU,
+                                 unsigned short *restrict       dstV)
+{
+  for (unsigned i = 0; i < nrBlocks; i++)
+  {
+    const auto block = src + i * 4;
+    dstY[i * 2]      = block[offsets.y];
+    dstY[i * 2 + 1]  = block[offsets.y + 2];
+    dstU[i]          = block[offsets.u];
+    dstV[i]          = block[offsets.v];
+  }
+}
 
-        *dstY++ = values[oY];
-        *dstY++ = values[oY + 2];
-        *dstU++ = values[oU];
-        *dstV++ = values[oV];
+// Split nrBlocks blocks of 4 byte packed 10 bit 4:2:2 samples (40 bits in 5 bytes) into the Y, U
+// and V planes.
+void unpackPacked422Samples10BitBytePacking(const unsigned char *restrict src,
+                                            const unsigned                nrBlocks,
+                                            const PackedOffsets           offsets,
+                                            unsigned short *restrict      dstY,
+                                            unsigned short *restrict      dstU,
+                                            unsigned short *restrict      dstV)
+{
+  for (unsigned i = 0; i < nrBlocks; i++)
+  {
+    const auto     block = src + i * 5;
+    unsigned short values[4];
+    values[0] = (block[0] << 2) + (block[1] >> 6);
+    values[1] = ((block[1] & 0x3f) << 4) + (block[2] >> 4);
+    values[2] = ((block[2] & 0x0f) << 6) + (block[3] >> 2);
+    values[3] = ((block[3] & 0x03) << 8) + block[4];
+
+    dstY[i * 2]     = values[offsets.y];
+    dstY[i * 2 + 1] = values[offsets.y + 2];
+    dstU[i]         = values[offsets.u];
+    dstV[i]         = values[offsets.v];
+  }
+}
 
-        src += 5;
-      }
+// Split nrPixels packed 4:4:4 pixels (3 or 4 samples each) into the Y, U and V planes.
+template <typename T>
+void unpackPacked444Samples(const T *restrict   src,
+                            const unsigned      nrPixels,
+                            const PackedOffsets offsets,
+                            const unsigned      samplesPerPixel,
+                            T *restrict         dstY,
+                            T *restrict         dstU,
+                            T *restrict         dstV)
+{
+  for (unsigned i = 0; i < nrPixels; i++)
+  {
+    const auto pixel = src + i * samplesPerPixel;
+    dstY[i]          = pixel[offsets.y];
+    dstU[i]          = pixel[offsets.u];
+    dstV[i]          = pixel[offsets.v];
+  }
+}
 
-      return {true, fmt};
-    }
-    else
+// Unpack one line of V210 data into the Y, U and V planes. There are 6 pixels values per 16 bytes
+// in the input. 6 Values (6 Y, 3 U/V) are packed like this (highest to lowest bit, each value is
+// 10 bit):
+// Byte 0-3:   (2 zero bytes), Cr0, Y0, Cb0
+// Byte 4-7:   (2 zero bytes), Y2, Cb1, Y1
+// Byte 8-11:  (2 zero bytes), Cb2, Y3, Cr1
+// Byte 12-15: (2 zero bytes), Y5, Cr2, Y4
+void unpackV210Line(const unsigned char *restrict src,
+                    const unsigned                w,
+                    unsigned short *restrict      dstY,
+                    unsigned short *restrict      dstU,
+                    unsigned short *restrict      dstV)
+{
+  for (auto [xIn, xOutY, xOutUV] = std::tuple{0u, 0u, 0u}; xOutY < w;
+       xOutY += 6, xOutUV += 3, xIn += 16)
+  {
+    auto           xw0 = xIn;
+    unsigned short Cb0 = src[xw0] + ((src[xw0 + 1] & 0x03) << 8);
+    unsigned short Y0  = ((src[xw0 + 1] >> 2) & 0x3f) + ((src[xw0 + 2] & 0x0f) << 6);
+    unsigned short Cr0 = (src[xw0 + 2] >> 4) + ((src[xw0 + 3] & 0x3f) << 4);
+
+    auto           xw1 = xIn + 4;
+    unsigned short Y1  = src[xw1] + ((src[xw1 + 1] & 0x03) << 8);
+    unsigned short Cb1 = ((src[xw1 + 1] >> 2) & 0x3f) + ((src[xw1 + 2] & 0x0f) << 6);
+    unsigned short Y2  = (src[xw1 + 2] >> 4) + ((src[xw1 + 3] & 0x3f) << 4);
+
+    auto           xw2 = xIn + 8;
+    unsigned short Cr1 = src[xw2] + ((src[xw2 + 1] & 0x03) << 8);
+    unsigned short Y3  = ((src[xw2 + 1] >> 2) & 0x3f) + ((src[xw2 + 2] & 0x0f) << 6);
+    unsigned short Cb2 = (src[xw2 + 2] >> 4) + ((src[xw2 + 3] & 0x3f) << 4);
+
+    auto           xw3 = xIn + 12;
+    unsigned short Y4  = src[xw3] + ((src[xw3 + 1] & 0x03) << 8);
+    unsigned short Cr2 = ((src[xw3 + 1] >> 2) & 0x3f) + ((src[xw3 + 2] & 0x0f) << 6);
+    unsigned short Y5  = (src[xw3 + 2] >> 4) + ((src[xw3 + 3] & 0x3f) << 4);
+
+    dstY[xOutY]     = Y0;
+    dstY[xOutY + 1] = Y1;
+    dstU[xOutUV]    = Cb0;
+    dstV[xOutUV]    = Cr0;
+
+    if (xOutY + 2 < w)
     {
-      if (bps == 1)
-      {
-        // One byte per sample.
-        const unsigned char *restrict src  = (unsigned char *)sourceBuffer.data();
-        unsigned char *restrict       dstY = (unsigned char *)targetBuffer.data();
-        unsigned char *restrict       dstU = dstY + w * h;
-        unsigned char *restrict       dstV = dstU + w / 2 * h;
+      dstY[xOutY + 2]  = Y2;
+      dstY[xOutY + 3]  = Y3;
+      dstU[xOutUV + 1] = Cb1;
+      dstV[xOutUV + 1] = Cr1;
 
-        for (unsigned i = 0; i < nr4Samples; i++)
-        {
-          *dstY++ = src[oY];
-          *dstY++ = src[oY + 2];
-          *dstU++ = src[oU];
-          *dstV++ = src[oV];
-          src += 4; // Goto the next 4 samples
-        }
-      }
-      else
+      if (xOutY + 4 < w)
       {
-        // Two bytes per sample.
-        const unsigned short *restrict src  = (unsigned short *)sourceBuffer.data();
-        unsigned short *restrict       dstY = (unsigned short *)targetBuffer.data();
-        unsigned short *restrict       dstU = dstY + w * h;
-        unsigned short *restrict       dstV = dstU + w / 2 * h;
-
-        for (unsigned i = 0; i < nr4Samples; i++)
-        {
-          *dstY++ = src[oY];
-          *dstY++ = src[oY + 2];
-          *dstU++ = src[oU];
-          *dstV++ = src[oV];
-          src += 4; // Goto the next 4 samples
-        }
+        dstY[xOutY + 4]  = Y4;
+        dstY[xOutY + 5]  = Y5;
+        dstU[xOutUV + 2] = Cb2;
+        dstV[xOutUV + 2] = Cr2;
       }
     }
   }
-  else if (format.getSubsampling() == Subsampling::YUV_444)
-  {
-    // What are the offsets withing the 3 or 4 bytes per sample?
-    const int oY = (packing == PackingOrder::AYUV) ? 1 : (packing == PackingOrder::VUYA) ? 2 : 0;
-    const int oU = (packing == PackingOrder::YUV || packing == PackingOrder::YUVA ||
-                    packing == PackingOrder::VUYA)
-                       ? 1
-                       : 2;
-    const int oV = (packing == PackingOrder::YVU)    ? 1
-                   : (packing == PackingOrder::AYUV) ? 3
-                   : (packing == PackingOrder::VUYA) ? 0
-                                                     : 2;
+}
 
-    // How many samples to the next sample?
-    const int offsetNext = (packing == PackingOrder::YUV || packing == PackingOrder::YVU ? 3 : 4);
+// The number of bytes of one line of V210 data. The width is rounded up to a multiple of 48.
+unsigned getV210LineStride(const unsigned w)
+{
+  auto widthRoundUp = (((w + 48 - 1) / 48) * 48);
+  return widthRoundUp / 6 * 16;
+}
 
-    if (bps == 1)
-    {
-      // One byte per sample.
-      const unsigned char *restrict src  = (unsigned char *)sourceBuffer.data();
-      unsigned char *restrict       dstY = (unsigned char *)targetBuffer.data();
-      unsigned char *restrict       dstU = dstY + w * h;
-      unsigned char *restrict       dstV = dstU + w * h;
+// Unpack nrPixels pixels of packed data in the given format (or V210 data of one line) into the Y,
+// U and V planes. The planes have the bit depth and byte order returned by
+// getUnpackedPlanarFormat. Returns false if the packed format is not supported.
+bool unpackPackedSamples(const unsigned char *restrict src,
+                         const unsigned                nrPixels,
+                         const PixelFormatYUV &        format,
+                         unsigned char *restrict       dstY,
+                         unsigned char *restrict       dstU,
+                         unsigned char *restrict       dstV)
+{
+  if (auto predefinedFormat = format.getPredefinedFormat())
+  {
+    if (*predefinedFormat != PredefinedPixelFormat::V210)
+      return false;
+    unpackV210Line(
+        src, nrPixels, (unsigned short *)dstY, (unsigned short *)dstU, (unsigned short *)dstV);
+    return true;
+  }
 
-      for (unsigned i = 0; i < w * h; i++)
-      {
-        *dstY++ = src[oY];
-        *dstU++ = src[oU];
-        *dstV++ = src[oV];
-        src += offsetNext; // Goto the next sample
-      }
-    }
+  const auto packing  = format.getPackingOrder();
+  const auto twoBytes = format.getBitsPerSample() > 8;
+  if (format.getSubsampling() == Subsampling::YUV_422)
+  {
+    const auto offsets  = getPackedOffsets422(packing);
+    const auto nrBlocks = nrPixels / 2;
+    if (format.getBitsPerSample() == 10 && format.isBytePacking())
+      unpackPacked422Samples10BitBytePacking(src,
+                                             nrBlocks,
+                                             offsets,
+                                             (unsigned short *)dstY,
+                                             (unsigned short *)dstU,
+                                             (unsigned short *)dstV);
+    else if (twoBytes)
+      unpackPacked422Samples16Bit((const unsigned short *)src,
+                                  nrBlocks,
+                                  offsets,
+                                  (unsigned short *)dstY,
+                                  (unsigned short *)dstU,
+                                  (unsigned short *)dstV);
     else
-    {
-      // Two bytes per sample.
-      const unsigned short *restrict src  = (unsigned short *)sourceBuffer.data();
-      unsigned short *restrict       dstY = (unsigned short *)targetBuffer.data();
-      unsigned short *restrict       dstU = dstY + w * h;
-      unsigned short *restrict       dstV = dstU + w * h;
-
-      for (unsigned i = 0; i < w * h; i++)
-      {
-        *dstY++ = src[oY];
-        *dstU++ = src[oU];
-        *dstV++ = src[oV];
-        src += offsetNext; // Goto the next sample
-      }
-    }
+      unpackPacked422Samples8Bit(src, nrBlocks, offsets, dstY, dstU, dstV);
+    return true;
   }
-  else
-    return {};
+  if (format.getSubsampling() == Subsampling::YUV_444)
+  {
+    const auto offsets = getPackedOffsets444(packing);
+    // How many samples to the next sample?
+    const auto samplesPerPixel =
+        (packing == PackingOrder::YUV || packing == PackingOrder::YVU) ? 3u : 4u;
+    if (twoBytes)
+      unpackPacked444Samples((const unsigned short *)src,
+                             nrPixels,
+                             offsets,
+                             samplesPerPixel,
+                             (unsigned short *)dstY,
+                             (unsigned short *)dstU,
+                             (unsigned short *)dstV);
+    else
+      unpackPacked444Samples(src, nrPixels, offsets, samplesPerPixel, dstY, dstU, dstV);
+    return true;
+  }
+  return false;
+}
+
+// The planar format that unpackPackedSamples writes for the given packed format.
+PixelFormatYUV getUnpackedPlanarFormat(const PixelFormatYUV &format)
+{
+  if (format.getPredefinedFormat() ||
+      (format.getSubsampling() == Subsampling::YUV_422 && format.getBitsPerSample() == 10 &&
+       format.isBytePacking()))
+    return PixelFormatYUV(Subsampling::YUV_422, 10, PlaneOrder::YUV);
 
   // The output buffer is planar with the same subsampling as before
-  auto newFormat = PixelFormatYUV(format.getSubsampling(),
-                                  format.getBitsPerSample(),
-                                  PlaneOrder::YUV,
-                                  format.isBigEndian(),
-                                  format.getChromaOffset(),
-                                  format.isUVInterleaved());
+  return PixelFormatYUV(format.getSubsampling(),
+                        format.getBitsPerSample(),
+                        PlaneOrder::YUV,
+                        format.isBigEndian(),
+                        format.getChromaOffset(),
+                        format.isUVInterleaved());
+}
+
+std::pair<bool, PixelFormatYUV> convertYUVPackedToPlanar(const QByteArray &    sourceBuffer,
+                                                         QByteArray &          targetBuffer,
+                                                         const Size            curFrameSize,
+                                                         const PixelFormatYUV &format)
+{
+  const auto newFormat = getUnpackedPlanarFormat(format);
+
+  // Make sure that the target buffer is big enough. It should be at least as big as the input
+  // buffer.
+  if (targetBuffer.size() != sourceBuffer.size())
+    targetBuffer.resize(sourceBuffer.size());
+  const auto outputSize = newFormat.bytesPerFrame(curFrameSize);
+  if (targetBuffer.size() < outputSize)
+    targetBuffer.resize(outputSize);
+
+  const auto w = curFrameSize.width;
+  const auto h = curFrameSize.height;
+
+  // Bytes per sample
+  const auto bps = (newFormat.getBitsPerSample() > 8) ? 2u : 1u;
+
+  // The packed samples of all lines are continuous so the frame is unpacked in one go
+  const auto chromaPlaneSize =
+      w / newFormat.getSubsamplingHor() * h / newFormat.getSubsamplingVer() * bps;
+  auto dstY = (unsigned char *)targetBuffer.data();
+  auto dstU = dstY + w * h * bps;
+  auto dstV = dstU + chromaPlaneSize;
+  if (!unpackPackedSamples(
+          (const unsigned char *)sourceBuffer.data(), w * h, format, dstY, dstU, dstV))
+    return {};
 
   return {true, newFormat};
 }
@@ -288,13 +456,6 @@ std::pair<bool, PixelFormatYUV> convertV210PackedToPlanar(const QByteArray &sour
                                                           QByteArray &      targetBuffer,
                                                           const Size        curFrameSize)
 {
-  // There are 6 pixels values per 16 bytes in the input.
-  // 6 Values (6 Y, 3 U/V) are packed like this (highest to lowest bit, each value is 10 bit):
-  // Byte 0-3:   (2 zero bytes), Cr0, Y0, Cb0
-  // Byte 4-7:   (2 zero bytes), Y2, Cb1, Y1
-  // Byte 8-11:  (2 zero bytes), Cb2, Y3, Cr1
-  // Byte 12-15: (2 zero bytes), Y5, Cr2, Y4
-
   // The output format is 422 10 bit planar
   auto       newFormat        = PixelFormatYUV(Subsampling::YUV_422, 10, PlaneOrder::YUV);
   const auto bytesPerOutFrame = newFormat.bytesPerFrame(curFrameSize);
@@ -304,8 +465,7 @@ std::pair<bool, PixelFormatYUV> convertV210PackedToPlanar(const QByteArray &sour
   const auto w = curFrameSize.width;
   const auto h = curFrameSize.height;
 
-  auto widthRoundUp = (((w + 48 - 1) / 48) * 48);
-  auto strideIn     = widthRoundUp / 6 * 16;
+  const auto strideIn = getV210LineStride(w);
 
   const unsigned char *restrict src  = (unsigned char *)sourceBuffer.data();
   unsigned short *restrict      dstY = (unsigned short *)targetBuffer.data();
@@ -314,50 +474,7 @@ std::pair<bool, PixelFormatYUV> convertV210PackedToPlanar(const QByteArray &sour
 
   for (unsigned y = 0; y < h; y++)
   {
-    for (auto [xIn, xOutY, xOutUV] = std::tuple{0u, 0u, 0u}; xOutY < w;
-         xOutY += 6, xOutUV += 3, xIn += 16)
-    {
-      auto           xw0 = xIn;
-      unsigned short Cb0 = src[xw0] + ((src[xw0 + 1] & 0x03) << 8);
-      unsigned short Y0  = ((src[xw0 + 1] >> 2) & 0x3f) + ((src[xw0 + 2] & 0x0f) << 6);
-      unsigned short Cr0 = (src[xw0 + 2] >> 4) + ((src[xw0 + 3] & 0x3f) << 4);
-
-      auto           xw1 = xIn + 4;
-      unsigned short Y1  = src[xw1] + ((src[xw1 + 1] & 0x03) << 8);
-      unsigned short Cb1 = ((src[xw1 + 1] >> 2) & 0x3f) + ((src[xw1 + 2] & 0x0f) << 6);
-      unsigned short Y2  = (src[xw1 + 2] >> 4) + ((src[xw1 + 3] & 0x3f) << 4);
-
-      auto           xw2 = xIn + 8;
-      unsigned short Cr1 = src[xw2] + ((src[xw2 + 1] & 0x03) << 8);
-      unsigned short Y3  = ((src[xw2 + 1] >> 2) & 0x3f) + ((src[xw2 + 2] & 0x0f) << 6);
-      unsigned short Cb2 = (src[xw2 + 2] >> 4) + ((src[xw2 + 3] & 0x3f) << 4);
-
-      auto           xw3 = xIn + 12;
-      unsigned short Y4  = src[xw3] + ((src[xw3 + 1] & 0x03) << 8);
-      unsigned short Cr2 = ((src[xw3 + 1] >> 2) & 0x3f) + ((src[xw3 + 2] & 0x0f) << 6);
-      unsigned short Y5  = (src[xw3 + 2] >> 4) + ((src[xw3 + 3] & 0x3f) << 4);
-
-      dstY[xOutY]     = Y0;
-      dstY[xOutY + 1] = Y1;
-      dstU[xOutUV]    = Cb0;
-      dstV[xOutUV]    = Cr0;
-
-      if (xOutY + 2 < w)
-      {
-        dstY[xOutY + 2]  = Y2;
-        dstY[xOutY + 3]  = Y3;
-        dstU[xOutUV + 1] = Cb1;
-        dstV[xOutUV + 1] = Cr1;
-
-        if (xOutY + 4 < w)
-        {
-          dstY[xOutY + 4]  = Y4;
-          dstY[xOutY + 5]  = Y5;
-          dstU[xOutUV + 2] = Cb2;
-          dstV[xOutUV + 2] = Cr2;
-        }
-      }
-    }
+    unpackV210Line(src, w, dstY, dstU, dstV);
     src += strideIn;
     dstY += w;
     dstU += w / 2;
@@ -676,6 +793,35 @@ inline int transformYUV(const bool         invert,
   return newValue;
 }
 
+// The bit depth classes need different integer math in the conversion to RGB
+enum class BitDepthClass
+{
+  EightBit,   // One byte per sample
+  UpTo14Bit,  // Two bytes per sample
+  Above14Bit, // Two bytes per sample. Two bits are dropped to stay within 32 bit.
+};
+
+/* The format of the planar YUV input resolved at compile time. The conversion kernels below are
+ * instantiated for every combination of these parameters and the right instance is chosen once
+ * per frame (see dispatchPlanarFormat). Like this, the inner loops carry no format branches. The
+ * exact bit depth and the YUV math are still runtime values but they are constant in the loops.
+ */
+template <BitDepthClass BitDepth, bool BigEndian, int ValueSkip, bool FullRange> struct PlanarFormat
+{
+  static constexpr auto bitDepthClass = BitDepth;
+  static constexpr auto bytes         = (BitDepth == BitDepthClass::EightBit) ? 1u : 2u;
+  // Skip this many values in the input for every chroma value. For pure planar formats, this is 1.
+  // If the UV components are interleaved, this is 2 or 3.
+  static constexpr int  valueSkip = ValueSkip;
+  static constexpr bool fullRange = FullRange;
+
+  static int read(const unsigned char *restrict src, const int idx)
+  {
+    return readSample<bytes, BigEndian>(src, size_t(idx));
+  }
+};
+
+template <typename Format>
 inline void convertYUVToRGB8Bit(const unsigned int valY,
                                 const unsigned int valU,
                                 const unsigned int valV,
@@ -683,25 +829,27 @@ inline void convertYUVToRGB8Bit(const unsigned int valY,
                                 int &              valG,
                                 int &              valB,
                                 const int          RGBConv[5],
-                                const bool         fullRange,
                                 const int          bps)
 {
-  if (bps > 14)
+  // With more than 8 bit, the sums of the products can exceed 32 bit (e.g. 14 bit limited range)
+  using Sum = std::conditional_t<Format::bitDepthClass == BitDepthClass::EightBit, int, int64_t>;
+
+  if constexpr (Format::bitDepthClass == BitDepthClass::Above14Bit)
   {
     // The bit depth of an int (32) is not enough to perform a YUV -> RGB conversion for a bit depth
     // > 14 bits. We could use 64 bit values but for what? We are clipping the result to 8 bit
     // anyways so let's just get rid of 2 of the bits for the YUV values.
-    const int yOffset = (fullRange ? 0 : 16 << (bps - 10));
+    const int yOffset = (Format::fullRange ? 0 : 16 << (bps - 10));
     const int cZero   = 128 << (bps - 10);
 
-    const int Y_tmp = ((valY >> 2) - yOffset) * RGBConv[0];
-    const int U_tmp = (valU >> 2) - cZero;
-    const int V_tmp = (valV >> 2) - cZero;
+    const Sum Y_tmp = Sum(int(valY >> 2) - yOffset) * RGBConv[0];
+    const int U_tmp = int(valU >> 2) - cZero;
+    const int V_tmp = int(valV >> 2) - cZero;
 
-    const int R_tmp = (Y_tmp + V_tmp * RGBConv[1]) >>
-                      (16 + bps - 10); // 32 to 16 bit conversion by right shifting
-    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 10);
-    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]) >> (16 + bps - 10);
+    const int R_tmp = int((Y_tmp + V_tmp * RGBConv[1]) >>
+                          (16 + bps - 10)); // 32 to 16 bit conversion by right shifting
+    const int G_tmp = int((Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 10));
+    const int B_tmp = int((Y_tmp + U_tmp * RGBConv[4]) >> (16 + bps - 10));
 
     valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
     valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
@@ -709,17 +857,17 @@ inline void convertYUVToRGB8Bit(const unsigned int valY,
   }
   else
   {
-    const int yOffset = (fullRange ? 0 : 16 << (bps - 8));
+    const int yOffset = (Format::fullRange ? 0 : 16 << (bps - 8));
     const int cZero   = 128 << (bps - 8);
 
-    const int Y_tmp = (valY - yOffset) * RGBConv[0];
-    const int U_tmp = valU - cZero;
-    const int V_tmp = valV - cZero;
+    const Sum Y_tmp = Sum(int(valY) - yOffset) * RGBConv[0];
+    const int U_tmp = int(valU) - cZero;
+    const int V_tmp = int(valV) - cZero;
 
-    const int R_tmp =
-        (Y_tmp + V_tmp * RGBConv[1]) >> (16 + bps - 8); // 32 to 16 bit conversion by right shifting
-    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 8);
-    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]) >> (16 + bps - 8);
+    const int R_tmp = int((Y_tmp + V_tmp * RGBConv[1]) >>
+                          (16 + bps - 8)); // 32 to 16 bit conversion by right shifting
+    const int G_tmp = int((Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 8));
+    const int B_tmp = int((Y_tmp + U_tmp * RGBConv[4]) >> (16 + bps - 8));
 
     valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
     valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
@@ -764,29 +912,26 @@ inline void setValueInBuffer(
 }
 
 // For every input sample in src, apply YUV transformation, (scale to 8 bit if required) and set the
-// value as RGB (monochrome). inValSkip: skip this many values in the input for every value. For
-// pure planar formats, this 1. If the UV components are interleaved, this is 2 or 3.
+// value as RGB (monochrome). The value skip of the format is applied to the input.
+template <typename Format>
 inline void YUVPlaneToRGBMonochrome_444(const int                     componentSize,
                                         const MathParameters          math,
                                         const unsigned char *restrict src,
                                         unsigned char *restrict       dst,
                                         const int                     inMax,
-                                        const int                     bps,
-                                        const bool                    bigEndian,
-                                        const int                     inValSkip,
-                                        const bool                    fullRange)
+                                        const int                     bps)
 {
   const bool applyMath   = math.mathRequired();
   const int  shiftTo8Bit = bps - 8;
   for (int i = 0; i < componentSize; ++i)
   {
-    int newVal = getValueFromSource(src, i * inValSkip, bps, bigEndian);
+    int newVal = Format::read(src, i * Format::valueSkip);
     if (applyMath)
       newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
 
     if (shiftTo8Bit > 0)
       newVal = clip8Bit(newVal >> shiftTo8Bit);
-    if (!fullRange)
+    if constexpr (!Format::fullRange)
       newVal = videoHandler::convScaleLimitedRange(newVal);
 
     // Set the value for R, G and B (BGRA)
@@ -799,27 +944,25 @@ inline void YUVPlaneToRGBMonochrome_444(const int                     componentS
 
 // For every input sample in the YZV 422 src, apply interpolation (sample and hold), apply YUV
 // transformation, (scale to 8 bit if required) and set the value as RGB (monochrome).
+template <typename Format>
 inline void YUVPlaneToRGBMonochrome_422(const int                     componentSize,
                                         const MathParameters          math,
                                         const unsigned char *restrict src,
                                         unsigned char *restrict       dst,
                                         const int                     inMax,
-                                        const int                     bps,
-                                        const bool                    bigEndian,
-                                        const int                     inValSkip,
-                                        const bool                    fullRange)
+                                        const int                     bps)
 {
   const bool applyMath   = math.mathRequired();
   const int  shiftTo8Bit = bps - 8;
   for (int i = 0; i < componentSize; ++i)
   {
-    int newVal = getValueFromSource(src, i * inValSkip, bps, bigEndian);
+    int newVal = Format::read(src, i * Format::valueSkip);
     if (applyMath)
       newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
 
     if (shiftTo8Bit > 0)
       newVal = clip8Bit(newVal >> shiftTo8Bit);
-    if (!fullRange)
+    if constexpr (!Format::fullRange)
       newVal = videoHandler::convScaleLimitedRange(newVal);
 
     // Set the value for R, G and B of 2 pixels (BGRA)
@@ -834,16 +977,14 @@ inline void YUVPlaneToRGBMonochrome_422(const int                     componentS
   }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGBMonochrome_420(const int                     w,
                                         const int                     h,
                                         const MathParameters          math,
                                         const unsigned char *restrict src,
                                         unsigned char *restrict       dst,
                                         const int                     inMax,
-                                        const int                     bps,
-                                        const bool                    bigEndian,
-                                        const int                     inValSkip,
-                                        const bool                    fullRange)
+                                        const int                     bps)
 {
   const bool applyMath   = math.mathRequired();
   const int  shiftTo8Bit = bps - 8;
@@ -851,13 +992,13 @@ inline void YUVPlaneToRGBMonochrome_420(const int                     w,
     for (int x = 0; x < w / 2; x++)
     {
       const int srcIdx = y * (w / 2) + x;
-      int       newVal = getValueFromSource(src, srcIdx * inValSkip, bps, bigEndian);
+      int       newVal = Format::read(src, srcIdx * Format::valueSkip);
       if (applyMath)
         newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
 
       if (shiftTo8Bit > 0)
         newVal = clip8Bit(newVal >> shiftTo8Bit);
-      if (!fullRange)
+      if constexpr (!Format::fullRange)
         newVal = videoHandler::convScaleLimitedRange(newVal);
 
       // Set the value for R, G and B of 4 pixels (BGRA)
@@ -882,16 +1023,14 @@ inline void YUVPlaneToRGBMonochrome_420(const int                     w,
     }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGBMonochrome_440(const int                     w,
                                         const int                     h,
                                         const MathParameters          math,
                                         const unsigned char *restrict src,
                                         unsigned char *restrict       dst,
                                         const int                     inMax,
-                                        const int                     bps,
-                                        const bool                    bigEndian,
-                                        const int                     inValSkip,
-                                        const bool                    fullRange)
+                                        const int                     bps)
 {
   const bool applyMath   = math.mathRequired();
   const int  shiftTo8Bit = bps - 8;
@@ -899,13 +1038,13 @@ inline void YUVPlaneToRGBMonochrome_440(const int                     w,
     for (int x = 0; x < w; x++)
     {
       const int srcIdx = y * w + x;
-      int       newVal = getValueFromSource(src, srcIdx * inValSkip, bps, bigEndian);
+      int       newVal = Format::read(src, srcIdx * Format::valueSkip);
       if (applyMath)
         newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
 
       if (shiftTo8Bit > 0)
         newVal = clip8Bit(newVal >> shiftTo8Bit);
-      if (!fullRange)
+      if constexpr (!Format::fullRange)
         newVal = videoHandler::convScaleLimitedRange(newVal);
 
       // Set the value for R, G and B of 2 pixels (BGRA)
@@ -922,16 +1061,14 @@ inline void YUVPlaneToRGBMonochrome_440(const int                     w,
     }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGBMonochrome_410(const int                     w,
                                         const int                     h,
                                         const MathParameters          math,
                                         const unsigned char *restrict src,
                                         unsigned char *restrict       dst,
                                         const int                     inMax,
-                                        const int                     bps,
-                                        const bool                    bigEndian,
-                                        const int                     inValSkip,
-                                        const bool                    fullRange)
+                                        const int                     bps)
 {
   // Horizontal subsampling by 4, vertical subsampling by 4
   const bool applyMath   = math.mathRequired();
@@ -940,14 +1077,14 @@ inline void YUVPlaneToRGBMonochrome_410(const int                     w,
     for (int x = 0; x < w / 4; x++)
     {
       const int srcIdx = y * (w / 4) + x;
-      int       newVal = getValueFromSource(src, srcIdx * inValSkip, bps, bigEndian);
+      int       newVal = Format::read(src, srcIdx * Format::valueSkip);
 
       if (applyMath)
         newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
 
       if (shiftTo8Bit > 0)
         newVal = clip8Bit(newVal >> shiftTo8Bit);
-      if (!fullRange)
+      if constexpr (!Format::fullRange)
         newVal = videoHandler::convScaleLimitedRange(newVal);
 
       // Set the value as RGB for 4 pixels in this line and the next 3 lines (BGRA)
@@ -963,28 +1100,26 @@ inline void YUVPlaneToRGBMonochrome_410(const int                     w,
     }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGBMonochrome_411(const int                     componentSize,
                                         const MathParameters          math,
                                         const unsigned char *restrict src,
                                         unsigned char *restrict       dst,
                                         const int                     inMax,
-                                        const int                     bps,
-                                        const bool                    bigEndian,
-                                        const int                     inValSkip,
-                                        const bool                    fullRange)
+                                        const int                     bps)
 {
   // Horizontally U and V are subsampled by 4
   const bool applyMath   = math.mathRequired();
   const int  shiftTo8Bit = bps - 8;
   for (int i = 0; i < componentSize; ++i)
   {
-    int newVal = getValueFromSource(src, i * inValSkip, bps, bigEndian);
+    int newVal = Format::read(src, i * Format::valueSkip);
     if (applyMath)
       newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
 
     if (shiftTo8Bit > 0)
       newVal = clip8Bit(newVal >> shiftTo8Bit);
-    if (!fullRange)
+    if constexpr (!Format::fullRange)
       newVal = videoHandler::convScaleLimitedRange(newVal);
 
     // Set the value for R, G and B of 4 pixels (BGRA)
@@ -1165,6 +1300,7 @@ inline void UVPlaneResamplingChromaOffset(const PixelFormatYUV          format,
   }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGB_444(const int                     componentSize,
                               const MathParameters          mathY,
                               const MathParameters          mathC,
@@ -1173,20 +1309,17 @@ inline void YUVPlaneToRGB_444(const int                     componentSize,
                               const unsigned char *restrict srcV,
                               unsigned char *restrict       dst,
                               const int                     RGBConv[5],
-                              const bool                    fullRange,
                               const int                     inMax,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
+                              const int                     bps)
 {
   const bool applyMathLuma   = mathY.mathRequired();
   const bool applyMathChroma = mathC.mathRequired();
 
   for (int i = 0; i < componentSize; ++i)
   {
-    unsigned int valY = getValueFromSource(srcY, i, bps, bigEndian);
-    unsigned int valU = getValueFromSource(srcU, i * inValSkip, bps, bigEndian);
-    unsigned int valV = getValueFromSource(srcV, i * inValSkip, bps, bigEndian);
+    unsigned int valY = Format::read(srcY, i);
+    unsigned int valU = Format::read(srcU, i * Format::valueSkip);
+    unsigned int valV = Format::read(srcV, i * Format::valueSkip);
 
     if (applyMathLuma)
       valY = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY, inMax);
@@ -1198,7 +1331,7 @@ inline void YUVPlaneToRGB_444(const int                     componentSize,
 
     // Get the RGB values for this sample
     int valR, valG, valB;
-    convertYUVToRGB8Bit(valY, valU, valV, valR, valG, valB, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY, valU, valV, valR, valG, valB, RGBConv, bps);
 
     // Save the RGB values
     dst[i * 4]     = valB;
@@ -1208,6 +1341,7 @@ inline void YUVPlaneToRGB_444(const int                     componentSize,
   }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGB_422(const int                     w,
                               const int                     h,
                               const MathParameters          mathY,
@@ -1217,12 +1351,9 @@ inline void YUVPlaneToRGB_422(const int                     w,
                               const unsigned char *restrict srcV,
                               unsigned char *restrict       dst,
                               const int                     RGBConv[5],
-                              const bool                    fullRange,
                               const int                     inMax,
                               const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
+                              const int                     bps)
 {
   const bool applyMathLuma   = mathY.mathRequired();
   const bool applyMathChroma = mathC.mathRequired();
@@ -1230,8 +1361,8 @@ inline void YUVPlaneToRGB_422(const int                     w,
   for (int y = 0; y < h; y++)
   {
     const int srcIdxUV   = y * w / 2;
-    int       curUSample = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-    int       curVSample = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
+    int       curUSample = Format::read(srcU, srcIdxUV * Format::valueSkip);
+    int       curVSample = Format::read(srcV, srcIdxUV * Format::valueSkip);
     if (applyMathChroma)
     {
       curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
@@ -1242,8 +1373,8 @@ inline void YUVPlaneToRGB_422(const int                     w,
     {
       // Get the next U/V sample
       const int srcPosLineUV = srcIdxUV + x + 1;
-      int       nextUSample  = getValueFromSource(srcU, srcPosLineUV * inValSkip, bps, bigEndian);
-      int       nextVSample  = getValueFromSource(srcV, srcPosLineUV * inValSkip, bps, bigEndian);
+      int       nextUSample  = Format::read(srcU, srcPosLineUV * Format::valueSkip);
+      int       nextVSample  = Format::read(srcV, srcPosLineUV * Format::valueSkip);
       if (applyMathChroma)
       {
         nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
@@ -1255,8 +1386,8 @@ inline void YUVPlaneToRGB_422(const int                     w,
       int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
 
       // Get the 2 Y samples
-      int valY1 = getValueFromSource(srcY, y * w + x * 2, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, y * w + x * 2 + 1, bps, bigEndian);
+      int valY1 = Format::read(srcY, y * w + x * 2);
+      int valY2 = Format::read(srcY, y * w + x * 2 + 1);
       if (applyMathLuma)
       {
         valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1265,10 +1396,9 @@ inline void YUVPlaneToRGB_422(const int                     w,
 
       // Convert to 2 RGB values and save them (BGRA)
       int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(
-          valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(
-          valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, bps);
+      convertYUVToRGB8Bit<Format>(
+          valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, bps);
       const int pos = (y * w + x * 2) * 4;
       dst[pos]      = valB1;
       dst[pos + 1]  = valG1;
@@ -1288,8 +1418,8 @@ inline void YUVPlaneToRGB_422(const int                     w,
     // required either.
 
     // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (y + 1) * w - 2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y + 1) * w - 1, bps, bigEndian);
+    int valY1 = Format::read(srcY, (y + 1) * w - 2);
+    int valY2 = Format::read(srcY, (y + 1) * w - 1);
     if (applyMathLuma)
     {
       valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1298,10 +1428,8 @@ inline void YUVPlaneToRGB_422(const int                     w,
 
     // Convert to 2 RGB values and save them
     int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(
-        valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(
-        valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, bps);
+    convertYUVToRGB8Bit<Format>(valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, bps);
     const int pos = ((y + 1) * w) * 4;
     dst[pos - 8]  = valB1;
     dst[pos - 7]  = valG1;
@@ -1314,6 +1442,7 @@ inline void YUVPlaneToRGB_422(const int                     w,
   }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGB_440(const int                     w,
                               const int                     h,
                               const MathParameters          mathY,
@@ -1323,12 +1452,9 @@ inline void YUVPlaneToRGB_440(const int                     w,
                               const unsigned char *restrict srcV,
                               unsigned char *restrict       dst,
                               const int                     RGBConv[5],
-                              const bool                    fullRange,
                               const int                     inMax,
                               const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
+                              const int                     bps)
 {
   const bool applyMathLuma   = mathY.mathRequired();
   const bool applyMathChroma = mathC.mathRequired();
@@ -1336,8 +1462,8 @@ inline void YUVPlaneToRGB_440(const int                     w,
 
   for (int x = 0; x < w; x++)
   {
-    int curUSample = getValueFromSource(srcU, x * inValSkip, bps, bigEndian);
-    int curVSample = getValueFromSource(srcV, x * inValSkip, bps, bigEndian);
+    int curUSample = Format::read(srcU, x * Format::valueSkip);
+    int curVSample = Format::read(srcV, x * Format::valueSkip);
     if (applyMathChroma)
     {
       curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
@@ -1346,10 +1472,10 @@ inline void YUVPlaneToRGB_440(const int                     w,
 
     for (int y = 0; y < (h / 2) - 1; y++)
     {
-      // Get the next U/V sample
-      const int srcIdxUV    = y * w + x;
-      int       nextUSample = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-      int       nextVSample = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
+      // Get the U/V sample of the next line
+      const int srcIdxUV    = (y + 1) * w + x;
+      int       nextUSample = Format::read(srcU, srcIdxUV * Format::valueSkip);
+      int       nextVSample = Format::read(srcV, srcIdxUV * Format::valueSkip);
       if (applyMathChroma)
       {
         nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
@@ -1361,8 +1487,8 @@ inline void YUVPlaneToRGB_440(const int                     w,
       int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
 
       // Get the 2 Y samples
-      int valY1 = getValueFromSource(srcY, y * 2 * w + x, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, (y * 2 + 1) * w + x, bps, bigEndian);
+      int valY1 = Format::read(srcY, y * 2 * w + x);
+      int valY2 = Format::read(srcY, (y * 2 + 1) * w + x);
       if (applyMathLuma)
       {
         valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1371,10 +1497,9 @@ inline void YUVPlaneToRGB_440(const int                     w,
 
       // Convert to 2 RGB values and save them
       int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(
-          valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(
-          valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, bps);
+      convertYUVToRGB8Bit<Format>(
+          valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, bps);
       const int pos1 = (y * 2 * w + x) * 4;
       const int pos2 = pos1 + 4 * w;
       dst[pos1]      = valB1;
@@ -1395,8 +1520,8 @@ inline void YUVPlaneToRGB_440(const int                     w,
     // interpolation required either.
 
     // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (h - 2) * w + x, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (h - 1) * w + x, bps, bigEndian);
+    int valY1 = Format::read(srcY, (h - 2) * w + x);
+    int valY2 = Format::read(srcY, (h - 1) * w + x);
     if (applyMathLuma)
     {
       valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1405,10 +1530,8 @@ inline void YUVPlaneToRGB_440(const int                     w,
 
     // Convert to 2 RGB values and save them
     int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(
-        valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(
-        valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, bps);
+    convertYUVToRGB8Bit<Format>(valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, bps);
     const int pos1 = ((h - 2) * w + x) * 4;
     const int pos2 = pos1 + w * 4;
     dst[pos1]      = valB1;
@@ -1422,6 +1545,7 @@ inline void YUVPlaneToRGB_440(const int                     w,
   }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGB_420(const int                     w,
                               const int                     h,
                               const MathParameters          mathY,
@@ -1431,12 +1555,9 @@ inline void YUVPlaneToRGB_420(const int                     w,
                               const unsigned char *restrict srcV,
                               unsigned char *restrict       dst,
                               const int                     RGBConv[5],
-                              const bool                    fullRange,
                               const int                     inMax,
                               const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
+                              const int                     bps)
 {
   const bool applyMathLuma   = mathY.mathRequired();
   const bool applyMathChroma = mathC.mathRequired();
@@ -1449,10 +1570,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
     // Get the current U/V samples for this y line and the next one (_NL)
     const int srcIdxUV0 = y * wh;
     const int srcIdxUV1 = (y + 1) * wh;
-    int       curU      = getValueFromSource(srcU, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curV      = getValueFromSource(srcV, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curU_NL   = getValueFromSource(srcU, srcIdxUV1 * inValSkip, bps, bigEndian);
-    int       curV_NL   = getValueFromSource(srcV, srcIdxUV1 * inValSkip, bps, bigEndian);
+    int       curU      = Format::read(srcU, srcIdxUV0 * Format::valueSkip);
+    int       curV      = Format::read(srcV, srcIdxUV0 * Format::valueSkip);
+    int       curU_NL   = Format::read(srcU, srcIdxUV1 * Format::valueSkip);
+    int       curV_NL   = Format::read(srcV, srcIdxUV1 * Format::valueSkip);
     if (applyMathChroma)
     {
       curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
@@ -1466,10 +1587,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
       // Get the next U/V sample for this line and the next one
       const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
       const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
-      int       nextU         = getValueFromSource(srcU, srcIdxUVLine0 * inValSkip, bps, bigEndian);
-      int       nextV         = getValueFromSource(srcV, srcIdxUVLine0 * inValSkip, bps, bigEndian);
-      int       nextU_NL      = getValueFromSource(srcU, srcIdxUVLine1 * inValSkip, bps, bigEndian);
-      int       nextV_NL      = getValueFromSource(srcV, srcIdxUVLine1 * inValSkip, bps, bigEndian);
+      int       nextU         = Format::read(srcU, srcIdxUVLine0 * Format::valueSkip);
+      int       nextV         = Format::read(srcV, srcIdxUVLine0 * Format::valueSkip);
+      int       nextU_NL      = Format::read(srcU, srcIdxUVLine1 * Format::valueSkip);
+      int       nextV_NL      = Format::read(srcV, srcIdxUVLine1 * Format::valueSkip);
       if (applyMathChroma)
       {
         nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
@@ -1491,10 +1612,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
           interpolateUVSample2D(interpolation, curV, nextV, curV_NL, nextV_NL); // 2D interpolation
 
       // Get the 4 Y samples
-      int valY1 = getValueFromSource(srcY, (y * w + x) * 2, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, (y * w + x) * 2 + 1, bps, bigEndian);
-      int valY3 = getValueFromSource(srcY, (y * 2 + 1) * w + x * 2, bps, bigEndian);
-      int valY4 = getValueFromSource(srcY, (y * 2 + 1) * w + x * 2 + 1, bps, bigEndian);
+      int valY1 = Format::read(srcY, (y * w + x) * 2);
+      int valY2 = Format::read(srcY, (y * w + x) * 2 + 1);
+      int valY3 = Format::read(srcY, (y * 2 + 1) * w + x * 2);
+      int valY4 = Format::read(srcY, (y * 2 + 1) * w + x * 2 + 1);
       if (applyMathLuma)
       {
         valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1505,16 +1626,9 @@ inline void YUVPlaneToRGB_420(const int                     w,
 
       // Convert to 4 RGB values and save them
       int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(valY2,
-                          interpolatedU_Hor,
-                          interpolatedV_Hor,
-                          valR2,
-                          valG2,
-                          valB2,
-                          RGBConv,
-                          fullRange,
-                          bps);
+      convertYUVToRGB8Bit<Format>(valY1, curU, curV, valR1, valG1, valB1, RGBConv, bps);
+      convertYUVToRGB8Bit<Format>(
+          valY2, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, bps);
       const int pos1 = (y * 2 * w + x * 2) * 4;
       dst[pos1]      = valB1;
       dst[pos1 + 1]  = valG1;
@@ -1524,17 +1638,16 @@ inline void YUVPlaneToRGB_420(const int                     w,
       dst[pos1 + 5]  = valG2;
       dst[pos1 + 6]  = valR2;
       dst[pos1 + 7]  = 255;
-      convertYUVToRGB8Bit(valY3,
-                          interpolatedU_Ver,
-                          interpolatedV_Ver,
-                          valR1,
-                          valG1,
-                          valB1,
-                          RGBConv,
-                          fullRange,
-                          bps); // Second line
-      convertYUVToRGB8Bit(
-          valY4, interpolatedU_Bi, interpolatedV_Bi, valR2, valG2, valB2, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(valY3,
+                                  interpolatedU_Ver,
+                                  interpolatedV_Ver,
+                                  valR1,
+                                  valG1,
+                                  valB1,
+                                  RGBConv,
+                                  bps); // Second line
+      convertYUVToRGB8Bit<Format>(
+          valY4, interpolatedU_Bi, interpolatedV_Bi, valR2, valG2, valB2, RGBConv, bps);
       const int pos2 = pos1 + w * 4; // Next line
       dst[pos2]      = valB1;
       dst[pos2 + 1]  = valG1;
@@ -1559,10 +1672,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
     int interpolatedV_Ver = interpolateUVSample(interpolation, curV, curV_NL);
 
     // Get the 4 Y samples
-    int valY1 = getValueFromSource(srcY, (y * 2 + 1) * w - 2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y * 2 + 1) * w - 1, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y * 2 + 2) * w - 2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y * 2 + 2) * w - 1, bps, bigEndian);
+    int valY1 = Format::read(srcY, (y * 2 + 1) * w - 2);
+    int valY2 = Format::read(srcY, (y * 2 + 1) * w - 1);
+    int valY3 = Format::read(srcY, (y * 2 + 2) * w - 2);
+    int valY4 = Format::read(srcY, (y * 2 + 2) * w - 1);
     if (applyMathLuma)
     {
       valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1573,8 +1686,8 @@ inline void YUVPlaneToRGB_420(const int                     w,
 
     // Convert to 4 RGB values and save them
     int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(valY2, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY1, curU, curV, valR1, valG1, valB1, RGBConv, bps);
+    convertYUVToRGB8Bit<Format>(valY2, curU, curV, valR2, valG2, valB2, RGBConv, bps);
     const int pos1 = ((y * 2 + 1) * w) * 4;
     dst[pos1 - 8]  = valB1;
     dst[pos1 - 7]  = valG1;
@@ -1584,17 +1697,16 @@ inline void YUVPlaneToRGB_420(const int                     w,
     dst[pos1 - 3]  = valG2;
     dst[pos1 - 2]  = valR2;
     dst[pos1 - 1]  = 255;
-    convertYUVToRGB8Bit(valY3,
-                        interpolatedU_Ver,
-                        interpolatedV_Ver,
-                        valR1,
-                        valG1,
-                        valB1,
-                        RGBConv,
-                        fullRange,
-                        bps); // Second line
-    convertYUVToRGB8Bit(
-        valY4, interpolatedU_Ver, interpolatedV_Ver, valR2, valG2, valB2, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY3,
+                                interpolatedU_Ver,
+                                interpolatedV_Ver,
+                                valR1,
+                                valG1,
+                                valB1,
+                                RGBConv,
+                                bps); // Second line
+    convertYUVToRGB8Bit<Format>(
+        valY4, interpolatedU_Ver, interpolatedV_Ver, valR2, valG2, valB2, RGBConv, bps);
     const int pos2 = pos1 + w * 4; // Next line
     dst[pos2 - 8]  = valB1;
     dst[pos2 - 7]  = valG1;
@@ -1615,8 +1727,8 @@ inline void YUVPlaneToRGB_420(const int                     w,
 
   // Get 2 chroma samples from this line
   const int srcIdxUV = y * wh;
-  int       curU     = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-  int       curV     = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
+  int       curU     = Format::read(srcU, srcIdxUV * Format::valueSkip);
+  int       curV     = Format::read(srcV, srcIdxUV * Format::valueSkip);
   if (applyMathChroma)
   {
     curU = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
@@ -1627,8 +1739,8 @@ inline void YUVPlaneToRGB_420(const int                     w,
   {
     // Get the next U/V sample for this line and the next one
     const int srcIdxLineUV = srcIdxUV + x + 1;
-    int       nextU        = getValueFromSource(srcU, srcIdxLineUV * inValSkip, bps, bigEndian);
-    int       nextV        = getValueFromSource(srcV, srcIdxLineUV * inValSkip, bps, bigEndian);
+    int       nextU        = Format::read(srcU, srcIdxLineUV * Format::valueSkip);
+    int       nextV        = Format::read(srcV, srcIdxLineUV * Format::valueSkip);
     if (applyMathChroma)
     {
       nextU = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
@@ -1641,10 +1753,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
     int interpolatedV_Hor = interpolateUVSample(interpolation, curV, nextV);
 
     // Get the 4 Y samples
-    int valY1 = getValueFromSource(srcY, (y * w + x) * 2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y * w + x) * 2 + 1, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y2 + 1) * w + x * 2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y2 + 1) * w + x * 2 + 1, bps, bigEndian);
+    int valY1 = Format::read(srcY, (y * w + x) * 2);
+    int valY2 = Format::read(srcY, (y * w + x) * 2 + 1);
+    int valY3 = Format::read(srcY, (y2 + 1) * w + x * 2);
+    int valY4 = Format::read(srcY, (y2 + 1) * w + x * 2 + 1);
     if (applyMathLuma)
     {
       valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1655,9 +1767,9 @@ inline void YUVPlaneToRGB_420(const int                     w,
 
     // Convert to 4 RGB values and save them
     int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(
-        valY2, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY1, curU, curV, valR1, valG1, valB1, RGBConv, bps);
+    convertYUVToRGB8Bit<Format>(
+        valY2, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, bps);
     const int pos1 = (y2 * w + x * 2) * 4;
     dst[pos1]      = valB1;
     dst[pos1 + 1]  = valG1;
@@ -1667,10 +1779,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
     dst[pos1 + 5]  = valG2;
     dst[pos1 + 6]  = valR2;
     dst[pos1 + 7]  = 255;
-    convertYUVToRGB8Bit(
-        valY3, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps); // Second line
-    convertYUVToRGB8Bit(
-        valY4, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(
+        valY3, curU, curV, valR1, valG1, valB1, RGBConv, bps); // Second line
+    convertYUVToRGB8Bit<Format>(
+        valY4, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, bps);
     const int pos2 = pos1 + w * 4; // Next line
     dst[pos2]      = valB1;
     dst[pos2 + 1]  = valG1;
@@ -1690,10 +1802,10 @@ inline void YUVPlaneToRGB_420(const int                     w,
   // direction. Just sample and hold. No interpolation is required.
 
   // Get the 4 Y samples
-  int valY1 = getValueFromSource(srcY, (y2 + 1) * w - 2, bps, bigEndian);
-  int valY2 = getValueFromSource(srcY, (y2 + 1) * w - 1, bps, bigEndian);
-  int valY3 = getValueFromSource(srcY, (y2 + 2) * w - 2, bps, bigEndian);
-  int valY4 = getValueFromSource(srcY, (y2 + 2) * w - 1, bps, bigEndian);
+  int valY1 = Format::read(srcY, (y2 + 1) * w - 2);
+  int valY2 = Format::read(srcY, (y2 + 1) * w - 1);
+  int valY3 = Format::read(srcY, (y2 + 2) * w - 2);
+  int valY4 = Format::read(srcY, (y2 + 2) * w - 1);
   if (applyMathLuma)
   {
     valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1704,8 +1816,8 @@ inline void YUVPlaneToRGB_420(const int                     w,
 
   // Convert to 4 RGB values and save them
   int valR1, valR2, valG1, valG2, valB1, valB2;
-  convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-  convertYUVToRGB8Bit(valY2, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
+  convertYUVToRGB8Bit<Format>(valY1, curU, curV, valR1, valG1, valB1, RGBConv, bps);
+  convertYUVToRGB8Bit<Format>(valY2, curU, curV, valR2, valG2, valB2, RGBConv, bps);
   const int pos1 = (y2 + 1) * w * 4;
   dst[pos1 - 8]  = valB1;
   dst[pos1 - 7]  = valG1;
@@ -1715,9 +1827,8 @@ inline void YUVPlaneToRGB_420(const int                     w,
   dst[pos1 - 3]  = valG2;
   dst[pos1 - 2]  = valR2;
   dst[pos1 - 1]  = 255;
-  convertYUVToRGB8Bit(
-      valY3, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps); // Second line
-  convertYUVToRGB8Bit(valY4, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
+  convertYUVToRGB8Bit<Format>(valY3, curU, curV, valR1, valG1, valB1, RGBConv, bps); // Second line
+  convertYUVToRGB8Bit<Format>(valY4, curU, curV, valR2, valG2, valB2, RGBConv, bps);
   const int pos2 = pos1 + w * 4; // Next line
   dst[pos2 - 8]  = valB1;
   dst[pos2 - 7]  = valG1;
@@ -1729,6 +1840,7 @@ inline void YUVPlaneToRGB_420(const int                     w,
   dst[pos2 - 1]  = 255;
 }
 
+template <typename Format>
 inline void YUVPlaneToRGB_410(const int                     w,
                               const int                     h,
                               const MathParameters          mathY,
@@ -1738,31 +1850,28 @@ inline void YUVPlaneToRGB_410(const int                     w,
                               const unsigned char *restrict srcV,
                               unsigned char *restrict       dst,
                               const int                     RGBConv[5],
-                              const bool                    fullRange,
                               const int                     inMax,
                               const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
+                              const int                     bps)
 {
   const bool applyMathLuma   = mathY.mathRequired();
   const bool applyMathChroma = mathC.mathRequired();
-  // Format is YUV 4:1:0. Horizontal and vertical up-sampling is required. Process 4 Y positions of
-  // 2 lines at a time Horizontal subsampling by 4, vertical subsampling by 2
+  // Format is YUV 4:1:0. Horizontal and vertical up-sampling is required. Process 4x4 Y positions
+  // at a time. Horizontal subsampling by 4, vertical subsampling by 4.
   const int hq = h / 4; // The quarter values
   const int wq = w / 4;
 
   for (int y = 0; y < hq; y++)
   {
-    // Get the current U/V samples for this y line and the next one (_NL)
-    const int srcIdxUV0 = y * wq;
-    const int srcIdxUV1 = (y + 1) * wq;
-    int       curU      = getValueFromSource(srcU, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curV      = getValueFromSource(srcV, srcIdxUV0 * inValSkip, bps, bigEndian);
-    int       curU_NL =
-        (y < hq - 1) ? getValueFromSource(srcU, srcIdxUV1 * inValSkip, bps, bigEndian) : curU;
-    int curV_NL =
-        (y < hq - 1) ? getValueFromSource(srcV, srcIdxUV1 * inValSkip, bps, bigEndian) : curV;
+    // Get the current U/V samples for this y line and the next one (_NL). In the last line, there
+    // is no next line. Just sample and hold.
+    const bool hasNextLine = (y < hq - 1);
+    const int  srcIdxUV0   = y * wq;
+    const int  srcIdxUV1   = (y + 1) * wq;
+    int        curU        = Format::read(srcU, srcIdxUV0 * Format::valueSkip);
+    int        curV        = Format::read(srcV, srcIdxUV0 * Format::valueSkip);
+    int        curU_NL     = hasNextLine ? Format::read(srcU, srcIdxUV1 * Format::valueSkip) : curU;
+    int        curV_NL     = hasNextLine ? Format::read(srcV, srcIdxUV1 * Format::valueSkip) : curV;
     if (applyMathChroma)
     {
       curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
@@ -1775,25 +1884,27 @@ inline void YUVPlaneToRGB_410(const int                     w,
     {
       // We process 4*4 values per U/V value
 
-      // Get the next U/V sample for this line and the next one
-      const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
-      const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
-      int       nextU =
-          (x < wq - 1) ? getValueFromSource(srcU, srcIdxUVLine0 * inValSkip, bps, bigEndian) : curU;
-      int nextV =
-          (x < wq - 1) ? getValueFromSource(srcV, srcIdxUVLine0 * inValSkip, bps, bigEndian) : curV;
-      int nextU_NL = (x < wq - 1)
-                         ? getValueFromSource(srcU, srcIdxUVLine1 * inValSkip, bps, bigEndian)
-                         : curU_NL;
-      int nextV_NL = (x < wq - 1)
-                         ? getValueFromSource(srcV, srcIdxUVLine1 * inValSkip, bps, bigEndian)
-                         : curV_NL;
-      if (applyMathChroma)
+      // Get the next U/V sample for this line and the next one. In the last column, there is no
+      // next sample. Just sample and hold. The current samples are already transformed.
+      int nextU    = curU;
+      int nextV    = curV;
+      int nextU_NL = curU_NL;
+      int nextV_NL = curV_NL;
+      if (x < wq - 1)
       {
-        nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-        nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-        nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
-        nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
+        const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
+        const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
+        nextU    = Format::read(srcU, srcIdxUVLine0 * Format::valueSkip);
+        nextV    = Format::read(srcV, srcIdxUVLine0 * Format::valueSkip);
+        nextU_NL = hasNextLine ? Format::read(srcU, srcIdxUVLine1 * Format::valueSkip) : nextU;
+        nextV_NL = hasNextLine ? Format::read(srcV, srcIdxUVLine1 * Format::valueSkip) : nextV;
+        if (applyMathChroma)
+        {
+          nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
+          nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
+          nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
+          nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
+        }
       }
 
       // Now we interpolate and set the RGB values for the 4x4 pixels
@@ -1811,14 +1922,14 @@ inline void YUVPlaneToRGB_410(const int                     w,
           int U = interpolateUVSampleQ(interpolation, curU_INT, nextU_INT, xo);
           int V = interpolateUVSampleQ(interpolation, curV_INT, nextV_INT, xo);
           // Get the Y sample
-          int Y = getValueFromSource(srcY, (y * 4 + yo) * w + x * 4 + xo, bps, bigEndian);
+          int Y = Format::read(srcY, (y * 4 + yo) * w + x * 4 + xo);
           if (applyMathLuma)
             Y = transformYUV(mathY.invert, mathY.scale, mathY.offset, Y, inMax);
 
           // Convert to RGB and save (BGRA)
           int       R, G, B;
           const int pos = ((y * 4 + yo) * w + x * 4 + xo) * 4;
-          convertYUVToRGB8Bit(Y, U, V, R, G, B, RGBConv, fullRange, bps);
+          convertYUVToRGB8Bit<Format>(Y, U, V, R, G, B, RGBConv, bps);
           dst[pos]     = B;
           dst[pos + 1] = G;
           dst[pos + 2] = R;
@@ -1834,6 +1945,7 @@ inline void YUVPlaneToRGB_410(const int                     w,
   }
 }
 
+template <typename Format>
 inline void YUVPlaneToRGB_411(const int                     w,
                               const int                     h,
                               const MathParameters          mathY,
@@ -1843,12 +1955,9 @@ inline void YUVPlaneToRGB_411(const int                     w,
                               const unsigned char *restrict srcV,
                               unsigned char *restrict       dst,
                               const int                     RGBConv[5],
-                              const bool                    fullRange,
                               const int                     inMax,
                               const ChromaInterpolation     interpolation,
-                              const int                     bps,
-                              const bool                    bigEndian,
-                              const int                     inValSkip)
+                              const int                     bps)
 {
   // Chroma: quarter horizontal resolution
   const bool applyMathLuma   = mathY.mathRequired();
@@ -1858,8 +1967,8 @@ inline void YUVPlaneToRGB_411(const int                     w,
   for (int y = 0; y < h; y++)
   {
     const int srcIdxUV   = y * w / 4;
-    int       curUSample = getValueFromSource(srcU, srcIdxUV * inValSkip, bps, bigEndian);
-    int       curVSample = getValueFromSource(srcV, srcIdxUV * inValSkip, bps, bigEndian);
+    int       curUSample = Format::read(srcU, srcIdxUV * Format::valueSkip);
+    int       curVSample = Format::read(srcV, srcIdxUV * Format::valueSkip);
     if (applyMathChroma)
     {
       curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
@@ -1870,8 +1979,8 @@ inline void YUVPlaneToRGB_411(const int                     w,
     {
       // Get the next U/V sample
       const int srcIdxUVLine = srcIdxUV + x + 1;
-      int       nextUSample  = getValueFromSource(srcU, srcIdxUVLine * inValSkip, bps, bigEndian);
-      int       nextVSample  = getValueFromSource(srcV, srcIdxUVLine * inValSkip, bps, bigEndian);
+      int       nextUSample  = Format::read(srcU, srcIdxUVLine * Format::valueSkip);
+      int       nextVSample  = Format::read(srcV, srcIdxUVLine * Format::valueSkip);
       if (applyMathChroma)
       {
         nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
@@ -1887,10 +1996,10 @@ inline void YUVPlaneToRGB_411(const int                     w,
       int interpolatedV3 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 3);
 
       // Get the 4 Y samples
-      int valY1 = getValueFromSource(srcY, y * w + x * 4, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, y * w + x * 4 + 1, bps, bigEndian);
-      int valY3 = getValueFromSource(srcY, y * w + x * 4 + 2, bps, bigEndian);
-      int valY4 = getValueFromSource(srcY, y * w + x * 4 + 3, bps, bigEndian);
+      int valY1 = Format::read(srcY, y * w + x * 4);
+      int valY2 = Format::read(srcY, y * w + x * 4 + 1);
+      int valY3 = Format::read(srcY, y * w + x * 4 + 2);
+      int valY4 = Format::read(srcY, y * w + x * 4 + 3);
       if (applyMathLuma)
       {
         valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1902,25 +2011,25 @@ inline void YUVPlaneToRGB_411(const int                     w,
       // Convert to 4 RGB values and save them
       int       valR, valG, valB;
       const int pos = (y * w + x * 4) * 4;
-      convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
       dst[pos]     = valB;
       dst[pos + 1] = valG;
       dst[pos + 2] = valR;
       dst[pos + 3] = 255;
-      convertYUVToRGB8Bit(
-          valY2, interpolatedU1, interpolatedV1, valR, valG, valB, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(
+          valY2, interpolatedU1, interpolatedV1, valR, valG, valB, RGBConv, bps);
       dst[pos + 4] = valB;
       dst[pos + 5] = valG;
       dst[pos + 6] = valR;
       dst[pos + 7] = 255;
-      convertYUVToRGB8Bit(
-          valY3, interpolatedU2, interpolatedV2, valR, valG, valB, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(
+          valY3, interpolatedU2, interpolatedV2, valR, valG, valB, RGBConv, bps);
       dst[pos + 8]  = valB;
       dst[pos + 9]  = valG;
       dst[pos + 10] = valR;
       dst[pos + 11] = 255;
-      convertYUVToRGB8Bit(
-          valY4, interpolatedU3, interpolatedV3, valR, valG, valB, RGBConv, fullRange, bps);
+      convertYUVToRGB8Bit<Format>(
+          valY4, interpolatedU3, interpolatedV3, valR, valG, valB, RGBConv, bps);
       dst[pos + 12] = valB;
       dst[pos + 13] = valG;
       dst[pos + 14] = valR;
@@ -1935,10 +2044,10 @@ inline void YUVPlaneToRGB_411(const int                     w,
     // required either.
 
     // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (y + 1) * w - 4, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y + 1) * w - 3, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y + 1) * w - 2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y + 1) * w - 1, bps, bigEndian);
+    int valY1 = Format::read(srcY, (y + 1) * w - 4);
+    int valY2 = Format::read(srcY, (y + 1) * w - 3);
+    int valY3 = Format::read(srcY, (y + 1) * w - 2);
+    int valY4 = Format::read(srcY, (y + 1) * w - 1);
     if (applyMathLuma)
     {
       valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
@@ -1950,22 +2059,22 @@ inline void YUVPlaneToRGB_411(const int                     w,
     // Convert to 4 RGB values and save them
     int       valR, valG, valB;
     const int pos = ((y + 1) * w) * 4;
-    convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
     dst[pos - 16] = valB;
     dst[pos - 15] = valG;
     dst[pos - 14] = valR;
     dst[pos - 13] = 255;
-    convertYUVToRGB8Bit(valY2, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY2, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
     dst[pos - 12] = valB;
     dst[pos - 11] = valG;
     dst[pos - 10] = valR;
     dst[pos - 9]  = 255;
-    convertYUVToRGB8Bit(valY3, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY3, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
     dst[pos - 8] = valB;
     dst[pos - 7] = valG;
     dst[pos - 6] = valR;
     dst[pos - 5] = 255;
-    convertYUVToRGB8Bit(valY4, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
+    convertYUVToRGB8Bit<Format>(valY4, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
     dst[pos - 4] = valB;
     dst[pos - 3] = valG;
     dst[pos - 2] = valR;
@@ -1973,6 +2082,64 @@ inline void YUVPlaneToRGB_411(const int                     w,
   }
 }
 
+template <BitDepthClass BitDepth, bool BigEndian, int ValueSkip, typename Function>
+bool dispatchFullRange(const bool fullRange, Function &function)
+{
+  if (fullRange)
+    return function(PlanarFormat<BitDepth, BigEndian, ValueSkip, true>());
+  return function(PlanarFormat<BitDepth, BigEndian, ValueSkip, false>());
+}
+
+template <BitDepthClass BitDepth, bool BigEndian, typename Function>
+bool dispatchValueSkip(const int valueSkip, const bool fullRange, Function &function)
+{
+  switch (valueSkip)
+  {
+  case 1:
+    return dispatchFullRange<BitDepth, BigEndian, 1>(fullRange, function);
+  case 2:
+    return dispatchFullRange<BitDepth, BigEndian, 2>(fullRange, function);
+  case 3:
+    return dispatchFullRange<BitDepth, BigEndian, 3>(fullRange, function);
+  default:
+    return false;
+  }
+}
+
+template <BitDepthClass BitDepth, typename Function>
+bool dispatchEndianness(const bool bigEndian,
+                        const int  valueSkip,
+                        const bool fullRange,
+                        Function & function)
+{
+  // The endianness does not matter for one byte per sample
+  if constexpr (BitDepth == BitDepthClass::EightBit)
+    return dispatchValueSkip<BitDepth, false>(valueSkip, fullRange, function);
+  else if (bigEndian)
+    return dispatchValueSkip<BitDepth, true>(valueSkip, fullRange, function);
+  else
+    return dispatchValueSkip<BitDepth, false>(valueSkip, fullRange, function);
+}
+
+// Call the function with the PlanarFormat that matches the given runtime parameters. This selects
+// the instance of the conversion kernels once per frame. Returns false if the format is not
+// supported.
+template <typename Function>
+bool dispatchPlanarFormat(const int  bps,
+                          const bool bigEndian,
+                          const int  valueSkip,
+                          const bool fullRange,
+                          Function   function)
+{
+  if (bps <= 8)
+    return dispatchEndianness<BitDepthClass::EightBit>(bigEndian, valueSkip, fullRange, function);
+  if (bps <= 14)
+    return dispatchEndianness<BitDepthClass::UpTo14Bit>(bigEndian, valueSkip, fullRange, function);
+  if (bps <= 16)
+    return dispatchEndianness<BitDepthClass::Above14Bit>(bigEndian, valueSkip, fullRange, function);
+  return false;
+}
+
 bool convertYUVPlanarToRGB(const QByteArray &        sourceBuffer,
                            uchar *                   targetBuffer,
                            const Size                curFrameSize,
@@ -2022,347 +2189,213 @@ bool convertYUVPlanarToRGB(const QByteArray &        sourceBuffer,
   // A pointer to the output
   unsigned char *restrict dst = targetBuffer;
 
-  if (component != ComponentDisplayMode::DisplayAll ||
-      format.getSubsampling() == Subsampling::YUV_400)
+  const auto subsampling = format.getSubsampling();
+  const auto bigEndian   = format.isBigEndian();
+
+  if (component != ComponentDisplayMode::DisplayAll || subsampling == Subsampling::YUV_400)
   {
     // We only display (or there is only) one of the color components (possibly with YUV math)
-    if (component == ComponentDisplayMode::DisplayY ||
-        format.getSubsampling() == Subsampling::YUV_400)
+    if (component == ComponentDisplayMode::DisplayY || subsampling == Subsampling::YUV_400)
     {
       // Luma only. The chroma subsampling does not matter.
       const unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
-      YUVPlaneToRGBMonochrome_444(
-          componentSizeLuma, mathY, srcY, dst, inputMax, bps, format.isBigEndian(), 1, fullRange);
+      return dispatchPlanarFormat(bps, bigEndian, 1, fullRange, [&](auto planarFormat) {
+        YUVPlaneToRGBMonochrome_444<decltype(planarFormat)>(
+            componentSizeLuma, mathY, srcY, dst, inputMax, bps);
+        return true;
+      });
     }
-    else
-    {
-      // Display only the U or V component
-      bool firstComponent = (((format.getPlaneOrder() == PlaneOrder::YUV ||
-                               format.getPlaneOrder() == PlaneOrder::YUVA) &&
-                              component == ComponentDisplayMode::DisplayCb) ||
-                             ((format.getPlaneOrder() == PlaneOrder::YVU ||
-                               format.getPlaneOrder() == PlaneOrder::YVUA) &&
-                              component == ComponentDisplayMode::DisplayCr));
-
-      int srcOffset = nrBytesLumaPlane;
-      if (!firstComponent)
-      {
-        if (format.isUVInterleaved())
-          srcOffset += (bps > 8) ? 2 : 1;
-        else
-          srcOffset += nrBytesChromaPlane;
-      }
 
-      const unsigned char *restrict srcC = (unsigned char *)sourceBuffer.data() + srcOffset;
-      if (format.getSubsampling() == Subsampling::YUV_444)
-        YUVPlaneToRGBMonochrome_444(componentSizeChroma,
-                                    mathC,
-                                    srcC,
-                                    dst,
-                                    inputMax,
-                                    bps,
-                                    format.isBigEndian(),
-                                    inputValSkip,
-                                    fullRange);
-      else if (format.getSubsampling() == Subsampling::YUV_422)
-        YUVPlaneToRGBMonochrome_422(componentSizeChroma,
-                                    mathC,
-                                    srcC,
-                                    dst,
-                                    inputMax,
-                                    bps,
-                                    format.isBigEndian(),
-                                    inputValSkip,
-                                    fullRange);
-      else if (format.getSubsampling() == Subsampling::YUV_420)
-        YUVPlaneToRGBMonochrome_420(
-            w, h, mathC, srcC, dst, inputMax, bps, format.isBigEndian(), inputValSkip, fullRange);
-      else if (format.getSubsampling() == Subsampling::YUV_440)
-        YUVPlaneToRGBMonochrome_440(
-            w, h, mathC, srcC, dst, inputMax, bps, format.isBigEndian(), inputValSkip, fullRange);
-      else if (format.getSubsampling() == Subsampling::YUV_410)
-        YUVPlaneToRGBMonochrome_410(
-            w, h, mathC, srcC, dst, inputMax, bps, format.isBigEndian(), inputValSkip, fullRange);
-      else if (format.getSubsampling() == Subsampling::YUV_411)
-        YUVPlaneToRGBMonochrome_411(componentSizeChroma,
-                                    mathC,
-                                    srcC,
-                                    dst,
-                                    inputMax,
-                                    bps,
-                                    format.isBigEndian(),
-                                    inputValSkip,
-                                    fullRange);
+    // Display only the U or V component
+    bool firstComponent = (((format.getPlaneOrder() == PlaneOrder::YUV ||
+                             format.getPlaneOrder() == PlaneOrder::YUVA) &&
+                            component == ComponentDisplayMode::DisplayCb) ||
+                           ((format.getPlaneOrder() == PlaneOrder::YVU ||
+                             format.getPlaneOrder() == PlaneOrder::YVUA) &&
+                            component == ComponentDisplayMode::DisplayCr));
+
+    int srcOffset = nrBytesLumaPlane;
+    if (!firstComponent)
+    {
+      if (format.isUVInterleaved())
+        srcOffset += (bps > 8) ? 2 : 1;
       else
-        return false;
+        srcOffset += nrBytesChromaPlane;
     }
-  }
-  else
-  {
-    // Is the U plane the first or the second?
-    const bool uPlaneFirst =
-        (format.getPlaneOrder() == PlaneOrder::YUV || format.getPlaneOrder() == PlaneOrder::YUVA);
-
-    // In case the U and V (and A if present) components are interleaved, the skip to the next plane
-    // is just 1 (or 2) bytes
-    int nrBytesToNextChromaPlane = nrBytesChromaPlane;
-    if (format.isUVInterleaved())
-      nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
-
-    // Get/set the parameters used for YUV -> RGB conversion
-    int RGBConv[5];
-    getColorConversionCoefficients(conversion, RGBConv);
-
-    // We are displaying all components, so we have to perform conversion to RGB (possibly including
-    // interpolation and YUV math)
-    if (format.getSubsampling() != Subsampling::YUV_400 &&
-        (format.getChromaOffset().x != 0 || format.getChromaOffset().y != 0) &&
-        interpolation != ChromaInterpolation::NearestNeighbor)
-    {
-      // If there is a chroma offset, we must resample the chroma components before we convert them
-      // to RGB. If so, the resampled chroma values are saved in these arrays. We only ignore the
-      // chroma offset for other interpolations then nearest neighbor.
-      QByteArray uvPlaneChromaResampled[2];
-      uvPlaneChromaResampled[0].resize(nrBytesChromaPlane);
-      uvPlaneChromaResampled[1].resize(nrBytesChromaPlane);
-
-      // We have to perform pre-filtering for the U and V positions, because there is an offset
-      // between the pixel positions of Y and U/V
-      unsigned char *restrict dstU = (unsigned char *)uvPlaneChromaResampled[0].data();
-      unsigned char *restrict dstV = (unsigned char *)uvPlaneChromaResampled[1].data();
-
-      unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
-      unsigned char *restrict srcU = uPlaneFirst
-                                         ? srcY + nrBytesLumaPlane
-                                         : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      unsigned char *restrict srcV = uPlaneFirst
-                                         ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
-                                         : srcY + nrBytesLumaPlane;
-
-      UVPlaneResamplingChromaOffset(format,
-                                    w / format.getSubsamplingHor(),
-                                    h / format.getSubsamplingVer(),
-                                    srcU,
-                                    srcV,
-                                    inputValSkip,
-                                    dstU,
-                                    dstV);
-
-      if (format.getSubsampling() == Subsampling::YUV_444)
-        YUVPlaneToRGB_444(componentSizeLuma,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_422)
-        YUVPlaneToRGB_422(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_420)
-        YUVPlaneToRGB_420(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_440)
-        YUVPlaneToRGB_440(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_410)
-        YUVPlaneToRGB_410(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
-      else if (format.getSubsampling() == Subsampling::YUV_411)
-        YUVPlaneToRGB_411(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          dstU,
-                          dstV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          1);
+
+    const unsigned char *restrict srcC = (unsigned char *)sourceBuffer.data() + srcOffset;
+    return dispatchPlanarFormat(bps, bigEndian, inputValSkip, fullRange, [&](auto planarFormat) {
+      using Format = decltype(planarFormat);
+      if (subsampling == Subsampling::YUV_444)
+        YUVPlaneToRGBMonochrome_444<Format>(componentSizeChroma, mathC, srcC, dst, inputMax, bps);
+      else if (subsampling == Subsampling::YUV_422)
+        YUVPlaneToRGBMonochrome_422<Format>(componentSizeChroma, mathC, srcC, dst, inputMax, bps);
+      else if (subsampling == Subsampling::YUV_420)
+        YUVPlaneToRGBMonochrome_420<Format>(w, h, mathC, srcC, dst, inputMax, bps);
+      else if (subsampling == Subsampling::YUV_440)
+        YUVPlaneToRGBMonochrome_440<Format>(w, h, mathC, srcC, dst, inputMax, bps);
+      else if (subsampling == Subsampling::YUV_410)
+        YUVPlaneToRGBMonochrome_410<Format>(w, h, mathC, srcC, dst, inputMax, bps);
+      else if (subsampling == Subsampling::YUV_411)
+        YUVPlaneToRGBMonochrome_411<Format>(componentSizeChroma, mathC, srcC, dst, inputMax, bps);
       else
         return false;
-    }
-    else
-    {
-      // Get the pointers to the source planes (8 bit per sample)
-      const unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
-      const unsigned char *restrict srcU = uPlaneFirst
-                                               ? srcY + nrBytesLumaPlane
-                                               : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      const unsigned char *restrict srcV = uPlaneFirst
-                                               ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
-                                               : srcY + nrBytesLumaPlane;
-
-      if (format.getSubsampling() == Subsampling::YUV_444)
-        YUVPlaneToRGB_444(componentSizeLuma,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_422)
-        YUVPlaneToRGB_422(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_420)
-        YUVPlaneToRGB_420(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_440)
-        YUVPlaneToRGB_440(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_410)
-        YUVPlaneToRGB_410(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_411)
-        YUVPlaneToRGB_411(w,
-                          h,
-                          mathY,
-                          mathC,
-                          srcY,
-                          srcU,
-                          srcV,
-                          dst,
-                          RGBConv,
-                          fullRange,
-                          inputMax,
-                          interpolation,
-                          bps,
-                          format.isBigEndian(),
-                          inputValSkip);
-      else if (format.getSubsampling() == Subsampling::YUV_400)
-        YUVPlaneToRGBMonochrome_444(
-            componentSizeLuma, mathY, srcY, dst, fullRange, inputMax, bps, format.isBigEndian(), 1);
+      return true;
+    });
+  }
+
+  // Is the U plane the first or the second?
+  const bool uPlaneFirst =
+      (format.getPlaneOrder() == PlaneOrder::YUV || format.getPlaneOrder() == PlaneOrder::YUVA);
+
+  // In case the U and V (and A if present) components are interleaved, the skip to the next plane
+  // is just 1 (or 2) bytes
+  int nrBytesToNextChromaPlane = nrBytesChromaPlane;
+  if (format.isUVInterleaved())
+    nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
+
+  // Get/set the parameters used for YUV -> RGB conversion
+  int RGBConv[5];
+  getColorConversionCoefficients(conversion, RGBConv);
+
+  // We are displaying all components, so we have to perform conversion to RGB (possibly including
+  // interpolation and YUV math)
+  auto convertPlanesToRGB = [&](const unsigned char *restrict srcY,
+                                const unsigned char *restrict srcU,
+                                const unsigned char *restrict srcV,
+                                const int                     valueSkip) {
+    return dispatchPlanarFormat(bps, bigEndian, valueSkip, fullRange, [&](auto planarFormat) {
+      using Format = decltype(planarFormat);
+      if (subsampling == Subsampling::YUV_444)
+        YUVPlaneToRGB_444<Format>(
+            componentSizeLuma, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, bps);
+      else if (subsampling == Subsampling::YUV_422)
+        YUVPlaneToRGB_422<Format>(
+            w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, interpolation, bps);
+      else if (subsampling == Subsampling::YUV_420)
+        YUVPlaneToRGB_420<Format>(
+            w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, interpolation, bps);
+      else if (subsampling == Subsampling::YUV_440)
+        YUVPlaneToRGB_440<Format>(
+            w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, interpolation, bps);
+      else if (subsampling == Subsampling::YUV_410)
+        YUVPlaneToRGB_410<Format>(
+            w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, interpolation, bps);
+      else if (subsampling == Subsampling::YUV_411)
+        YUVPlaneToRGB_411<Format>(
+            w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, interpolation, bps);
       else
         return false;
-    }
+      return true;
+    });
+  };
+
+  if ((format.getChromaOffset().x != 0 || format.getChromaOffset().y != 0) &&
+      interpolation != ChromaInterpolation::NearestNeighbor)
+  {
+    // If there is a chroma offset, we must resample the chroma components before we convert them
+    // to RGB. If so, the resampled chroma values are saved in these arrays. We only ignore the
+    // chroma offset for other interpolations then nearest neighbor.
+    QByteArray uvPlaneChromaResampled[2];
+    uvPlaneChromaResampled[0].resize(nrBytesChromaPlane);
+    uvPlaneChromaResampled[1].resize(nrBytesChromaPlane);
+
+    // We have to perform pre-filtering for the U and V positions, because there is an offset
+    // between the pixel positions of Y and U/V
+    unsigned char *restrict dstU = (unsigned char *)uvPlaneChromaResampled[0].data();
+    unsigned char *restrict dstV = (unsigned char *)uvPlaneChromaResampled[1].data();
+
+    unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
+    unsigned char *restrict srcU = uPlaneFirst
+                                       ? srcY + nrBytesLumaPlane
+                                       : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
+    unsigned char *restrict srcV = uPlaneFirst
+                                       ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
+                                       : srcY + nrBytesLumaPlane;
+
+    UVPlaneResamplingChromaOffset(format,
+                                  w / format.getSubsamplingHor(),
+                                  h / format.getSubsamplingVer(),
+                                  srcU,
+                                  srcV,
+                                  inputValSkip,
+                                  dstU,
+                                  dstV);
+
+    // The resampled chroma planes are not interleaved
+    return convertPlanesToRGB(srcY, dstU, dstV, 1);
+  }
+
+  // Get the pointers to the source planes (8 bit per sample)
+  const unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
+  const unsigned char *restrict srcU = uPlaneFirst
+                                           ? srcY + nrBytesLumaPlane
+                                           : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
+  const unsigned char *restrict srcV = uPlaneFirst
+                                           ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane
+                                           : srcY + nrBytesLumaPlane;
+  return convertPlanesToRGB(srcY, srcU, srcV, inputValSkip);
+}
+
+// Check if packed data in the given format can be converted to RGB line by line. This is only
+// possible if the conversion of a line does not depend on the neighboring lines. Interpolated
+// chroma samples with an offset are resampled in both directions first, which needs the whole
+// frame.
+bool canConvertPackedLineByLine(const PixelFormatYUV &    format,
+                                const ConversionSettings &conversionSettings)
+{
+  const auto subsampling = format.getSubsampling();
+  if (subsampling != Subsampling::YUV_422 && subsampling != Subsampling::YUV_444)
+    return false;
+  if (format.isBytePacking() && !format.getPredefinedFormat() &&
+      !(subsampling == Subsampling::YUV_422 && format.getBitsPerSample() == 10))
+    return false;
+
+  const auto chromaOffset = format.getChromaOffset();
+  return conversionSettings.chromaInterpolation == ChromaInterpolation::NearestNeighbor ||
+         (chromaOffset.x == 0 && chromaOffset.y == 0);
+}
+
+// Convert packed YUV data (including predefined formats like V210) to RGB without a planar copy
+// of the whole frame. Each line is unpacked into a small planar line buffer which is converted
+// right away while it is still in the cache.
+bool convertYUVPackedToRGB(const QByteArray &        sourceBuffer,
+                           unsigned char *           targetBuffer,
+                           const Size                curFrameSize,
+                           const PixelFormatYUV &    format,
+                           const ConversionSettings &conversionSettings)
+{
+  const auto w = curFrameSize.width;
+  const auto h = curFrameSize.height;
+
+  const auto lineSize   = Size(w, 1u);
+  const auto lineFormat = getUnpackedPlanarFormat(format);
+  const auto strideIn   = format.bytesPerFrame(lineSize);
+  const auto bps        = (lineFormat.getBitsPerSample() > 8) ? 2u : 1u;
+  if (strideIn <= 0 || sourceBuffer.size() < strideIn * h)
+    return false;
+
+  QByteArray lineBuffer;
+  lineBuffer.resize(int(lineFormat.bytesPerFrame(lineSize)));
+  auto lineY = (unsigned char *)lineBuffer.data();
+  auto lineU = lineY + w * bps;
+  auto lineV = lineU + w / lineFormat.getSubsamplingHor() * bps;
+
+  const unsigned char *restrict src = (unsigned char *)sourceBuffer.data();
+  for (unsigned y = 0; y < h; y++)
+  {
+    if (!unpackPackedSamples(src + y * strideIn, w, format, lineY, lineU, lineV))
+      return false;
+    if (!convertYUVPlanarToRGB(
+            lineBuffer, targetBuffer + size_t(y) * w * 4, lineSize, lineFormat, conversionSettings))
+      return false;
   }
 
   return true;
 }
 
-// Convert the given raw YUV data in sourceBuffer (using srcPixelFormat) to image (RGB-888), using
-// the buffer tmpRGBBuffer for intermediate RGB values.
+} // namespace
+
 void convertYUVToImage(const QByteArray &        sourceBuffer,
                        QImage &                  outputImage,
                        const PixelFormatYUV &    yuvFormat,
@@ -2384,15 +2417,16 @@ void convertYUVToImage(const QByteArray &        sourceBuffer,
   // be multiple of 4)
   auto qFrameSize          = QSize(int(curFrameSize.width), int(curFrameSize.height));
   auto platformImageFormat = functionsGui::platformImageFormat(yuvFormat.hasAlpha());
+  auto &pool               = FrameBufferPool::instance();
   if (is_Q_OS_WIN || is_Q_OS_MAC)
-    outputImage = QImage(qFrameSize, platformImageFormat);
+    outputImage = pool.getImage(qFrameSize, platformImageFormat);
   else if (is_Q_OS_LINUX)
   {
     if (platformImageFormat == QImage::Format_ARGB32_Premultiplied ||
         platformImageFormat == QImage::Format_ARGB32)
-      outputImage = QImage(qFrameSize, platformImageFormat);
+      outputImage = pool.getImage(qFrameSize, platformImageFormat);
     else
-      outputImage = QImage(qFrameSize, QImage::Format_RGB32);
+      outputImage = pool.getImage(qFrameSize, QImage::Format_RGB32);
   }
 
   // Check the image buffer size before we write to it
@@ -2429,24 +2463,17 @@ void convertYUVToImage(const QByteArray &        sourceBuffer,
       convOK = convertYUVPlanarToRGB(
           sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat, conversionSettings);
   }
+  else if (canConvertPackedLineByLine(yuvFormat, conversionSettings))
+    convOK = convertYUVPackedToRGB(
+        sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat, conversionSettings);
   else
   {
     // Convert to a planar format first
     QByteArray tmpPlanarYUVSource;
     // This is the current format of the buffer. The conversion function will change this.
     PixelFormatYUV newPixelFormat;
-
-    if (auto predefinedFormat = yuvFormat.getPredefinedFormat())
-    {
-      if (*predefinedFormat == PredefinedPixelFormat::V210)
-        std::tie(convOK, newPixelFormat) =
-            convertV210PackedToPlanar(sourceBuffer, tmpPlanarYUVSource, curFrameSize);
-      else
-        convOK = false;
-    }
-    else
-      std::tie(convOK, newPixelFormat) =
-          convertYUVPackedToPlanar(sourceBuffer, tmpPlanarYUVSource, curFrameSize, yuvFormat);
+    std::tie(convOK, newPixelFormat) =
+        convertToPlanarYUV(sourceBuffer, tmpPlanarYUVSource, curFrameSize, yuvFormat);
 
     if (convOK)
       convOK &= convertYUVPlanarToRGB(
@@ -2468,9 +2495,25 @@ void convertYUVToImage(const QByteArray &        sourceBuffer,
   DEBUG_YUV("videoHandlerYUV::convertYUVToImage Done");
 }
 
-} // namespace
+std::pair<bool, PixelFormatYUV> convertToPlanarYUV(const QByteArray &    sourceBuffer,
+                                                   QByteArray &          targetBuffer,
+                                                   const Size            curFrameSize,
+                                                   const PixelFormatYUV &format)
+{
+  if (auto predefinedFormat = format.getPredefinedFormat())
+  {
+    if (*predefinedFormat == PredefinedPixelFormat::V210)
+      return convertV210PackedToPlanar(sourceBuffer, targetBuffer, curFrameSize);
+    return {false, format};
+  }
+  if (!format.isPlanar())
+    return convertYUVPackedToPlanar(sourceBuffer, targetBuffer, curFrameSize, format);
+
+  targetBuffer = sourceBuffer;
+  return {true, format};
+}
 
-videoHandlerYUV::videoHandlerYUV() : videoHandler()
+videoHandlerYUV::videoHandlerYUV() : videoHandler(), tileCache(TILE_CACHE_MAX_BYTES)
 {
   // Set the default YUV transformation parameters.
   this->conversionSettings.mathParameters[Component::Luma]   = MathParameters(1, 125, false);
@@ -2527,10 +2570,211 @@ void videoHandlerYUV::drawFrame(QPainter *painter,
     // Draw the text
     painter->drawText(textRect, QString::fromStdString(msg));
   }
+  else if (this->useTiledConversion() && this->currentFrameRawData_frameIndex == frameIdx)
+    this->drawFrameTiled(painter, frameIdx, zoomFactor, drawRawData);
   else
     videoHandler::drawFrame(painter, frameIdx, zoomFactor, drawRawData);
 }
 
+ItemLoadingState videoHandlerYUV::needsLoading(int frameIndex, bool loadRawValues)
+{
+  if (this->useTiledConversion())
+    // There is no double buffer. Only the raw data of the frame is needed.
+    return this->needsLoadingRawValues(frameIndex);
+  return videoHandler::needsLoading(frameIndex, loadRawValues);
+}
+
+void videoHandlerYUV::invalidateAllBuffers()
+{
+  this->tileCache.clear();
+  videoHandler::invalidateAllBuffers();
+}
+
+QImage videoHandlerYUV::getCurrentFrameAsImage()
+{
+  this->convertCurrentFrameIfTiled();
+  return videoHandler::getCurrentFrameAsImage();
+}
+
+std::function<void(QPainter *, double)> videoHandlerYUV::getFrameDrawFunction(int  frameIndex,
+                                                                              bool caching)
+{
+  if (!caching && frameIndex == this->currentFrameRawData_frameIndex)
+    this->convertCurrentFrameIfTiled();
+  return videoHandler::getFrameDrawFunction(frameIndex, caching);
+}
+
+QRgb videoHandlerYUV::getPixelVal(int x, int y)
+{
+  this->convertCurrentFrameIfTiled();
+  return videoHandler::getPixelVal(x, y);
+}
+
+void videoHandlerYUV::convertCurrentFrameIfTiled()
+{
+  if (!this->useTiledConversion() || this->currentFrameRawData_frameIndex == -1 ||
+      this->currentFrameRawData_frameIndex == this->currentImageIndex)
+    return;
+
+  DEBUG_YUV("videoHandlerYUV::convertCurrentFrameIfTiled "
+            << this->currentFrameRawData_frameIndex);
+
+  QByteArray rawData;
+  int        frameIndex;
+  {
+    QMutexLocker locker(&this->requestDataMutex);
+    rawData    = this->currentFrameRawData;
+    frameIndex = this->currentFrameRawData_frameIndex;
+  }
+
+  QImage image;
+  convertYUVToImage(
+      rawData, image, this->srcPixelFormat, this->frameSize, this->conversionSettings);
+
+  QMutexLocker imageLock(&this->currentImageSetMutex);
+  this->currentImage      = image;
+  this->currentImageIndex = frameIndex;
+}
+
+bool videoHandlerYUV::useTiledConversion() const
+{
+  return this->srcPixelFormat.isPlanar() && !this->srcPixelFormat.getPredefinedFormat() &&
+         !this->srcPixelFormat.hasAlpha() &&
+         size_t(this->frameSize.width) * this->frameSize.height >= TILED_CONVERSION_MIN_PIXELS;
+}
+
+QString videoHandlerYUV::getTileSettings() const
+{
+  auto settings = QString("%1;%2x%3;%4;%5;%6")
+                      .arg(QString::fromStdString(this->srcPixelFormat.getName()))
+                      .arg(this->frameSize.width)
+                      .arg(this->frameSize.height)
+                      .arg(int(this->conversionSettings.chromaInterpolation))
+                      .arg(int(this->conversionSettings.componentDisplayMode))
+                      .arg(int(this->conversionSettings.colorConversion));
+  for (const auto &[component, parameters] : this->conversionSettings.mathParameters)
+    settings += QString(";%1:%2,%3,%4")
+                    .arg(int(component))
+                    .arg(parameters.scale)
+                    .arg(parameters.offset)
+                    .arg(parameters.invert);
+  return settings;
+}
+
+void videoHandlerYUV::drawFrameTiled(QPainter *painter,
+                                     int       frameIdx,
+                                     double    zoomFactor,
+                                     bool      drawRawData)
+{
+  DEBUG_YUV("videoHandlerYUV::drawFrameTiled " << frameIdx);
+
+  QRect videoRect;
+  videoRect.setSize(QSize(frameSize.width * zoomFactor, frameSize.height * zoomFactor));
+  videoRect.moveCenter(QPoint(0, 0));
+
+  // Determine which part of the frame is visible (in item coordinates)
+  auto visibleRect = painter->worldTransform().inverted().mapRect(QRectF(painter->viewport()));
+  if (painter->hasClipping())
+    visibleRect &= painter->clipBoundingRect();
+  visibleRect &= QRectF(videoRect);
+  if (visibleRect.isEmpty())
+    return;
+
+  // When zoomed out, the tiles are converted from a downscaled version of the frame so that one
+  // tile pixel is never drawn smaller than half a screen pixel.
+  unsigned level = 0;
+  if (zoomFactor < 0.5)
+    level = std::min(unsigned(std::floor(std::log2(1.0 / zoomFactor))), TILE_MAX_LEVEL);
+  const auto tileFramePixels = TILE_SIZE << level;
+
+  // Get the index of the tile at the given position (in item coordinates)
+  const auto getTileIndex = [&](double pos, int videoRectStart, unsigned size) {
+    const auto framePos = std::max(std::floor((pos - videoRectStart) / zoomFactor), 0.0);
+    return std::min(unsigned(framePos), size - 1) / tileFramePixels;
+  };
+  const auto firstTileX = getTileIndex(visibleRect.left(), videoRect.left(), frameSize.width);
+  const auto lastTileX  = getTileIndex(visibleRect.right(), videoRect.left(), frameSize.width);
+  const auto firstTileY = getTileIndex(visibleRect.top(), videoRect.top(), frameSize.height);
+  const auto lastTileY  = getTileIndex(visibleRect.bottom(), videoRect.top(), frameSize.height);
+
+  struct Tile
+  {
+    TileKey key;
+    // The position in the frame and the size of the tile image
+    unsigned x, y;
+    Size     size;
+    QImage   image;
+  };
+
+  // The tile sizes must be a multiple of the subsampling. At the right and bottom border of the
+  // frame, a few pixels may be skipped when the tiles are downscaled.
+  const auto subH     = unsigned(this->srcPixelFormat.getSubsamplingHor());
+  const auto subV     = unsigned(this->srcPixelFormat.getSubsamplingVer());
+  const auto settings = this->getTileSettings();
+
+  std::vector<Tile> tiles;
+  auto              nrMissingTiles = 0;
+  for (auto tileY = firstTileY; tileY <= lastTileY; tileY++)
+  {
+    for (auto tileX = firstTileX; tileX <= lastTileX; tileX++)
+    {
+      Tile tile;
+      tile.key = {frameIdx, level, tileX, tileY, settings};
+      tile.x   = tileX * tileFramePixels;
+      tile.y   = tileY * tileFramePixels;
+
+      const auto width  = std::min(TILE_SIZE, (frameSize.width - tile.x) >> level) / subH * subH;
+      const auto height = std::min(TILE_SIZE, (frameSize.height - tile.y) >> level) / subV * subV;
+      if (width == 0 || height == 0)
+        continue;
+
+      tile.size  = Size(width, height);
+      tile.image = this->tileCache.get(tile.key);
+      if (tile.image.isNull())
+        nrMissingTiles++;
+      tiles.push_back(tile);
+    }
+  }
+
+  if (nrMissingTiles > 0)
+  {
+    // Copy the raw data so that it can not be replaced while the tiles are converted
+    QByteArray rawData;
+    {
+      QMutexLocker locker(&this->requestDataMutex);
+      rawData = this->currentFrameRawData;
+    }
+    const auto format             = this->srcPixelFormat;
+    const auto curFrameSize       = this->frameSize;
+    const auto conversionSettings = this->conversionSettings;
+    QtConcurrent::blockingMap(tiles, [&](Tile &tile) {
+      if (!tile.image.isNull())
+        return;
+      PixelFormatYUV tileFormat;
+      const auto     tileData = extractScaledRegion(
+          rawData, format, curFrameSize, tile.x, tile.y, tile.size, level, tileFormat);
+      convertYUVToImage(tileData, tile.image, tileFormat, tile.size, conversionSettings);
+    });
+    DEBUG_YUV("videoHandlerYUV::drawFrameTiled converted " << nrMissingTiles << " tiles");
+  }
+
+  for (const auto &tile : tiles)
+  {
+    if (tile.image.isNull())
+      continue;
+    this->tileCache.insert(tile.key, tile.image);
+
+    const QRectF targetRect(videoRect.left() + tile.x * zoomFactor,
+                            videoRect.top() + tile.y * zoomFactor,
+                            (tile.size.width << level) * zoomFactor,
+                            (tile.size.height << level) * zoomFactor);
+    painter->drawImage(targetRect, tile.image);
+  }
+
+  if (drawRawData && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
+    this->drawPixelValues(painter, frameIdx, videoRect, zoomFactor);
+}
+
 /// --- Convert from the current YUV input format to YUV 444
 
 #if SSE_CONVERSION_420_ALT
@@ -3289,130 +3533,12 @@ void videoHandlerYUV::setFormatFromSizeAndName(Size             frameSize,
   setSrcPixelFormat(fmt, false);
 }
 
-/** Try to guess the format of the raw YUV data. A list of candidates is tried (candidateModes) and
- * it is checked if the file size matches and if the correlation of the first two frames is below a
- * threshold. radData must contain at least two frames of the video sequence. Only formats that two
- * frames of could fit into rawData are tested. E.g. the biggest format that is tested here is 1080p
- * YUV 4:2:2 8 bit which is 4147200 bytes per frame. So make sure rawData contains 8294400 bytes so
- * that all formats are tested. If a file size is given, we test if the candidates frame size is a
- * multiple of the fileSize. If fileSize is -1, this test is skipped.
- */
-void videoHandlerYUV::setFormatFromCorrelation(const QByteArray &rawYUVData, int64_t fileSize)
+void videoHandlerYUV::setFormatFromCorrelation(const FileReader &reader, int64_t fileSize)
 {
-  if (rawYUVData.size() < 1)
-    return;
-
-  class testFormatAndSize
-  {
-  public:
-    testFormatAndSize(const Size &size, PixelFormatYUV format) : size(size), format(format)
-    {
-      interesting = false;
-      mse         = 0;
-    }
-    Size           size;
-    PixelFormatYUV format;
-    bool           interesting;
-    double         mse;
-  };
-
-  // The candidates for the size
-  const auto testSizes = std::vector<Size>({Size(176, 144),
-                                            Size(352, 240),
-                                            Size(352, 288),
-                                            Size(480, 480),
-                                            Size(480, 576),
-                                            Size(704, 480),
-                                            Size(720, 480),
-                                            Size(704, 576),
-                                            Size(720, 576),
-                                            Size(1024, 768),
-                                            Size(1280, 720),
-                                            Size(1280, 960),
-                                            Size(1920, 1072),
-                                            Size(1920, 1080)});
-
-  // Test bit depths 8, 10 and 16
-  std::vector<testFormatAndSize> formatList;
-  for (int b = 0; b < 3; b++)
-  {
-    int bits = (b == 0) ? 8 : (b == 1) ? 10 : 16;
-    // Test all subsampling modes
-    for (const auto &subsampling : SubsamplingMapper.getEnums())
-      for (const auto &size : testSizes)
-        formatList.push_back(
-            testFormatAndSize(size, PixelFormatYUV(subsampling, bits, PlaneOrder::YUV)));
-  }
-
-  if (fileSize > 0)
-  {
-    // if any candidate exceeds file size for two frames, discard
-    // if any candidate does not represent a multiple of file size, discard
-    bool fileSizeMatchFound = false;
-
-    for (testFormatAndSize &testFormat : formatList)
-    {
-      auto picSize = testFormat.format.bytesPerFrame(testFormat.size);
-
-      const bool atLeastTwoPictureInInput = fileSize >= (picSize * 2);
-      if (atLeastTwoPictureInInput)
-      {
-        if ((fileSize % picSize) == 0) // important: file size must be multiple of the picture size
-        {
-          testFormat.interesting = true;
-          fileSizeMatchFound     = true;
-        }
-      }
-    }
-
-    if (!fileSizeMatchFound)
-      return;
-  }
-
-  // calculate max. correlation for first two frames, use max. candidate frame size
-  for (testFormatAndSize &testFormat : formatList)
-  {
-    if (testFormat.interesting)
-    {
-      auto picSize     = testFormat.format.bytesPerFrame(testFormat.size);
-      int  lumaSamples = testFormat.size.width * testFormat.size.height;
-
-      // Calculate the MSE for 2 frames
-      if (testFormat.format.getBitsPerSample() == 8)
-      {
-        auto ptr       = (unsigned char *)rawYUVData.data();
-        testFormat.mse = computeMSE(ptr, ptr + picSize, lumaSamples);
-      }
-      else if (testFormat.format.getBitsPerSample() > 8 &&
-               testFormat.format.getBitsPerSample() <= 16)
-      {
-        auto ptr       = (unsigned short *)rawYUVData.data();
-        testFormat.mse = computeMSE(ptr, ptr + picSize / 2, lumaSamples);
-      }
-      else
-        continue;
-    }
-  }
-
-  // step3: select best candidate
-  double         leastMSE = std::numeric_limits<double>::max();
-  PixelFormatYUV bestFormat;
-  Size           bestSize;
-  for (const testFormatAndSize &testFormat : formatList)
-  {
-    if (testFormat.interesting && testFormat.mse < leastMSE)
-    {
-      bestFormat = testFormat.format;
-      bestSize   = testFormat.size;
-      leastMSE   = testFormat.mse;
-    }
-  }
-
-  const double mseThreshold = 400;
-  if (leastMSE < mseThreshold)
+  if (auto sizeAndFormat = guessFormatFromCorrelation(reader, fileSize))
   {
-    setSrcPixelFormat(bestFormat, false);
-    setFrameSize(bestSize);
+    this->setSrcPixelFormat(sizeAndFormat->second, false);
+    this->setFrameSize(sizeAndFormat->first);
   }
 }
 
@@ -3443,6 +3569,15 @@ void videoHandlerYUV::loadFrame(int frameIndex, bool loadToDoubleBuffer)
     // We cannot load a frame if the format is not known
     return;
 
+  if (this->useTiledConversion())
+  {
+    // Only the raw data is loaded. The visible tiles are converted when the frame is drawn. There
+    // is no double buffer because it would replace the raw data of the current frame.
+    if (!loadToDoubleBuffer)
+      this->loadRawYUVData(frameIndex);
+    return;
+  }
+
   // Does the data in currentFrameRawData need to be updated?
   if (!loadRawYUVData(frameIndex))
     // Loading failed or it is still being performed in the background
@@ -3524,7 +3659,8 @@ bool videoHandlerYUV::loadRawYUVData(int frameIndex)
     return false;
   }
 
-  currentFrameRawData            = rawData;
+  // The buffer of the last frame is not used anymore (the raw data was replaced by the new frame)
+  FrameBufferPool::instance().replace(currentFrameRawData, rawData);
   currentFrameRawData_frameIndex = frameIndex;
   requestDataMutex.unlock();
 
@@ -3615,22 +3751,17 @@ yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) const
     const auto packing = format.getPackingOrder();
     if (format.getSubsampling() == Subsampling::YUV_422)
     {
-      // The data is arranged in blocks of 4 samples. How many of these are there?
+      // The data is arranged in blocks of 4 samples.
       // What are the offsets withing the 4 samples for the components?
-      const int oY = (packing == PackingOrder::YUYV || packing == PackingOrder::YVYU) ? 0 : 1;
-      const int oU = (packing == PackingOrder::UYVY)   ? 0
-                     : (packing == PackingOrder::YUYV) ? 1
-                     : (packing == PackingOrder::VYUY) ? 2
-                                                       : 3;
-      const int oV = (packing == PackingOrder::VYUY)   ? 0
-                     : (packing == PackingOrder::YVYU) ? 1
-                     : (packing == PackingOrder::UYVY) ? 2
-                                                       : 3;
+      const auto offsets = getPackedOffsets422(packing);
+      const int  oY      = offsets.y;
+      const int  oU      = offsets.u;
+      const int  oV      = offsets.v;
 
       if (format.isBytePacking() && format.getBitsPerSample() == 10)
       {
         // The format is 4 values in 40 bits (5 bytes) which fits exactly for 422 10 bit.
-        auto                          offsetInInput = pixelPos.y() * (pixelPos.x() / 2) * 5;
+        auto offsetInInput = (pixelPos.y() * (w / 2) + pixelPos.x() / 2) * 5;
         const unsigned char *restrict src =
             (unsigned char *)currentFrameRawData.data() + offsetInInput;
 
@@ -3667,15 +3798,10 @@ yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) const
     {
       // The samples are packed in 4:4:4.
       // What are the offsets withing the 3 or 4 bytes per sample?
-      const int oY = (packing == PackingOrder::AYUV) ? 1 : (packing == PackingOrder::VUYA) ? 2 : 0;
-      const int oU = (packing == PackingOrder::YUV || packing == PackingOrder::YUVA ||
-                      packing == PackingOrder::VUYA)
-                         ? 1
-                         : 2;
-      const int oV = (packing == PackingOrder::YVU)    ? 1
-                     : (packing == PackingOrder::AYUV) ? 3
-                     : (packing == PackingOrder::VUYA) ? 0
-                                                       : 2;
+      const auto offsets = getPackedOffsets444(packing);
+      const int  oY      = offsets.y;
+      const int  oU      = offsets.u;
+      const int  oV      = offsets.v;
 
       // How many bytes to the next sample?
       const int offsetNext =
@@ -3693,105 +3819,6 @@ yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) const
   return value;
 }
 
-bool videoHandlerYUV::markDifferencesYUVPlanarToRGB(const QByteArray &    sourceBuffer,
-                                                    unsigned char *       targetBuffer,
-                                                    const Size            curFrameSize,
-                                                    const PixelFormatYUV &sourceBufferFormat) const
-{
-  // These are constant for the runtime of this function. This way, the compiler can optimize the
-  // hell out of this function.
-  const auto format = sourceBufferFormat;
-  const auto w      = curFrameSize.width;
-  const auto h      = curFrameSize.height;
-
-  const int bps   = format.getBitsPerSample();
-  const int cZero = 128 << (bps - 8);
-
-  // Other bit depths not (yet) supported. w and h must be divisible by the subsampling.
-  assert(bps >= 8 && bps <= 16 && (w % format.getSubsamplingHor()) == 0 &&
-         (h % format.getSubsamplingVer()) == 0);
-
-  // The luma component has full resolution. The size of each chroma components depends on the
-  // subsampling.
-  const int componentSizeLuma = (w * h);
-  const int componentSizeChroma =
-      (w / format.getSubsamplingHor()) * (h / format.getSubsamplingVer());
-
-  // How many bytes are in each component?
-  const int nrBytesLumaPlane   = (bps > 8) ? componentSizeLuma * 2 : componentSizeLuma;
-  const int nrBytesChromaPlane = (bps > 8) ? componentSizeChroma * 2 : componentSizeChroma;
-
-  // Is this big endian (actually the difference buffer should always be big endian)
-  const bool bigEndian = format.isBigEndian();
-
-  // A pointer to the output
-  unsigned char *restrict dst = targetBuffer;
-
-  // Get the pointers to the source planes (8 bit per sample)
-  const unsigned char *restrict srcY = (unsigned char *)sourceBuffer.data();
-  const unsigned char *restrict srcU =
-      (format.getPlaneOrder() == PlaneOrder::YUV || format.getPlaneOrder() == PlaneOrder::YUVA)
-          ? srcY + nrBytesLumaPlane
-          : srcY + nrBytesLumaPlane + nrBytesChromaPlane;
-  const unsigned char *restrict srcV =
-      (format.getPlaneOrder() == PlaneOrder::YUV || format.getPlaneOrder() == PlaneOrder::YUVA)
-          ? srcY + nrBytesLumaPlane + nrBytesChromaPlane
-          : srcY + nrBytesLumaPlane;
-
-  const int sampleBlocksX = format.getSubsamplingHor();
-  const int sampleBlocksY = format.getSubsamplingVer();
-
-  const int strideC = w / sampleBlocksX; // How many samples to the next y line?
-  for (unsigned y = 0; y < h; y += sampleBlocksY)
-    for (unsigned x = 0; x < w; x += sampleBlocksX)
-    {
-      // Get the U/V difference value. For all values within the sub-block this is constant.
-      int uvIndex = (y / sampleBlocksY) * strideC + x / sampleBlocksX;
-      int valU    = getValueFromSource(srcU, uvIndex, bps, bigEndian);
-      int valV    = getValueFromSource(srcV, uvIndex, bps, bigEndian);
-
-      for (int yInBlock = 0; yInBlock < sampleBlocksY; yInBlock++)
-      {
-        for (int xInBlock = 0; xInBlock < sampleBlocksX; xInBlock++)
-        {
-          // Get the Y difference value
-          int valY = getValueFromSource(srcY, (y + yInBlock) * w + x + xInBlock, bps, bigEndian);
-
-          // select RGB color
-          unsigned char R = 0, G = 0, B = 0;
-          if (valY == cZero)
-          {
-            G = (valU == cZero) ? 0 : 70;
-            B = (valV == cZero) ? 0 : 70;
-          }
-          else
-          {
-            // Y difference
-            if (valU == cZero && valV == cZero)
-            {
-              R = 70;
-              G = 70;
-              B = 70;
-            }
-            else
-            {
-              G = (valU == cZero) ? 0 : 255;
-              B = (valV == cZero) ? 0 : 255;
-            }
-          }
-
-          // Set the RGB value for the output
-          dst[((y + yInBlock) * w + x + xInBlock) * 4]     = B;
-          dst[((y + yInBlock) * w + x + xInBlock) * 4 + 1] = G;
-          dst[((y + yInBlock) * w + x + xInBlock) * 4 + 2] = R;
-          dst[((y + yInBlock) * w + x + xInBlock) * 4 + 3] = 255;
-        }
-      }
-    }
-
-  return true;
-}
-
 QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
                                             const int        frameIdxItem0,
                                             const int        frameIdxItem1,
@@ -3821,30 +3848,6 @@ QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
                                              amplificationFactor,
                                              markDifference);
 
-  // Get/Set the bit depth of the input and output
-  // If the bit depth if the two items is different, we will scale the item with the lower bit depth
-  // up.
-  const unsigned bps_in[2] = {srcPixelFormat.getBitsPerSample(),
-                              yuvItem2->srcPixelFormat.getBitsPerSample()};
-  const auto     bps_out   = std::max(bps_in[0], bps_in[1]);
-  // Which of the two input values has to be scaled up? Only one of these (or neither) can be set.
-  const bool bitDepthScaling[2] = {bps_in[0] != bps_out, bps_in[1] != bps_out};
-  // Scale the input up by this many bits
-  const auto depthScale = bps_out - (bitDepthScaling[0] ? bps_in[0] : bps_in[1]);
-  // Add a warning if the bit depths of the two inputs don't agree
-  if (bitDepthScaling[0] || bitDepthScaling[1])
-    differenceInfoList.append(
-        InfoItem("Warning",
-                 "The bit depth of the two items differs.",
-                 "The bit depth of the two input items is different. The lower bit depth will be "
-                 "scaled up and the difference is calculated."));
-  // What are the maximum and middle value for the output bit depth
-  const int diffZero = 128 << (bps_out - 8);
-  const int maxVal   = (1 << bps_out) - 1;
-
-  // Do we amplify the values?
-  const bool amplification = (amplificationFactor != 1 && !markDifference);
-
   // Load the right raw YUV data (if not already loaded).
   // This will just update the raw YUV data. No conversion to image (RGB) is performed. This is
   // either done on request if the frame is actually shown or has already been done by the caching
@@ -3858,164 +3861,90 @@ QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
   DEBUG_YUV("videoHandlerYUV::calculateDifference frame idx item 0 "
             << frameIdxItem0 << " - item 1 " << frameIdxItem1);
 
+  auto outputImage = calculateDifferenceImage(this->currentFrameRawData,
+                                              this->srcPixelFormat,
+                                              this->frameSize,
+                                              yuvItem2->currentFrameRawData,
+                                              yuvItem2->srcPixelFormat,
+                                              yuvItem2->frameSize,
+                                              differenceInfoList,
+                                              amplificationFactor,
+                                              markDifference,
+                                              this->diffResult,
+                                              this->diffYUV,
+                                              this->diffYUVFormat);
+
+  // we have a yuv differance available
+  this->diffReady = !outputImage.isNull();
+  return outputImage;
+}
+
+QImage videoHandlerYUV::calculateDifferenceImage(const QByteArray &    rawData0,
+                                                 const PixelFormatYUV &format0,
+                                                 const Size            frameSize0,
+                                                 const QByteArray &    rawData1,
+                                                 const PixelFormatYUV &format1,
+                                                 const Size            frameSize1,
+                                                 QList<InfoItem> &     differenceInfoList,
+                                                 const int             amplificationFactor,
+                                                 const bool            markDifference,
+                                                 DifferenceResult &    diffResult,
+                                                 QByteArray &          diffYUV,
+                                                 PixelFormatYUV &      diffYUVFormat)
+{
+  if (format0.getSubsampling() != format1.getSubsampling())
+    return QImage();
+
+  // If the bit depth if the two items is different, we will scale the item with the lower bit depth
+  // up.
+  const auto bps_out = std::max(format0.getBitsPerSample(), format1.getBitsPerSample());
+  // Add a warning if the bit depths of the two inputs don't agree
+  if (format0.getBitsPerSample() != format1.getBitsPerSample())
+    differenceInfoList.append(
+        InfoItem("Warning",
+                 "The bit depth of the two items differs.",
+                 "The bit depth of the two input items is different. The lower bit depth will be "
+                 "scaled up and the difference is calculated."));
+
   // The items can be of different size (we then calculate the difference of the top left aligned
   // part)
-  const unsigned w_in[] = {frameSize.width, yuvItem2->frameSize.width};
-  const unsigned h_in[] = {frameSize.height, yuvItem2->frameSize.height};
-  const auto     w_out  = std::min(w_in[0], w_in[1]);
-  const auto     h_out  = std::min(h_in[0], h_in[1]);
+  const auto w_out = std::min(frameSize0.width, frameSize1.width);
+  const auto h_out = std::min(frameSize0.height, frameSize1.height);
   // Append a warning if the frame sizes are different
-  if (frameSize != yuvItem2->frameSize)
+  if (frameSize0 != frameSize1)
     differenceInfoList.append(
         InfoItem("Warning",
                  "The size of the two items differs.",
                  "The size of the two input items is different. The difference of the top left "
                  "aligned part that overlaps will be calculated."));
 
-  PixelFormatYUV tmpDiffYUVFormat(srcPixelFormat.getSubsampling(), bps_out, PlaneOrder::YUV, true);
-  diffYUVFormat = tmpDiffYUVFormat;
-
+  PixelFormatYUV tmpDiffYUVFormat(format0.getSubsampling(), bps_out);
   if (!tmpDiffYUVFormat.canConvertToRGB(Size(w_out, h_out)))
     return QImage();
 
-  // Get subsampling modes (they are identical for both inputs and the output)
-  const auto subH = srcPixelFormat.getSubsamplingHor();
-  const auto subV = srcPixelFormat.getSubsamplingVer();
-
-  // Get the endianness of the inputs
-  const bool bigEndian[2] = {srcPixelFormat.isBigEndian(), yuvItem2->srcPixelFormat.isBigEndian()};
-
-  // Get pointers to the inputs
-  const unsigned componentSizeLuma_In[2]   = {w_in[0] * h_in[0], w_in[1] * h_in[1]};
-  const unsigned componentSizeChroma_In[2] = {(w_in[0] / subH) * (h_in[0] / subV),
-                                              (w_in[1] / subH) * (h_in[1] / subV)};
-  const unsigned nrBytesLumaPlane_In[2]    = {
-      bps_in[0] > 8 ? 2 * componentSizeLuma_In[0] : componentSizeLuma_In[0],
-      bps_in[1] > 8 ? 2 * componentSizeLuma_In[1] : componentSizeLuma_In[1]};
-  const unsigned nrBytesChromaPlane_In[2] = {
-      bps_in[0] > 8 ? 2 * componentSizeChroma_In[0] : componentSizeChroma_In[0],
-      bps_in[1] > 8 ? 2 * componentSizeChroma_In[1] : componentSizeChroma_In[1]};
-  // Current item
-  const unsigned char *restrict srcY1 = (unsigned char *)currentFrameRawData.data();
-  const unsigned char *restrict srcU1 =
-      (srcPixelFormat.getPlaneOrder() == PlaneOrder::YUV ||
-       srcPixelFormat.getPlaneOrder() == PlaneOrder::YUVA)
-          ? srcY1 + nrBytesLumaPlane_In[0]
-          : srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0];
-  const unsigned char *restrict srcV1 =
-      (srcPixelFormat.getPlaneOrder() == PlaneOrder::YUV ||
-       srcPixelFormat.getPlaneOrder() == PlaneOrder::YUVA)
-          ? srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0]
-          : srcY1 + nrBytesLumaPlane_In[0];
-  // The other item
-  const unsigned char *restrict srcY2 = (unsigned char *)yuvItem2->currentFrameRawData.data();
-  const unsigned char *restrict srcU2 =
-      (yuvItem2->srcPixelFormat.getPlaneOrder() == PlaneOrder::YUV ||
-       yuvItem2->srcPixelFormat.getPlaneOrder() == PlaneOrder::YUVA)
-          ? srcY2 + nrBytesLumaPlane_In[1]
-          : srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1];
-  const unsigned char *restrict srcV2 =
-      (yuvItem2->srcPixelFormat.getPlaneOrder() == PlaneOrder::YUV ||
-       yuvItem2->srcPixelFormat.getPlaneOrder() == PlaneOrder::YUVA)
-          ? srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1]
-          : srcY2 + nrBytesLumaPlane_In[1];
-
-  // Get pointers to the output
-  const int componentSizeLuma_out   = w_out * h_out * (bps_out > 8 ? 2 : 1); // Size in bytes
-  const int componentSizeChroma_out = (w_out / subH) * (h_out / subV) * (bps_out > 8 ? 2 : 1);
-  // Resize the output buffer to the right size
-  diffYUV.resize(componentSizeLuma_out + 2 * componentSizeChroma_out);
-  unsigned char *restrict dstY = (unsigned char *)diffYUV.data();
-  unsigned char *restrict dstU = dstY + componentSizeLuma_out;
-  unsigned char *restrict dstV = dstU + componentSizeChroma_out;
-
-  // Also calculate the MSE while we're at it (Y,U,V)
-  // TODO: Bug: MSE is not scaled correctly in all YUV format cases
-  int64_t mseAdd[3] = {0, 0, 0};
-
-  // Calculate Luma sample difference
-  const unsigned stride_in[2] = {bps_in[0] > 8 ? w_in[0] * 2 : w_in[0],
-                                 bps_in[1] > 8 ? w_in[1] * 2
-                                               : w_in[1]}; // How many bytes to the next y line?
-  for (unsigned y = 0; y < h_out; y++)
-  {
-    for (unsigned x = 0; x < w_out; x++)
-    {
-      auto val1 = getValueFromSource(srcY1, x, bps_in[0], bigEndian[0]);
-      auto val2 = getValueFromSource(srcY2, x, bps_in[1], bigEndian[1]);
-
-      // Scale (if necessary)
-      if (bitDepthScaling[0])
-        val1 = val1 << depthScale;
-      else if (bitDepthScaling[1])
-        val2 = val2 << depthScale;
-
-      // Calculate the difference, add MSE, (amplify) and clip the difference value
-      auto diff = val1 - val2;
-      mseAdd[0] += diff * diff;
-      if (amplification)
-        diff *= amplificationFactor;
-      diff = functions::clip(diff + diffZero, 0, maxVal);
-
-      setValueInBuffer(dstY, diff, 0, bps_out, true);
-      dstY += (bps_out > 8) ? 2 : 1;
-    }
-
-    // Goto the next y line
-    srcY1 += stride_in[0];
-    srcY2 += stride_in[1];
-  }
-
-  // Next U/V
-  const unsigned strideC_in[2] = {
-      w_in[0] / subH * (bps_in[0] > 8 ? 2 : 1),
-      w_in[1] / subH * (bps_in[1] > 8 ? 2 : 1)}; // How many bytes to the next U/V y line
-  for (unsigned y = 0; y < h_out / subV; y++)
-  {
-    for (unsigned x = 0; x < w_out / subH; x++)
-    {
-      auto valU1 = getValueFromSource(srcU1, x, bps_in[0], bigEndian[0]);
-      auto valU2 = getValueFromSource(srcU2, x, bps_in[1], bigEndian[1]);
-      auto valV1 = getValueFromSource(srcV1, x, bps_in[0], bigEndian[0]);
-      auto valV2 = getValueFromSource(srcV2, x, bps_in[1], bigEndian[1]);
-
-      // Scale (if necessary)
-      if (bitDepthScaling[0])
-      {
-        valU1 = valU1 << depthScale;
-        valV1 = valV1 << depthScale;
-      }
-      else if (bitDepthScaling[1])
-      {
-        valU2 = valU2 << depthScale;
-        valV2 = valV2 << depthScale;
-      }
-
-      // Calculate the difference, add MSE, (amplify) and clip the difference value
-      auto diffU = valU1 - valU2;
-      auto diffV = valV1 - valV2;
-      mseAdd[1] += diffU * diffU;
-      mseAdd[2] += diffV * diffV;
-      if (amplification)
-      {
-        diffU *= amplificationFactor;
-        diffV *= amplificationFactor;
-      }
-      diffU = functions::clip(diffU + diffZero, 0, maxVal);
-      diffV = functions::clip(diffV + diffZero, 0, maxVal);
-
-      setValueInBuffer(dstU, diffU, 0, bps_out, true);
-      setValueInBuffer(dstV, diffV, 0, bps_out, true);
-      dstU += (bps_out > 8) ? 2 : 1;
-      dstV += (bps_out > 8) ? 2 : 1;
-    }
+  // Packed formats are converted to planar first
+  QByteArray     planarData[2];
+  PixelFormatYUV planarFormat[2];
+  bool           convOK[2];
+  std::tie(convOK[0], planarFormat[0]) =
+      convertToPlanarYUV(rawData0, planarData[0], frameSize0, format0);
+  std::tie(convOK[1], planarFormat[1]) =
+      convertToPlanarYUV(rawData1, planarData[1], frameSize1, format1);
+  if (!convOK[0] || !convOK[1])
+    return QImage();
 
-    // Goto the next y line
-    srcU1 += strideC_in[0];
-    srcV1 += strideC_in[0];
-    srcU2 += strideC_in[1];
-    srcV2 += strideC_in[1];
-  }
+  // Calculate the difference image, the statistics and the positions of the differences in one
+  // pass. If the differences are only marked, there is no need to amplify them.
+  diffResult    = calculateDifferencePlanar(planarData[0],
+                                            planarFormat[0],
+                                            frameSize0,
+                                            planarData[1],
+                                            planarFormat[1],
+                                            frameSize1,
+                                            markDifference ? 1 : amplificationFactor,
+                                            diffYUV,
+                                            tmpDiffYUVFormat);
+  diffYUVFormat = tmpDiffYUVFormat;
 
   // Next we convert the difference YUV image to RGB, either using the normal conversion function or
   // another function that only marks the difference values.
@@ -4041,8 +3970,7 @@ QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
 
   if (markDifference)
     // We don't want to see the actual difference but just where differences are.
-    markDifferencesYUVPlanarToRGB(
-        diffYUV, outputImage.bits(), Size(w_out, h_out), tmpDiffYUVFormat);
+    markDifferencesToRGB(diffYUV, tmpDiffYUVFormat, Size(w_out, h_out), outputImage.bits());
   else
   {
     // Get the format of the tmpDiffYUV buffer and convert it to RGB
@@ -4056,35 +3984,41 @@ QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
   differenceInfoList.append(
       InfoItem("Difference Type",
                QString("YUV %1").arg(QString::fromStdString(
-                   SubsamplingMapper.getText(srcPixelFormat.getSubsampling())))));
+                   SubsamplingMapper.getText(format0.getSubsampling())))));
 
   {
-    auto       nrPixelsLuma = w_out * h_out;
-    const auto maxSquared   = ((1 << bps_out) - 1) * ((1 << bps_out) - 1);
-    auto       mse          = double(mseAdd[0]) / nrPixelsLuma;
-    auto       psnr         = 10 * std::log10(maxSquared / mse);
-    differenceInfoList.append(
-        InfoItem("MSE/PSNR Y", QString("%1 (%2dB)").arg(mse, 0, 'f', 1).arg(psnr, 0, 'f', 2)));
-
-    if (srcPixelFormat.getSubsampling() != Subsampling::YUV_400)
+    const auto &planes = diffResult.planes;
+    const auto  names  = QStringList() << "Y"
+                                       << "U"
+                                       << "V";
+    for (size_t c = 0; c < planes.size(); c++)
     {
-      auto nrPixelsChroma = w_out / subH * h_out / subV;
-
-      auto mseU  = double(mseAdd[1]) / nrPixelsChroma;
-      auto psnrU = 10 * std::log10(maxSquared / mseU);
+      const auto mse  = planes[c].getMSE();
+      const auto psnr = psnrFromMSE(mse, bps_out);
       differenceInfoList.append(
-          InfoItem("MSE/PSNR U", QString("%1 (%2dB)").arg(mseU, 0, 'f', 1).arg(psnrU, 0, 'f', 2)));
-
-      auto mseV  = double(mseAdd[2]) / nrPixelsChroma;
-      auto psnrV = 10 * std::log10(maxSquared / mseV);
-      differenceInfoList.append(
-          InfoItem("MSE/PSNR V", QString("%1 (%2dB)").arg(mseV, 0, 'f', 1).arg(psnrV, 0, 'f', 2)));
+          InfoItem(QString("MSE/PSNR %1").arg(names[int(c)]),
+                   QString("%1 (%2dB)").arg(mse, 0, 'f', 1).arg(psnr, 0, 'f', 2)));
+    }
 
-      auto mseAvg = double(mseAdd[0] + mseAdd[1] + mseAdd[2]) / (nrPixelsLuma + 2 * nrPixelsChroma);
-      auto psnrAvg = 10 * std::log10(maxSquared / mseAvg);
+    if (planes.size() == 3)
+    {
+      uint64_t sumSquaredError = 0;
+      uint64_t nrSamples       = 0;
+      for (const auto &plane : planes)
+      {
+        sumSquaredError += plane.sumSquaredError;
+        nrSamples += plane.nrSamples;
+      }
+      const auto mseAvg  = double(sumSquaredError) / double(nrSamples);
+      const auto psnrAvg = psnrFromMSE(mseAvg, bps_out);
       differenceInfoList.append(InfoItem(
           "MSE/PSNR Avg", QString("%1 (%2dB)").arg(mseAvg, 0, 'f', 1).arg(psnrAvg, 0, 'f', 2)));
     }
+
+    QStringList maxDifferences;
+    for (size_t c = 0; c < planes.size(); c++)
+      maxDifferences.append(QString("%1 %2").arg(names[int(c)]).arg(planes[c].maxAbsDifference));
+    differenceInfoList.append(InfoItem("Max abs diff", maxDifferences.join(" ")));
   }
 
   if (is_Q_OS_LINUX)
@@ -4097,11 +4031,21 @@ QImage videoHandlerYUV::calculateDifference(FrameHandler *   item2,
       return outputImage.convertToFormat(format);
   }
 
-  // we have a yuv differance available
-  this->diffReady = true;
   return outputImage;
 }
 
+QImage videoHandlerYUV::convertRawToImage(const QByteArray &    rawData,
+                                          const PixelFormatYUV &format,
+                                          const Size            frameSize) const
+{
+  // Copy the settings so that they can not change while converting
+  const auto conversionSettings = this->conversionSettings;
+
+  QImage image;
+  convertYUVToImage(rawData, image, format, frameSize, conversionSettings);
+  return image;
+}
+
 void videoHandlerYUV::setPixelFormatYUV(const PixelFormatYUV &newFormat, bool emitSignal)
 {
   if (!newFormat.isValid())
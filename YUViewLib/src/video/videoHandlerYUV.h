@@ -32,7 +32,9 @@
 
 #pragma once
 
+#include "DifferenceKernel.h"
 #include "PixelFormatYUV.h"
+#include "TileCache.h"
 #include "videoHandler.h"
 
 #include "ui_videoHandlerYUV.h"
@@ -71,6 +73,22 @@ struct ConversionSettings
   std::map<Component, MathParameters> mathParameters;
 };
 
+// Convert the raw data of a frame in the given format (packed or predefined formats like V210) to
+// a planar format. Planar data is not converted (the target is a shallow copy of the source).
+// Returns if the conversion succeeded and the format of the data in the target buffer.
+std::pair<bool, PixelFormatYUV> convertToPlanarYUV(const QByteArray &    sourceBuffer,
+                                                   QByteArray &          targetBuffer,
+                                                   const Size            curFrameSize,
+                                                   const PixelFormatYUV &format);
+
+// Convert the given raw YUV frame in the given format to an RGB image using the conversion
+// settings. The output image is null if the format can not be converted.
+void convertYUVToImage(const QByteArray &        sourceBuffer,
+                       QImage &                  outputImage,
+                       const PixelFormatYUV &    yuvFormat,
+                       const Size &              curFrameSize,
+                       const ConversionSettings &conversionSettings);
+
 /** The videoHandlerYUV can be used in any playlistItem to read/display YUV data. A playlistItem
  * could even provide multiple YUV videos. A videoHandlerYUV supports handling of YUV data and can
  * return a specific frame as a image by calling getOneFrame. All conversions from the various YUV
@@ -97,6 +115,22 @@ public:
   virtual void
   drawFrame(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) override;
 
+  // Frames that are too large to be converted as a whole are converted in tiles when they are
+  // drawn. For these, only the raw data has to be loaded.
+  virtual ItemLoadingState needsLoading(int frameIndex, bool loadRawValues) override;
+
+  // Also clear the converted tiles
+  virtual void invalidateAllBuffers() override;
+
+  // Frames that are converted in tiles are not cached
+  virtual bool isFrameCachingSupported() const override { return !this->useTiledConversion(); }
+
+  // For frames that are converted in tiles, there is no current image. It is converted as a whole
+  // only if one of these needs it.
+  virtual QImage getCurrentFrameAsImage() override;
+  virtual std::function<void(QPainter *, double)> getFrameDrawFunction(int  frameIndex,
+                                                                       bool caching) override;
+
   // Return the YUV values for the given pixel
   // If a second item is provided, return the difference values to that item at the given position.
   // If th second item cannot be cast to a videoHandlerYUV, we call the FrameHandler::getPixelValues
@@ -117,6 +151,30 @@ public:
                                      const int        amplificationFactor,
                                      const bool       markDifference) override;
 
+  // Calculate the difference image of the two given raw YUV frames. This does not use the state
+  // of a handler so it can be called from any thread (e.g. to cache the difference). The
+  // statistics and the positions of the differences as well as the difference YUV data are
+  // returned. A null image is returned if the subsampling of the frames differs or if the
+  // difference can not be converted.
+  static QImage calculateDifferenceImage(const QByteArray &    rawData0,
+                                         const PixelFormatYUV &format0,
+                                         const Size            frameSize0,
+                                         const QByteArray &    rawData1,
+                                         const PixelFormatYUV &format1,
+                                         const Size            frameSize1,
+                                         QList<InfoItem> &     differenceInfoList,
+                                         const int             amplificationFactor,
+                                         const bool            markDifference,
+                                         DifferenceResult &    diffResult,
+                                         QByteArray &          diffYUV,
+                                         PixelFormatYUV &      diffYUVFormat);
+
+  // Convert the given raw YUV frame (e.g. a resampled frame of this video) to an image using the
+  // conversion settings of this video. This does not change the state of the handler.
+  QImage convertRawToImage(const QByteArray &    rawData,
+                           const PixelFormatYUV &format,
+                           const Size            frameSize) const;
+
   // Get the number of bytes for one YUV frame with the current format
   virtual int64_t getBytesPerFrame() const override
   {
@@ -132,9 +190,7 @@ public:
                                         const QFileInfo &fileInfo) override;
 
   // Try to guess and set the format (frameSize/srcPixelFormat) from the raw YUV data.
-  // If a file size is given, it is tested if the YUV format and the file size match.
-  virtual void setFormatFromCorrelation(const QByteArray &rawYUVData,
-                                        int64_t           fileSize = -1) override;
+  virtual void setFormatFromCorrelation(const FileReader &reader, int64_t fileSize) override;
 
   virtual QString getFormatAsString() const override
   {
@@ -188,6 +244,8 @@ public:
 
   QByteArray     getDiffYUV() const { return this->diffYUV; };
   PixelFormatYUV getDiffYUVFormat() const { return this->diffYUVFormat; }
+  // The statistics and the positions of the differences of the last calculateDifference call
+  const DifferenceResult &getDiffResult() const { return this->diffResult; }
 
   bool isDiffReady() const { return this->diffReady; }
 
@@ -202,6 +260,9 @@ protected:
 
   virtual yuv_t getPixelValue(const QPoint &pixelPos) const;
 
+  // The RGB value from the current image (e.g. for the difference to a non YUV item)
+  virtual QRgb getPixelVal(int x, int y) override;
+
   // Load the given frame and return it for caching. The current buffers (currentFrameRawYUVData and
   // currentFrame) will not be modified.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache) override;
@@ -211,6 +272,19 @@ private:
   // Return false is loading failed.
   bool loadRawYUVData(int frameIndex);
 
+  // Is the current frame too large to be converted as a whole? In this case, only the visible part
+  // of it is converted (in tiles) when it is drawn. This is only supported for planar formats.
+  bool useTiledConversion() const;
+  // Draw the visible tiles of the frame in currentFrameRawData. Missing tiles are converted (in
+  // parallel) and are kept in the tileCache. When zoomed out, the tiles are converted from a
+  // downscaled version of the raw data.
+  void drawFrameTiled(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData);
+  // The format and conversion settings that the tiles are converted with (part of the tile key)
+  QString getTileSettings() const;
+  // Convert the whole frame in currentFrameRawData to the currentImage if the frame is converted in
+  // tiles and the currentImage is not up to date.
+  void convertCurrentFrameIfTiled();
+
   // Set the new pixel format thread save (lock the mutex). We should also emit that something
   // changed (can be disabled).
   void setSrcPixelFormat(PixelFormatYUV newFormat, bool emitChangedSignal = true);
@@ -222,11 +296,6 @@ private:
   bool setFormatFromSizeAndNamePacked(
       QString name, const Size size, int bitDepth, Subsampling subsampling, int64_t fileSize);
 
-  bool markDifferencesYUVPlanarToRGB(const QByteArray &    sourceBuffer,
-                                     unsigned char *       targetBuffer,
-                                     const Size            frameSize,
-                                     const PixelFormatYUV &sourceBufferFormat) const;
-
 #if SSE_CONVERSION_420_ALT
   void yuv420_to_argb8888(quint8 *yp,
                           quint8 *up,
@@ -241,12 +310,15 @@ private:
 
   SafeUi<Ui::videoHandlerYUV> ui;
 
-  bool           diffReady{};
-  QByteArray     diffYUV;
-  PixelFormatYUV diffYUVFormat{};
+  bool             diffReady{};
+  QByteArray       diffYUV;
+  PixelFormatYUV   diffYUVFormat{};
+  DifferenceResult diffResult;
 
   QList<PixelFormatYUV> presetList;
 
+  TileCache tileCache;
+
 private slots:
 
   // All the valueChanged() signals from the controls are connected here.
@@ -0,0 +1,183 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResultWriter.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cmath>
+#include <iostream>
+
+namespace metrics
+{
+
+namespace
+{
+
+QString formatValue(double value)
+{
+  if (std::isinf(value))
+    return "inf";
+  return QString::number(value, 'f', 6);
+}
+
+QJsonValue jsonValue(double value)
+{
+  // JSON has no representation for infinity
+  if (std::isinf(value))
+    return QJsonValue("inf");
+  return QJsonValue(value);
+}
+
+QJsonObject toJson(const video::yuv::ComponentMetrics &metrics)
+{
+  QJsonObject object;
+  object["mse"]  = jsonValue(metrics.mse);
+  object["psnr"] = jsonValue(metrics.psnr);
+  object["ssim"] = jsonValue(metrics.ssim);
+  return object;
+}
+
+} // namespace
+
+ResultWriter::ResultWriter(Format format, QTextStream &stream, const Options &options)
+    : format(format), stream(stream), options(options)
+{
+}
+
+QStringList ResultWriter::getComponentNames() const
+{
+  if (this->averages.size() == 1)
+    return {"Y"};
+  return {"Y", "U", "V"};
+}
+
+void ResultWriter::addFrame(const FrameResult &result)
+{
+  if (result.components.empty())
+  {
+    std::cerr << result.error.toStdString() << "\n";
+    this->nrErrors++;
+    return;
+  }
+
+  if (this->nrFrames == 0)
+  {
+    this->averages.resize(result.components.size());
+    this->bitDepth = result.bitDepth;
+
+    if (this->format == Format::CSV)
+    {
+      this->stream << "frame";
+      for (const auto &name : this->getComponentNames())
+        this->stream << "," << name << "_MSE," << name << "_PSNR," << name << "_SSIM";
+      this->stream << "\n";
+    }
+  }
+  if (result.components.size() != this->averages.size())
+  {
+    std::cerr << "The number of components of frame " << result.frameIndex << " changed\n";
+    this->nrErrors++;
+    return;
+  }
+
+  for (size_t i = 0; i < result.components.size(); i++)
+  {
+    this->averages[i].sumMSE += result.components[i].mse;
+    this->averages[i].sumSSIM += result.components[i].ssim;
+  }
+  this->nrFrames++;
+
+  const auto componentNames = this->getComponentNames();
+  if (this->format == Format::CSV)
+  {
+    this->stream << result.frameIndex;
+    for (const auto &metrics : result.components)
+      this->stream << "," << formatValue(metrics.mse) << "," << formatValue(metrics.psnr) << ","
+                   << formatValue(metrics.ssim);
+    this->stream << "\n";
+    this->stream.flush();
+  }
+  else
+  {
+    QJsonObject frame;
+    frame["frame"] = result.frameIndex;
+    for (size_t i = 0; i < result.components.size(); i++)
+      frame[componentNames[int(i)]] = toJson(result.components[i]);
+    this->jsonFrames.append(frame);
+  }
+}
+
+void ResultWriter::finish()
+{
+  std::vector<video::yuv::ComponentMetrics> averageMetrics;
+  for (const auto &average : this->averages)
+  {
+    video::yuv::ComponentMetrics metrics;
+    metrics.mse  = average.sumMSE / this->nrFrames;
+    metrics.psnr = video::yuv::psnrFromMSE(metrics.mse, this->bitDepth);
+    metrics.ssim = average.sumSSIM / this->nrFrames;
+    averageMetrics.push_back(metrics);
+  }
+
+  const auto componentNames = this->getComponentNames();
+  if (this->format == Format::CSV)
+  {
+    if (this->nrFrames == 0)
+      return;
+    this->stream << "average";
+    for (const auto &metrics : averageMetrics)
+      this->stream << "," << formatValue(metrics.mse) << "," << formatValue(metrics.psnr) << ","
+                   << formatValue(metrics.ssim);
+    this->stream << "\n";
+  }
+  else
+  {
+    QJsonObject average;
+    for (size_t i = 0; i < averageMetrics.size(); i++)
+      average[componentNames[int(i)]] = toJson(averageMetrics[i]);
+
+    QJsonObject document;
+    document["file0"]    = this->options.fileNames[0];
+    document["file1"]    = this->options.fileNames[1];
+    document["bitDepth"] = int(this->bitDepth);
+    document["nrFrames"] = this->nrFrames;
+    document["nrErrors"] = this->nrErrors;
+    document["frames"]   = this->jsonFrames;
+    document["average"]  = average;
+    this->stream << QJsonDocument(document).toJson();
+  }
+  this->stream.flush();
+}
+
+} // namespace metrics
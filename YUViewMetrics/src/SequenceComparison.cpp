@@ -0,0 +1,192 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SequenceComparison.h"
+
+#include <QFileInfo>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <playlistitem/playlistItemCompressedVideo.h>
+#include <playlistitem/playlistItemRawFile.h>
+
+#include <deque>
+
+namespace metrics
+{
+
+namespace
+{
+
+std::unique_ptr<playlistItem> openItem(const QString &fileName, const Options &options)
+{
+  const auto  extension = QFileInfo(fileName).suffix().toLower();
+  QStringList allExtensions, filters;
+
+  playlistItemCompressedVideo::getSupportedFileExtensions(allExtensions, filters);
+  if (allExtensions.contains(extension))
+    return std::make_unique<playlistItemCompressedVideo>(fileName);
+
+  // Everything else is opened as a raw YUV file
+  allExtensions.clear();
+  playlistItemRawFile::getSupportedFileExtensions(allExtensions, filters);
+  const auto rawFormat = allExtensions.contains(extension) ? QString() : QString("yuv");
+  return std::make_unique<playlistItemRawFile>(
+      fileName, options.frameSize, options.pixelFormat, rawFormat);
+}
+
+} // namespace
+
+bool SequenceComparison::open(const Options &options, QString &error)
+{
+  this->options = options;
+
+  int framesLeft[2];
+  for (int i = 0; i < 2; i++)
+  {
+    const auto &fileName = options.fileNames[i];
+    if (!QFileInfo(fileName).isFile())
+    {
+      error = "The file " + fileName + " does not exist.";
+      return false;
+    }
+
+    this->items[i]    = openItem(fileName, options);
+    this->handlers[i] = dynamic_cast<video::yuv::videoHandlerYUV *>(
+        this->items[i]->getFrameHandler());
+    if (this->handlers[i] == nullptr)
+    {
+      error = "The file " + fileName + " does not contain YUV data.";
+      return false;
+    }
+    if (!this->handlers[i]->isFormatValid())
+    {
+      error = "The format of the file " + fileName +
+              " could not be determined. Please set the frame size and pixel format.";
+      return false;
+    }
+
+    const auto range = this->items[i]->properties().startEndRange;
+    framesLeft[i]    = range.second - range.first + 1 - options.startFrame;
+  }
+
+  this->nrFrames = std::max(std::min(framesLeft[0], framesLeft[1]), 0);
+  if (options.nrFrames >= 0)
+    this->nrFrames = std::min(this->nrFrames, options.nrFrames);
+  if (this->nrFrames == 0)
+  {
+    error = "There are no frames to compare.";
+    return false;
+  }
+
+  return true;
+}
+
+void SequenceComparison::run(std::function<void(const FrameResult &)> frameDone)
+{
+  QThreadPool pool;
+  if (this->options.nrThreads > 0)
+    pool.setMaxThreadCount(int(this->options.nrThreads));
+
+  // Limit the number of frames that are kept in memory
+  const auto maxFramesInFlight = size_t(pool.maxThreadCount()) * 2;
+
+  std::deque<QFuture<FrameResult>> framesInFlight;
+
+  auto finishOldestFrame = [&]() {
+    frameDone(framesInFlight.front().result());
+    framesInFlight.pop_front();
+  };
+
+  for (int i = 0; i < this->nrFrames; i++)
+  {
+    const auto frameIndex = this->options.startFrame + i;
+
+    // Both sequences are read at the same time. Each item can only load one frame at a time so
+    // this is where the frames are read in order.
+    auto frame1Future = QtConcurrent::run(
+        &pool, [this, frameIndex]() { return this->loadFrame(1, frameIndex); });
+    const auto frame0 = this->loadFrame(0, frameIndex);
+    const auto frame1 = frame1Future.result();
+
+    framesInFlight.push_back(QtConcurrent::run(&pool, [frameIndex, frame0, frame1]() {
+      return SequenceComparison::compareFrames(frameIndex, frame0, frame1);
+    }));
+
+    while (framesInFlight.size() >= maxFramesInFlight)
+      finishOldestFrame();
+  }
+
+  while (!framesInFlight.empty())
+    finishOldestFrame();
+}
+
+SequenceComparison::RawFrame SequenceComparison::loadFrame(int itemIndex, int frameIndex) const
+{
+  const auto handler    = this->handlers[itemIndex];
+  const auto firstFrame = this->items[itemIndex]->properties().startEndRange.first;
+
+  RawFrame frame;
+  frame.data = handler->loadRawFrameData(firstFrame + frameIndex);
+  // The format of a compressed sequence is only known once the decoder provided a frame
+  frame.format    = video::yuv::PixelFormatYUV(handler->getRawPixelFormatYUVName().toStdString());
+  frame.frameSize = handler->getFrameSize();
+  return frame;
+}
+
+FrameResult SequenceComparison::compareFrames(int             frameIndex,
+                                              const RawFrame &frame0,
+                                              const RawFrame &frame1)
+{
+  FrameResult result;
+  result.frameIndex = frameIndex;
+
+  video::yuv::PlanarFrame planarFrames[2];
+  const RawFrame *        rawFrames[2] = {&frame0, &frame1};
+  for (int i = 0; i < 2; i++)
+  {
+    if (!video::yuv::convertToPlanarFrame(
+            rawFrames[i]->data, rawFrames[i]->format, rawFrames[i]->frameSize, planarFrames[i]))
+    {
+      result.error = QString("Loading frame %1 of sequence %2 failed").arg(frameIndex).arg(i);
+      return result;
+    }
+  }
+
+  result.bitDepth   = std::max(planarFrames[0].bitDepth, planarFrames[1].bitDepth);
+  result.components = video::yuv::calculateMetrics(planarFrames[0], planarFrames[1]);
+  if (result.components.empty())
+    result.error = QString("The subsampling of frame %1 differs").arg(frameIndex);
+  return result;
+}
+
+} // namespace metrics
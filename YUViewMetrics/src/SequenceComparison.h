@@ -0,0 +1,102 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QSize>
+#include <QStringList>
+
+#include <playlistitem/playlistItem.h>
+#include <video/FrameMetrics.h>
+#include <video/videoHandlerYUV.h>
+
+#include <functional>
+#include <memory>
+
+namespace metrics
+{
+
+struct Options
+{
+  QString  fileNames[2];
+  QSize    frameSize;   // Empty: Guess from the file name
+  QString  pixelFormat; // Empty: Guess from the file name
+  int      startFrame{0};
+  int      nrFrames{-1}; // -1: All frames that both sequences have
+  unsigned nrThreads{0}; // 0: QThread::idealThreadCount()
+};
+
+struct FrameResult
+{
+  int                                       frameIndex{};
+  unsigned                                  bitDepth{};
+  std::vector<video::yuv::ComponentMetrics> components; // Empty if the frame could not be compared
+  QString                                   error;
+};
+
+/* Compare two sequences frame by frame. Both files are opened through the same playlist items that
+ * YUView uses so that every format (raw YUV in all of its layouts and all compressed formats that
+ * can be decoded) is supported.
+ * The frames are loaded (or decoded) in order with one thread per sequence while the conversion and
+ * the calculation of the metrics run in a thread pool.
+ */
+class SequenceComparison
+{
+public:
+  SequenceComparison() = default;
+
+  // Open both files. Returns false and sets the error message if this failed.
+  bool open(const Options &options, QString &error);
+
+  int getNumberFrames() const { return this->nrFrames; }
+
+  // Compare all frames. The callback is invoked for every frame in the order of the frames.
+  void run(std::function<void(const FrameResult &)> frameDone);
+
+private:
+  struct RawFrame
+  {
+    QByteArray                 data;
+    video::yuv::PixelFormatYUV format;
+    Size                       frameSize;
+  };
+
+  RawFrame           loadFrame(int itemIndex, int frameIndex) const;
+  static FrameResult compareFrames(int frameIndex, const RawFrame &frame0, const RawFrame &frame1);
+
+  Options                       options;
+  std::unique_ptr<playlistItem> items[2];
+  video::yuv::videoHandlerYUV * handlers[2]{};
+  int                           nrFrames{};
+};
+
+} // namespace metrics
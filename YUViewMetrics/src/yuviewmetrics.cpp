@@ -0,0 +1,151 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+ *   <https://github.com/IENT/YUView>
+ *   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   In addition, as a special exception, the copyright holders give
+ *   permission to link the code of portions of this program with the
+ *   OpenSSL library under certain conditions as described in each
+ *   individual source file, and distribute linked combinations including
+ *   the two.
+ *
+ *   You must obey the GNU General Public License in all respects for all
+ *   of the code used other than OpenSSL. If you modify file(s) with this
+ *   exception, you may extend this exception to your version of the
+ *   file(s), but you are not obligated to do so. If you do not wish to do
+ *   so, delete this exception statement from your version. If you delete
+ *   this exception statement from all source files in the program, then
+ *   also delete it here.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <iostream>
+
+#include <common/Typedef.h>
+
+#include "ResultWriter.h"
+#include "SequenceComparison.h"
+
+/* Calculate the objective metrics (MSE, PSNR and SSIM per component) between two sequences without
+ * showing anything. The files are read the same way as in YUView so all of its formats can be
+ * compared. The results are printed as CSV or JSON.
+ */
+int main(int argc, char *argv[])
+{
+  // Nothing is shown, so no display is needed
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  qRegisterMetaType<recacheIndicator>("recacheIndicator");
+
+  QApplication app(argc, argv);
+  // Use the same settings (e.g. the decoder libraries) as YUView
+  QApplication::setApplicationName("YUView");
+  QApplication::setOrganizationName("Institut für Nachrichtentechnik, RWTH Aachen University");
+  QApplication::setOrganizationDomain("ient.rwth-aachen.de");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Calculate the MSE, PSNR and SSIM per component between two "
+                                   "sequences.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("file0", "The first (reference) sequence.");
+  parser.addPositionalArgument("file1", "The second sequence.");
+  QCommandLineOption frameSizeOption(
+      "size", "The frame size (WxH) of raw files (default: guess from the file name).", "size");
+  QCommandLineOption pixelFormatOption(
+      "pixel-format",
+      "The YUV pixel format name of raw files as shown in YUView (default: guess from the file "
+      "name).",
+      "name");
+  QCommandLineOption startOption("start", "The first frame to compare.", "n", "0");
+  QCommandLineOption framesOption(
+      "frames", "The number of frames to compare (default: all).", "n", "-1");
+  QCommandLineOption threadsOption("threads", "The number of threads (0: one per core).", "n", "0");
+  QCommandLineOption formatOption("format", "The output format (csv or json).", "format", "csv");
+  QCommandLineOption outputOption(
+      "output", "Write the results to this file instead of the standard output.", "file");
+  parser.addOptions({frameSizeOption,
+                     pixelFormatOption,
+                     startOption,
+                     framesOption,
+                     threadsOption,
+                     formatOption,
+                     outputOption});
+  parser.process(app);
+
+  const auto files = parser.positionalArguments();
+  if (files.size() != 2)
+  {
+    std::cerr << "Two files must be given\n";
+    parser.showHelp(1);
+  }
+
+  metrics::Options options;
+  options.fileNames[0] = files[0];
+  options.fileNames[1] = files[1];
+  if (parser.isSet(frameSizeOption))
+  {
+    const auto frameSize = parser.value(frameSizeOption).split('x');
+    if (frameSize.size() != 2 || frameSize[0].toInt() <= 0 || frameSize[1].toInt() <= 0)
+    {
+      std::cerr << "Invalid frame size " << parser.value(frameSizeOption).toStdString() << "\n";
+      return 1;
+    }
+    options.frameSize = QSize(frameSize[0].toInt(), frameSize[1].toInt());
+  }
+  options.pixelFormat = parser.value(pixelFormatOption);
+  options.startFrame  = std::max(parser.value(startOption).toInt(), 0);
+  options.nrFrames    = parser.value(framesOption).toInt();
+  options.nrThreads   = parser.value(threadsOption).toUInt();
+
+  const auto formatName = parser.value(formatOption).toLower();
+  if (formatName != "csv" && formatName != "json")
+  {
+    std::cerr << "Unknown output format " << formatName.toStdString() << "\n";
+    return 1;
+  }
+  const auto format = (formatName == "csv") ? metrics::ResultWriter::Format::CSV
+                                            : metrics::ResultWriter::Format::JSON;
+
+  metrics::SequenceComparison comparison;
+  QString                     error;
+  if (!comparison.open(options, error))
+  {
+    std::cerr << error.toStdString() << "\n";
+    return 1;
+  }
+
+  QFile outputFile;
+  if (parser.isSet(outputOption))
+  {
+    outputFile.setFileName(parser.value(outputOption));
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+      std::cerr << "Error opening output file " << outputFile.fileName().toStdString() << "\n";
+      return 1;
+    }
+  }
+  else
+    outputFile.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+
+  QTextStream           stream(&outputFile);
+  metrics::ResultWriter writer(format, stream, options);
+  comparison.run([&writer](const metrics::FrameResult &result) { writer.addFrame(result); });
+  writer.finish();
+
+  return writer.getNumberErrors() > 0 ? 1 : 0;
+}
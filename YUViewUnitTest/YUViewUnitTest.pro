@@ -3,5 +3,8 @@ TEMPLATE = subdirs
 requires(qtHaveModule(testlib))
 
 SUBDIRS = filesource \
+          parser \
+          playlistitem \
           statistics \
+          ui \
           video
@@ -0,0 +1,194 @@
+#include <QtTest>
+
+#include <parser/common/BitratePlotModel.h>
+
+#include <algorithm>
+#include <random>
+
+class BitratePlotModelTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  BitratePlotModelTest(){};
+  ~BitratePlotModelTest(){};
+
+private slots:
+  void testDecodeOrder();
+  void testPresentationOrder();
+  void testInsertInPresentationOrder();
+};
+
+namespace
+{
+
+using Entries = std::vector<BitratePlotModel::BitrateEntry>;
+
+// The points of one plot are averaged over this many points left and right
+constexpr unsigned AVERAGE_RANGE = 10;
+
+// Create entries in decoding order. The presentation order is reversed within blocks of the given
+// size (like the B frames of a GOP).
+Entries createEntries(int firstDts, int nrEntries, int reorderBlockSize, unsigned seed)
+{
+  std::mt19937                    generator(seed);
+  std::uniform_int_distribution<> bitrateDistribution(100, 100000);
+
+  Entries entries;
+  for (int i = 0; i < nrEntries; i++)
+  {
+    const auto blockStart = i - i % reorderBlockSize;
+    const auto blockEnd   = std::min(blockStart + reorderBlockSize, nrEntries);
+
+    BitratePlotModel::BitrateEntry entry;
+    entry.dts       = firstDts + i;
+    entry.pts       = firstDts + blockStart + (blockEnd - 1 - i);
+    entry.duration  = 1;
+    entry.bitrate   = size_t(bitrateDistribution(generator));
+    entry.keyframe  = (i % 16 == 0);
+    entry.frameType = entry.keyframe ? "I" : "B";
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+// The average like it was calculated by summing up the bitrates in the window
+unsigned referenceAverage(const Entries &sortedEntries, unsigned index)
+{
+  const auto start = (index > AVERAGE_RANGE) ? index - AVERAGE_RANGE : 0;
+  const auto end   = std::min(index + AVERAGE_RANGE, unsigned(sortedEntries.size()));
+  size_t     sum   = 0;
+  for (auto i = start; i < end; i++)
+    sum += sortedEntries[i].bitrate;
+  return unsigned(sum / (end - start));
+}
+
+void addEntries(BitratePlotModel &model, int streamIndex, Entries entries)
+{
+  for (auto &entry : entries)
+    model.addBitratePoint(streamIndex, entry);
+}
+
+void checkStream(const BitratePlotModel &model,
+                 unsigned                streamIndex,
+                 Entries                 entries,
+                 bool                    presentationOrder)
+{
+  auto key = [presentationOrder](const BitratePlotModel::BitrateEntry &entry) {
+    return presentationOrder ? entry.pts : entry.dts;
+  };
+  std::stable_sort(entries.begin(), entries.end(), [&key](const auto &a, const auto &b) {
+    return key(a) < key(b);
+  });
+
+  const auto nrPoints = unsigned(entries.size());
+  const auto param    = model.getStreamParameter(streamIndex);
+  QCOMPARE(param.getNrPlots(), 2u);
+  QVERIFY(param.plotParameters[0].type == PlotModel::PlotType::Bar);
+  QCOMPARE(param.plotParameters[0].nrpoints, nrPoints);
+  QVERIFY(param.plotParameters[1].type == PlotModel::PlotType::Line);
+  QCOMPARE(param.plotParameters[1].nrpoints, nrPoints);
+
+  // The bitrate range of a stream always starts at 0
+  size_t maxBitrate = 0;
+  for (const auto &entry : entries)
+    maxBitrate = std::max(maxBitrate, entry.bitrate);
+  QCOMPARE(param.yRange.min, 0.0);
+  QCOMPARE(param.yRange.max, double(maxBitrate));
+
+  for (unsigned i = 0; i < nrPoints; i++)
+  {
+    const auto bar = model.getPlotPoint(streamIndex, 0, i);
+    QCOMPARE(bar.x, double(key(entries[i])));
+    QCOMPARE(bar.y, double(entries[i].bitrate));
+    QCOMPARE(bar.width, double(entries[i].duration));
+    QCOMPARE(bar.intra, entries[i].keyframe);
+
+    const auto average = model.getPlotPoint(streamIndex, 1, i);
+    QCOMPARE(average.x, bar.x);
+    QCOMPARE(average.y, double(referenceAverage(entries, i)));
+  }
+
+  // Without a column width, the buckets are the points themselves
+  const auto xRange =
+      Range<double>({double(key(entries.front())), double(key(entries.back()))});
+  for (unsigned plotIndex = 0; plotIndex < 2; plotIndex++)
+  {
+    const auto buckets = model.getPlotBuckets(streamIndex, plotIndex, xRange, 0);
+    QCOMPARE(buckets.size(), size_t(nrPoints));
+    for (unsigned i = 0; i < nrPoints; i++)
+    {
+      QCOMPARE(buckets[i].firstPointIndex, i);
+      QCOMPARE(buckets[i].yMax, model.getPlotPoint(streamIndex, plotIndex, i).y);
+    }
+  }
+}
+
+} // namespace
+
+void BitratePlotModelTest::testDecodeOrder()
+{
+  BitratePlotModel model;
+
+  const auto entries0 = createEntries(0, 200, 4, 1);
+  const auto entries1 = createEntries(-5, 50, 8, 2);
+  addEntries(model, 0, entries0);
+  addEntries(model, 1, entries1);
+
+  QCOMPARE(model.getNrStreams(), 2u);
+  checkStream(model, 0, entries0, false);
+  checkStream(model, 1, entries1, false);
+
+  size_t maxBitrate = 0;
+  for (const auto &entries : {entries0, entries1})
+    for (const auto &entry : entries)
+      maxBitrate = std::max(maxBitrate, entry.bitrate);
+  QCOMPARE(model.getYRange().max, double(maxBitrate));
+
+  QVERIFY(model.getPointInfo(0, 1, 0).contains("<td align=\"right\">I</td>"));
+  QVERIFY(model.getPointInfo(2, 0, 0).isEmpty());
+  QVERIFY(model.getPointInfo(0, 0, 200).isEmpty());
+}
+
+void BitratePlotModelTest::testPresentationOrder()
+{
+  BitratePlotModel model;
+
+  const auto entries = createEntries(0, 300, 4, 3);
+  addEntries(model, 0, entries);
+
+  model.setBitrateSortingIndex(1);
+  checkStream(model, 0, entries, true);
+  QCOMPARE(model.getStreamParameter(0).xRange.min, 0.0);
+  QCOMPARE(model.getStreamParameter(0).xRange.max, 299.0);
+
+  model.setBitrateSortingIndex(0);
+  checkStream(model, 0, entries, false);
+  QCOMPARE(model.getStreamParameter(0).xRange.min, 0.0);
+  QCOMPARE(model.getStreamParameter(0).xRange.max, 299.0);
+}
+
+void BitratePlotModelTest::testInsertInPresentationOrder()
+{
+  BitratePlotModel model;
+  model.setBitrateSortingIndex(1);
+
+  // Small reorder distances are found by the search from the end. The blocks of 100 entries also
+  // need the binary search.
+  const auto entries0 = createEntries(0, 100, 4, 4);
+  const auto entries1 = createEntries(100, 300, 100, 5);
+  addEntries(model, 0, entries0);
+  addEntries(model, 1, entries1);
+
+  checkStream(model, 0, entries0, true);
+  checkStream(model, 1, entries1, true);
+
+  auto entries = entries0;
+  entries.insert(entries.end(), entries1.begin(), entries1.end());
+  addEntries(model, 2, entries);
+  checkStream(model, 2, entries, true);
+}
+
+QTEST_MAIN(BitratePlotModelTest)
+
+#include "BitratePlotModelTest.moc"
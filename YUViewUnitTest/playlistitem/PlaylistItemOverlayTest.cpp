@@ -0,0 +1,223 @@
+#include <QtTest>
+
+#include <common/TemporaryFile.h>
+#include <playlistitem/playlistItemOverlay.h>
+#include <playlistitem/playlistItemRawFile.h>
+#include <video/PixelFormatYUV.h>
+
+#include <fstream>
+
+class PlaylistItemOverlayTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  PlaylistItemOverlayTest(){};
+  ~PlaylistItemOverlayTest(){};
+
+private slots:
+  void testDrawFunctionMatchesDrawItem();
+  void testCompositeMatchesDrawItem();
+  void testDrawFunctionKeepsFrame();
+  void testCachedFrameNeedsNoLoading();
+  void testCachedFrameRecordsChildAccess();
+};
+
+namespace
+{
+
+constexpr auto NR_FRAMES = 2;
+
+// The children are aligned at the top left corner of the first (and biggest) child. The size of
+// the overlay is only known once the layout was updated when it is drawn the first time.
+const auto OVERLAY_SIZE = QSize(16, 8);
+
+// Write a 4:2:0 8 bit file where every frame has a different pattern
+void writeYUVFile(const std::string &filename, int width, int height)
+{
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  for (int i = 0; i < NR_FRAMES; i++)
+  {
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++)
+        file << char((x * 13 + y * 29 + i * 71) % 256);
+    for (int y = 0; y < height / 2; y++)
+      for (int x = 0; x < width / 2; x++)
+        file << char((x * 7 + i * 50) % 256);
+    for (int y = 0; y < height / 2; y++)
+      for (int x = 0; x < width / 2; x++)
+        file << char((y * 11 + i * 90) % 256);
+  }
+}
+
+playlistItemRawFile *createYUVItem(const TemporaryFile &file, const QSize &size)
+{
+  writeYUVFile(file.getFilename(), size.width(), size.height());
+  const auto format = video::yuv::PixelFormatYUV(video::yuv::Subsampling::YUV_420, 8);
+  return new playlistItemRawFile(
+      QString::fromStdString(file.getFilename()), size, QString::fromStdString(format.getName()));
+}
+
+// An overlay of a 16x8 and an 8x4 YUV file
+class OverlayWithFiles
+{
+public:
+  OverlayWithFiles()
+  {
+    // The overlay takes the ownership of its children
+    this->item1 = createYUVItem(this->file1, QSize(16, 8));
+    this->item2 = createYUVItem(this->file2, QSize(8, 4));
+    this->overlay.addChild(this->item1);
+    this->overlay.addChild(this->item2);
+  }
+
+  TemporaryFile        file1{"yuv"};
+  TemporaryFile        file2{"yuv"};
+  playlistItemOverlay  overlay;
+  playlistItemRawFile *item1{};
+  playlistItemRawFile *item2{};
+};
+
+// Draw into an image of the size of the overlay. Like in the view, the item is drawn centered at
+// (0,0).
+QImage draw(double zoomFactor, std::function<void(QPainter *)> drawFunction)
+{
+  QImage image(OVERLAY_SIZE * zoomFactor, QImage::Format_ARGB32_Premultiplied);
+  image.fill(Qt::transparent);
+  QPainter painter(&image);
+  painter.translate(image.width() / 2, image.height() / 2);
+  drawFunction(&painter);
+  return image;
+}
+
+QImage drawItem(playlistItemOverlay &overlay, int frameIdx, double zoomFactor)
+{
+  return draw(zoomFactor, [&](QPainter *painter) {
+    overlay.drawItem(painter, frameIdx, zoomFactor, false);
+  });
+}
+
+QImage drawWithFunction(const playlistItem::DrawFunction &drawFunction, double zoomFactor)
+{
+  return draw(zoomFactor, [&](QPainter *painter) { drawFunction(painter, zoomFactor); });
+}
+
+} // namespace
+
+void PlaylistItemOverlayTest::testDrawFunctionMatchesDrawItem()
+{
+  OverlayWithFiles items;
+  auto &           overlay = items.overlay;
+  overlay.loadFrame(0, false, false, false);
+
+  // The first draw sets up the layout of the children
+  const auto expected = drawItem(overlay, 0, 1.0);
+  QCOMPARE(overlay.getSize(), OVERLAY_SIZE);
+
+  const auto drawFunction = overlay.getDrawFunction(0, false);
+  QVERIFY(drawFunction);
+  QCOMPARE(drawWithFunction(drawFunction, 1.0), expected);
+
+  // Zoomed out, the frames are drawn from their pyramids. The pyramid is kept for the next call.
+  const auto expectedZoomedOut = drawItem(overlay, 0, 0.5);
+  QCOMPARE(drawWithFunction(drawFunction, 0.5), expectedZoomedOut);
+  QCOMPARE(drawWithFunction(drawFunction, 0.5), expectedZoomedOut);
+
+  // Frames that are not loaded or cached can not be drawn
+  QVERIFY(!overlay.getDrawFunction(1, false));
+}
+
+void PlaylistItemOverlayTest::testCompositeMatchesDrawItem()
+{
+  OverlayWithFiles items;
+  auto &           overlay = items.overlay;
+  overlay.loadFrame(0, false, false, false);
+  QSignalSpy itemChanged(&overlay, &playlistItem::SignalItemChanged);
+
+  // The composite is made in the background when the frame is drawn the second time
+  const auto expected = drawItem(overlay, 0, 1.0);
+  QCOMPARE(drawItem(overlay, 0, 1.0), expected);
+  QTRY_VERIFY(itemChanged.count() > 0);
+
+  // Now the composite is drawn
+  QCOMPARE(drawItem(overlay, 0, 1.0), expected);
+}
+
+void PlaylistItemOverlayTest::testDrawFunctionKeepsFrame()
+{
+  OverlayWithFiles items;
+  auto &           overlay = items.overlay;
+  overlay.loadFrame(0, false, false, false);
+
+  const auto expected     = drawItem(overlay, 0, 1.0);
+  const auto drawFunction = overlay.getDrawFunction(0, false);
+  QVERIFY(drawFunction);
+
+  // The draw function still draws its frame when the children load the next frame
+  overlay.loadFrame(1, false, false, false);
+  QVERIFY(drawItem(overlay, 1, 1.0) != expected);
+  QCOMPARE(drawWithFunction(drawFunction, 1.0), expected);
+}
+
+void PlaylistItemOverlayTest::testCachedFrameNeedsNoLoading()
+{
+  OverlayWithFiles items;
+  auto &           overlay = items.overlay;
+  overlay.loadFrame(0, false, false, false);
+  drawItem(overlay, 0, 1.0);
+
+  QCOMPARE(overlay.needsLoading(1, false), ItemLoadingState::LoadingNeeded);
+  overlay.cacheFrame(1, false);
+  QCOMPARE(overlay.getCachedFrames(), QList<int>({1}));
+
+  // The cached composite is drawn. The children do not need to load the frame.
+  QCOMPARE(overlay.needsLoading(1, false), ItemLoadingState::LoadingNotNeeded);
+  overlay.loadFrame(1, false, false, false);
+  QCOMPARE(items.item1->needsLoading(1, false), ItemLoadingState::LoadingNeeded);
+  QCOMPARE(items.item2->needsLoading(1, false), ItemLoadingState::LoadingNeeded);
+
+  // The raw values can only be loaded by the children
+  QCOMPARE(overlay.needsLoading(1, true), ItemLoadingState::LoadingNeeded);
+
+  // The composite shows the frame of the children
+  const auto composite = drawItem(overlay, 1, 1.0);
+  overlay.removeAllFramesFromCache();
+  overlay.loadFrame(1, false, false, false);
+  QCOMPARE(drawItem(overlay, 1, 1.0), composite);
+}
+
+// The children are not drawn when the cached composite is drawn. The cache policies still see that
+// their frames were shown.
+void PlaylistItemOverlayTest::testCachedFrameRecordsChildAccess()
+{
+  OverlayWithFiles items;
+  auto &           overlay = items.overlay;
+  overlay.loadFrame(0, false, false, false);
+  drawItem(overlay, 0, 1.0);
+
+  items.item1->cacheFrame(1, false);
+  QCOMPARE(items.item1->getCachedFrames(), QList<int>({1}));
+  overlay.cacheFrame(1, false);
+
+  const auto childAccess   = items.item1->getFrameLastAccess(1);
+  const auto childHits     = items.item1->getCacheStatistics().hits;
+  const auto overlayAccess = overlay.getFrameLastAccess(1);
+  QVERIFY(childAccess > 0);
+  QVERIFY(overlayAccess > 0);
+
+  drawItem(overlay, 1, 1.0);
+  QVERIFY(items.item1->getFrameLastAccess(1) > childAccess);
+  QCOMPARE(items.item1->getCacheStatistics().hits, childHits + 1);
+  QVERIFY(overlay.getFrameLastAccess(1) > overlayAccess);
+  QCOMPARE(overlay.getCacheStatistics().hits, uint64_t(1));
+  QCOMPARE(items.item2->getCacheStatistics().misses, uint64_t(2));
+
+  // Drawing the same frame again is not another access
+  drawItem(overlay, 1, 1.0);
+  QCOMPARE(items.item1->getCacheStatistics().hits, childHits + 1);
+  QCOMPARE(overlay.getCacheStatistics().hits, uint64_t(1));
+}
+
+QTEST_MAIN(PlaylistItemOverlayTest)
+
+#include "PlaylistItemOverlayTest.moc"
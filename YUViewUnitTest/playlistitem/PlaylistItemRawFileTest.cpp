@@ -0,0 +1,137 @@
+#include <QtTest>
+
+#include <common/TemporaryFile.h>
+#include <playlistitem/playlistItemRawFile.h>
+#include <video/FrameBufferPool.h>
+#include <video/PixelFormatYUV.h>
+#include <video/videoHandler.h>
+
+#include <fstream>
+
+class PlaylistItemRawFileTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  PlaylistItemRawFileTest(){};
+  ~PlaylistItemRawFileTest(){};
+
+private slots:
+  void testY4MConstantFrameDistance();
+  void testY4MBackgroundIndex();
+  void testY4MReloadRebuildsIndex();
+  void testRawDataBuffersAreRecycled();
+};
+
+namespace
+{
+
+// 8x4 pixels in 4:2:0 with 8 bit
+constexpr auto Y4M_HEADER     = "YUV4MPEG2 W8 H4 F25:1\n";
+constexpr auto FRAME_DATASIZE = 8 * 4 * 3 / 2;
+
+// Write a y4m file with one frame per frame header. All samples of frame i have the value i + 1.
+void writeY4MFile(const std::string &filename, const std::vector<std::string> &frameHeaders)
+{
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  file << Y4M_HEADER;
+  for (size_t i = 0; i < frameHeaders.size(); i++)
+  {
+    file << frameHeaders[i];
+    file << std::string(FRAME_DATASIZE, char(i + 1));
+  }
+}
+
+void checkFrames(playlistItemRawFile &item, int nrFrames)
+{
+  QCOMPARE(item.properties().startEndRange, indexRange(0, nrFrames - 1));
+
+  auto video = dynamic_cast<video::videoHandler *>(item.getFrameHandler());
+  QVERIFY(video != nullptr);
+  for (int i = 0; i < nrFrames; i++)
+  {
+    const auto data = video->loadRawFrameData(i);
+    QCOMPARE(data, QByteArray(FRAME_DATASIZE, char(i + 1)));
+  }
+}
+
+} // namespace
+
+void PlaylistItemRawFileTest::testY4MConstantFrameDistance()
+{
+  TemporaryFile y4mFile("y4m");
+  writeY4MFile(y4mFile.getFilename(), std::vector<std::string>(5, "FRAME\n"));
+
+  // All frame headers have the same length. All frames are known right away.
+  playlistItemRawFile item(QString::fromStdString(y4mFile.getFilename()));
+  checkFrames(item, 5);
+}
+
+void PlaylistItemRawFileTest::testY4MBackgroundIndex()
+{
+  TemporaryFile y4mFile("y4m");
+  writeY4MFile(y4mFile.getFilename(),
+               {"FRAME\n", "FRAME Ip\n", "FRAME\n", "FRAME Ip XCOMMENT\n", "FRAME\n"});
+
+  // The frame headers differ in length. The frames are indexed in the background.
+  playlistItemRawFile item(QString::fromStdString(y4mFile.getFilename()));
+  QTRY_COMPARE(item.properties().startEndRange, indexRange(0, 4));
+  checkFrames(item, 5);
+}
+
+void PlaylistItemRawFileTest::testY4MReloadRebuildsIndex()
+{
+  TemporaryFile y4mFile("y4m");
+  writeY4MFile(y4mFile.getFilename(), std::vector<std::string>(3, "FRAME\n"));
+
+  playlistItemRawFile item(QString::fromStdString(y4mFile.getFilename()));
+  checkFrames(item, 3);
+
+  // The frames move and there are more of them
+  writeY4MFile(y4mFile.getFilename(), {"FRAME Ip\n", "FRAME\n", "FRAME\n", "FRAME\n", "FRAME\n"});
+  item.reloadItemSource();
+  QTRY_COMPARE(item.properties().startEndRange, indexRange(0, 4));
+  checkFrames(item, 5);
+
+  // And back to a constant distance
+  writeY4MFile(y4mFile.getFilename(), std::vector<std::string>(4, "FRAME\n"));
+  item.reloadItemSource();
+  checkFrames(item, 4);
+}
+
+// While playing, the buffer of the last frame goes back to the pool and is reused for the next one
+void PlaylistItemRawFileTest::testRawDataBuffersAreRecycled()
+{
+  constexpr auto NR_FRAMES = 6;
+
+  TemporaryFile yuvFile("yuv");
+  {
+    std::ofstream file(yuvFile.getFilename(), std::ios::binary | std::ios::trunc);
+    for (int i = 0; i < NR_FRAMES; i++)
+      file << std::string(FRAME_DATASIZE, char(i + 1));
+  }
+
+  const auto format = video::yuv::PixelFormatYUV(video::yuv::Subsampling::YUV_420, 8);
+  playlistItemRawFile item(QString::fromStdString(yuvFile.getFilename()),
+                           QSize(8, 4),
+                           QString::fromStdString(format.getName()));
+
+  const auto statisticsBefore = video::FrameBufferPool::instance().getStatistics();
+  for (int i = 0; i < NR_FRAMES; i++)
+    item.loadFrame(i, false, false, false);
+  const auto statisticsAfter = video::FrameBufferPool::instance().getStatistics();
+
+  // The first two frames need new buffers. After that, the buffer of the frame before the last one
+  // is free.
+  QVERIFY(int(statisticsAfter.hits - statisticsBefore.hits) >= NR_FRAMES - 2);
+
+  // The recycled buffers hold the right frames
+  auto video = dynamic_cast<video::videoHandler *>(item.getFrameHandler());
+  QVERIFY(video != nullptr);
+  QCOMPARE(video->loadRawFrameData(NR_FRAMES - 1),
+           QByteArray(FRAME_DATASIZE, char(NR_FRAMES)));
+}
+
+QTEST_MAIN(PlaylistItemRawFileTest)
+
+#include "PlaylistItemRawFileTest.moc"
@@ -0,0 +1,71 @@
+#include <QtTest>
+
+#include "statistics/StatisticsData.h"
+#include "statistics/StatisticsDataPainting.h"
+
+#include <QPainter>
+
+class StatisticsDataTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  StatisticsDataTest(){};
+  ~StatisticsDataTest(){};
+
+private slots:
+  void testCopyIsIndependent();
+};
+
+namespace
+{
+
+constexpr auto TYPE_ID = 1;
+
+void setFrameData(stats::StatisticsData &data, int frameIndex, int value)
+{
+  data.setFrameIndex(frameIndex);
+  data[TYPE_ID].addBlockValue(0, 0, 8, 8, value);
+  data[TYPE_ID].addBlockValue(8, 8, 8, 8, 3 - value);
+}
+
+// Paint the statistics of the frame like the view does (centered at (0,0))
+QImage paint(stats::StatisticsData &data, int frameIndex)
+{
+  QImage image(16, 16, QImage::Format_ARGB32_Premultiplied);
+  image.fill(Qt::transparent);
+  QPainter painter(&image);
+  painter.translate(8, 8);
+  stats::paintStatisticsData(&painter, data, frameIndex, 1.0);
+  return image;
+}
+
+} // namespace
+
+// The draw functions of the items draw a copy of the statistics in another thread. The copy must
+// not change when the item loads the statistics of the next frame.
+void StatisticsDataTest::testCopyIsIndependent()
+{
+  stats::StatisticsData data;
+  data.setFrameSize(Size(16u, 16u));
+  data.addStatType(stats::StatisticsType(
+      TYPE_ID, "Value", stats::color::ColorMapper({0, 3}, stats::color::PredefinedType::Jet)));
+  data.getStatisticsTypes()[0].render = true;
+  setFrameData(data, 0, 0);
+
+  // Only the statistics of the current frame are painted
+  const auto frame0 = paint(data, 0);
+  QVERIFY(frame0 != paint(data, 1));
+
+  stats::StatisticsData copy(data);
+  QCOMPARE(copy.getFrameIndex(), 0);
+  QCOMPARE(paint(copy, 0), frame0);
+
+  setFrameData(data, 1, 3);
+  QVERIFY(paint(data, 1) != frame0);
+  QCOMPARE(paint(copy, 0), frame0);
+}
+
+QTEST_MAIN(StatisticsDataTest)
+
+#include "StatisticsDataTest.moc"
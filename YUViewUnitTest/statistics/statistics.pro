@@ -3,4 +3,5 @@ TEMPLATE = subdirs
 requires(qtHaveModule(testlib))
 
 SUBDIRS = StatisticsFileCSVTest.pro \
-          StatisticsFileVTMBMSTest.pro
+          StatisticsFileVTMBMSTest.pro \
+          StatisticsDataTest.pro
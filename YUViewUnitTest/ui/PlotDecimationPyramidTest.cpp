@@ -0,0 +1,224 @@
+#include <QtTest>
+
+#include <ui/views/PlotDecimationPyramid.h>
+
+#include <algorithm>
+#include <random>
+
+class PlotDecimationPyramidTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  PlotDecimationPyramidTest(){};
+  ~PlotDecimationPyramidTest(){};
+
+private slots:
+  void testDecimatedValues();
+  void testRangeQueries();
+  void testInsertAndSet();
+  void testBucketCollector();
+};
+
+namespace
+{
+
+using Points = std::vector<PlotModel::Point>;
+
+Points createPoints(size_t nrPoints, unsigned seed)
+{
+  std::mt19937                    generator(seed);
+  std::uniform_int_distribution<> distribution(0, 100000);
+
+  Points points;
+  for (size_t i = 0; i < nrPoints; i++)
+    points.push_back({double(i), double(distribution(generator)), 1.0, i % 8 == 0});
+  return points;
+}
+
+// The expected bucket for the given points, calculated directly from the points
+PlotModel::Bucket reduce(const Points &points, unsigned firstPointIndex, unsigned nrPoints)
+{
+  PlotModel::Bucket bucket;
+  bucket.xMin            = points[firstPointIndex].x - points[firstPointIndex].width / 2;
+  bucket.xMax            = points[firstPointIndex].x + points[firstPointIndex].width / 2;
+  bucket.yMin            = points[firstPointIndex].y;
+  bucket.yMax            = points[firstPointIndex].y;
+  bucket.yFirst          = points[firstPointIndex].y;
+  bucket.yLast           = points[firstPointIndex + nrPoints - 1].y;
+  bucket.firstPointIndex = firstPointIndex;
+  bucket.nrPoints        = nrPoints;
+
+  double ySum = 0;
+  for (auto i = firstPointIndex; i < firstPointIndex + nrPoints; i++)
+  {
+    const auto &point = points[i];
+    bucket.xMin       = std::min(bucket.xMin, point.x - point.width / 2);
+    bucket.xMax       = std::max(bucket.xMax, point.x + point.width / 2);
+    bucket.yMin       = std::min(bucket.yMin, point.y);
+    bucket.yMax       = std::max(bucket.yMax, point.y);
+    ySum += point.y;
+    if (point.intra)
+      bucket.yMaxIntra = bucket.intra ? std::max(bucket.yMaxIntra, point.y) : point.y;
+    bucket.intra = bucket.intra || point.intra;
+  }
+  bucket.yAverage = ySum / nrPoints;
+  return bucket;
+}
+
+void compareBuckets(const PlotModel::Bucket &actual, const PlotModel::Bucket &expected)
+{
+  QCOMPARE(actual.firstPointIndex, expected.firstPointIndex);
+  QCOMPARE(actual.nrPoints, expected.nrPoints);
+  QCOMPARE(actual.xMin, expected.xMin);
+  QCOMPARE(actual.xMax, expected.xMax);
+  QCOMPARE(actual.yMin, expected.yMin);
+  QCOMPARE(actual.yMax, expected.yMax);
+  QCOMPARE(actual.yFirst, expected.yFirst);
+  QCOMPARE(actual.yLast, expected.yLast);
+  QCOMPARE(actual.intra, expected.intra);
+  QCOMPARE(actual.yMaxIntra, expected.yMaxIntra);
+  QVERIFY(std::abs(actual.yAverage - expected.yAverage) <= 1e-6 * expected.yAverage + 1e-9);
+}
+
+// Check that the buckets are contiguous, that they cover at least the points in the range (plus
+// one point on each side) and that every bucket matches a direct reduction of its points.
+void checkBuckets(const std::vector<PlotModel::Bucket> &buckets,
+                  const Points &                        points,
+                  Range<double>                         xRange)
+{
+  QVERIFY(!buckets.empty());
+
+  auto firstInRange = size_t(0);
+  while (firstInRange < points.size() && points[firstInRange].x < xRange.min)
+    firstInRange++;
+  auto endInRange = firstInRange;
+  while (endInRange < points.size() && points[endInRange].x <= xRange.max)
+    endInRange++;
+  const auto expectedFirst = (firstInRange > 0) ? firstInRange - 1 : firstInRange;
+  const auto expectedEnd   = std::min(endInRange + 1, points.size());
+
+  QVERIFY(buckets.front().firstPointIndex <= expectedFirst);
+  const auto &last = buckets.back();
+  QVERIFY(last.firstPointIndex + last.nrPoints >= expectedEnd);
+
+  auto nextPointIndex = buckets.front().firstPointIndex;
+  for (const auto &bucket : buckets)
+  {
+    QCOMPARE(bucket.firstPointIndex, nextPointIndex);
+    QVERIFY(bucket.nrPoints > 0);
+    compareBuckets(bucket, reduce(points, bucket.firstPointIndex, bucket.nrPoints));
+    nextPointIndex += bucket.nrPoints;
+  }
+}
+
+PlotDecimationPyramid createPyramid(const Points &points)
+{
+  PlotDecimationPyramid pyramid;
+  for (const auto &point : points)
+    pyramid.append(point);
+  return pyramid;
+}
+
+} // namespace
+
+void PlotDecimationPyramidTest::testDecimatedValues()
+{
+  const auto points  = createPoints(1000, 42);
+  const auto pyramid = createPyramid(points);
+  QCOMPARE(pyramid.size(), points.size());
+
+  // Without a column width, every point is returned on its own
+  const auto allPoints = pyramid.getBuckets({0, 999}, 0);
+  QCOMPARE(allPoints.size(), points.size());
+  checkBuckets(allPoints, points, {0, 999});
+
+  // With n points per column, level log2(n) of the pyramid is used
+  for (const auto pointsPerColumn : {2.0, 4.0, 16.0, 128.0, 1000.0})
+  {
+    const auto buckets = pyramid.getBuckets({0, 999}, pointsPerColumn);
+    QVERIFY(buckets.size() < points.size());
+    QVERIFY(buckets.size() <= size_t(1000 / pointsPerColumn) + 2);
+    checkBuckets(buckets, points, {0, 999});
+  }
+}
+
+void PlotDecimationPyramidTest::testRangeQueries()
+{
+  const auto points  = createPoints(5000, 7);
+  const auto pyramid = createPyramid(points);
+
+  std::mt19937                       generator(42);
+  std::uniform_real_distribution<>   xDistribution(-100, 5100);
+  std::uniform_int_distribution<int> columnDistribution(1, 500);
+  for (int i = 0; i < 200; i++)
+  {
+    auto x1 = xDistribution(generator);
+    auto x2 = xDistribution(generator);
+    if (x1 > x2)
+      std::swap(x1, x2);
+    if (x2 < 0 || x1 > 4999)
+      continue;
+
+    const auto xRange      = Range<double>({x1, x2});
+    const auto columnWidth = (x2 - x1) / columnDistribution(generator);
+    checkBuckets(pyramid.getBuckets(xRange, columnWidth), points, xRange);
+  }
+}
+
+void PlotDecimationPyramidTest::testInsertAndSet()
+{
+  auto points  = createPoints(300, 3);
+  auto pyramid = createPyramid(points);
+
+  // Points inserted out of order (e.g. frames that are parsed later) move all following points
+  auto insertPoints = createPoints(20, 4);
+  for (unsigned i = 0; i < insertPoints.size(); i++)
+  {
+    const auto index = size_t(i * 13 % points.size());
+    points.insert(points.begin() + index, insertPoints[i]);
+    pyramid.insert(index, insertPoints[i]);
+  }
+  for (size_t i = 0; i < points.size(); i++)
+    points[i].x = double(i);
+  for (size_t i = 0; i < points.size(); i++)
+    pyramid.set(i, points[i]);
+
+  points[100].y = 200000;
+  pyramid.set(100, points[100]);
+  points.back().y = 0;
+  pyramid.set(points.size() - 1, points.back());
+
+  const auto xRange = Range<double>({0, double(points.size() - 1)});
+  QCOMPARE(pyramid.size(), points.size());
+  checkBuckets(pyramid.getBuckets(xRange, 0), points, xRange);
+  checkBuckets(pyramid.getBuckets(xRange, 8), points, xRange);
+
+  const auto allInOne = pyramid.getBuckets(xRange, 10000);
+  QCOMPARE(allInOne.size(), size_t(1));
+  QCOMPARE(allInOne[0].yMax, 200000.0);
+  QCOMPARE(allInOne[0].yMin, 0.0);
+
+  pyramid.clear();
+  QCOMPARE(pyramid.size(), size_t(0));
+  QVERIFY(pyramid.getBuckets(xRange, 1).empty());
+}
+
+void PlotDecimationPyramidTest::testBucketCollector()
+{
+  const auto points = createPoints(100, 5);
+
+  // Points 0-9 go to column 0, 10-19 to column 1, ...
+  PlotBucketCollector collector(-0.5, 10);
+  for (unsigned i = 0; i < points.size(); i++)
+    collector.add(PlotBucketCollector::bucketFromPoint(points[i], i));
+
+  const auto buckets = collector.takeBuckets();
+  QCOMPARE(buckets.size(), size_t(10));
+  for (unsigned i = 0; i < buckets.size(); i++)
+    compareBuckets(buckets[i], reduce(points, i * 10, 10));
+}
+
+QTEST_MAIN(PlotDecimationPyramidTest)
+
+#include "PlotDecimationPyramidTest.moc"
@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+
+requires(qtHaveModule(testlib))
+
+SUBDIRS = PlotDecimationPyramidTest.pro
@@ -0,0 +1,159 @@
+#include <QtTest>
+
+#include <common/TemporaryFile.h>
+#include <playlistitem/playlistItemRawFile.h>
+#include <video/CachePolicy.h>
+#include <video/PixelFormatYUV.h>
+
+#include <fstream>
+#include <memory>
+
+using namespace video;
+
+class CachePolicyTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  CachePolicyTest(){};
+  ~CachePolicyTest(){};
+
+private slots:
+  void testRecentlyUsedForward();
+  void testRecentlyUsedBackward();
+  void testRecentlyUsedPlayingAtEnd();
+  void testLoopRegionWrapsAround();
+};
+
+namespace
+{
+
+constexpr auto NR_FRAMES = 10;
+// The cache can hold this many frames
+constexpr auto CACHE_FRAMES = 4;
+
+using CacheJobs     = QList<QPair<playlistItem *, indexRange>>;
+using EvictionOrder = QList<QPair<playlistItem *, int>>;
+
+// Write a file with 8x4 frames in 4:2:0 with 8 bit
+std::unique_ptr<playlistItemRawFile> createYUVItem(const TemporaryFile &file)
+{
+  {
+    std::ofstream stream(file.getFilename(), std::ios::binary | std::ios::trunc);
+    for (int i = 0; i < NR_FRAMES; i++)
+      stream << std::string(8 * 4 * 3 / 2, char(i * 20));
+  }
+  const auto format = yuv::PixelFormatYUV(yuv::Subsampling::YUV_420, 8);
+  return std::make_unique<playlistItemRawFile>(QString::fromStdString(file.getFilename()),
+                                               QSize(8, 4),
+                                               QString::fromStdString(format.getName()));
+}
+
+// A playlist of two items where the first one is selected. The frames of the items are cached in
+// the given order which is also the order of the last access.
+class Playlist
+{
+public:
+  Playlist(const QList<QPair<int, int>> &cachedFrames)
+  {
+    this->itemA = createYUVItem(this->fileA);
+    this->itemB = createYUVItem(this->fileB);
+    for (const auto &frame : cachedFrames)
+      this->getItem(frame.first)->cacheFrame(frame.second, false);
+  }
+
+  CacheState getState(int currentFrame, int playbackDirection, bool playing) const
+  {
+    CacheState state;
+    state.allItems          = {this->itemA.get(), this->itemB.get()};
+    state.selectedItem      = this->itemA.get();
+    state.selectedItemPos   = 0;
+    state.playing           = playing;
+    state.currentFrame      = currentFrame;
+    state.playbackDirection = playbackDirection;
+    state.cacheLevelMax     = CACHE_FRAMES * int64_t(this->itemA->getCachingFrameSize());
+    return state;
+  }
+
+  playlistItem *getItem(int i) const { return i == 0 ? this->itemA.get() : this->itemB.get(); }
+
+private:
+  TemporaryFile                        fileA{"yuv"};
+  TemporaryFile                        fileB{"yuv"};
+  std::unique_ptr<playlistItemRawFile> itemA;
+  std::unique_ptr<playlistItemRawFile> itemB;
+};
+
+QHash<int, int> createRanking(const std::vector<int> &frames)
+{
+  QHash<int, int> ranking;
+  for (int i = 0; i < int(frames.size()); i++)
+    ranking.insert(frames[i], i);
+  return ranking;
+}
+
+} // namespace
+
+void CachePolicyTest::testRecentlyUsedForward()
+{
+  Playlist   playlist({{1, 0}, {0, 2}, {0, 1}});
+  const auto a = playlist.getItem(0);
+  const auto b = playlist.getItem(1);
+
+  const auto policy = createCachePolicy(CachePolicyType::RecentlyUsed);
+  const auto plan   = policy->plan(playlist.getState(5, 1, false));
+  QCOMPARE(plan.protectedFrames, createRanking({5, 6, 7, 8}));
+  QCOMPARE(plan.cacheJobs, CacheJobs({{a, indexRange(5, 8)}}));
+  QCOMPARE(plan.evictionOrder, EvictionOrder({{b, 0}, {a, 2}, {a, 1}}));
+}
+
+void CachePolicyTest::testRecentlyUsedBackward()
+{
+  Playlist   playlist({{1, 0}, {0, 2}, {0, 1}});
+  const auto a = playlist.getItem(0);
+  const auto b = playlist.getItem(1);
+
+  // The frames before the playhead are kept. Frame 2 is cached already and is not removed.
+  const auto policy = createCachePolicy(CachePolicyType::RecentlyUsed);
+  const auto plan   = policy->plan(playlist.getState(5, -1, false));
+  QCOMPARE(plan.protectedFrames, createRanking({5, 4, 3, 2}));
+  QCOMPARE(plan.cacheJobs,
+           CacheJobs({{a, indexRange(5, 5)}, {a, indexRange(4, 4)}, {a, indexRange(3, 3)}}));
+  QCOMPARE(plan.evictionOrder, EvictionOrder({{b, 0}, {a, 1}}));
+}
+
+// At the end of the selected item, the remaining space is used for the item that is played next
+void CachePolicyTest::testRecentlyUsedPlayingAtEnd()
+{
+  Playlist   playlist({{1, 0}, {0, 2}, {0, 1}});
+  const auto a = playlist.getItem(0);
+  const auto b = playlist.getItem(1);
+
+  const auto policy = createCachePolicy(CachePolicyType::RecentlyUsed);
+  const auto plan   = policy->plan(playlist.getState(8, 1, true));
+  QCOMPARE(plan.protectedFrames, createRanking({8, 9}));
+  QCOMPARE(plan.cacheJobs, CacheJobs({{a, indexRange(8, 9)}, {b, indexRange(1, 1)}}));
+  QCOMPARE(plan.evictionOrder, EvictionOrder({{b, 0}, {a, 2}, {a, 1}}));
+}
+
+// The loop continues at the start of the range. The frames of the loop that are shown last are
+// removed last (after the other items) and in the order of the loop and not of the last access.
+void CachePolicyTest::testLoopRegionWrapsAround()
+{
+  Playlist   playlist({{0, 3}, {0, 5}, {1, 0}, {0, 7}, {0, 1}});
+  const auto a = playlist.getItem(0);
+  const auto b = playlist.getItem(1);
+
+  const auto policy = createCachePolicy(CachePolicyType::LoopRegion);
+  for (const auto direction : {1, -1})
+  {
+    const auto plan = policy->plan(playlist.getState(8, direction, true));
+    QCOMPARE(plan.protectedFrames, createRanking({8, 9, 0, 1}));
+    QCOMPARE(plan.cacheJobs, CacheJobs({{a, indexRange(8, 9)}, {a, indexRange(0, 0)}}));
+    QCOMPARE(plan.evictionOrder, EvictionOrder({{b, 0}, {a, 7}, {a, 5}, {a, 3}}));
+  }
+}
+
+QTEST_MAIN(CachePolicyTest)
+
+#include "CachePolicyTest.moc"
@@ -0,0 +1,243 @@
+#include <QtTest>
+
+#include <video/DifferenceKernel.h>
+
+#include <random>
+
+using namespace video::yuv;
+
+class DifferenceKernelTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  DifferenceKernelTest(){};
+  ~DifferenceKernelTest(){};
+
+private slots:
+  void testIdenticalFrames();
+  void testDifference_data();
+  void testDifference();
+  void testMarkDifferences();
+  void testFirstDifferenceHEVC();
+};
+
+namespace
+{
+
+void writeSample(QByteArray &data, int idx, int value, unsigned bitDepth, bool bigEndian)
+{
+  if (bitDepth <= 8)
+    data[idx] = char(value);
+  else
+  {
+    data[idx * 2]     = char(bigEndian ? value >> 8 : value & 0xff);
+    data[idx * 2 + 1] = char(bigEndian ? value & 0xff : value >> 8);
+  }
+}
+
+int readSample(const QByteArray &data, int idx, unsigned bitDepth)
+{
+  const auto src = reinterpret_cast<const unsigned char *>(data.constData());
+  if (bitDepth <= 8)
+    return src[idx];
+  return src[idx * 2] | (src[idx * 2 + 1] << 8);
+}
+
+} // namespace
+
+void DifferenceKernelTest::testIdenticalFrames()
+{
+  const auto frameSize = Size(64, 32);
+  const auto format    = PixelFormatYUV(Subsampling::YUV_420, 8);
+  QByteArray frame(int(format.bytesPerFrame(frameSize)), char(42));
+
+  QByteArray     diffYUV;
+  PixelFormatYUV diffFormat;
+  const auto     result = calculateDifferencePlanar(
+      frame, format, frameSize, frame, format, frameSize, 1, diffYUV, diffFormat);
+
+  QCOMPARE(result.planes.size(), size_t(3));
+  for (const auto &plane : result.planes)
+  {
+    QCOMPARE(plane.sumSquaredError, uint64_t(0));
+    QCOMPARE(plane.maxAbsDifference, 0u);
+  }
+  for (auto hasDifference : result.blockHasDifference)
+    QCOMPARE(hasDifference, uint8_t(0));
+  for (auto value : diffYUV)
+    QCOMPARE(int(uint8_t(value)), 128);
+}
+
+void DifferenceKernelTest::testDifference_data()
+{
+  QTest::addColumn<unsigned>("bitDepth0");
+  QTest::addColumn<unsigned>("bitDepth1");
+  QTest::addColumn<bool>("bigEndian1");
+  QTest::addColumn<bool>("interleaved0");
+  QTest::addColumn<int>("amplification");
+
+  QTest::newRow("8bit") << 8u << 8u << false << false << 1;
+  QTest::newRow("8bitAmplified") << 8u << 8u << false << false << 4;
+  QTest::newRow("8bitStrongAmplified") << 8u << 8u << false << false << 500;
+  QTest::newRow("8bitInterleaved") << 8u << 8u << false << true << 1;
+  QTest::newRow("10bit") << 10u << 10u << false << false << 1;
+  QTest::newRow("10bitBigEndian") << 10u << 10u << true << false << 2;
+  QTest::newRow("8bitTo10bit") << 8u << 10u << false << false << 1;
+  QTest::newRow("16bitTo8bit") << 16u << 8u << false << true << 1;
+}
+
+void DifferenceKernelTest::testDifference()
+{
+  QFETCH(unsigned, bitDepth0);
+  QFETCH(unsigned, bitDepth1);
+  QFETCH(bool, bigEndian1);
+  QFETCH(bool, interleaved0);
+  QFETCH(int, amplification);
+
+  // Big enough to be split into stripes and not a multiple of the vector width
+  const auto frameSize = Size(150, 260);
+  const auto format0 =
+      PixelFormatYUV(Subsampling::YUV_420, bitDepth0, PlaneOrder::YUV, false, {}, interleaved0);
+  const auto format1 = PixelFormatYUV(Subsampling::YUV_420, bitDepth1, PlaneOrder::YVU, bigEndian1);
+
+  const int lumaSamples   = int(frameSize.width * frameSize.height);
+  const int chromaSamples = lumaSamples / 4;
+  const int chromaWidth   = int(frameSize.width / 2);
+
+  QByteArray frame0(int(format0.bytesPerFrame(frameSize)), 0);
+  QByteArray frame1(int(format1.bytesPerFrame(frameSize)), 0);
+
+  std::mt19937 random(42);
+  const auto   bitDepthOut = std::max(bitDepth0, bitDepth1);
+  const int    diffZero    = 128 << (bitDepthOut - 8);
+  const int    maxVal      = (1 << bitDepthOut) - 1;
+
+  uint64_t             expectedSSE[3]{};
+  unsigned             expectedMax[3]{};
+  std::vector<int>     expectedDiff(lumaSamples + 2 * chromaSamples);
+  const auto           blocksHor = (frameSize.width + 3) / 4;
+  std::vector<uint8_t> expectedBlocks(blocksHor * ((frameSize.height + 3) / 4), 0);
+
+  for (int c = 0; c < 3; c++)
+  {
+    const auto nrSamples = (c == 0) ? lumaSamples : chromaSamples;
+    for (int i = 0; i < nrSamples; i++)
+    {
+      const int value0 = int(random() % (1u << bitDepth0));
+      int       value1 = (bitDepth1 >= bitDepth0) ? value0 << (bitDepth1 - bitDepth0)
+                                                  : value0 >> (bitDepth0 - bitDepth1);
+      if (random() % 20 == 0)
+        value1 = int(random() % (1u << bitDepth1));
+
+      // Input 0: Y, then U and V (possibly interleaved)
+      int idx0 = i;
+      if (c > 0 && interleaved0)
+        idx0 = lumaSamples + i * 2 + (c - 1);
+      else if (c > 0)
+        idx0 = lumaSamples + (c - 1) * chromaSamples + i;
+      writeSample(frame0, idx0, value0, bitDepth0, false);
+      // Input 1: Y, then V and U
+      const int idx1 = (c == 0) ? i : lumaSamples + (2 - c) * chromaSamples + i;
+      writeSample(frame1, idx1, value1, bitDepth1, bigEndian1);
+
+      const auto diff =
+          (value0 << (bitDepthOut - bitDepth0)) - (value1 << (bitDepthOut - bitDepth1));
+      expectedSSE[c] += uint64_t(int64_t(diff) * diff);
+      expectedMax[c] = std::max(expectedMax[c], unsigned(std::abs(diff)));
+      const auto outIdx    = (c == 0) ? i : lumaSamples + (c - 1) * chromaSamples + i;
+      expectedDiff[outIdx] = std::clamp(diff * amplification + diffZero, 0, maxVal);
+
+      if (diff != 0)
+      {
+        const int lumaX = (c == 0) ? i % int(frameSize.width) : (i % chromaWidth) * 2;
+        const int lumaY = (c == 0) ? i / int(frameSize.width) : (i / chromaWidth) * 2;
+        expectedBlocks[(lumaY / 4) * blocksHor + lumaX / 4] = 1;
+      }
+    }
+  }
+
+  QByteArray     diffYUV;
+  PixelFormatYUV diffFormat;
+  const auto     result = calculateDifferencePlanar(
+      frame0, format0, frameSize, frame1, format1, frameSize, amplification, diffYUV, diffFormat);
+
+  QCOMPARE(diffFormat.getBitsPerSample(), bitDepthOut);
+  QCOMPARE(result.planes.size(), size_t(3));
+  for (int c = 0; c < 3; c++)
+  {
+    QCOMPARE(result.planes[c].sumSquaredError, expectedSSE[c]);
+    QCOMPARE(result.planes[c].maxAbsDifference, expectedMax[c]);
+  }
+  for (int i = 0; i < int(expectedDiff.size()); i++)
+    QCOMPARE(readSample(diffYUV, i, bitDepthOut), expectedDiff[i]);
+  QCOMPARE(result.blockHasDifference, expectedBlocks);
+}
+
+void DifferenceKernelTest::testMarkDifferences()
+{
+  // 4:4:4, one pixel for each combination of differences
+  const auto frameSize = Size(4, 1);
+  const auto format    = PixelFormatYUV(Subsampling::YUV_444, 8);
+  QByteArray diffYUV(12, char(128));
+  // Pixel 0: No difference. Pixel 1: Y differs. Pixel 2: U differs. Pixel 3: Y and V differ.
+  diffYUV[1]     = char(129);
+  diffYUV[4 + 2] = char(127);
+  diffYUV[3]     = char(130);
+  diffYUV[8 + 3] = char(100);
+
+  std::vector<unsigned char> rgb(16);
+  markDifferencesToRGB(diffYUV, format, frameSize, rgb.data());
+
+  // BGRA
+  const std::vector<unsigned char> expected = {
+      0, 0, 0, 255, 70, 70, 70, 255, 0, 70, 0, 255, 255, 0, 0, 255};
+  QCOMPARE(rgb, expected);
+}
+
+void DifferenceKernelTest::testFirstDifferenceHEVC()
+{
+  // A 150x100 frame. This is 3x2 LCUs, the right and bottom LCUs are only partly in the frame.
+  DifferenceResult result;
+  result.blocksHor = 38;
+  result.blocksVer = 25;
+
+  auto setDifferences = [&](std::vector<std::pair<unsigned, unsigned>> blocks) {
+    result.blockHasDifference.assign(result.blocksHor * result.blocksVer, 0);
+    for (const auto &block : blocks)
+      result.blockHasDifference[block.second * result.blocksHor + block.first] = 1;
+  };
+
+  setDifferences({});
+  QVERIFY(!findFirstDifferenceHEVC(result));
+
+  // The LCUs are scanned in raster order, the blocks within each LCU in z-order
+  setDifferences({{20, 3}, {0, 15}});
+  auto position = findFirstDifferenceHEVC(result);
+  QVERIFY(position);
+  QCOMPARE(position->lcu, 0u);
+  QCOMPARE(position->x, 0u);
+  QCOMPARE(position->y, 60u);
+  QCOMPARE(position->partIndex, 170u);
+
+  setDifferences({{20, 3}});
+  position = findFirstDifferenceHEVC(result);
+  QVERIFY(position);
+  QCOMPARE(position->lcu, 1u);
+  QCOMPARE(position->x, 80u);
+  QCOMPARE(position->y, 12u);
+  QCOMPARE(position->partIndex, 26u);
+
+  // Blocks outside of the frame are not counted
+  setDifferences({{32, 24}});
+  position = findFirstDifferenceHEVC(result);
+  QVERIFY(position);
+  QCOMPARE(position->lcu, 5u);
+  QCOMPARE(position->x, 128u);
+  QCOMPARE(position->y, 96u);
+  QCOMPARE(position->partIndex, 48u);
+}
+
+QTEST_MAIN(DifferenceKernelTest)
+
+#include "DifferenceKernelTest.moc"
@@ -0,0 +1,121 @@
+#include <QtTest>
+
+#include <video/FrameBufferPool.h>
+
+using namespace video;
+
+class FrameBufferPoolTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FrameBufferPoolTest(){};
+  ~FrameBufferPoolTest(){};
+
+private slots:
+  void init();
+  void testAcquireAndRecycleByteArray();
+  void testAcquireAndRecycleImage();
+  void testSharedBuffersAreNotPooled();
+  void testByteLimit();
+};
+
+void FrameBufferPoolTest::init()
+{
+  auto &pool = FrameBufferPool::instance();
+  pool.setMaxPooledBytes(int64_t(64) * 1024 * 1024);
+  pool.clear();
+}
+
+void FrameBufferPoolTest::testAcquireAndRecycleByteArray()
+{
+  auto &pool = FrameBufferPool::instance();
+
+  auto buffer = pool.getByteArray(1000);
+  QCOMPARE(buffer.size(), 1000);
+  QCOMPARE(pool.getStatistics().hits, uint64_t(0));
+
+  const auto data = buffer.constData();
+  pool.recycle(buffer);
+  QVERIFY(buffer.isEmpty());
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(1000));
+
+  // A buffer of another size is not handed out
+  QCOMPARE(pool.getByteArray(500).size(), 500);
+  QCOMPARE(pool.getStatistics().hits, uint64_t(0));
+
+  auto reused = pool.getByteArray(1000);
+  QCOMPARE(reused.size(), 1000);
+  QVERIFY(reused.constData() == data);
+  QCOMPARE(pool.getStatistics().hits, uint64_t(1));
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(0));
+}
+
+void FrameBufferPoolTest::testAcquireAndRecycleImage()
+{
+  auto &pool = FrameBufferPool::instance();
+
+  auto image = pool.getImage(QSize(64, 32), QImage::Format_RGB32);
+  QCOMPARE(image.size(), QSize(64, 32));
+  QCOMPARE(image.format(), QImage::Format_RGB32);
+
+  const auto bits = image.constBits();
+  pool.recycle(image);
+  QVERIFY(image.isNull());
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(64 * 32 * 4));
+
+  // The format is part of the key
+  QCOMPARE(pool.getImage(QSize(64, 32), QImage::Format_ARGB32).format(), QImage::Format_ARGB32);
+  QCOMPARE(pool.getStatistics().hits, uint64_t(0));
+
+  auto reused = pool.getImage(QSize(64, 32), QImage::Format_RGB32);
+  QVERIFY(reused.constBits() == bits);
+  QCOMPARE(pool.getStatistics().hits, uint64_t(1));
+}
+
+void FrameBufferPoolTest::testSharedBuffersAreNotPooled()
+{
+  auto &pool = FrameBufferPool::instance();
+
+  // E.g. an image that is also held by the cache must stay with the cache only
+  auto       image  = pool.getImage(QSize(16, 16), QImage::Format_RGB32);
+  const auto cached = image;
+  pool.recycle(image);
+  QVERIFY(image.isNull());
+  QVERIFY(cached.isDetached());
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(0));
+
+  auto buffer = pool.getByteArray(100);
+  auto copy   = buffer;
+  pool.recycle(buffer);
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(0));
+  pool.recycle(copy);
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(100));
+}
+
+void FrameBufferPoolTest::testByteLimit()
+{
+  auto &pool = FrameBufferPool::instance();
+  pool.setMaxPooledBytes(2500);
+
+  QList<QByteArray> buffers;
+  for (int i = 0; i < 4; i++)
+    buffers.append(pool.getByteArray(1000));
+  for (auto &buffer : buffers)
+  {
+    pool.recycle(buffer);
+    QVERIFY(pool.getStatistics().pooledBytes <= 2500);
+  }
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(2000));
+
+  // Lowering the limit drops buffers right away
+  pool.setMaxPooledBytes(1000);
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(1000));
+  pool.setMaxPooledBytes(0);
+  QCOMPARE(pool.getStatistics().pooledBytes, int64_t(0));
+  QCOMPARE(pool.getByteArray(1000).size(), 1000);
+}
+
+QTEST_MAIN(FrameBufferPoolTest)
+
+#include "FrameBufferPoolTest.moc"
@@ -0,0 +1,75 @@
+#include <QtTest>
+
+#include <video/FrameCompression.h>
+
+#include <random>
+
+using namespace video;
+
+class FrameCompressionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FrameCompressionTest(){};
+  ~FrameCompressionTest(){};
+
+private slots:
+  void testRoundTrip_data();
+  void testRoundTrip();
+  void testUncompressedFormats();
+};
+
+void FrameCompressionTest::testRoundTrip_data()
+{
+  QTest::addColumn<bool>("noise");
+  QTest::addColumn<bool>("compressionExpected");
+
+  QTest::newRow("Gradient") << false << true;
+  QTest::newRow("Noise") << true << false;
+}
+
+void FrameCompressionTest::testRoundTrip()
+{
+  QFETCH(bool, noise);
+  QFETCH(bool, compressionExpected);
+
+  std::mt19937                    generator(42);
+  std::uniform_int_distribution<> distribution(0, 255);
+
+  QImage image(123, 45, QImage::Format_ARGB32_Premultiplied);
+  for (int y = 0; y < image.height(); y++)
+    for (int x = 0; x < image.width(); x++)
+    {
+      const auto r = noise ? distribution(generator) : x * 2;
+      const auto g = noise ? distribution(generator) : y * 5;
+      const auto b = noise ? distribution(generator) : 255 - x;
+      image.setPixel(x, y, qRgb(r, g, b));
+    }
+
+  CachedFrame frame(image, true);
+  QCOMPARE(frame.isCompressed(), compressionExpected);
+  QCOMPARE(frame.getUncompressedBytes(), int64_t(image.width()) * image.height() * 4);
+  if (compressionExpected)
+    QVERIFY(frame.getBytes() < frame.getUncompressedBytes());
+  QCOMPARE(frame.getImage(), image);
+}
+
+void FrameCompressionTest::testUncompressedFormats()
+{
+  QImage image(16, 16, QImage::Format_RGB888);
+  image.fill(Qt::gray);
+
+  CachedFrame frame(image, true);
+  QVERIFY(!frame.isCompressed());
+  QCOMPARE(frame.getImage(), image);
+
+  CachedFrame notCompressed(QImage(16, 16, QImage::Format_RGB32), false);
+  QVERIFY(!notCompressed.isCompressed());
+  QVERIFY(!notCompressed.isNull());
+  QVERIFY(CachedFrame().isNull());
+}
+
+QTEST_MAIN(FrameCompressionTest)
+
+#include "FrameCompressionTest.moc"
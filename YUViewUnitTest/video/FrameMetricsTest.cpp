@@ -0,0 +1,151 @@
+#include <QtTest>
+
+#include <video/FrameMetrics.h>
+
+#include <cmath>
+
+using namespace video::yuv;
+
+class FrameMetricsTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FrameMetricsTest(){};
+  ~FrameMetricsTest(){};
+
+private slots:
+  void testIdenticalFrames();
+  void testConstantOffset();
+  void testPlaneOrderAndInterleaving();
+  void testPackedFormat();
+  void testDifferentBitDepths();
+};
+
+namespace
+{
+
+const auto TestFrameSize = Size(16, 8);
+
+// A planar 8 bit 4:2:0 frame where each sample has a different value
+QByteArray createPlanar420Frame(int offset = 0)
+{
+  const auto lumaSamples   = int(TestFrameSize.width * TestFrameSize.height);
+  const auto chromaSamples = lumaSamples / 4;
+  QByteArray data(lumaSamples + 2 * chromaSamples, 0);
+  for (int i = 0; i < data.size(); i++)
+    data[i] = char(((i * 7) % 200) + offset);
+  return data;
+}
+
+} // namespace
+
+void FrameMetricsTest::testIdenticalFrames()
+{
+  const auto format = PixelFormatYUV(Subsampling::YUV_420, 8);
+  const auto data   = createPlanar420Frame();
+
+  PlanarFrame frame;
+  QVERIFY(convertToPlanarFrame(data, format, TestFrameSize, frame));
+  QCOMPARE(frame.planes.size(), size_t(3));
+  QCOMPARE(frame.planes[1].size, Size(8, 4));
+
+  const auto metrics = calculateMetrics(frame, frame);
+  QCOMPARE(metrics.size(), size_t(3));
+  for (const auto &componentMetrics : metrics)
+  {
+    QCOMPARE(componentMetrics.mse, 0.0);
+    QVERIFY(std::isinf(componentMetrics.psnr));
+    QCOMPARE(componentMetrics.ssim, 1.0);
+  }
+}
+
+void FrameMetricsTest::testConstantOffset()
+{
+  const auto format = PixelFormatYUV(Subsampling::YUV_420, 8);
+
+  PlanarFrame frame0, frame1;
+  QVERIFY(convertToPlanarFrame(createPlanar420Frame(), format, TestFrameSize, frame0));
+  QVERIFY(convertToPlanarFrame(createPlanar420Frame(4), format, TestFrameSize, frame1));
+
+  const auto metrics = calculateMetrics(frame0, frame1);
+  QCOMPARE(metrics.size(), size_t(3));
+  for (const auto &componentMetrics : metrics)
+  {
+    QCOMPARE(componentMetrics.mse, 16.0);
+    QCOMPARE(componentMetrics.psnr, psnrFromMSE(16.0, 8));
+    QVERIFY(componentMetrics.ssim < 1.0);
+  }
+}
+
+void FrameMetricsTest::testPlaneOrderAndInterleaving()
+{
+  const auto data        = createPlanar420Frame();
+  const auto lumaBytes   = int(TestFrameSize.width * TestFrameSize.height);
+  const auto chromaBytes = lumaBytes / 4;
+  const auto planeY      = data.mid(0, lumaBytes);
+  const auto planeU      = data.mid(lumaBytes, chromaBytes);
+  const auto planeV      = data.mid(lumaBytes + chromaBytes, chromaBytes);
+  auto       interleaved = planeY;
+  for (int i = 0; i < chromaBytes; i++)
+    interleaved.append(planeU[i]).append(planeV[i]);
+
+  PlanarFrame reference, swapped, semiPlanar;
+  QVERIFY(convertToPlanarFrame(
+      data, PixelFormatYUV(Subsampling::YUV_420, 8), TestFrameSize, reference));
+  QVERIFY(convertToPlanarFrame(planeY + planeV + planeU,
+                               PixelFormatYUV(Subsampling::YUV_420, 8, PlaneOrder::YVU),
+                               TestFrameSize,
+                               swapped));
+  QVERIFY(convertToPlanarFrame(
+      interleaved,
+      PixelFormatYUV(Subsampling::YUV_420, 8, PlaneOrder::YUV, false, {}, true),
+      TestFrameSize,
+      semiPlanar));
+
+  for (size_t i = 0; i < 3; i++)
+  {
+    QVERIFY(reference.planes[i].samples == swapped.planes[i].samples);
+    QVERIFY(reference.planes[i].samples == semiPlanar.planes[i].samples);
+  }
+}
+
+void FrameMetricsTest::testPackedFormat()
+{
+  // 2x1 pixels in UYVY: U0 Y0 V0 Y1
+  const auto frameSize = Size(2, 1);
+  const auto packed    = QByteArray("\x10\x20\x30\x40", 4);
+
+  PlanarFrame frame;
+  QVERIFY(convertToPlanarFrame(
+      packed, PixelFormatYUV(Subsampling::YUV_422, 8, PackingOrder::UYVY), frameSize, frame));
+  QCOMPARE(frame.planes.size(), size_t(3));
+  QCOMPARE(frame.planes[0].samples, std::vector<uint16_t>({0x20, 0x40}));
+  QCOMPARE(frame.planes[1].samples, std::vector<uint16_t>({0x10}));
+  QCOMPARE(frame.planes[2].samples, std::vector<uint16_t>({0x30}));
+}
+
+void FrameMetricsTest::testDifferentBitDepths()
+{
+  const auto data8Bit = createPlanar420Frame();
+  QByteArray data10Bit;
+  for (auto value : data8Bit)
+  {
+    // Little endian 10 bit values
+    const auto value10Bit = unsigned(uint8_t(value)) << 2;
+    data10Bit.append(char(value10Bit & 0xff)).append(char(value10Bit >> 8));
+  }
+
+  PlanarFrame frame8Bit, frame10Bit;
+  QVERIFY(convertToPlanarFrame(
+      data8Bit, PixelFormatYUV(Subsampling::YUV_420, 8), TestFrameSize, frame8Bit));
+  QVERIFY(convertToPlanarFrame(
+      data10Bit, PixelFormatYUV(Subsampling::YUV_420, 10), TestFrameSize, frame10Bit));
+
+  for (const auto &componentMetrics : calculateMetrics(frame8Bit, frame10Bit))
+    QCOMPARE(componentMetrics.mse, 0.0);
+}
+
+QTEST_MAIN(FrameMetricsTest)
+
+#include "FrameMetricsTest.moc"
@@ -0,0 +1,106 @@
+#include <QtTest>
+
+#include <video/ImagePyramid.h>
+
+#include <algorithm>
+
+using namespace video;
+
+class ImagePyramidTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  ImagePyramidTest(){};
+  ~ImagePyramidTest(){};
+
+private slots:
+  void testOddSize();
+  void testZoomAtPowerOfTwo();
+  void testSourceChanged();
+};
+
+namespace
+{
+
+QImage createImage(int width, int height)
+{
+  QImage image(width, height, QImage::Format_RGB32);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      image.setPixel(x, y, qRgb(x * 50 + y * 7, 255 - x * 31, y * 60 + 3));
+  return image;
+}
+
+// The rounded average of the pixels of the 2x2 block at (x, y) that are inside of the image
+QRgb averageBlock(const QImage &image, int x, int y)
+{
+  int sum[3]{};
+  int n = 0;
+  for (int yo = y; yo < std::min(y + 2, image.height()); yo++)
+    for (int xo = x; xo < std::min(x + 2, image.width()); xo++)
+    {
+      const auto pixel = image.pixel(xo, yo);
+      sum[0] += qRed(pixel);
+      sum[1] += qGreen(pixel);
+      sum[2] += qBlue(pixel);
+      n++;
+    }
+  return qRgb((sum[0] + n / 2) / n, (sum[1] + n / 2) / n, (sum[2] + n / 2) / n);
+}
+
+} // namespace
+
+// The last column and row of a level of an image with an odd size are not dropped. They are the
+// average of the pixels that exist.
+void ImagePyramidTest::testOddSize()
+{
+  const auto   image = createImage(5, 3);
+  ImagePyramid pyramid;
+
+  const auto &level = pyramid.getImageForZoom(image, 0.3);
+  QCOMPARE(level.size(), QSize(3, 2));
+  for (int y = 0; y < level.height(); y++)
+    for (int x = 0; x < level.width(); x++)
+      QCOMPARE(level.pixel(x, y), averageBlock(image, x * 2, y * 2));
+
+  // The next level rounds up again
+  QCOMPARE(pyramid.getImageForZoom(image, 0.2).size(), QSize(2, 1));
+}
+
+// The smallest level that is not smaller than the drawn image is used
+void ImagePyramidTest::testZoomAtPowerOfTwo()
+{
+  const auto   image = createImage(16, 8);
+  ImagePyramid pyramid;
+
+  QCOMPARE(&pyramid.getImageForZoom(image, 1.0), &image);
+  QCOMPARE(&pyramid.getImageForZoom(image, 0.5), &image);
+  QCOMPARE(pyramid.getImageForZoom(image, 0.25).size(), QSize(4, 2));
+  QCOMPARE(pyramid.getImageForZoom(image, 0.125).size(), QSize(2, 1));
+  QCOMPARE(pyramid.getImageForZoom(image, 0.4).size(), QSize(8, 4));
+}
+
+// The levels are built again when the image changes
+void ImagePyramidTest::testSourceChanged()
+{
+  auto         image = createImage(8, 8);
+  ImagePyramid pyramid;
+
+  const auto level = pyramid.getImageForZoom(image, 0.25);
+  QCOMPARE(pyramid.getImageForZoom(image, 0.25), level);
+
+  image.fill(qRgb(10, 20, 30));
+  const auto &changed = pyramid.getImageForZoom(image, 0.25);
+  QCOMPARE(changed.size(), QSize(2, 2));
+  QVERIFY(changed != level);
+  QCOMPARE(changed.pixel(1, 1), qRgb(10, 20, 30));
+
+  // A different image of the same size
+  const auto other = createImage(8, 8);
+  QCOMPARE(pyramid.getImageForZoom(other, 0.25), level);
+}
+
+QTEST_MAIN(ImagePyramidTest)
+
+#include "ImagePyramidTest.moc"
@@ -15,6 +15,11 @@ public:
 private slots:
   void testFormatGuessFromFilename_data();
   void testFormatGuessFromFilename();
+
+  void testLineSSE_data();
+  void testLineSSE();
+  void testFormatGuessFromCorrelation();
+  void testFormatGuessFromCorrelationFailsForShortFile();
 };
 
 PixelFormatYUVGuessTest::PixelFormatYUVGuessTest()
@@ -130,6 +135,88 @@ void PixelFormatYUVGuessTest::testFormatGuessFromFilename()
   QCOMPARE(fmtName, expectedFormatName.toStdString());
 }
 
+void PixelFormatYUVGuessTest::testLineSSE_data()
+{
+  QTest::addColumn<unsigned>("bytesPerSample");
+  QTest::addColumn<int>("nrSamples");
+
+  for (const auto bytesPerSample : {1u, 2u})
+    for (const auto nrSamples : {1, 15, 16, 17, 352, 4099, 5000})
+      QTest::newRow(qPrintable(QString("%1 byte %2 samples").arg(bytesPerSample).arg(nrSamples)))
+          << bytesPerSample << nrSamples;
+}
+
+void PixelFormatYUVGuessTest::testLineSSE()
+{
+  QFETCH(unsigned, bytesPerSample);
+  QFETCH(int, nrSamples);
+
+  QByteArray line0(nrSamples * int(bytesPerSample), 0);
+  QByteArray line1(nrSamples * int(bytesPerSample), 0);
+  auto       src0 = reinterpret_cast<unsigned char *>(line0.data());
+  auto       src1 = reinterpret_cast<unsigned char *>(line1.data());
+  for (int i = 0; i < line0.size(); i++)
+  {
+    src0[i] = static_cast<unsigned char>(i * 7 + 3);
+    src1[i] = static_cast<unsigned char>(255 - i * 13);
+  }
+
+  uint64_t expected = 0;
+  for (int i = 0; i < nrSamples; i++)
+  {
+    int64_t value0 = src0[i * bytesPerSample];
+    int64_t value1 = src1[i * bytesPerSample];
+    if (bytesPerSample == 2)
+    {
+      value0 |= int64_t(src0[i * 2 + 1]) << 8;
+      value1 |= int64_t(src1[i * 2 + 1]) << 8;
+    }
+    expected += uint64_t((value0 - value1) * (value0 - value1));
+  }
+
+  const auto sse =
+      computeLineSSE(line0.constData(), line1.constData(), line0.size(), bytesPerSample);
+  QCOMPARE(sse, expected);
+}
+
+void PixelFormatYUVGuessTest::testFormatGuessFromCorrelation()
+{
+  // Three frames of a 352x288 YUV 4:2:0 8 bit sequence with a smooth gradient
+  const Size    frameSize(352, 288);
+  const int64_t bytesPerFrame = 352 * 288 * 3 / 2;
+  QByteArray    file(int(bytesPerFrame * 3), char(128));
+  for (int frame = 0; frame < 3; frame++)
+    for (unsigned y = 0; y < frameSize.height; y++)
+      for (unsigned x = 0; x < frameSize.width; x++)
+        file[int(frame * bytesPerFrame + y * frameSize.width + x)] =
+            char((x + y) / 4 + unsigned(frame));
+
+  int64_t nrBytesRead = 0;
+  auto    reader      = [&file, &nrBytesRead](int64_t position, int64_t nrBytes) {
+    nrBytesRead += nrBytes;
+    return file.mid(int(position), int(nrBytes));
+  };
+
+  const auto sizeAndFormat = video::yuv::guessFormatFromCorrelation(reader, file.size());
+  QVERIFY(sizeAndFormat);
+  QCOMPARE(sizeAndFormat->first, frameSize);
+  QCOMPARE(sizeAndFormat->second.getName(), std::string("YUV 4:2:0 8-bit"));
+
+  // Only a fraction of the file must be read
+  QVERIFY(nrBytesRead < file.size());
+}
+
+void PixelFormatYUVGuessTest::testFormatGuessFromCorrelationFailsForShortFile()
+{
+  // Less than two frames of the smallest candidate
+  QByteArray file(1000, char(0));
+  auto       reader = [&file](int64_t position, int64_t nrBytes) {
+    return file.mid(int(position), int(nrBytes));
+  };
+
+  QVERIFY(!video::yuv::guessFormatFromCorrelation(reader, file.size()));
+}
+
 QTEST_MAIN(PixelFormatYUVGuessTest)
 
 #include "PixelFormatYUVGuessTest.moc"
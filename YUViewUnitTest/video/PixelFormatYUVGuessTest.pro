@@ -7,7 +7,7 @@ CONFIG -= app_bundled
 
 TARGET = PixelFormatYUVGuessTest
 
-QT += testlib
+QT += testlib concurrent
 QT -= gui
 
 INCLUDEPATH += $$top_srcdir/YUViewLib/src
@@ -0,0 +1,132 @@
+#include <QtTest>
+
+#include <video/PlanarYUV.h>
+
+#include "YUVTestFrame.h"
+
+using namespace video;
+using namespace video::yuv;
+using namespace test;
+
+class PlanarYUVTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  PlanarYUVTest(){};
+  ~PlanarYUVTest(){};
+
+private slots:
+  void testExtractScaledRegion_data();
+  void testExtractScaledRegion();
+};
+
+namespace
+{
+
+int readOutputSample(const QByteArray &data, size_t index, unsigned bitDepth)
+{
+  const auto src = reinterpret_cast<const unsigned char *>(data.constData());
+  if (bitDepth <= 8)
+    return src[index];
+  return src[index * 2] | (src[index * 2 + 1] << 8);
+}
+
+} // namespace
+
+void PlanarYUVTest::testExtractScaledRegion_data()
+{
+  QTest::addColumn<int>("subsampling");
+  QTest::addColumn<unsigned>("bitDepth");
+  QTest::addColumn<int>("planeOrder");
+  QTest::addColumn<bool>("bigEndian");
+  QTest::addColumn<bool>("uvInterleaved");
+  QTest::addColumn<unsigned>("scaleShift");
+
+  for (const auto scaleShift : {0u, 1u, 2u})
+  {
+    const auto scale = " 1/" + std::to_string(1 << scaleShift);
+    QTest::newRow(("420 8 bit" + scale).c_str())
+        << int(Subsampling::YUV_420) << 8u << int(PlaneOrder::YUV) << false << false << scaleShift;
+    QTest::newRow(("420 8 bit YVU" + scale).c_str())
+        << int(Subsampling::YUV_420) << 8u << int(PlaneOrder::YVU) << false << false << scaleShift;
+    QTest::newRow(("420 8 bit interleaved" + scale).c_str())
+        << int(Subsampling::YUV_420) << 8u << int(PlaneOrder::YUV) << false << true << scaleShift;
+    QTest::newRow(("420 10 bit" + scale).c_str())
+        << int(Subsampling::YUV_420) << 10u << int(PlaneOrder::YUV) << false << false << scaleShift;
+    QTest::newRow(("420 10 bit big endian" + scale).c_str())
+        << int(Subsampling::YUV_420) << 10u << int(PlaneOrder::YUV) << true << false << scaleShift;
+    QTest::newRow(("422 16 bit interleaved" + scale).c_str())
+        << int(Subsampling::YUV_422) << 16u << int(PlaneOrder::YVU) << false << true << scaleShift;
+    QTest::newRow(("444 8 bit" + scale).c_str())
+        << int(Subsampling::YUV_444) << 8u << int(PlaneOrder::YUV) << false << false << scaleShift;
+    QTest::newRow(("400 12 bit" + scale).c_str())
+        << int(Subsampling::YUV_400) << 12u << int(PlaneOrder::YUV) << false << false << scaleShift;
+  }
+}
+
+void PlanarYUVTest::testExtractScaledRegion()
+{
+  QFETCH(int, subsampling);
+  QFETCH(unsigned, bitDepth);
+  QFETCH(int, planeOrder);
+  QFETCH(bool, bigEndian);
+  QFETCH(bool, uvInterleaved);
+  QFETCH(unsigned, scaleShift);
+
+  const auto format = PixelFormatYUV(Subsampling(subsampling),
+                                     bitDepth,
+                                     PlaneOrder(planeOrder),
+                                     bigEndian,
+                                     Offset(),
+                                     uvInterleaved);
+  const auto frameSize = Size(64, 48);
+  const auto planes    = createRandomPlanes(format, frameSize);
+  const auto frame     = writeFrame(planes, format);
+  QCOMPARE(int64_t(frame.size()), format.bytesPerFrame(frameSize));
+
+  // The region starts at (8, 16) and covers (12 x 8) << scaleShift pixels of the frame
+  const auto     x          = 8u;
+  const auto     y          = 16u;
+  const auto     outputSize = Size(12, 8);
+  PixelFormatYUV outputFormat;
+  const auto     output = extractScaledRegion(
+      frame, format, frameSize, x, y, outputSize, scaleShift, outputFormat);
+
+  QVERIFY(outputFormat.getSubsampling() == format.getSubsampling());
+  QCOMPARE(outputFormat.getBitsPerSample(), bitDepth);
+  QVERIFY(outputFormat.getPlaneOrder() == PlaneOrder::YUV);
+  QVERIFY(!outputFormat.isBigEndian());
+  QVERIFY(!outputFormat.isUVInterleaved());
+  QCOMPARE(int64_t(output.size()), outputFormat.bytesPerFrame(outputSize));
+
+  // Every output sample is the rounded average of the input samples that it covers
+  const auto factor      = 1u << scaleShift;
+  size_t     outputIndex = 0;
+  for (unsigned c = 0; c < planes.nrPlanes; c++)
+  {
+    const auto subH       = (c == 0) ? 1u : unsigned(format.getSubsamplingHor());
+    const auto subV       = (c == 0) ? 1u : unsigned(format.getSubsamplingVer());
+    const auto planeWidth = planes.sizes[c].width;
+    for (unsigned outY = 0; outY < outputSize.height / subV; outY++)
+    {
+      for (unsigned outX = 0; outX < outputSize.width / subH; outX++)
+      {
+        unsigned sum = 0;
+        for (unsigned dy = 0; dy < factor; dy++)
+          for (unsigned dx = 0; dx < factor; dx++)
+          {
+            const auto planeX = x / subH + outX * factor + dx;
+            const auto planeY = y / subV + outY * factor + dy;
+            sum += unsigned(planes.samples[c][planeY * planeWidth + planeX]);
+          }
+        const auto expected = int((sum + factor * factor / 2) / (factor * factor));
+        QCOMPARE(readOutputSample(output, outputIndex++, bitDepth), expected);
+      }
+    }
+  }
+}
+
+QTEST_MAIN(PlanarYUVTest)
+
+#include "PlanarYUVTest.moc"
@@ -0,0 +1,248 @@
+#include <QtTest>
+
+#include <video/RGBConversion.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace video;
+using namespace video::rgb;
+
+Q_DECLARE_METATYPE(AlphaMode)
+Q_DECLARE_METATYPE(Endianness)
+
+class RGBConversionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  RGBConversionTest(){};
+  ~RGBConversionTest(){};
+
+private slots:
+  void testConversion_data();
+  void testConversion();
+  void testGreyscaleConversion_data();
+  void testGreyscaleConversion();
+
+  void benchmarkConversion_data();
+  void benchmarkConversion();
+};
+
+namespace
+{
+
+QByteArray createRandomFrame(const PixelFormatRGB &format, const Size frameSize)
+{
+  QByteArray data(int(format.bytesPerFrame(frameSize)), 0);
+
+  std::mt19937 generator(42);
+  for (auto &byte : data)
+    byte = char(generator() & 0xff);
+  return data;
+}
+
+// Get the value of the given channel as 8 bit (scaled, clipped and inverted)
+int getExpectedValue(const QByteArray &    data,
+                     const PixelFormatRGB &format,
+                     const Size            frameSize,
+                     const unsigned        pixel,
+                     const Channel         channel,
+                     const int             scale,
+                     const bool            invert)
+{
+  const auto position = unsigned(format.getComponentPosition(channel));
+  const auto idx      = format.getDataLayout() == DataLayout::Planar
+                            ? position * frameSize.width * frameSize.height + pixel
+                            : pixel * format.nrChannels() + position;
+
+  const auto src = reinterpret_cast<const unsigned char *>(data.constData());
+  auto       val = 0;
+  if (format.getBitsPerSample() == 8)
+    val = src[idx];
+  else if (format.getEndianess() == Endianness::Big)
+    val = (src[idx * 2] << 8) | src[idx * 2 + 1];
+  else
+    val = src[idx * 2] | (src[idx * 2 + 1] << 8);
+
+  val = std::clamp((val * scale) >> (format.getBitsPerSample() - 8), 0, 255);
+  return invert ? 255 - val : val;
+}
+
+} // namespace
+
+void RGBConversionTest::testConversion_data()
+{
+  QTest::addColumn<unsigned>("bitsPerSample");
+  QTest::addColumn<DataLayout>("dataLayout");
+  QTest::addColumn<AlphaMode>("alphaMode");
+  QTest::addColumn<Endianness>("endianness");
+  QTest::addColumn<bool>("invert");
+  QTest::addColumn<int>("scale");
+
+  for (const auto bitsPerSample : {8u, 10u, 12u, 16u})
+    for (const auto dataLayout : {DataLayout::Packed, DataLayout::Planar})
+      for (const auto alphaMode : {AlphaMode::None, AlphaMode::First, AlphaMode::Last})
+        for (const auto endianness : {Endianness::Little, Endianness::Big})
+        {
+          if (bitsPerSample == 8 && endianness == Endianness::Big)
+            continue;
+          const auto name = QString("%1 bit %2 alpha %3 %4")
+                                .arg(bitsPerSample)
+                                .arg(dataLayout == DataLayout::Planar ? "planar" : "packed")
+                                .arg(int(alphaMode))
+                                .arg(endianness == Endianness::Big ? "BE" : "LE");
+          QTest::newRow(qPrintable(name))
+              << bitsPerSample << dataLayout << alphaMode << endianness << false << 1;
+          QTest::newRow(qPrintable(name + " inverted"))
+              << bitsPerSample << dataLayout << alphaMode << endianness << true << 1;
+          QTest::newRow(qPrintable(name + " scaled"))
+              << bitsPerSample << dataLayout << alphaMode << endianness << false << 2;
+        }
+}
+
+void RGBConversionTest::testConversion()
+{
+  QFETCH(unsigned, bitsPerSample);
+  QFETCH(DataLayout, dataLayout);
+  QFETCH(AlphaMode, alphaMode);
+  QFETCH(Endianness, endianness);
+  QFETCH(bool, invert);
+  QFETCH(int, scale);
+
+  // An odd size so that the remainder of the vectorized loops is tested as well
+  const auto frameSize = Size(37, 5);
+  const auto format =
+      PixelFormatRGB(bitsPerSample, dataLayout, ChannelOrder::GBR, alphaMode, endianness);
+  const auto data     = createRandomFrame(format, frameSize);
+  const auto hasAlpha = format.hasAlpha();
+
+  const bool componentInvert[4] = {invert, false, invert, invert};
+  const int  componentScale[4]  = {scale, scale, scale, scale};
+
+  std::vector<unsigned char> output(frameSize.width * frameSize.height * 4);
+  convertInputRGBToRGBA(data,
+                        format,
+                        output.data(),
+                        frameSize,
+                        componentInvert,
+                        componentScale,
+                        false,
+                        hasAlpha,
+                        false);
+
+  for (unsigned i = 0; i < frameSize.width * frameSize.height; i++)
+  {
+    QCOMPARE(int(output[i * 4]),
+             getExpectedValue(data, format, frameSize, i, Channel::Blue, scale, invert));
+    QCOMPARE(int(output[i * 4 + 1]),
+             getExpectedValue(data, format, frameSize, i, Channel::Green, scale, false));
+    QCOMPARE(int(output[i * 4 + 2]),
+             getExpectedValue(data, format, frameSize, i, Channel::Red, scale, invert));
+    const auto expectedAlpha =
+        hasAlpha ? getExpectedValue(data, format, frameSize, i, Channel::Alpha, scale, invert)
+                 : 255;
+    QCOMPARE(int(output[i * 4 + 3]), expectedAlpha);
+  }
+}
+
+void RGBConversionTest::testGreyscaleConversion_data()
+{
+  QTest::addColumn<unsigned>("bitsPerSample");
+  QTest::addColumn<DataLayout>("dataLayout");
+  QTest::addColumn<AlphaMode>("alphaMode");
+
+  for (const auto bitsPerSample : {8u, 10u, 16u})
+    for (const auto dataLayout : {DataLayout::Packed, DataLayout::Planar})
+      for (const auto alphaMode : {AlphaMode::None, AlphaMode::Last})
+        QTest::newRow(qPrintable(QString("%1 bit %2 alpha %3")
+                                     .arg(bitsPerSample)
+                                     .arg(dataLayout == DataLayout::Planar ? "planar" : "packed")
+                                     .arg(int(alphaMode))))
+            << bitsPerSample << dataLayout << alphaMode;
+}
+
+void RGBConversionTest::testGreyscaleConversion()
+{
+  QFETCH(unsigned, bitsPerSample);
+  QFETCH(DataLayout, dataLayout);
+  QFETCH(AlphaMode, alphaMode);
+
+  const auto frameSize = Size(37, 5);
+  const auto format    = PixelFormatRGB(bitsPerSample, dataLayout, ChannelOrder::BGR, alphaMode);
+  const auto data      = createRandomFrame(format, frameSize);
+
+  for (const auto channel : {Channel::Red, Channel::Green, Channel::Blue})
+  {
+    std::vector<unsigned char> output(frameSize.width * frameSize.height * 4);
+    convertSinglePlaneRGBToGreyscaleRGBA(data,
+                                         format,
+                                         output.data(),
+                                         frameSize,
+                                         1,
+                                         channel == Channel::Green,
+                                         format.getComponentPosition(channel),
+                                         false);
+
+    for (unsigned i = 0; i < frameSize.width * frameSize.height; i++)
+    {
+      const auto expected =
+          getExpectedValue(data, format, frameSize, i, channel, 1, channel == Channel::Green);
+      QCOMPARE(int(output[i * 4]), expected);
+      QCOMPARE(int(output[i * 4 + 1]), expected);
+      QCOMPARE(int(output[i * 4 + 2]), expected);
+      QCOMPARE(int(output[i * 4 + 3]), 255);
+    }
+  }
+}
+
+void RGBConversionTest::benchmarkConversion_data()
+{
+  QTest::addColumn<unsigned>("bitsPerSample");
+  QTest::addColumn<DataLayout>("dataLayout");
+  QTest::addColumn<AlphaMode>("alphaMode");
+  QTest::addColumn<int>("scale");
+
+  QTest::newRow("RGB 8 bit packed") << 8u << DataLayout::Packed << AlphaMode::None << 1;
+  QTest::newRow("RGBA 8 bit packed") << 8u << DataLayout::Packed << AlphaMode::Last << 1;
+  QTest::newRow("RGB 8 bit planar") << 8u << DataLayout::Planar << AlphaMode::None << 1;
+  QTest::newRow("RGB 10 bit packed") << 10u << DataLayout::Packed << AlphaMode::None << 1;
+  QTest::newRow("RGBA 10 bit packed") << 10u << DataLayout::Packed << AlphaMode::Last << 1;
+  QTest::newRow("RGB 10 bit planar") << 10u << DataLayout::Planar << AlphaMode::None << 1;
+  QTest::newRow("RGB 16 bit planar") << 16u << DataLayout::Planar << AlphaMode::None << 1;
+  QTest::newRow("RGB 8 bit planar (generic)") << 8u << DataLayout::Planar << AlphaMode::None << 2;
+  QTest::newRow("RGB 10 bit planar (generic)") << 10u << DataLayout::Planar << AlphaMode::None << 2;
+}
+
+void RGBConversionTest::benchmarkConversion()
+{
+  QFETCH(unsigned, bitsPerSample);
+  QFETCH(DataLayout, dataLayout);
+  QFETCH(AlphaMode, alphaMode);
+  QFETCH(int, scale);
+
+  const auto frameSize = Size(1920, 1080);
+  const auto format    = PixelFormatRGB(bitsPerSample, dataLayout, ChannelOrder::RGB, alphaMode);
+  const auto data      = createRandomFrame(format, frameSize);
+
+  const bool componentInvert[4] = {false, false, false, false};
+  const int  componentScale[4]  = {scale, scale, scale, scale};
+
+  std::vector<unsigned char> output(frameSize.width * frameSize.height * 4);
+  QBENCHMARK
+  {
+    convertInputRGBToRGBA(data,
+                          format,
+                          output.data(),
+                          frameSize,
+                          componentInvert,
+                          componentScale,
+                          false,
+                          format.hasAlpha(),
+                          false);
+  }
+}
+
+QTEST_MAIN(RGBConversionTest)
+
+#include "RGBConversionTest.moc"
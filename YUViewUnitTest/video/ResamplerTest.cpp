@@ -0,0 +1,188 @@
+#include <QtTest>
+
+#include <video/Resampler.h>
+
+#include <cmath>
+
+using namespace video::yuv;
+
+class ResamplerTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  ResamplerTest(){};
+  ~ResamplerTest(){};
+
+private slots:
+  void testFilterTables_data();
+  void testFilterTables();
+  void testConstantPlanes_data();
+  void testConstantPlanes();
+  void testIdentity();
+  void testAreaDownscale();
+  void testInvalidInput();
+};
+
+namespace
+{
+
+QByteArray createGradientFrame8Bit(const PixelFormatYUV &format, const Size frameSize)
+{
+  QByteArray data(int(format.bytesPerFrame(frameSize)), 0);
+  for (int i = 0; i < data.size(); i++)
+    data[i] = char((i * 7) % 256);
+  return data;
+}
+
+} // namespace
+
+void ResamplerTest::testFilterTables_data()
+{
+  QTest::addColumn<unsigned>("srcSize");
+  QTest::addColumn<unsigned>("dstSize");
+  QTest::addColumn<int>("filter");
+
+  for (auto filter : {ResampleFilter::Bilinear,
+                      ResampleFilter::Bicubic,
+                      ResampleFilter::Lanczos3,
+                      ResampleFilter::Area})
+  {
+    const auto name = std::to_string(int(filter));
+    QTest::newRow(("Up " + name).c_str()) << 17u << 64u << int(filter);
+    QTest::newRow(("Down " + name).c_str()) << 64u << 17u << int(filter);
+    QTest::newRow(("Same " + name).c_str()) << 32u << 32u << int(filter);
+  }
+}
+
+void ResamplerTest::testFilterTables()
+{
+  QFETCH(unsigned, srcSize);
+  QFETCH(unsigned, dstSize);
+  QFETCH(int, filter);
+
+  const auto table = createResampleFilterTable(srcSize, dstSize, ResampleFilter(filter));
+  QCOMPARE(table.firstSample.size(), size_t(dstSize));
+  QCOMPARE(table.coefficients.size(), size_t(dstSize * table.taps));
+
+  for (unsigned i = 0; i < dstSize; i++)
+  {
+    QVERIFY(table.firstSample[i] + table.taps <= srcSize);
+    float sum = 0.0f;
+    for (unsigned t = 0; t < table.taps; t++)
+      sum += table.coefficients[i * table.taps + t];
+    QVERIFY(std::abs(sum - 1.0f) < 1e-4f);
+  }
+}
+
+void ResamplerTest::testConstantPlanes_data()
+{
+  QTest::addColumn<unsigned>("bitDepth");
+  QTest::addColumn<int>("filter");
+
+  QTest::newRow("8 bit Bicubic") << 8u << int(ResampleFilter::Bicubic);
+  QTest::newRow("8 bit Lanczos") << 8u << int(ResampleFilter::Lanczos3);
+  QTest::newRow("10 bit Lanczos") << 10u << int(ResampleFilter::Lanczos3);
+  QTest::newRow("10 bit Area") << 10u << int(ResampleFilter::Area);
+}
+
+void ResamplerTest::testConstantPlanes()
+{
+  QFETCH(unsigned, bitDepth);
+  QFETCH(int, filter);
+
+  const auto format    = PixelFormatYUV(Subsampling::YUV_420, bitDepth);
+  const auto inputSize = Size(64, 48);
+  const auto lumaValue = (1u << bitDepth) - 20;
+
+  // A constant plane must stay constant for every filter (no overshoot at the borders)
+  const auto bytes      = bitDepth > 8 ? 2 : 1;
+  const auto lumaPixels = int(inputSize.width * inputSize.height);
+  QByteArray data(int(format.bytesPerFrame(inputSize)), 0);
+  for (int i = 0; i < data.size() / bytes; i++)
+  {
+    const auto value = i < lumaPixels ? lumaValue : 1u << (bitDepth - 1);
+    data[i * bytes] = char(value & 0xff);
+    if (bytes == 2)
+      data[i * bytes + 1] = char(value >> 8);
+  }
+
+  for (auto outputSize : {Size(96, 72), Size(22, 16)})
+  {
+    PixelFormatYUV outputFormat;
+    const auto     output = resamplePlanarYUV(
+        data, format, inputSize, outputSize, ResampleFilter(filter), outputFormat);
+    QCOMPARE(outputFormat.getBitsPerSample(), bitDepth);
+    QCOMPARE(output.size(), int(outputFormat.bytesPerFrame(outputSize)));
+
+    const auto outputLumaPixels = int(outputSize.width * outputSize.height);
+    for (int i = 0; i < output.size() / bytes; i++)
+    {
+      auto value = unsigned(uchar(output[i * bytes]));
+      if (bytes == 2)
+        value |= unsigned(uchar(output[i * bytes + 1])) << 8;
+      const auto expected = i < outputLumaPixels ? lumaValue : 1u << (bitDepth - 1);
+      QCOMPARE(value, expected);
+    }
+  }
+}
+
+void ResamplerTest::testIdentity()
+{
+  const auto format    = PixelFormatYUV(Subsampling::YUV_420, 8);
+  const auto frameSize = Size(40, 30);
+  const auto data      = createGradientFrame8Bit(format, frameSize);
+
+  for (auto filter : {ResampleFilter::Bilinear, ResampleFilter::Area})
+  {
+    PixelFormatYUV outputFormat;
+    const auto output = resamplePlanarYUV(data, format, frameSize, frameSize, filter, outputFormat);
+    QCOMPARE(output, data);
+  }
+}
+
+void ResamplerTest::testAreaDownscale()
+{
+  const auto format    = PixelFormatYUV(Subsampling::YUV_444, 8);
+  const auto inputSize = Size(8, 8);
+  const auto data      = createGradientFrame8Bit(format, inputSize);
+
+  PixelFormatYUV outputFormat;
+  const auto     output = resamplePlanarYUV(
+      data, format, inputSize, Size(4, 4), ResampleFilter::Area, outputFormat);
+  QCOMPARE(output.size(), 3 * 4 * 4);
+
+  // Every output sample is the rounded mean of a 2x2 block of input samples
+  for (int plane = 0; plane < 3; plane++)
+    for (int y = 0; y < 4; y++)
+      for (int x = 0; x < 4; x++)
+      {
+        auto input = [&](int dx, int dy) {
+          return int(uchar(data[plane * 64 + (y * 2 + dy) * 8 + x * 2 + dx]));
+        };
+        const auto sum      = input(0, 0) + input(1, 0) + input(0, 1) + input(1, 1);
+        const auto expected = int(std::lround(sum / 4.0));
+        QCOMPARE(int(uchar(output[plane * 16 + y * 4 + x])), expected);
+      }
+}
+
+void ResamplerTest::testInvalidInput()
+{
+  const auto     format    = PixelFormatYUV(Subsampling::YUV_420, 8);
+  const auto     inputSize = Size(16, 16);
+  const auto     data      = createGradientFrame8Bit(format, inputSize);
+  PixelFormatYUV outputFormat;
+
+  // The output size must be a multiple of the subsampling
+  QVERIFY(
+      resamplePlanarYUV(data, format, inputSize, Size(9, 8), ResampleFilter::Bicubic, outputFormat)
+          .isEmpty());
+  // Not enough data
+  QVERIFY(resamplePlanarYUV(
+              data.left(100), format, inputSize, Size(8, 8), ResampleFilter::Bicubic, outputFormat)
+              .isEmpty());
+}
+
+QTEST_MAIN(ResamplerTest)
+
+#include "ResamplerTest.moc"
@@ -0,0 +1,126 @@
+#include <QtTest>
+
+#include <video/TileCache.h>
+
+using namespace video;
+
+class TileCacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  TileCacheTest(){};
+  ~TileCacheTest(){};
+
+private slots:
+  void testInsertAndGet();
+  void testLeastRecentlyUsedIsDropped();
+  void testReplaceTile();
+  void testTileLargerThanLimit();
+  void testClear();
+};
+
+namespace
+{
+
+// The format and conversion settings of the tiles
+const auto SETTINGS = QString("4:2:0 8 bit;64x64");
+
+// Each tile has 16 * 16 * 4 = 1024 bytes
+constexpr size_t TILE_BYTES = 1024;
+
+QImage createTile(QRgb color)
+{
+  QImage tile(16, 16, QImage::Format_RGB32);
+  tile.fill(color);
+  return tile;
+}
+
+TileKey createKey(unsigned tileX)
+{
+  return {0, 0, tileX, 0, SETTINGS};
+}
+
+} // namespace
+
+void TileCacheTest::testInsertAndGet()
+{
+  TileCache cache(10 * TILE_BYTES);
+  QVERIFY(cache.get(createKey(0)).isNull());
+
+  const auto tile = createTile(qRgb(255, 0, 0));
+  cache.insert(createKey(0), tile);
+  QCOMPARE(cache.get(createKey(0)), tile);
+
+  // All parts of the key must match
+  QVERIFY(cache.get({1, 0, 0, 0, SETTINGS}).isNull());
+  QVERIFY(cache.get({0, 1, 0, 0, SETTINGS}).isNull());
+  QVERIFY(cache.get({0, 0, 1, 0, SETTINGS}).isNull());
+  QVERIFY(cache.get({0, 0, 0, 1, SETTINGS}).isNull());
+  QVERIFY(cache.get({0, 0, 0, 0, SETTINGS + ";1:2,0,0"}).isNull());
+}
+
+void TileCacheTest::testLeastRecentlyUsedIsDropped()
+{
+  TileCache cache(3 * TILE_BYTES);
+  for (unsigned i = 0; i < 3; i++)
+    cache.insert(createKey(i), createTile(qRgb(i, 0, 0)));
+
+  // Tile 0 becomes the most recently used one, so tile 1 is dropped first
+  QVERIFY(!cache.get(createKey(0)).isNull());
+  cache.insert(createKey(3), createTile(qRgb(3, 0, 0)));
+  QVERIFY(!cache.get(createKey(0)).isNull());
+  QVERIFY(cache.get(createKey(1)).isNull());
+  QVERIFY(!cache.get(createKey(2)).isNull());
+  QVERIFY(!cache.get(createKey(3)).isNull());
+
+  cache.insert(createKey(4), createTile(qRgb(4, 0, 0)));
+  QVERIFY(cache.get(createKey(0)).isNull());
+  QVERIFY(!cache.get(createKey(4)).isNull());
+}
+
+void TileCacheTest::testReplaceTile()
+{
+  TileCache cache(2 * TILE_BYTES);
+  cache.insert(createKey(0), createTile(qRgb(1, 0, 0)));
+
+  // Replacing a tile must not count its bytes twice
+  const auto newTile = createTile(qRgb(2, 0, 0));
+  cache.insert(createKey(0), newTile);
+  cache.insert(createKey(1), createTile(qRgb(3, 0, 0)));
+  QCOMPARE(cache.get(createKey(0)), newTile);
+  QVERIFY(!cache.get(createKey(1)).isNull());
+}
+
+void TileCacheTest::testTileLargerThanLimit()
+{
+  TileCache cache(TILE_BYTES / 2);
+  cache.insert(createKey(0), createTile(qRgb(1, 0, 0)));
+
+  // The tile that was just inserted is kept so that it can be drawn
+  QVERIFY(!cache.get(createKey(0)).isNull());
+
+  cache.insert(createKey(1), createTile(qRgb(2, 0, 0)));
+  QVERIFY(cache.get(createKey(0)).isNull());
+  QVERIFY(!cache.get(createKey(1)).isNull());
+}
+
+void TileCacheTest::testClear()
+{
+  TileCache cache(2 * TILE_BYTES);
+  cache.insert(createKey(0), createTile(qRgb(1, 0, 0)));
+  cache.insert(createKey(1), createTile(qRgb(2, 0, 0)));
+  cache.clear();
+  QVERIFY(cache.get(createKey(0)).isNull());
+  QVERIFY(cache.get(createKey(1)).isNull());
+
+  // After clearing, the full limit is available again
+  cache.insert(createKey(2), createTile(qRgb(3, 0, 0)));
+  cache.insert(createKey(3), createTile(qRgb(4, 0, 0)));
+  QVERIFY(!cache.get(createKey(2)).isNull());
+  QVERIFY(!cache.get(createKey(3)).isNull());
+}
+
+QTEST_MAIN(TileCacheTest)
+
+#include "TileCacheTest.moc"
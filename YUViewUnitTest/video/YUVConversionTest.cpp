@@ -0,0 +1,315 @@
+#include <QtTest>
+
+#include <video/videoHandlerYUV.h>
+
+#include "YUVTestFrame.h"
+
+#include <algorithm>
+
+using namespace video;
+using namespace video::yuv;
+using namespace test;
+
+Q_DECLARE_METATYPE(Subsampling)
+Q_DECLARE_METATYPE(ColorConversion)
+Q_DECLARE_METATYPE(ComponentDisplayMode)
+
+class YUVConversionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  YUVConversionTest(){};
+  ~YUVConversionTest(){};
+
+private slots:
+  void testConversion_data();
+  void testConversion();
+
+  void testBilinearConversionAtBorder_data();
+  void testBilinearConversionAtBorder();
+
+  void benchmarkConversion_data();
+  void benchmarkConversion();
+};
+
+namespace
+{
+
+ConversionSettings createConversionSettings(ColorConversion      colorConversion,
+                                            ComponentDisplayMode componentDisplayMode,
+                                            bool                 applyMath,
+                                            unsigned             bitDepth)
+{
+  ConversionSettings settings;
+  settings.colorConversion      = colorConversion;
+  settings.componentDisplayMode = componentDisplayMode;
+  settings.mathParameters[Component::Luma]   = MathParameters();
+  settings.mathParameters[Component::Chroma] = MathParameters();
+  if (applyMath)
+  {
+    const auto offset                          = 1 << (bitDepth - 1);
+    settings.mathParameters[Component::Luma]   = MathParameters(2, offset, true);
+    settings.mathParameters[Component::Chroma] = MathParameters(3, offset, false);
+  }
+  return settings;
+}
+
+// The reference for the specialized conversion kernels. Every pixel is converted on its own with
+// nearest neighbor chroma upsampling.
+class ReferenceConversion
+{
+public:
+  ReferenceConversion(const Planes &            planes,
+                      const PixelFormatYUV &    format,
+                      const Size                frameSize,
+                      const ConversionSettings &settings)
+      : planes(planes), format(format), frameSize(frameSize), settings(settings)
+  {
+    getColorConversionCoefficients(settings.colorConversion, this->RGBConv);
+    this->fullRange = settings.colorConversion == ColorConversion::BT709_FullRange ||
+                      settings.colorConversion == ColorConversion::BT601_FullRange ||
+                      settings.colorConversion == ColorConversion::BT2020_FullRange;
+  }
+
+  QRgb getPixel(unsigned x, unsigned y) const
+  {
+    const auto bitDepth  = int(this->format.getBitsPerSample());
+    const auto display   = this->settings.componentDisplayMode;
+    const auto lumaOnly  = this->planes.nrPlanes == 1;
+    const auto showPlane = (display == ComponentDisplayMode::DisplayCb) ? 1 : 2;
+    auto       valY      = this->getSample(0, x, y, Component::Luma);
+
+    if (display != ComponentDisplayMode::DisplayAll || lumaOnly)
+    {
+      auto val = (display == ComponentDisplayMode::DisplayY || lumaOnly)
+                     ? valY
+                     : this->getSample(showPlane, x, y, Component::Chroma);
+      if (bitDepth > 8)
+        val = std::clamp(val >> (bitDepth - 8), 0, 255);
+      if (!this->fullRange)
+        val = videoHandler::convScaleLimitedRange(val);
+      return qRgb(val, val, val);
+    }
+
+    auto valU = this->getSample(1, x, y, Component::Chroma);
+    auto valV = this->getSample(2, x, y, Component::Chroma);
+
+    // Above 14 bit, two bits are dropped to stay within 32 bit
+    auto shift = bitDepth - 8;
+    if (bitDepth > 14)
+    {
+      valY >>= 2;
+      valU >>= 2;
+      valV >>= 2;
+      shift = bitDepth - 10;
+    }
+    const auto yOffset = this->fullRange ? 0 : 16 << shift;
+    const auto cZero   = 128 << shift;
+
+    const auto yTmp = int64_t(valY - yOffset) * this->RGBConv[0];
+    const auto uTmp = int64_t(valU - cZero);
+    const auto vTmp = int64_t(valV - cZero);
+    const auto r    = (yTmp + vTmp * this->RGBConv[1]) >> (16 + shift);
+    const auto g    = (yTmp + uTmp * this->RGBConv[2] + vTmp * this->RGBConv[3]) >> (16 + shift);
+    const auto b    = (yTmp + uTmp * this->RGBConv[4]) >> (16 + shift);
+    return qRgb(int(std::clamp(r, int64_t(0), int64_t(255))),
+                int(std::clamp(g, int64_t(0), int64_t(255))),
+                int(std::clamp(b, int64_t(0), int64_t(255))));
+  }
+
+private:
+  int getSample(unsigned plane, unsigned x, unsigned y, Component component) const
+  {
+    const auto subH  = (plane == 0) ? 1u : unsigned(this->format.getSubsamplingHor());
+    const auto subV  = (plane == 0) ? 1u : unsigned(this->format.getSubsamplingVer());
+    const auto width = this->frameSize.width / subH;
+    auto       value = this->planes.samples[plane][(y / subV) * width + x / subH];
+
+    const auto math = this->settings.mathParameters.at(component);
+    if (math.mathRequired())
+    {
+      const auto inputMax = (1 << this->format.getBitsPerSample()) - 1;
+      value               = (value - math.offset) * math.scale;
+      value               = (math.invert ? -value : value) + math.offset;
+      value               = std::clamp(value, 0, inputMax);
+    }
+    return value;
+  }
+
+  const Planes &            planes;
+  const PixelFormatYUV &    format;
+  const Size                frameSize;
+  const ConversionSettings &settings;
+  int                       RGBConv[5]{};
+  bool                      fullRange{};
+};
+
+} // namespace
+
+void YUVConversionTest::testConversion_data()
+{
+  QTest::addColumn<Subsampling>("subsampling");
+  QTest::addColumn<unsigned>("bitDepth");
+  QTest::addColumn<bool>("bigEndian");
+  QTest::addColumn<bool>("uvInterleaved");
+  QTest::addColumn<ColorConversion>("colorConversion");
+  QTest::addColumn<ComponentDisplayMode>("componentDisplayMode");
+  QTest::addColumn<bool>("applyMath");
+
+  for (const auto subsampling : {Subsampling::YUV_444,
+                                 Subsampling::YUV_422,
+                                 Subsampling::YUV_420,
+                                 Subsampling::YUV_440,
+                                 Subsampling::YUV_410,
+                                 Subsampling::YUV_411,
+                                 Subsampling::YUV_400})
+    for (const auto bitDepth : {8u, 10u, 14u, 16u})
+      for (const auto bigEndian : {false, true})
+        for (const auto colorConversion :
+             {ColorConversion::BT709_LimitedRange, ColorConversion::BT601_FullRange})
+        {
+          if (bitDepth == 8 && bigEndian)
+            continue;
+          const auto name =
+              QString("%1 %2 bit %3 %4")
+                  .arg(QString::fromStdString(SubsamplingMapper.getName(subsampling)))
+                  .arg(bitDepth)
+                  .arg(bigEndian ? "BE" : "LE")
+                  .arg(QString::fromStdString(ColorConversionMapper.getName(colorConversion)));
+          QTest::newRow(qPrintable(name)) << subsampling << bitDepth << bigEndian << false
+                                          << colorConversion << ComponentDisplayMode::DisplayAll
+                                          << false;
+          if (subsampling == Subsampling::YUV_400)
+            continue;
+          QTest::newRow(qPrintable(name + " interleaved"))
+              << subsampling << bitDepth << bigEndian << true << colorConversion
+              << ComponentDisplayMode::DisplayAll << false;
+          QTest::newRow(qPrintable(name + " math"))
+              << subsampling << bitDepth << bigEndian << false << colorConversion
+              << ComponentDisplayMode::DisplayAll << true;
+          for (const auto display : {ComponentDisplayMode::DisplayY,
+                                     ComponentDisplayMode::DisplayCb,
+                                     ComponentDisplayMode::DisplayCr})
+            QTest::newRow(qPrintable(
+                name + " " + QString::fromStdString(ComponentDisplayModeMapper.getName(display))))
+                << subsampling << bitDepth << bigEndian << true << colorConversion << display
+                << true;
+        }
+}
+
+void YUVConversionTest::testConversion()
+{
+  QFETCH(Subsampling, subsampling);
+  QFETCH(unsigned, bitDepth);
+  QFETCH(bool, bigEndian);
+  QFETCH(bool, uvInterleaved);
+  QFETCH(ColorConversion, colorConversion);
+  QFETCH(ComponentDisplayMode, componentDisplayMode);
+  QFETCH(bool, applyMath);
+
+  // The chroma offset is not the 4:2:0 default of (0, 1). So 8 and 10 bit 4:2:0 use the same
+  // kernels as all other formats and not the older dedicated conversion. For nearest neighbor
+  // interpolation, the offset has no effect.
+  const auto format = PixelFormatYUV(
+      subsampling, bitDepth, PlaneOrder::YVU, bigEndian, Offset(0, 0), uvInterleaved);
+  const auto frameSize = Size(24, 8);
+  const auto planes    = createRandomPlanes(format, frameSize);
+  const auto data      = writeFrame(planes, format);
+  QCOMPARE(int64_t(data.size()), format.bytesPerFrame(frameSize));
+
+  const auto settings =
+      createConversionSettings(colorConversion, componentDisplayMode, applyMath, bitDepth);
+
+  QImage image;
+  convertYUVToImage(data, image, format, frameSize, settings);
+  QCOMPARE(image.size(), QSize(int(frameSize.width), int(frameSize.height)));
+
+  const ReferenceConversion reference(planes, format, frameSize, settings);
+  for (unsigned y = 0; y < frameSize.height; y++)
+    for (unsigned x = 0; x < frameSize.width; x++)
+      QCOMPARE(image.pixel(int(x), int(y)), reference.getPixel(x, y));
+}
+
+void YUVConversionTest::testBilinearConversionAtBorder_data()
+{
+  QTest::addColumn<unsigned>("bitDepth");
+  QTest::addColumn<bool>("applyMath");
+
+  QTest::newRow("4:1:0 8 bit") << 8u << false;
+  QTest::newRow("4:1:0 8 bit math") << 8u << true;
+  QTest::newRow("4:1:0 10 bit") << 10u << false;
+  QTest::newRow("4:1:0 10 bit math") << 10u << true;
+}
+
+// In the last chroma line and column there is no next chroma sample to interpolate with. With
+// constant chroma planes, bilinear interpolation must give the same result as nearest neighbor.
+// The U and V values differ, so a read past the end of the U plane changes the result.
+void YUVConversionTest::testBilinearConversionAtBorder()
+{
+  QFETCH(unsigned, bitDepth);
+  QFETCH(bool, applyMath);
+
+  // Without a chroma offset, the chroma planes are not resampled before the conversion
+  const auto format =
+      PixelFormatYUV(Subsampling::YUV_410, bitDepth, PlaneOrder::YUV, false, Offset(0, 0));
+  const auto frameSize = Size(24, 8);
+  auto       planes    = createRandomPlanes(format, frameSize);
+  std::fill(planes.samples[1].begin(), planes.samples[1].end(), 64 << (bitDepth - 8));
+  std::fill(planes.samples[2].begin(), planes.samples[2].end(), 192 << (bitDepth - 8));
+  const auto data = writeFrame(planes, format);
+
+  auto settings = createConversionSettings(
+      ColorConversion::BT709_LimitedRange, ComponentDisplayMode::DisplayAll, applyMath, bitDepth);
+  settings.chromaInterpolation = ChromaInterpolation::Bilinear;
+
+  QImage image;
+  convertYUVToImage(data, image, format, frameSize, settings);
+  QCOMPARE(image.size(), QSize(int(frameSize.width), int(frameSize.height)));
+
+  const ReferenceConversion reference(planes, format, frameSize, settings);
+  for (unsigned y = 0; y < frameSize.height; y++)
+    for (unsigned x = 0; x < frameSize.width; x++)
+      QCOMPARE(image.pixel(int(x), int(y)), reference.getPixel(x, y));
+}
+
+void YUVConversionTest::benchmarkConversion_data()
+{
+  QTest::addColumn<Subsampling>("subsampling");
+  QTest::addColumn<unsigned>("bitDepth");
+  QTest::addColumn<bool>("bigEndian");
+  QTest::addColumn<bool>("uvInterleaved");
+
+  QTest::newRow("4:2:0 8 bit") << Subsampling::YUV_420 << 8u << false << false;
+  QTest::newRow("4:2:0 8 bit interleaved") << Subsampling::YUV_420 << 8u << false << true;
+  QTest::newRow("4:2:0 10 bit") << Subsampling::YUV_420 << 10u << false << false;
+  QTest::newRow("4:2:0 10 bit BE") << Subsampling::YUV_420 << 10u << true << false;
+  QTest::newRow("4:2:2 10 bit") << Subsampling::YUV_422 << 10u << false << false;
+  QTest::newRow("4:4:4 8 bit") << Subsampling::YUV_444 << 8u << false << false;
+  QTest::newRow("4:4:4 16 bit") << Subsampling::YUV_444 << 16u << false << false;
+}
+
+void YUVConversionTest::benchmarkConversion()
+{
+  QFETCH(Subsampling, subsampling);
+  QFETCH(unsigned, bitDepth);
+  QFETCH(bool, bigEndian);
+  QFETCH(bool, uvInterleaved);
+
+  const auto format = PixelFormatYUV(
+      subsampling, bitDepth, PlaneOrder::YUV, bigEndian, Offset(0, 0), uvInterleaved);
+  const auto frameSize = Size(1920, 1080);
+  const auto data      = writeFrame(createRandomPlanes(format, frameSize), format);
+  const auto settings  = createConversionSettings(
+      ColorConversion::BT709_LimitedRange, ComponentDisplayMode::DisplayAll, false, bitDepth);
+
+  QImage image;
+  QBENCHMARK
+  {
+    convertYUVToImage(data, image, format, frameSize, settings);
+  }
+}
+
+QTEST_MAIN(YUVConversionTest)
+
+#include "YUVConversionTest.moc"
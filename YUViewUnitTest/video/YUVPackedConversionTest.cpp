@@ -0,0 +1,265 @@
+#include <QtTest>
+
+#include <video/videoHandlerYUV.h>
+
+#include "YUVTestFrame.h"
+
+using namespace video;
+using namespace video::yuv;
+using namespace test;
+
+Q_DECLARE_METATYPE(PixelFormatYUV)
+Q_DECLARE_METATYPE(ChromaInterpolation)
+
+class YUVPackedConversionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  YUVPackedConversionTest(){};
+  ~YUVPackedConversionTest(){};
+
+private slots:
+  void testPackedConversion_data();
+  void testPackedConversion();
+
+  void testBytePackedPixelValues_data();
+  void testBytePackedPixelValues();
+};
+
+namespace
+{
+
+// The planar format that a packed frame in the given format is unpacked to
+PixelFormatYUV getPlanarFormat(const PixelFormatYUV &packedFormat)
+{
+  if (packedFormat.getPredefinedFormat() || packedFormat.isBytePacking())
+    return PixelFormatYUV(Subsampling::YUV_422, 10, PlaneOrder::YUV);
+  return PixelFormatYUV(packedFormat.getSubsampling(),
+                        packedFormat.getBitsPerSample(),
+                        PlaneOrder::YUV,
+                        packedFormat.isBigEndian());
+}
+
+// Append 4 10 bit values in 5 bytes (highest bits first)
+void appendBytePackedBlock(QByteArray &data, const int values[4])
+{
+  data.append(char(values[0] >> 2));
+  data.append(char(((values[0] & 0x03) << 6) + (values[1] >> 4)));
+  data.append(char(((values[1] & 0x0f) << 4) + (values[2] >> 6)));
+  data.append(char(((values[2] & 0x3f) << 2) + (values[3] >> 8)));
+  data.append(char(values[3] & 0xff));
+}
+
+// Write the planes in the packing order of the given format. The order of the samples is taken
+// from the name of the packing (e.g. UYVY) where a second Y is the luma sample of the next pixel.
+// The alpha samples are set to a constant value.
+QByteArray writePackedFrame(const Planes &planes, const PixelFormatYUV &packedFormat)
+{
+  const auto bitDepth      = packedFormat.getBitsPerSample();
+  const auto bigEndian     = packedFormat.isBigEndian();
+  const auto packingName   = PackingOrderMapper.getName(packedFormat.getPackingOrder());
+  const auto pixelsInBlock = unsigned(packedFormat.getSubsamplingHor());
+  const auto nrBlocks      = planes.samples[1].size();
+
+  QByteArray data;
+  for (size_t block = 0; block < nrBlocks; block++)
+  {
+    std::vector<int> values;
+    auto             lumaIndex = block * pixelsInBlock;
+    for (const auto component : packingName)
+    {
+      if (component == 'Y')
+        values.push_back(planes.samples[0][lumaIndex++]);
+      else if (component == 'U')
+        values.push_back(planes.samples[1][block]);
+      else if (component == 'V')
+        values.push_back(planes.samples[2][block]);
+      else
+        values.push_back((1 << bitDepth) - 1);
+    }
+
+    if (packedFormat.isBytePacking())
+      appendBytePackedBlock(data, values.data());
+    else
+      for (const auto value : values)
+        appendSample(data, value, bitDepth, bigEndian);
+  }
+  return data;
+}
+
+void appendV210Word(QByteArray &data, int value0, int value1, int value2)
+{
+  const auto word = unsigned(value0) + (unsigned(value1) << 10) + (unsigned(value2) << 20);
+  for (unsigned i = 0; i < 4; i++)
+    data.append(char((word >> (i * 8)) & 0xff));
+}
+
+// Write the 4:2:2 10 bit planes as V210. Each line is padded to a multiple of 48 pixels.
+QByteArray writeV210Frame(const Planes &planes, const Size frameSize)
+{
+  const auto w            = frameSize.width;
+  const auto widthRoundUp = (w + 47) / 48 * 48;
+
+  QByteArray data;
+  for (unsigned y = 0; y < frameSize.height; y++)
+  {
+    const auto getY = [&](unsigned x) { return x < w ? planes.samples[0][y * w + x] : 0; };
+    const auto getU = [&](unsigned x) { return x < w ? planes.samples[1][y * w / 2 + x / 2] : 0; };
+    const auto getV = [&](unsigned x) { return x < w ? planes.samples[2][y * w / 2 + x / 2] : 0; };
+    for (unsigned x = 0; x < widthRoundUp; x += 6)
+    {
+      appendV210Word(data, getU(x), getY(x), getV(x));
+      appendV210Word(data, getY(x + 1), getU(x + 2), getY(x + 2));
+      appendV210Word(data, getV(x + 2), getY(x + 3), getU(x + 4));
+      appendV210Word(data, getY(x + 4), getV(x + 4), getY(x + 5));
+    }
+  }
+  return data;
+}
+
+ConversionSettings createConversionSettings(ChromaInterpolation chromaInterpolation)
+{
+  ConversionSettings settings;
+  settings.chromaInterpolation               = chromaInterpolation;
+  settings.mathParameters[Component::Luma]   = MathParameters();
+  settings.mathParameters[Component::Chroma] = MathParameters();
+  return settings;
+}
+
+QString getFormatName(const PixelFormatYUV &format)
+{
+  if (format.getPredefinedFormat())
+    return "V210";
+  return QString::fromStdString(format.getName());
+}
+
+} // namespace
+
+void YUVPackedConversionTest::testPackedConversion_data()
+{
+  QTest::addColumn<PixelFormatYUV>("packedFormat");
+  QTest::addColumn<unsigned>("width");
+  QTest::addColumn<ChromaInterpolation>("chromaInterpolation");
+
+  std::vector<PixelFormatYUV> formats;
+  for (const auto packing : PackingOrderMapper.getEnums())
+  {
+    if (packing == PackingOrder::UNKNOWN)
+      continue;
+    const auto subsampling = (packing == PackingOrder::UYVY || packing == PackingOrder::VYUY ||
+                              packing == PackingOrder::YUYV || packing == PackingOrder::YVYU)
+                                 ? Subsampling::YUV_422
+                                 : Subsampling::YUV_444;
+    for (const auto bitDepth : {8u, 10u, 16u})
+      for (const auto bigEndian : {false, true})
+      {
+        if (bitDepth == 8 && bigEndian)
+          continue;
+        formats.push_back(PixelFormatYUV(subsampling, bitDepth, packing, false, bigEndian));
+      }
+    if (subsampling == Subsampling::YUV_422)
+      formats.push_back(PixelFormatYUV(subsampling, 10, packing, true));
+  }
+  formats.push_back(PixelFormatYUV(PredefinedPixelFormat::V210));
+
+  // The widths are not a multiple of the 6 pixels of a V210 block or the 16 pixels that the
+  // vectorized unpacking processes at a time
+  for (const auto &format : formats)
+    for (const auto width : {22u, 38u})
+      for (const auto interpolation : ChromaInterpolationMapper.getEnums())
+      {
+        const auto name =
+            QString("%1 width %2 %3")
+                .arg(getFormatName(format))
+                .arg(width)
+                .arg(QString::fromStdString(ChromaInterpolationMapper.getName(interpolation)));
+        QTest::newRow(qPrintable(name)) << format << width << interpolation;
+      }
+}
+
+// Packed frames are converted to RGB line by line. This must give the same result as unpacking
+// the whole frame to planar and converting that.
+void YUVPackedConversionTest::testPackedConversion()
+{
+  QFETCH(PixelFormatYUV, packedFormat);
+  QFETCH(unsigned, width);
+  QFETCH(ChromaInterpolation, chromaInterpolation);
+
+  const auto frameSize    = Size(width, 5u);
+  const auto planarFormat = getPlanarFormat(packedFormat);
+  const auto planes       = createRandomPlanes(planarFormat, frameSize);
+  const auto planarData   = writeFrame(planes, planarFormat);
+  const auto packedData   = packedFormat.getPredefinedFormat()
+                                ? writeV210Frame(planes, frameSize)
+                                : writePackedFrame(planes, packedFormat);
+  QCOMPARE(int64_t(packedData.size()), packedFormat.bytesPerFrame(frameSize));
+
+  QByteArray unpackedData;
+  const auto [unpackOK, unpackedFormat] =
+      convertToPlanarYUV(packedData, unpackedData, frameSize, packedFormat);
+  QVERIFY(unpackOK);
+  QCOMPARE(unpackedFormat, planarFormat);
+  QCOMPARE(unpackedData.left(planarData.size()), planarData);
+
+  const auto settings = createConversionSettings(chromaInterpolation);
+
+  QImage packedImage;
+  convertYUVToImage(packedData, packedImage, packedFormat, frameSize, settings);
+  QImage planarImage;
+  convertYUVToImage(unpackedData, planarImage, unpackedFormat, frameSize, settings);
+
+  QCOMPARE(packedImage.size(), QSize(int(frameSize.width), int(frameSize.height)));
+  QCOMPARE(planarImage.size(), packedImage.size());
+  for (int y = 0; y < packedImage.height(); y++)
+    for (int x = 0; x < packedImage.width(); x++)
+      QCOMPARE(packedImage.pixel(x, y), planarImage.pixel(x, y));
+}
+
+void YUVPackedConversionTest::testBytePackedPixelValues_data()
+{
+  QTest::addColumn<PixelFormatYUV>("packedFormat");
+
+  for (const auto packing :
+       {PackingOrder::UYVY, PackingOrder::VYUY, PackingOrder::YUYV, PackingOrder::YVYU})
+  {
+    const auto format = PixelFormatYUV(Subsampling::YUV_422, 10, packing, true);
+    QTest::newRow(qPrintable(getFormatName(format))) << format;
+  }
+}
+
+// The pixel values of byte packed 10 bit 4:2:2 are read from the right block in every line
+void YUVPackedConversionTest::testBytePackedPixelValues()
+{
+  QFETCH(PixelFormatYUV, packedFormat);
+
+  const auto frameSize  = Size(22u, 5u);
+  const auto planes     = createRandomPlanes(getPlanarFormat(packedFormat), frameSize);
+  const auto packedData = writePackedFrame(planes, packedFormat);
+
+  videoHandlerYUV handler;
+  handler.setFrameSize(frameSize);
+  handler.setPixelFormatYUV(packedFormat);
+  QObject::connect(&handler,
+                   &videoHandler::signalRequestRawData,
+                   [&handler, &packedData](int frameIndex, bool) {
+                     handler.rawData            = packedData;
+                     handler.rawData_frameIndex = frameIndex;
+                   });
+  handler.loadFrame(0);
+
+  const auto w = frameSize.width;
+  for (unsigned y = 0; y < frameSize.height; y++)
+    for (unsigned x = 0; x < w; x++)
+    {
+      const auto values = handler.getPixelValues(QPoint(int(x), int(y)), 0);
+      QCOMPARE(values.size(), 3);
+      QCOMPARE(values[0].second, QString::number(planes.samples[0][y * w + x]));
+      QCOMPARE(values[1].second, QString::number(planes.samples[1][y * w / 2 + x / 2]));
+      QCOMPARE(values[2].second, QString::number(planes.samples[2][y * w / 2 + x / 2]));
+    }
+}
+
+QTEST_MAIN(YUVPackedConversionTest)
+
+#include "YUVPackedConversionTest.moc"
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <video/PixelFormatYUV.h>
+
+#include <QByteArray>
+
+#include <random>
+#include <vector>
+
+// Create YUV test frames with random samples and write them in the layout of a planar format. This
+// is shared by the YUV conversion tests.
+namespace test
+{
+
+// The samples of the Y, U and V plane of a frame
+struct Planes
+{
+  std::vector<int> samples[3];
+  Size             sizes[3]{{0, 0}, {0, 0}, {0, 0}};
+  unsigned         nrPlanes{};
+};
+
+inline Planes createRandomPlanes(const video::yuv::PixelFormatYUV &format, const Size frameSize)
+{
+  std::mt19937                    generator(42);
+  std::uniform_int_distribution<> distribution(0, (1 << format.getBitsPerSample()) - 1);
+
+  Planes planes;
+  planes.nrPlanes = (format.getSubsampling() == video::yuv::Subsampling::YUV_400) ? 1 : 3;
+  for (unsigned c = 0; c < planes.nrPlanes; c++)
+  {
+    const auto subH = (c == 0) ? 1u : unsigned(format.getSubsamplingHor());
+    const auto subV = (c == 0) ? 1u : unsigned(format.getSubsamplingVer());
+    planes.sizes[c] = Size(frameSize.width / subH, frameSize.height / subV);
+    planes.samples[c].resize(size_t(planes.sizes[c].width) * planes.sizes[c].height);
+    for (auto &sample : planes.samples[c])
+      sample = distribution(generator);
+  }
+  return planes;
+}
+
+inline void appendSample(QByteArray &data, int value, unsigned bitDepth, bool bigEndian)
+{
+  if (bitDepth <= 8)
+    data.append(char(value));
+  else if (bigEndian)
+  {
+    data.append(char(value >> 8));
+    data.append(char(value & 0xff));
+  }
+  else
+  {
+    data.append(char(value & 0xff));
+    data.append(char(value >> 8));
+  }
+}
+
+// Write the planes in the layout of the given format (plane order, UV interleaving, endianness)
+inline QByteArray writeFrame(const Planes &planes, const video::yuv::PixelFormatYUV &format)
+{
+  const auto bitDepth  = format.getBitsPerSample();
+  const auto bigEndian = format.isBigEndian();
+
+  QByteArray data;
+  for (const auto sample : planes.samples[0])
+    appendSample(data, sample, bitDepth, bigEndian);
+  if (planes.nrPlanes == 1)
+    return data;
+
+  const auto swapUV = format.getPlaneOrder() == video::yuv::PlaneOrder::YVU;
+  const auto first  = swapUV ? 2 : 1;
+  const auto second = swapUV ? 1 : 2;
+  if (format.isUVInterleaved())
+  {
+    for (size_t i = 0; i < planes.samples[1].size(); i++)
+    {
+      appendSample(data, planes.samples[first][i], bitDepth, bigEndian);
+      appendSample(data, planes.samples[second][i], bitDepth, bigEndian);
+    }
+  }
+  else
+  {
+    for (const auto sample : planes.samples[first])
+      appendSample(data, sample, bitDepth, bigEndian);
+    for (const auto sample : planes.samples[second])
+      appendSample(data, sample, bitDepth, bigEndian);
+  }
+  return data;
+}
+
+} // namespace test
@@ -5,4 +5,16 @@ requires(qtHaveModule(testlib))
 SUBDIRS = PixelFormatYUVTest.pro \
           PixelFormatRGBTest.pro \
           PixelFormatYUVGuessTest.pro \
-          PixelFormatRGBGuessTest.pro
+          PixelFormatRGBGuessTest.pro \
+          FrameMetricsTest.pro \
+          DifferenceKernelTest.pro \
+          FrameCompressionTest.pro \
+          ResamplerTest.pro \
+          RGBConversionTest.pro \
+          YUVConversionTest.pro \
+          YUVPackedConversionTest.pro \
+          FrameBufferPoolTest.pro \
+          TileCacheTest.pro \
+          PlanarYUVTest.pro \
+          ImagePyramidTest.pro \
+          CachePolicyTest.pro